@@ -9,14 +9,167 @@
 #include "api/function_dict_c_api.h"
 #include <QMutex>
 #include <QString>
+#include <QStringEncoder>
+#include <QStringList>
 #include <QVector>
+#include <cstring>
+#include <memory>
 #include "common/logger/logger.h"
 #include "core/database/databasemanager.h"
+#include "core/database/functionsnapshot.h"
+#include "core/database/functionstore.h"
+
+/**
+ * @brief 数据库句柄，每个线程在句柄上使用自己的连接和错误信息
+ */
+struct fd_handle
+{
+    FunctionStore store;  ///< 函数表批量访问
+
+    explicit fd_handle(const QString& dbPath) : store(dbPath) {}
+};
+
+/**
+ * @brief 查询游标，文本列编码到按列复用的缓冲区中，缓冲区只增长不释放
+ */
+struct fd_cursor
+{
+    fd_handle* handle;                       ///< 打开游标的句柄（用于记录错误）
+    std::unique_ptr<FunctionCursor> cursor;  ///< 函数查询游标
+    QStringEncoder encoder;                  ///< UTF-8编码器
+    QByteArray buffers[5];                   ///< 文本列的缓冲区（名称、介绍、签名、路径、语言）
+
+    fd_cursor(fd_handle* owner, std::unique_ptr<FunctionCursor> functionCursor)
+        : handle(owner),
+          cursor(std::move(functionCursor)),
+          encoder(QStringEncoder::Utf8, QStringConverter::Flag::Stateless)
+    {
+    }
+};
+
+/**
+ * @brief 只读函数字典快照
+ */
+struct fd_snapshot
+{
+    FunctionSnapshot snapshot;  ///< 快照读取器
+    QByteArray errorUtf8;       ///< 打开失败的原因（UTF-8）
+};
 
 namespace
 {
 QMutex g_mutex;
 QString g_lastError;
+
+/**
+ * @brief 把C结构体数组转换为函数记录
+ * @param functions 函数记录数组
+ * @param count 数组长度
+ * @return 函数记录
+ */
+QVector<FunctionRecord> toRecords(const fd_function* functions, int count)
+{
+    QVector<FunctionRecord> records;
+    records.resize(count);
+    for (int i = 0; i < count; ++i)
+    {
+        const fd_function& function = functions[i];
+        FunctionRecord& record = records[i];
+        record.projectId = function.project_id;
+        record.key = QString::fromUtf8(function.key);
+        record.value = QString::fromUtf8(function.value);
+        record.signature = QString::fromUtf8(function.signature);
+        record.filePath = QString::fromUtf8(function.file_path);
+        record.startLine = function.start_line;
+        record.endLine = function.end_line;
+        record.language = QString::fromUtf8(function.language);
+    }
+    return records;
+}
+
+/**
+ * @brief 批量写入的公共实现
+ * @param handle 句柄
+ * @param functions 函数记录数组
+ * @param count 数组长度
+ * @param replaceExisting 是否更新已有函数
+ * @param affected 输出参数（可为NULL），写入数量
+ * @return 0表示成功，非0表示失败
+ */
+int writeFunctions(fd_handle* handle, const fd_function* functions, int count, bool replaceExisting, int* affected)
+{
+    if (affected != nullptr)
+    {
+        *affected = 0;
+    }
+    if (handle == nullptr)
+    {
+        return -1;
+    }
+    if (count < 0 || (functions == nullptr && count > 0))
+    {
+        handle->store.setLastError("函数记录数组无效");
+        return -1;
+    }
+
+    return handle->store.writeFunctions(toRecords(functions, count), replaceExisting, affected) ? 0 : -1;
+}
+
+/**
+ * @brief 打开查询游标的公共实现
+ * @param handle 句柄
+ * @param filter 过滤方式
+ * @param argument 过滤参数
+ * @param cursor 输出参数，游标
+ * @return 0表示成功，非0表示失败
+ */
+int openCursor(fd_handle* handle, FunctionFilter filter, const QVariant& argument, fd_cursor** cursor)
+{
+    if (cursor == nullptr)
+    {
+        return -1;
+    }
+    *cursor = nullptr;
+    if (handle == nullptr)
+    {
+        return -1;
+    }
+
+    std::unique_ptr<FunctionCursor> functionCursor = handle->store.openCursor(filter, argument);
+    if (!functionCursor)
+    {
+        return -1;
+    }
+    *cursor = new fd_cursor(handle, std::move(functionCursor));
+    return 0;
+}
+
+/**
+ * @brief 把文本列编码到游标的缓冲区中
+ * @param cursor 游标
+ * @param buffer 缓冲区编号
+ * @param value 列的值
+ * @return 指向缓冲区的字符串，值为NULL时返回NULL
+ */
+const char* encodeColumn(fd_cursor* cursor, int buffer, const QVariant& value)
+{
+    if (value.isNull())
+    {
+        return nullptr;
+    }
+
+    // 缓冲区只在容量不足时扩大，之后的行直接覆盖写入
+    QString text = value.toString();
+    QByteArray& bytes = cursor->buffers[buffer];
+    qsizetype required = cursor->encoder.requiredSpace(text.size()) + 1;
+    if (bytes.size() < required)
+    {
+        bytes.resize(required);
+    }
+    char* end = cursor->encoder.appendToBuffer(bytes.data(), text);
+    *end = '\0';
+    return bytes.constData();
+}
 }  // namespace
 
 int function_dict_init(const char* db_path)
@@ -151,3 +304,216 @@ void function_dict_cleanup()
     g_lastError.clear();
     Logger::instance().info("C接口资源已清理");
 }
+
+int fd_open(const char* db_path, fd_handle** handle)
+{
+    if (handle == nullptr)
+    {
+        return -1;
+    }
+    *handle = nullptr;
+
+    if (db_path == nullptr)
+    {
+        Logger::instance().error("数据库路径不能为空");
+        return -1;
+    }
+
+    *handle = new fd_handle(QString::fromUtf8(db_path));
+    return (*handle)->store.open() ? 0 : -1;
+}
+
+void fd_close(fd_handle* handle)
+{
+    delete handle;
+}
+
+const char* fd_last_error(fd_handle* handle)
+{
+    if (handle == nullptr)
+    {
+        return nullptr;
+    }
+    const QByteArray& error = handle->store.lastErrorUtf8();
+    return error.isEmpty() ? nullptr : error.constData();
+}
+
+int fd_insert_functions(fd_handle* handle, const fd_function* functions, int count, int* inserted)
+{
+    return writeFunctions(handle, functions, count, false, inserted);
+}
+
+int fd_upsert_functions(fd_handle* handle, const fd_function* functions, int count, int* affected)
+{
+    return writeFunctions(handle, functions, count, true, affected);
+}
+
+int fd_functions_exist(fd_handle* handle, const char* const* keys, int count, int* results)
+{
+    if (handle == nullptr)
+    {
+        return -1;
+    }
+    if (count < 0 || (count > 0 && (keys == nullptr || results == nullptr)))
+    {
+        handle->store.setLastError("函数名称数组或结果数组无效");
+        return -1;
+    }
+
+    QStringList keyList;
+    keyList.reserve(count);
+    for (int i = 0; i < count; ++i)
+    {
+        keyList.append(keys[i] != nullptr ? QString::fromUtf8(keys[i]) : QString());
+    }
+
+    QVector<bool> exists;
+    if (!handle->store.functionsExist(keyList, exists))
+    {
+        return -1;
+    }
+    for (int i = 0; i < count; ++i)
+    {
+        results[i] = exists[i] ? 1 : 0;
+    }
+    return 0;
+}
+
+int fd_query_by_project(fd_handle* handle, int project_id, fd_cursor** cursor)
+{
+    return openCursor(handle, FunctionFilter::Project, project_id, cursor);
+}
+
+int fd_query_by_key(fd_handle* handle, const char* key, fd_cursor** cursor)
+{
+    if (handle != nullptr && key == nullptr)
+    {
+        handle->store.setLastError("函数名称不能为空");
+        return -1;
+    }
+    return openCursor(handle, FunctionFilter::Key, QString::fromUtf8(key), cursor);
+}
+
+int fd_query_by_prefix(fd_handle* handle, const char* prefix, fd_cursor** cursor)
+{
+    if (handle != nullptr && prefix == nullptr)
+    {
+        handle->store.setLastError("名称前缀不能为空");
+        return -1;
+    }
+    return openCursor(handle, FunctionFilter::KeyPrefix, QString::fromUtf8(prefix), cursor);
+}
+
+int fd_query_search(fd_handle* handle, const char* term, fd_cursor** cursor)
+{
+    if (handle != nullptr && term == nullptr)
+    {
+        handle->store.setLastError("搜索文本不能为空");
+        return -1;
+    }
+    return openCursor(handle, FunctionFilter::Text, QString::fromUtf8(term), cursor);
+}
+
+int fd_cursor_next(fd_cursor* cursor, fd_row* row)
+{
+    if (cursor == nullptr || row == nullptr)
+    {
+        return -1;
+    }
+
+    FunctionCursor& functionCursor = *cursor->cursor;
+    if (!functionCursor.next())
+    {
+        if (!functionCursor.lastError().isEmpty())
+        {
+            cursor->handle->store.setLastError(functionCursor.lastError());
+            return -1;
+        }
+        return 0;
+    }
+
+    row->id = functionCursor.value(FunctionCursor::Id).toInt();
+    row->project_id = functionCursor.value(FunctionCursor::ProjectId).toInt();
+    row->key = encodeColumn(cursor, 0, functionCursor.value(FunctionCursor::Key));
+    row->value = encodeColumn(cursor, 1, functionCursor.value(FunctionCursor::Value));
+    row->signature = encodeColumn(cursor, 2, functionCursor.value(FunctionCursor::Signature));
+    row->file_path = encodeColumn(cursor, 3, functionCursor.value(FunctionCursor::FilePath));
+    row->language = encodeColumn(cursor, 4, functionCursor.value(FunctionCursor::Language));
+    row->start_line = functionCursor.value(FunctionCursor::StartLine).toInt();
+    row->end_line = functionCursor.value(FunctionCursor::EndLine).toInt();
+    return 1;
+}
+
+void fd_cursor_close(fd_cursor* cursor)
+{
+    delete cursor;
+}
+
+int fd_export_snapshot(fd_handle* handle, const char* path, int* count)
+{
+    if (count != nullptr)
+    {
+        *count = 0;
+    }
+    if (handle == nullptr)
+    {
+        return -1;
+    }
+    if (path == nullptr)
+    {
+        handle->store.setLastError("快照文件路径不能为空");
+        return -1;
+    }
+    return handle->store.exportSnapshot(QString::fromUtf8(path), count) ? 0 : -1;
+}
+
+int fd_snapshot_open(const char* path, fd_snapshot** snapshot)
+{
+    if (snapshot == nullptr)
+    {
+        return -1;
+    }
+    *snapshot = nullptr;
+
+    if (path == nullptr)
+    {
+        Logger::instance().error("快照文件路径不能为空");
+        return -1;
+    }
+
+    *snapshot = new fd_snapshot;
+    if (!(*snapshot)->snapshot.open(QString::fromUtf8(path)))
+    {
+        (*snapshot)->errorUtf8 = (*snapshot)->snapshot.lastError().toUtf8();
+        return -1;
+    }
+    return 0;
+}
+
+int fd_snapshot_lookup(const fd_snapshot* snapshot, const char* key, const char** value, size_t* value_length)
+{
+    if (snapshot == nullptr || key == nullptr || value == nullptr)
+    {
+        return -1;
+    }
+    return snapshot->snapshot.lookup(key, std::strlen(key), value, value_length) ? 1 : 0;
+}
+
+int fd_snapshot_count(const fd_snapshot* snapshot)
+{
+    return snapshot != nullptr ? static_cast<int>(snapshot->snapshot.size()) : 0;
+}
+
+const char* fd_snapshot_last_error(const fd_snapshot* snapshot)
+{
+    if (snapshot == nullptr || snapshot->errorUtf8.isEmpty())
+    {
+        return nullptr;
+    }
+    return snapshot->errorUtf8.constData();
+}
+
+void fd_snapshot_close(fd_snapshot* snapshot)
+{
+    delete snapshot;
+}
@@ -7,16 +7,68 @@
  *
  * 本模块提供C语言风格的API，支持Python等其他语言调用。
  * 所有接口均使用extern "C"导出，确保二进制兼容性。
+ *
+ * 接口分两组：
+ * - function_dict_*：基于全局数据库单例的单条操作，所有调用串行执行，错误信息为进程全局
+ * - fd_*：基于句柄的接口，每个线程在句柄上使用自己的数据库连接，可在多个线程中同时调用；
+ *   支持在一个事务中批量插入、批量更新或插入、批量检查存在，错误信息按句柄（和调用线程）保存；
+ *   查询以游标返回，逐行读取，行中的字符串指向游标持有并复用的缓冲区，调用者无需释放
+ * - fd_snapshot_*：只读的函数字典快照（由 fd_export_snapshot 导出），内存映射后按函数名称查找介绍，
+ *   查找不访问数据库、不分配内存，多个进程可以共享同一个快照文件的页缓存
  */
 
 #ifndef FUNCTION_DICT_C_API_H
 #define FUNCTION_DICT_C_API_H
 
+#include <stddef.h>
+
 #ifdef __cplusplus
 extern "C"
 {
 #endif
 
+    /**
+ * @brief 数据库句柄（不透明类型）
+ */
+    typedef struct fd_handle fd_handle;
+
+    /**
+ * @brief 批量写入的函数记录，字符串均为UTF-8编码
+ */
+    typedef struct fd_function
+    {
+        const char* key;        /**< 函数名称，不能为空 */
+        const char* value;      /**< 函数介绍（Markdown格式），可为NULL */
+        const char* signature;  /**< 函数签名，可为NULL */
+        const char* file_path;  /**< 源文件路径，可为NULL；与函数名称一起唯一确定一个函数 */
+        const char* language;   /**< 编程语言，可为NULL */
+        int project_id;         /**< 所属项目ID，小于等于0表示不属于任何项目 */
+        int start_line;         /**< 起始行号 */
+        int end_line;           /**< 结束行号 */
+    } fd_function;
+
+    /**
+ * @brief 查询游标（不透明类型）
+ */
+    typedef struct fd_cursor fd_cursor;
+
+    /**
+ * @brief 查询结果中的一行；字符串为UTF-8编码，指向游标持有的缓冲区，在下次 fd_cursor_next 或
+ * fd_cursor_close 前有效，调用者不应释放
+ */
+    typedef struct fd_row
+    {
+        int id;                 /**< 函数ID */
+        int project_id;         /**< 所属项目ID，不属于任何项目时为0 */
+        const char* key;        /**< 函数名称 */
+        const char* value;      /**< 函数介绍，数据库中为NULL时为NULL */
+        const char* signature;  /**< 函数签名，数据库中为NULL时为NULL */
+        const char* file_path;  /**< 源文件路径，数据库中为NULL时为NULL */
+        const char* language;   /**< 编程语言，数据库中为NULL时为NULL */
+        int start_line;         /**< 起始行号 */
+        int end_line;           /**< 结束行号 */
+    } fd_row;
+
     /**
  * @brief 初始化函数字典库
  * @param db_path 数据库文件路径（UTF-8编码）
@@ -73,6 +125,160 @@ extern "C"
  */
     void function_dict_cleanup();
 
+    /**
+ * @brief 打开数据库句柄（数据库须已由 function_dict_init 或应用初始化过表结构）
+ * @param db_path 数据库文件路径（UTF-8编码）
+ * @param handle 输出参数，句柄；打开失败时仍返回句柄以便读取错误信息，调用者须用 fd_close 释放
+ * @return 0表示成功，非0表示失败（db_path 或 handle 为NULL时不创建句柄）
+ */
+    int fd_open(const char* db_path, fd_handle** handle);
+
+    /**
+ * @brief 关闭句柄并释放调用线程的连接（其他线程的连接在这些线程退出或打开新句柄时释放）
+ * @param handle 句柄，可为NULL；调用前须保证没有其他线程仍在使用该句柄
+ */
+    void fd_close(fd_handle* handle);
+
+    /**
+ * @brief 获取调用线程在句柄上最后一次错误信息
+ * @param handle 句柄
+ * @return 错误信息（UTF-8编码），没有错误时返回NULL
+ * 注意：返回的字符串在本线程下次调用该句柄前有效，调用者不应释放
+ */
+    const char* fd_last_error(fd_handle* handle);
+
+    /**
+ * @brief 在一个事务中批量插入函数，（函数名称, 源文件路径）已存在的函数被跳过
+ * @param handle 句柄
+ * @param functions 函数记录数组
+ * @param count 数组长度
+ * @param inserted 输出参数（可为NULL），实际插入的数量
+ * @return 0表示成功，非0表示失败（失败时整批回滚）
+ */
+    int fd_insert_functions(fd_handle* handle, const fd_function* functions, int count, int* inserted);
+
+    /**
+ * @brief 在一个事务中批量更新或插入函数，（函数名称, 源文件路径）已存在的函数被更新
+ * @param handle 句柄
+ * @param functions 函数记录数组
+ * @param count 数组长度
+ * @param affected 输出参数（可为NULL），插入和更新的总数
+ * @return 0表示成功，非0表示失败（失败时整批回滚）
+ */
+    int fd_upsert_functions(fd_handle* handle, const fd_function* functions, int count, int* affected);
+
+    /**
+ * @brief 批量检查函数名称是否存在
+ * @param handle 句柄
+ * @param keys 函数名称数组（UTF-8编码）
+ * @param count 数组长度
+ * @param results 输出数组，长度为 count，1表示存在，0表示不存在
+ * @return 0表示成功，非0表示失败
+ */
+    int fd_functions_exist(fd_handle* handle, const char* const* keys, int count, int* results);
+
+    /**
+ * @brief 查询项目下的所有函数
+ * @param handle 句柄
+ * @param project_id 项目ID
+ * @param cursor 输出参数，游标；只能在打开它的线程中使用，并须在 fd_close 前用 fd_cursor_close 释放
+ * @return 0表示成功，非0表示失败
+ */
+    int fd_query_by_project(fd_handle* handle, int project_id, fd_cursor** cursor);
+
+    /**
+ * @brief 按函数名称查询（同名函数可能位于多个源文件）
+ * @param handle 句柄
+ * @param key 函数名称（UTF-8编码）
+ * @param cursor 输出参数，游标（使用限制同 fd_query_by_project）
+ * @return 0表示成功，非0表示失败
+ */
+    int fd_query_by_key(fd_handle* handle, const char* key, fd_cursor** cursor);
+
+    /**
+ * @brief 按函数名称前缀查询，结果按函数名称排序
+ * @param handle 句柄
+ * @param prefix 名称前缀（UTF-8编码，区分大小写）
+ * @param cursor 输出参数，游标（使用限制同 fd_query_by_project）
+ * @return 0表示成功，非0表示失败
+ */
+    int fd_query_by_prefix(fd_handle* handle, const char* prefix, fd_cursor** cursor);
+
+    /**
+ * @brief 搜索函数名称、签名或介绍中包含指定文本的函数（不区分ASCII大小写）
+ * @param handle 句柄
+ * @param term 搜索文本（UTF-8编码）
+ * @param cursor 输出参数，游标（使用限制同 fd_query_by_project）
+ * @return 0表示成功，非0表示失败
+ */
+    int fd_query_search(fd_handle* handle, const char* term, fd_cursor** cursor);
+
+    /**
+ * @brief 读取游标的下一行
+ * @param cursor 游标
+ * @param row 输出参数，当前行
+ * @return 1表示读到一行，0表示已读完，-1表示出错（错误信息通过 fd_last_error 获取）
+ */
+    int fd_cursor_next(fd_cursor* cursor, fd_row* row);
+
+    /**
+ * @brief 释放游标
+ * @param cursor 游标，可为NULL
+ */
+    void fd_cursor_close(fd_cursor* cursor);
+
+    /**
+ * @brief 只读函数字典快照（不透明类型）
+ */
+    typedef struct fd_snapshot fd_snapshot;
+
+    /**
+ * @brief 把所有函数的名称和介绍导出为快照文件（同名函数保留最早添加的一个），写完后原子替换目标文件
+ * @param handle 句柄
+ * @param path 快照文件路径（UTF-8编码）
+ * @param count 输出参数（可为NULL），快照中的函数数
+ * @return 0表示成功，非0表示失败
+ */
+    int fd_export_snapshot(fd_handle* handle, const char* path, int* count);
+
+    /**
+ * @brief 打开快照文件（只读内存映射）
+ * @param path 快照文件路径（UTF-8编码）
+ * @param snapshot 输出参数，快照；打开失败时仍返回快照以便读取错误信息，调用者须用 fd_snapshot_close 释放
+ * @return 0表示成功，非0表示失败（path 或 snapshot 为NULL时不创建快照）
+ */
+    int fd_snapshot_open(const char* path, fd_snapshot** snapshot);
+
+    /**
+ * @brief 按函数名称查找介绍（可在多个线程中同时调用，不分配内存）
+ * @param snapshot 快照
+ * @param key 函数名称（UTF-8编码，以0结尾）
+ * @param value 输出参数，以0结尾的介绍（UTF-8编码），指向映射内存，在 fd_snapshot_close 前有效
+ * @param value_length 输出参数（可为NULL），介绍的字节数
+ * @return 1表示找到，0表示不存在，-1表示参数无效
+ */
+    int fd_snapshot_lookup(const fd_snapshot* snapshot, const char* key, const char** value, size_t* value_length);
+
+    /**
+ * @brief 获取快照中的函数数
+ * @param snapshot 快照
+ * @return 函数数
+ */
+    int fd_snapshot_count(const fd_snapshot* snapshot);
+
+    /**
+ * @brief 获取快照打开失败的原因
+ * @param snapshot 快照
+ * @return 错误信息（UTF-8编码），没有错误时返回NULL
+ */
+    const char* fd_snapshot_last_error(const fd_snapshot* snapshot);
+
+    /**
+ * @brief 关闭快照并解除映射
+ * @param snapshot 快照，可为NULL
+ */
+    void fd_snapshot_close(fd_snapshot* snapshot);
+
 #ifdef __cplusplus
 }
 #endif
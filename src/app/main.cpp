@@ -7,12 +7,16 @@
 #include "common/theme/thememanager.h"
 #include "core/database/databasemanager.h"
 #include "core/services/parseservice.h"
+#include "core/watcher/projectwatcher.h"
 #include "ui/mainwindow/mainwindow.h"
 
 int main(int argc, char* argv[])
 {
     QApplication app(argc, argv);
 
+    Logger::instance().setAsyncEnabled(true);
+    Logger::instance().installCrashHandler();
+
     Q_INIT_RESOURCE(markdown);
     Q_INIT_RESOURCE(theme);
 
@@ -49,13 +53,23 @@ int main(int argc, char* argv[])
     }
 
     IDatabaseManager* dbManager = &DatabaseManager::instance();
-    IParseService* parseService = new ParseService(dbManager, &app);
+    ParseService* parseService = new ParseService(dbManager, &app);
+    // 界面只使用解析结果中的统计数据，函数列表从数据库刷新，不需要在内存中保留整批函数
+    parseService->setStreamResults(true);
 
     MainWindow window(dbManager, parseService);
+
+    // 监视已注册项目的根目录，文件变化后增量重新提取，并刷新函数树
+    ProjectWatcher* projectWatcher = new ProjectWatcher(dbManager, &app);
+    QObject::connect(projectWatcher, &ProjectWatcher::projectUpdated, &window, &MainWindow::onDataChanged);
+    int watchedCount = projectWatcher->watchAllProjects();
+    Logger::instance().info(QString("正在监视 %1 个项目").arg(watchedCount));
+
     window.show();
 
     int result = app.exec();
 
     Logger::instance().info("应用程序退出，返回码: " + QString::number(result));
+    Logger::instance().setAsyncEnabled(false);
     return result;
 }
@@ -0,0 +1,520 @@
+/**
+ * @file binarylog.cpp
+ * @brief 结构化二进制日志实现
+ * @author Developer
+ * @date 2026-10-18
+ * @version 1.0
+ */
+
+#include "common/logger/binarylog.h"
+#include <QDir>
+#include <QFileInfo>
+#include <QtEndian>
+#include <cstring>
+
+namespace
+{
+const char kMagic[4] = {'C', 'A', 'L', 'G'};  ///< 文件头魔数
+const quint16 kFormatVersion = 1;             ///< 文件格式版本
+const int kHeaderSize = 16;                   ///< 文件头字节数
+const int kCompressionLevel = 6;              ///< 旧文件压缩级别
+
+const quint8 kTagFormat = 1;  ///< 记录标签：定义格式串
+const quint8 kTagThread = 2;  ///< 记录标签：定义线程
+const quint8 kTagEntry = 3;   ///< 记录标签：日志
+
+/**
+ * @brief 追加一个无符号varint
+ */
+void appendVarint(QByteArray& out, quint64 value)
+{
+    while (value >= 0x80)
+    {
+        out.append(static_cast<char>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    out.append(static_cast<char>(value));
+}
+
+/**
+ * @brief 追加一个有符号varint（zigzag编码，绝对值小的负数也很短）
+ */
+void appendSignedVarint(QByteArray& out, qint64 value)
+{
+    appendVarint(out, (static_cast<quint64>(value) << 1) ^ static_cast<quint64>(value >> 63));
+}
+
+/**
+ * @brief 追加一个带长度前缀的UTF-8字符串
+ */
+void appendText(QByteArray& out, const QByteArray& utf8)
+{
+    appendVarint(out, static_cast<quint64>(utf8.size()));
+    out.append(utf8);
+}
+
+/**
+ * @brief 追加一个小端固定宽度整数
+ */
+template <typename T>
+void appendFixed(QByteArray& out, T value)
+{
+    char buffer[sizeof(T)];
+    qToLittleEndian(value, buffer);
+    out.append(buffer, sizeof(T));
+}
+
+/**
+ * @brief 按顺序读取字节数据的游标，越界后保持失败状态
+ */
+class ByteCursor
+{
+   public:
+    ByteCursor(const QByteArray& data, int pos) : m_data(data), m_pos(pos), m_ok(true) {}
+
+    bool ok() const { return m_ok; }
+    int pos() const { return m_pos; }
+
+    quint8 readByte()
+    {
+        if (!require(1))
+        {
+            return 0;
+        }
+        return static_cast<quint8>(m_data.at(m_pos++));
+    }
+
+    quint64 readVarint()
+    {
+        quint64 value = 0;
+        for (int shift = 0; shift < 64; shift += 7)
+        {
+            quint8 byte = readByte();
+            value |= static_cast<quint64>(byte & 0x7F) << shift;
+            if (!m_ok || !(byte & 0x80))
+            {
+                return value;
+            }
+        }
+        m_ok = false;
+        return 0;
+    }
+
+    qint64 readSignedVarint()
+    {
+        quint64 value = readVarint();
+        return static_cast<qint64>(value >> 1) ^ -static_cast<qint64>(value & 1);
+    }
+
+    double readReal()
+    {
+        if (!require(8))
+        {
+            return 0.0;
+        }
+        quint64 bits = qFromLittleEndian<quint64>(m_data.constData() + m_pos);
+        m_pos += 8;
+        double value = 0.0;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+
+    QString readText()
+    {
+        quint64 length = readVarint();
+        if (!m_ok || length > static_cast<quint64>(m_data.size() - m_pos))
+        {
+            m_ok = false;
+            return QString();
+        }
+        QString text = QString::fromUtf8(m_data.constData() + m_pos, static_cast<int>(length));
+        m_pos += static_cast<int>(length);
+        return text;
+    }
+
+   private:
+    bool require(int bytes)
+    {
+        if (!m_ok || m_data.size() - m_pos < bytes)
+        {
+            m_ok = false;
+        }
+        return m_ok;
+    }
+
+    const QByteArray& m_data;  ///< 数据
+    int m_pos;                 ///< 当前位置
+    bool m_ok;                 ///< 是否尚未越界或遇到无效数据
+};
+
+/**
+ * @brief 把文件压缩为 .z 文件并删除原文件
+ */
+bool compressFile(const QString& sourcePath, const QString& targetPath)
+{
+    QFile source(sourcePath);
+    if (!source.open(QIODevice::ReadOnly))
+    {
+        return false;
+    }
+    QByteArray compressed = qCompress(source.readAll(), kCompressionLevel);
+    source.close();
+
+    QFile target(targetPath);
+    if (!target.open(QIODevice::WriteOnly | QIODevice::Truncate) || target.write(compressed) != compressed.size())
+    {
+        target.remove();
+        return false;
+    }
+    target.close();
+    return source.remove();
+}
+}  // namespace
+
+BinaryLogWriter::BinaryLogWriter() : m_originEpochMs(0), m_lastNs(0) {}
+
+BinaryLogWriter::~BinaryLogWriter()
+{
+    close();
+}
+
+bool BinaryLogWriter::open(const QString& path, const BinaryLogOptions& options, qint64 originEpochMs)
+{
+    close();
+
+    m_path = path;
+    m_options = options;
+    m_originEpochMs = originEpochMs;
+
+    QDir dir = QFileInfo(path).absoluteDir();
+    if (!dir.exists())
+    {
+        dir.mkpath(".");
+    }
+
+    // 每个文件都以自己的文件头开始，上次运行留下的文件先作为旧文件轮转出去
+    if (QFileInfo(path).size() > 0)
+    {
+        return rotate();
+    }
+    return openFile();
+}
+
+void BinaryLogWriter::close()
+{
+    if (m_file.isOpen())
+    {
+        m_file.flush();
+        m_file.close();
+    }
+}
+
+void BinaryLogWriter::write(const LogRecord* records, int count)
+{
+    if (!m_file.isOpen() || count <= 0)
+    {
+        return;
+    }
+
+    QByteArray out;
+    out.reserve(count * 48);
+    for (int i = 0; i < count; ++i)
+    {
+        encodeRecord(out, records[i]);
+    }
+
+    if (m_file.write(out) != out.size())
+    {
+        m_lastError = m_file.errorString();
+    }
+    m_file.flush();
+
+    if (m_options.maxFileBytes > 0 && m_file.size() >= m_options.maxFileBytes)
+    {
+        rotate();
+    }
+}
+
+bool BinaryLogWriter::openFile()
+{
+    m_file.setFileName(m_path);
+    if (!m_file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+    {
+        m_lastError = m_file.errorString();
+        return false;
+    }
+
+    m_formatIds.clear();
+    m_threads.clear();
+    m_lastNs = 0;
+
+    QByteArray header(kMagic, sizeof(kMagic));
+    appendFixed<quint16>(header, kFormatVersion);
+    appendFixed<quint16>(header, 0);
+    appendFixed<qint64>(header, m_originEpochMs);
+    if (m_file.write(header) != header.size())
+    {
+        m_lastError = m_file.errorString();
+        m_file.close();
+        return false;
+    }
+    return true;
+}
+
+bool BinaryLogWriter::rotate()
+{
+    close();
+
+    if (m_options.maxFiles <= 0)
+    {
+        QFile::remove(m_path);
+        return openFile();
+    }
+
+    // 从最旧的文件开始依次加一，超出保留数的文件删除
+    for (int index = m_options.maxFiles; index >= 1; --index)
+    {
+        for (bool compressed : {false, true})
+        {
+            QString from = segmentPath(index, compressed);
+            if (!QFile::exists(from))
+            {
+                continue;
+            }
+            if (index == m_options.maxFiles)
+            {
+                QFile::remove(from);
+            }
+            else
+            {
+                QString to = segmentPath(index + 1, compressed);
+                QFile::remove(to);
+                QFile::rename(from, to);
+            }
+        }
+    }
+
+    QString rotated = segmentPath(1, false);
+    QFile::remove(rotated);
+    if (QFile::rename(m_path, rotated) && m_options.compressRotated)
+    {
+        compressFile(rotated, segmentPath(1, true));
+    }
+
+    return openFile();
+}
+
+QString BinaryLogWriter::segmentPath(int index, bool compressed) const
+{
+    return QString("%1.%2%3").arg(m_path).arg(index).arg(compressed ? ".z" : "");
+}
+
+void BinaryLogWriter::encodeRecord(QByteArray& out, const LogRecord& record)
+{
+    if (!m_threads.contains(record.threadId))
+    {
+        m_threads.insert(record.threadId);
+        out.append(static_cast<char>(kTagThread));
+        appendVarint(out, record.threadId);
+        appendText(out, logThreadName(record.threadId).toUtf8());
+    }
+
+    quint32 formatId = 0;
+    if (record.format)
+    {
+        // 格式串是字符串字面量，地址在进程内不变，按地址查重即可
+        auto it = m_formatIds.constFind(record.format);
+        if (it != m_formatIds.constEnd())
+        {
+            formatId = it.value();
+        }
+        else
+        {
+            formatId = static_cast<quint32>(m_formatIds.size() + 1);
+            m_formatIds.insert(record.format, formatId);
+            out.append(static_cast<char>(kTagFormat));
+            appendVarint(out, formatId);
+            appendText(out, QByteArray(record.format));
+        }
+    }
+
+    out.append(static_cast<char>(kTagEntry));
+    out.append(static_cast<char>(record.level));
+    appendVarint(out, record.threadId);
+    appendSignedVarint(out, record.monotonicNs - m_lastNs);
+    m_lastNs = record.monotonicNs;
+    appendVarint(out, formatId);
+
+    if (formatId == 0)
+    {
+        appendText(out, record.message.toUtf8());
+        return;
+    }
+
+    appendVarint(out, static_cast<quint64>(record.args.size()));
+    for (const LogArg& arg : record.args)
+    {
+        out.append(static_cast<char>(arg.type));
+        switch (arg.type)
+        {
+            case LogArg::Type::Integer:
+                appendSignedVarint(out, arg.integer);
+                break;
+            case LogArg::Type::Real:
+            {
+                quint64 bits = 0;
+                std::memcpy(&bits, &arg.real, sizeof(bits));
+                appendFixed<quint64>(out, bits);
+                break;
+            }
+            case LogArg::Type::Text:
+                appendText(out, arg.text.toUtf8());
+                break;
+        }
+    }
+}
+
+QString BinaryLogEntry::text() const
+{
+    if (format.isEmpty())
+    {
+        return message;
+    }
+    return formatLogMessage(format, args.constData(), args.size());
+}
+
+BinaryLogReader::BinaryLogReader() : m_pos(0), m_originEpochMs(0), m_lastNs(0) {}
+
+bool BinaryLogReader::open(const QString& path)
+{
+    m_data.clear();
+    m_pos = 0;
+    m_lastNs = 0;
+    m_formats.clear();
+    m_threads.clear();
+    m_lastError.clear();
+
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        m_lastError = file.errorString();
+        return false;
+    }
+    m_data = file.readAll();
+    if (path.endsWith(".z"))
+    {
+        m_data = qUncompress(m_data);
+    }
+
+    if (m_data.size() < kHeaderSize || std::memcmp(m_data.constData(), kMagic, sizeof(kMagic)) != 0)
+    {
+        m_lastError = "不是有效的二进制日志文件";
+        return false;
+    }
+    quint16 version = qFromLittleEndian<quint16>(m_data.constData() + 4);
+    if (version != kFormatVersion)
+    {
+        m_lastError = QString("不支持的日志格式版本: %1").arg(version);
+        return false;
+    }
+    m_originEpochMs = qFromLittleEndian<qint64>(m_data.constData() + 8);
+    m_pos = kHeaderSize;
+    return true;
+}
+
+bool BinaryLogReader::readNext(BinaryLogEntry& entry)
+{
+    while (m_pos < m_data.size())
+    {
+        ByteCursor cursor(m_data, m_pos);
+        quint8 tag = cursor.readByte();
+
+        if (tag == kTagFormat)
+        {
+            quint32 id = static_cast<quint32>(cursor.readVarint());
+            QString format = cursor.readText();
+            if (cursor.ok())
+            {
+                m_formats.insert(id, format);
+            }
+        }
+        else if (tag == kTagThread)
+        {
+            quint32 id = static_cast<quint32>(cursor.readVarint());
+            QString name = cursor.readText();
+            if (cursor.ok())
+            {
+                m_threads.insert(id, name);
+            }
+        }
+        else if (tag == kTagEntry)
+        {
+            entry = BinaryLogEntry();
+            entry.level = static_cast<LogLevel>(cursor.readByte());
+            entry.threadId = static_cast<quint32>(cursor.readVarint());
+            entry.monotonicNs = m_lastNs + cursor.readSignedVarint();
+            quint32 formatId = static_cast<quint32>(cursor.readVarint());
+
+            if (formatId == 0)
+            {
+                entry.message = cursor.readText();
+            }
+            else
+            {
+                auto it = m_formats.constFind(formatId);
+                if (it == m_formats.constEnd())
+                {
+                    m_lastError = QString("偏移 %1 处引用了未定义的格式串 %2").arg(m_pos).arg(formatId);
+                    return false;
+                }
+                entry.format = it.value();
+
+                quint64 argCount = cursor.readVarint();
+                for (quint64 i = 0; i < argCount && cursor.ok(); ++i)
+                {
+                    LogArg arg;
+                    arg.type = static_cast<LogArg::Type>(cursor.readByte());
+                    switch (arg.type)
+                    {
+                        case LogArg::Type::Integer:
+                            arg.integer = cursor.readSignedVarint();
+                            break;
+                        case LogArg::Type::Real:
+                            arg.real = cursor.readReal();
+                            break;
+                        case LogArg::Type::Text:
+                            arg.text = cursor.readText();
+                            break;
+                        default:
+                            m_lastError = QString("偏移 %1 处的参数类型无效").arg(cursor.pos() - 1);
+                            return false;
+                    }
+                    entry.args.append(arg);
+                }
+            }
+
+            if (cursor.ok())
+            {
+                m_pos = cursor.pos();
+                m_lastNs = entry.monotonicNs;
+                entry.epochMs = m_originEpochMs + entry.monotonicNs / 1000000;
+                entry.threadName = m_threads.value(entry.threadId);
+                return true;
+            }
+        }
+        else
+        {
+            m_lastError = QString("偏移 %1 处的记录标签无效: %2").arg(m_pos).arg(tag);
+            return false;
+        }
+
+        if (!cursor.ok())
+        {
+            // 进程在写入一批日志的中途退出时，文件末尾可能只有半条记录
+            m_lastError = QString("偏移 %1 处的记录不完整").arg(m_pos);
+            return false;
+        }
+        m_pos = cursor.pos();
+    }
+    return false;
+}
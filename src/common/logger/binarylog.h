@@ -0,0 +1,192 @@
+/**
+ * @file binarylog.h
+ * @brief 结构化二进制日志：写出端（带按大小轮转和压缩）和离线读取端
+ * @author Developer
+ * @date 2026-10-18
+ * @version 1.0
+ *
+ * @details 文件格式（整数均为小端，varint为LEB128）：
+ * - 文件头16字节："CALG"、u16版本、u16保留、i64单调时钟起点对应的墙钟时间（毫秒）
+ * - 之后是连续的记录，每条以u8标签开头：
+ *   - 1 定义格式串：varint编号、varint长度、UTF-8文本（每个格式串在每个文件中只写一次）
+ *   - 2 定义线程：varint线程编号、varint长度、UTF-8线程名
+ *   - 3 日志：u8级别、varint线程编号、zigzag varint时间增量（纳秒，相对上一条日志）、varint格式串编号，
+ *     编号为0时后跟varint长度和UTF-8消息，否则后跟varint参数个数和各参数（u8类型，
+ *     整数为zigzag varint，浮点为8字节，字符串为varint长度和UTF-8文本）
+ * 每个文件自包含，可以单独解码；轮转出的旧文件可压缩为 .z（qCompress格式）。
+ */
+
+#ifndef BINARYLOG_H
+#define BINARYLOG_H
+
+#include <QByteArray>
+#include <QFile>
+#include <QHash>
+#include <QSet>
+#include <QString>
+#include <QVector>
+#include "common/logger/logrecord.h"
+
+/**
+ * @brief 二进制日志选项
+ */
+struct BinaryLogOptions
+{
+    qint64 maxFileBytes;   ///< 当前文件达到此大小后轮转（0表示不轮转）
+    int maxFiles;          ///< 保留的旧文件数（path.1 最新，超出的最旧文件被删除）
+    bool compressRotated;  ///< 是否把轮转出的旧文件压缩为 .z
+
+    BinaryLogOptions() : maxFileBytes(64LL * 1024 * 1024), maxFiles(8), compressRotated(true) {}
+};
+
+/**
+ * @brief 二进制日志写出端（非线程安全，由 Logger 在写出锁内调用）
+ */
+class BinaryLogWriter
+{
+   public:
+    BinaryLogWriter();
+    ~BinaryLogWriter();
+
+    BinaryLogWriter(const BinaryLogWriter&) = delete;
+    BinaryLogWriter& operator=(const BinaryLogWriter&) = delete;
+
+    /**
+     * @brief 打开日志文件（已存在的非空文件先轮转为旧文件）
+     * @param path 文件路径
+     * @param options 轮转选项
+     * @param originEpochMs 单调时钟起点对应的墙钟时间（毫秒）
+     * @return 是否成功
+     */
+    bool open(const QString& path, const BinaryLogOptions& options, qint64 originEpochMs);
+
+    /**
+     * @brief 关闭日志文件
+     */
+    void close();
+
+    /**
+     * @brief 检查是否已打开
+     * @return 是否已打开
+     */
+    bool isOpen() const { return m_file.isOpen(); }
+
+    /**
+     * @brief 获取最后一次错误信息
+     * @return 错误信息
+     */
+    QString lastError() const { return m_lastError; }
+
+    /**
+     * @brief 写出一批日志（整批编码后一次写入，写完后检查是否需要轮转）
+     * @param records 日志数组
+     * @param count 日志条数
+     */
+    void write(const LogRecord* records, int count);
+
+   private:
+    /**
+     * @brief 创建新文件并写入文件头，重置本文件的格式串和线程表
+     * @return 是否成功
+     */
+    bool openFile();
+
+    /**
+     * @brief 轮转：旧文件编号依次加一，当前文件改名为 path.1（按选项压缩），然后创建新文件
+     * @return 是否成功创建新文件
+     */
+    bool rotate();
+
+    /**
+     * @brief 获取旧文件路径
+     * @param index 编号（从1开始）
+     * @param compressed 是否为压缩文件
+     * @return 文件路径
+     */
+    QString segmentPath(int index, bool compressed) const;
+
+    /**
+     * @brief 把一条日志（以及首次出现的格式串和线程定义）编码到缓冲区
+     * @param out 输出缓冲区
+     * @param record 日志
+     */
+    void encodeRecord(QByteArray& out, const LogRecord& record);
+
+    QString m_path;                           ///< 当前文件路径
+    BinaryLogOptions m_options;               ///< 轮转选项
+    qint64 m_originEpochMs;                   ///< 单调时钟起点对应的墙钟时间（毫秒）
+    QFile m_file;                             ///< 当前文件
+    QHash<const char*, quint32> m_formatIds;  ///< 格式串地址 -> 本文件内的编号
+    QSet<quint32> m_threads;                  ///< 本文件已定义的线程
+    qint64 m_lastNs;                          ///< 上一条日志的单调时间戳
+    QString m_lastError;                      ///< 最后一次错误信息
+};
+
+/**
+ * @brief 从二进制日志中读出的一条日志
+ */
+struct BinaryLogEntry
+{
+    qint64 monotonicNs;    ///< 单调时钟时间戳（纳秒）
+    qint64 epochMs;        ///< 换算后的墙钟时间（自1970年起的毫秒数）
+    LogLevel level;        ///< 日志级别
+    quint32 threadId;      ///< 线程编号
+    QString threadName;    ///< 线程名
+    QString format;        ///< 格式串（为空时使用message）
+    QVector<LogArg> args;  ///< 格式串参数
+    QString message;       ///< 未格式化的日志消息
+
+    BinaryLogEntry() : monotonicNs(0), epochMs(0), level(Info), threadId(0) {}
+
+    /**
+     * @brief 获取格式化后的文本消息
+     * @return 文本消息
+     */
+    QString text() const;
+};
+
+/**
+ * @brief 二进制日志读取端（用于离线解码，一次读入整个文件）
+ */
+class BinaryLogReader
+{
+   public:
+    BinaryLogReader();
+
+    /**
+     * @brief 打开日志文件（.z 结尾的文件先解压）
+     * @param path 文件路径
+     * @return 是否成功（文件头无效时返回false）
+     */
+    bool open(const QString& path);
+
+    /**
+     * @brief 读取下一条日志（跳过格式串和线程定义）
+     * @param entry 输出参数，读出的日志
+     * @return 是否读到日志（到达文件末尾或数据损坏时返回false，后者会设置错误信息）
+     */
+    bool readNext(BinaryLogEntry& entry);
+
+    /**
+     * @brief 获取单调时钟起点对应的墙钟时间
+     * @return 自1970年起的毫秒数
+     */
+    qint64 originEpochMs() const { return m_originEpochMs; }
+
+    /**
+     * @brief 获取最后一次错误信息
+     * @return 错误信息（没有错误时为空）
+     */
+    QString lastError() const { return m_lastError; }
+
+   private:
+    QByteArray m_data;                  ///< 文件内容
+    int m_pos;                          ///< 当前读取位置
+    qint64 m_originEpochMs;             ///< 单调时钟起点对应的墙钟时间
+    qint64 m_lastNs;                    ///< 上一条日志的单调时间戳
+    QHash<quint32, QString> m_formats;  ///< 格式串编号 -> 格式串
+    QHash<quint32, QString> m_threads;  ///< 线程编号 -> 线程名
+    QString m_lastError;                ///< 最后一次错误信息
+};
+
+#endif  // BINARYLOG_H
@@ -2,7 +2,8 @@
 #include <QCoreApplication>
 #include <QDir>
 #include <QFileInfo>
-#include <chrono>
+#include <csignal>
+#include <cstring>
 #include <ctime>
 #include <iomanip>
 
@@ -15,6 +16,13 @@
 #include <unistd.h>
 #endif
 
+namespace
+{
+const int kWriterWakeIntervalMs = 50;  ///< 后台线程无唤醒时的最长等待时间（毫秒）
+const int kMaxWriteBatch = 512;        ///< 每批写出的最大日志条数
+const int kCrashLockTimeoutMs = 200;   ///< 崩溃时等待写出锁的最长时间（毫秒）
+}  // namespace
+
 Logger& Logger::instance()
 {
     static Logger logger;
@@ -28,14 +36,27 @@ Logger::Logger()
       m_consoleEnabled(true),
       m_fileEnabled(true),
       m_minLevel(Debug),
-      m_colorSupported(false)
+      m_colorSupported(false),
+      m_cachedSecond(-1),
+      m_originEpochMs(QDateTime::currentMSecsSinceEpoch()),
+      m_writerThread(nullptr),
+      m_async(0),
+      m_stopping(0),
+      m_overflowPolicy(static_cast<int>(LogOverflowPolicy::Block)),
+      m_dropped(0),
+      m_reportedDropped(0),
+      m_written(0)
 {
+    m_clock.start();
     initConsoleColor();
 }
 
 Logger::~Logger()
 {
+    setAsyncEnabled(false);
+
     QMutexLocker locker(&m_mutex);
+    m_binaryLog.reset();
     if (m_logStream)
     {
         delete m_logStream;
@@ -117,6 +138,7 @@ void Logger::init(const QString& logFilePath)
     }
 
     m_initialized = true;
+    locker.unlock();
     info("日志系统初始化成功");
 }
 
@@ -132,117 +154,344 @@ void Logger::setFileEnabled(bool enabled)
 
 void Logger::setMinLevel(LogLevel level)
 {
-    m_minLevel = level;
+    m_minLevel.storeRelaxed(static_cast<int>(level));
 }
 
-QString Logger::getTimestamp()
+bool Logger::setBinaryLog(const QString& path, const BinaryLogOptions& options)
 {
-    auto now = std::chrono::system_clock::now();
-    auto now_time_t = std::chrono::system_clock::to_time_t(now);
-    auto now_ms = std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()) % 1000;
+    QMutexLocker locker(&m_mutex);
+    std::unique_ptr<BinaryLogWriter> writer(new BinaryLogWriter());
+    if (!writer->open(path, options, m_originEpochMs))
+    {
+        QString reason = writer->lastError();
+        locker.unlock();
+        error(QString("无法打开二进制日志文件: %1, 错误: %2").arg(path, reason));
+        return false;
+    }
+    m_binaryLog = std::move(writer);
+    locker.unlock();
+
+    info(QString("二进制日志已开启: %1").arg(path));
+    return true;
+}
 
-    std::tm tm_buf;
+void Logger::closeBinaryLog()
+{
+    flush();
+
+    QMutexLocker locker(&m_mutex);
+    m_binaryLog.reset();
+}
+
+QString Logger::formatTimestamp(qint64 msecsSinceEpoch)
+{
+    qint64 second = msecsSinceEpoch / 1000;
+    if (second != m_cachedSecond)
+    {
+        std::time_t time = static_cast<std::time_t>(second);
+        std::tm tm_buf;
 #ifdef _WIN32
-    localtime_s(&tm_buf, &now_time_t);
+        localtime_s(&tm_buf, &time);
 #else
-    localtime_r(&now_time_t, &tm_buf);
+        localtime_r(&time, &tm_buf);
 #endif
 
-    std::ostringstream oss;
-    oss << std::put_time(&tm_buf, "%Y-%m-%d %H:%M:%S") << "." << std::setfill('0') << std::setw(3) << now_ms.count();
+        std::ostringstream oss;
+        oss << std::put_time(&tm_buf, "%Y-%m-%d %H:%M:%S");
+        m_cachedSecond = second;
+        m_cachedSecondText = QString::fromStdString(oss.str());
+    }
 
-    return QString::fromStdString(oss.str());
+    return m_cachedSecondText + QString(".%1").arg(msecsSinceEpoch % 1000, 3, 10, QChar('0'));
 }
 
 QString Logger::levelToString(LogLevel level)
 {
+    return logLevelName(level);
+}
+
+const char* Logger::consoleColor(LogLevel level) const
+{
+    if (!m_colorSupported)
+        return "";
+
     switch (level)
     {
         case Debug:
-            return "DEBUG";
+            return "\033[36m";
         case Info:
-            return "INFO";
+            return "\033[32m";
         case Warning:
-            return "WARN";
+            return "\033[33m";
         case Error:
-            return "ERROR";
-        default:
-            return "UNKNOWN";
+            return "\033[31m";
     }
+    return "";
 }
 
-void Logger::setConsoleColor(LogLevel level)
+void Logger::writeRecords(const LogRecord* records, int count)
 {
-    if (!m_colorSupported)
+    QMutexLocker locker(&m_mutex);
+
+    // 二进制日志直接写格式串编号和参数，不需要格式化文本
+    if (m_binaryLog)
+    {
+        m_binaryLog->write(records, count);
+    }
+
+    bool toFile = m_fileEnabled && m_initialized && m_logStream;
+    if (!toFile && !m_consoleEnabled)
+    {
         return;
+    }
 
-    const char* colorCode = "";
-    switch (level)
+    std::string console;
+    for (int i = 0; i < count; ++i)
     {
-        case Debug:
-            colorCode = "\033[36m";
-            break;
-        case Info:
-            colorCode = "\033[32m";
-            break;
-        case Warning:
-            colorCode = "\033[33m";
-            break;
-        case Error:
-            colorCode = "\033[31m";
-            break;
+        const LogRecord& record = records[i];
+        QString timestamp = formatTimestamp(m_originEpochMs + record.monotonicNs / 1000000);
+        QString levelStr = levelToString(record.level);
+        QString message = logRecordMessage(record);
+
+        if (toFile)
+        {
+            *m_logStream << QString("[%1] [%2] %3").arg(timestamp, levelStr, message) << "\n";
+        }
+
+        if (m_consoleEnabled)
+        {
+            console += consoleColor(record.level);
+            console += "[" + timestamp.toStdString() + "] [" + levelStr.toStdString() + "] " + message.toStdString();
+            console += m_colorSupported ? "\033[0m\n" : "\n";
+        }
+    }
+
+    // 整批日志只刷新一次，避免逐行系统调用
+    if (toFile)
+    {
+        m_logStream->flush();
+    }
+    if (!console.empty())
+    {
+        std::cout.write(console.data(), static_cast<std::streamsize>(console.size()));
+        std::cout.flush();
     }
-    std::cout << colorCode;
 }
 
-void Logger::resetConsoleColor()
+void Logger::setAsyncEnabled(bool enabled, int queueCapacity)
 {
-    if (!m_colorSupported)
+    if (enabled)
+    {
+        if (m_writerThread)
+        {
+            return;
+        }
+
+        if (!m_queue)
+        {
+            m_queue.reset(new LogRingBuffer<LogRecord>(static_cast<std::size_t>(qMax(queueCapacity, 2))));
+        }
+        m_stopping.storeRelease(0);
+        m_writerThread = QThread::create([this]() { writerLoop(); });
+        m_writerThread->setObjectName("logger-writer");
+        m_writerThread->start();
+        m_async.storeRelease(1);
         return;
-    std::cout << "\033[0m";
+    }
+
+    if (!m_writerThread)
+    {
+        return;
+    }
+
+    m_async.storeRelease(0);
+    m_stopping.storeRelease(1);
+    m_wake.wakeAll();
+    m_writerThread->wait();
+    delete m_writerThread;
+    m_writerThread = nullptr;
+
+    // 后台线程退出前已写出缓冲区，这里再写出退出期间放入的日志
+    QMutexLocker drainLocker(&m_drainMutex);
+    drainQueue();
 }
 
-void Logger::printColoredLog(LogLevel level, const QString& message)
+void Logger::setOverflowPolicy(LogOverflowPolicy policy)
 {
-    setConsoleColor(level);
+    m_overflowPolicy.storeRelaxed(static_cast<int>(policy));
+}
 
-    QString levelStr = levelToString(level);
-    QString timestamp = getTimestamp();
+void Logger::flush()
+{
+    if (!isAsyncEnabled())
+    {
+        QMutexLocker locker(&m_mutex);
+        if (m_logStream)
+        {
+            m_logStream->flush();
+        }
+        std::cout.flush();
+        return;
+    }
 
-    std::cout << "[" << timestamp.toStdString() << "] "
-              << "[" << levelStr.toStdString() << "] " << message.toStdString();
+    quint64 target = m_queue->pushedCount();
+    QMutexLocker locker(&m_wakeMutex);
+    while (m_written < target && isAsyncEnabled())
+    {
+        m_wake.wakeOne();
+        m_flushed.wait(&m_wakeMutex, kWriterWakeIntervalMs);
+    }
+}
 
-    resetConsoleColor();
-    std::cout << std::endl;
+void Logger::installCrashHandler()
+{
+    std::signal(SIGSEGV, &Logger::crashSignalHandler);
+    std::signal(SIGABRT, &Logger::crashSignalHandler);
+    std::signal(SIGFPE, &Logger::crashSignalHandler);
+    std::signal(SIGILL, &Logger::crashSignalHandler);
+#ifdef SIGBUS
+    std::signal(SIGBUS, &Logger::crashSignalHandler);
+#endif
+}
 
-    std::cout.flush();
+void Logger::crashSignalHandler(int signal)
+{
+    // 写出过程不是异步信号安全的，进程已经处于崩溃状态，只求尽量保留最后的日志
+    Logger::instance().flushForCrash();
+    std::signal(signal, SIG_DFL);
+    std::raise(signal);
 }
 
-void Logger::log(LogLevel level, const QString& message)
+void Logger::flushForCrash()
 {
-    if (level < m_minLevel)
+    if (!m_queue || QThread::currentThread() == m_writerThread)
     {
         return;
     }
 
-    QMutexLocker locker(&m_mutex);
+    // 崩溃线程可能正是持有写出锁的线程，等待有上限
+    if (!m_drainMutex.tryLock(kCrashLockTimeoutMs))
+    {
+        return;
+    }
+    drainQueue();
+    m_drainMutex.unlock();
+}
+
+void Logger::enqueue(LogRecord& record)
+{
+    while (!m_queue->tryPush(record))
+    {
+        if (static_cast<LogOverflowPolicy>(m_overflowPolicy.loadRelaxed()) == LogOverflowPolicy::Drop)
+        {
+            m_dropped.fetchAndAddRelaxed(1);
+            return;
+        }
 
-    QString timestamp = getTimestamp();
-    QString levelStr = levelToString(level);
-    QString logMessage = QString("[%1] [%2] %3").arg(timestamp, levelStr, message);
+        if (!isAsyncEnabled())
+        {
+            writeRecords(&record, 1);
+            return;
+        }
+        m_wake.wakeOne();
+        QThread::yieldCurrentThread();
+    }
 
-    if (m_fileEnabled && m_initialized && m_logStream)
+    // 平时由后台线程定时取走，错误日志或缓冲区过半时立即唤醒
+    if (record.level >= Error || m_queue->sizeApprox() >= m_queue->capacity() / 2)
     {
-        *m_logStream << logMessage << "\n";
-        m_logStream->flush();
+        m_wake.wakeOne();
     }
+}
 
-    if (m_consoleEnabled)
+void Logger::writerLoop()
+{
+    while (true)
     {
-        printColoredLog(level, message);
+        bool stopping = m_stopping.loadAcquire() != 0;
+        {
+            QMutexLocker drainLocker(&m_drainMutex);
+            drainQueue();
+        }
+        if (stopping)
+        {
+            return;
+        }
+
+        QMutexLocker locker(&m_wakeMutex);
+        if (m_queue->sizeApprox() == 0 && !m_stopping.loadAcquire())
+        {
+            m_wake.wait(&m_wakeMutex, kWriterWakeIntervalMs);
+        }
     }
 }
 
+void Logger::drainQueue()
+{
+    QVector<LogRecord> batch;
+    batch.reserve(kMaxWriteBatch);
+
+    while (true)
+    {
+        LogRecord record;
+        while (batch.size() < kMaxWriteBatch && m_queue->tryPop(record))
+        {
+            batch.append(std::move(record));
+        }
+
+        quint64 dropped = m_dropped.loadRelaxed();
+        if (dropped != m_reportedDropped)
+        {
+            LogRecord notice;
+            notice.monotonicNs = m_clock.nsecsElapsed();
+            notice.threadId = currentLogThreadId();
+            notice.level = Warning;
+            notice.message = QString("日志缓冲区已满，累计丢弃 %1 条日志").arg(dropped);
+            batch.append(notice);
+            m_reportedDropped = dropped;
+        }
+
+        if (batch.isEmpty())
+        {
+            break;
+        }
+
+        writeRecords(batch.constData(), batch.size());
+        batch.clear();
+    }
+
+    QMutexLocker locker(&m_wakeMutex);
+    m_written = m_queue->poppedCount();
+    m_flushed.wakeAll();
+}
+
+void Logger::log(LogLevel level, const QString& message)
+{
+    if (!isEnabled(level))
+    {
+        return;
+    }
+
+    LogRecord record;
+    record.level = level;
+    record.message = message;
+    submit(record);
+}
+
+void Logger::submit(LogRecord& record)
+{
+    record.monotonicNs = m_clock.nsecsElapsed();
+    record.threadId = currentLogThreadId();
+
+    if (isAsyncEnabled())
+    {
+        enqueue(record);
+        return;
+    }
+
+    writeRecords(&record, 1);
+}
+
 void Logger::debug(const QString& message)
 {
     log(Debug, message);
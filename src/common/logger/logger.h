@@ -10,30 +10,43 @@
  * - 日志分级（Debug/Info/Warning/Error）
  * - 文件日志记录
  * - 线程安全
+ * - 异步模式：调用线程只把日志放入无锁环形缓冲区，由后台线程成批格式化和写入，
+ *   缓冲区满时按溢出策略等待或丢弃（丢弃数会被计数并写入日志）；崩溃时尽量写出缓冲区中的日志
+ * - 延迟格式化的日志宏（LOG_DEBUG 等）：先检查级别再求值参数，被过滤的日志不构造字符串；
+ *   低于编译期下限 CODEATLAS_LOG_FLOOR 的宏不生成任何运行时代码
+ * - 结构化二进制日志：日志宏只记录格式串和带类型的参数，文本在写出线程中才格式化；
+ *   二进制文件按大小轮转并压缩旧文件，用 logdecoder 工具离线解码为文本或JSON
  */
 
 #ifndef LOGGER_H
 #define LOGGER_H
 
+#include <QAtomicInteger>
 #include <QDateTime>
+#include <QElapsedTimer>
 #include <QFile>
 #include <QMutex>
 #include <QMutexLocker>
 #include <QString>
 #include <QTextStream>
+#include <QThread>
+#include <QVector>
+#include <QWaitCondition>
 #include <iostream>
+#include <memory>
 #include <sstream>
 #include <string>
+#include "common/logger/binarylog.h"
+#include "common/logger/logrecord.h"
+#include "common/logger/logringbuffer.h"
 
 /**
- * @brief 日志级别枚举
+ * @brief 异步日志缓冲区满时的处理策略
  */
-enum LogLevel
+enum class LogOverflowPolicy
 {
-    Debug,    ///< 调试信息 - 青色
-    Info,     ///< 一般信息 - 绿色
-    Warning,  ///< 警告信息 - 黄色
-    Error     ///< 错误信息 - 红色
+    Block,  ///< 调用线程等待后台线程腾出空间（不丢日志）
+    Drop    ///< 丢弃新日志并计数
 };
 
 /**
@@ -78,6 +91,59 @@ class Logger
      */
     void setMinLevel(LogLevel level);
 
+    /**
+     * @brief 开启或关闭异步模式（应在程序启动和退出时调用，关闭时会写出缓冲区中的所有日志）
+     * @param enabled 是否启用异步模式
+     * @param queueCapacity 缓冲区容量（条数，向上取整为2的幂，只在首次启用时生效）
+     */
+    void setAsyncEnabled(bool enabled, int queueCapacity = 8192);
+
+    /**
+     * @brief 检查是否处于异步模式
+     * @return 是否处于异步模式
+     */
+    bool isAsyncEnabled() const { return m_async.loadAcquire() != 0; }
+
+    /**
+     * @brief 设置异步缓冲区满时的处理策略
+     * @param policy 溢出策略，默认为 Block
+     */
+    void setOverflowPolicy(LogOverflowPolicy policy);
+
+    /**
+     * @brief 获取因缓冲区满而丢弃的日志数
+     * @return 丢弃数
+     */
+    quint64 droppedCount() const { return m_dropped.loadRelaxed(); }
+
+    /**
+     * @brief 开启结构化二进制日志（与文本日志文件相互独立，可同时开启）
+     * @param path 二进制日志文件路径
+     * @param options 轮转和压缩选项
+     * @return 是否成功打开
+     */
+    bool setBinaryLog(const QString& path, const BinaryLogOptions& options = BinaryLogOptions());
+
+    /**
+     * @brief 关闭结构化二进制日志
+     */
+    void closeBinaryLog();
+
+    /**
+     * @brief 等待此前记录的日志全部写出并刷新到文件和控制台
+     */
+    void flush();
+
+    /**
+     * @brief 安装崩溃信号处理函数（SIGSEGV、SIGABRT等），崩溃时先写出缓冲区中的日志再按默认方式终止
+     */
+    void installCrashHandler();
+
+    /**
+     * @brief 崩溃时写出缓冲区中的日志（尽力而为，获取不到写出锁时放弃）
+     */
+    void flushForCrash();
+
     /**
      * @brief 记录日志
      * @param level 日志级别
@@ -85,6 +151,29 @@ class Logger
      */
     void log(LogLevel level, const QString& message);
 
+    /**
+     * @brief 检查级别是否会被输出
+     * @param level 日志级别
+     * @return 是否会被输出
+     */
+    bool isEnabled(LogLevel level) const { return static_cast<int>(level) >= m_minLevel.loadRelaxed(); }
+
+    /**
+     * @brief 按格式串记录日志，参数依次替换 %1、%2 ...（由日志宏在级别检查之后调用）
+     * @param level 日志级别
+     * @param format 格式串（UTF-8字符串字面量，只保存地址，异步模式下在写出线程中才读取）
+     * @param args 参数（整数、枚举、浮点数和字符串，只做类型转换，不在调用线程格式化）
+     */
+    template <typename... Args>
+    void logf(LogLevel level, const char* format, const Args&... args)
+    {
+        LogRecord record;
+        record.level = level;
+        record.format = format;
+        (record.args.append(makeLogArg(args)), ...);
+        submit(record);
+    }
+
     /**
      * @brief 记录调试信息
      * @param message 日志消息
@@ -123,10 +212,17 @@ class Logger
     QString levelToString(LogLevel level);
 
     /**
-     * @brief 获取当前时间戳字符串
+     * @brief 记录时间戳和线程编号，然后放入缓冲区或直接写出
+     * @param record 日志（异步模式下被移走）
+     */
+    void submit(LogRecord& record);
+
+    /**
+     * @brief 格式化时间戳（同一秒内复用日期时间部分）
+     * @param msecsSinceEpoch 自1970年起的毫秒数
      * @return 格式化的时间戳字符串
      */
-    QString getTimestamp();
+    QString formatTimestamp(qint64 msecsSinceEpoch);
 
     /**
      * @brief 初始化控制台颜色支持
@@ -134,35 +230,128 @@ class Logger
     void initConsoleColor();
 
     /**
-     * @brief 设置控制台输出颜色
+     * @brief 获取控制台输出颜色的转义序列
      * @param level 日志级别，根据级别设置不同颜色
+     * @return 转义序列（不支持彩色输出时为空串）
      */
-    void setConsoleColor(LogLevel level);
+    const char* consoleColor(LogLevel level) const;
 
     /**
-     * @brief 重置控制台颜色为默认
+     * @brief 把一批日志写入文件、控制台和二进制日志，每批只刷新一次
+     * @param records 日志数组
+     * @param count 日志条数
      */
-    void resetConsoleColor();
+    void writeRecords(const LogRecord* records, int count);
 
     /**
-     * @brief 输出彩色日志到控制台
-     * @param level 日志级别
-     * @param message 格式化的日志消息
+     * @brief 异步模式下把日志放入缓冲区
+     * @param record 日志
      */
-    void printColoredLog(LogLevel level, const QString& message);
+    void enqueue(LogRecord& record);
 
-    QFile* m_logFile;          ///< 日志文件指针
-    QTextStream* m_logStream;  ///< 日志文件流
-    QMutex m_mutex;            ///< 互斥锁，保证线程安全
-    bool m_initialized;        ///< 初始化标志
-    bool m_consoleEnabled;     ///< 控制台输出开关
-    bool m_fileEnabled;        ///< 文件输出开关
-    LogLevel m_minLevel;       ///< 最低日志级别
-    bool m_colorSupported;     ///< 是否支持彩色输出
+    /**
+     * @brief 后台写出线程主循环
+     */
+    void writerLoop();
+
+    /**
+     * @brief 取出缓冲区中的所有日志并写出（调用方需持有 m_drainMutex）
+     */
+    void drainQueue();
+
+    /**
+     * @brief 崩溃信号处理函数
+     * @param signal 信号
+     */
+    static void crashSignalHandler(int signal);
+
+    QFile* m_logFile;            ///< 日志文件指针
+    QTextStream* m_logStream;    ///< 日志文件流
+    QMutex m_mutex;              ///< 互斥锁，保护文件和控制台输出
+    bool m_initialized;          ///< 初始化标志
+    bool m_consoleEnabled;       ///< 控制台输出开关
+    bool m_fileEnabled;          ///< 文件输出开关
+    QAtomicInt m_minLevel;       ///< 最低日志级别
+    bool m_colorSupported;       ///< 是否支持彩色输出
+    qint64 m_cachedSecond;       ///< 缓存的时间戳所在秒
+    QString m_cachedSecondText;  ///< 缓存的日期时间部分
+
+    QElapsedTimer m_clock;                         ///< 单调时钟，日志时间戳相对于它的起点
+    qint64 m_originEpochMs;                        ///< 单调时钟起点对应的墙钟时间（毫秒）
+    std::unique_ptr<BinaryLogWriter> m_binaryLog;  ///< 二进制日志（受 m_mutex 保护，未开启时为空）
+
+    std::unique_ptr<LogRingBuffer<LogRecord>> m_queue;  ///< 异步日志缓冲区
+    QThread* m_writerThread;                            ///< 后台写出线程
+    QAtomicInt m_async;                                 ///< 是否处于异步模式
+    QAtomicInt m_stopping;                              ///< 后台线程是否应退出
+    QAtomicInt m_overflowPolicy;                        ///< 溢出策略（LogOverflowPolicy）
+    QAtomicInteger<quint64> m_dropped;                  ///< 丢弃的日志数
+    quint64 m_reportedDropped;                          ///< 已写入日志的丢弃数（仅写出方使用）
+    quint64 m_written;                                  ///< 已写出的日志数（受 m_wakeMutex 保护）
+    QMutex m_drainMutex;                                ///< 写出锁，保证缓冲区只有一个消费者
+    QMutex m_wakeMutex;                                 ///< 唤醒条件的互斥锁
+    QWaitCondition m_wake;                              ///< 唤醒后台线程
+    QWaitCondition m_flushed;                           ///< 一批日志写出完成
 
 #ifdef Q_OS_WIN
     void* m_hConsole;  ///< Windows控制台句柄
 #endif
 };
 
+/**
+ * @brief 编译期日志级别下限（0=Debug 1=Info 2=Warning 3=Error），低于下限的日志宏编译为空语句
+ */
+#ifndef CODEATLAS_LOG_FLOOR
+#define CODEATLAS_LOG_FLOOR 0
+#endif
+
+/**
+ * @brief 先检查级别，通过后才求值参数并格式化
+ */
+#define CODEATLAS_LOG(level, ...)                               \
+    do                                                          \
+    {                                                           \
+        Logger& codeatlasLogger_ = Logger::instance();          \
+        if (codeatlasLogger_.isEnabled(level))                  \
+        {                                                       \
+            codeatlasLogger_.logf(level, __VA_ARGS__);          \
+        }                                                       \
+    } while (0)
+
+/**
+ * @brief 被编译期下限剔除的日志：参数仍参与类型检查，但不会被求值
+ */
+#define CODEATLAS_LOG_STRIPPED(level, ...)                      \
+    do                                                          \
+    {                                                           \
+        if (false)                                              \
+        {                                                       \
+            Logger::instance().logf(level, __VA_ARGS__);        \
+        }                                                       \
+    } while (0)
+
+#if CODEATLAS_LOG_FLOOR <= 0
+#define LOG_DEBUG(...) CODEATLAS_LOG(Debug, __VA_ARGS__)
+#else
+#define LOG_DEBUG(...) CODEATLAS_LOG_STRIPPED(Debug, __VA_ARGS__)
+#endif
+
+#if CODEATLAS_LOG_FLOOR <= 1
+#define LOG_INFO(...) CODEATLAS_LOG(Info, __VA_ARGS__)
+#else
+#define LOG_INFO(...) CODEATLAS_LOG_STRIPPED(Info, __VA_ARGS__)
+#endif
+
+#if CODEATLAS_LOG_FLOOR <= 2
+#define LOG_WARNING(...) CODEATLAS_LOG(Warning, __VA_ARGS__)
+#else
+#define LOG_WARNING(...) CODEATLAS_LOG_STRIPPED(Warning, __VA_ARGS__)
+#endif
+
+#if CODEATLAS_LOG_FLOOR <= 3
+#define LOG_ERROR(...) CODEATLAS_LOG(Error, __VA_ARGS__)
+#else
+#define LOG_ERROR(...) CODEATLAS_LOG_STRIPPED(Error, __VA_ARGS__)
+#endif
+
 #endif  // LOGGER_H
@@ -0,0 +1,114 @@
+/**
+ * @file logrecord.cpp
+ * @brief 日志记录辅助函数实现
+ * @author Developer
+ * @date 2026-10-18
+ * @version 1.0
+ */
+
+#include "common/logger/logrecord.h"
+#include <QAtomicInteger>
+#include <QCoreApplication>
+#include <QHash>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QThread>
+
+namespace
+{
+QAtomicInteger<quint32> g_nextThreadId(1);  ///< 下一个线程编号
+QMutex g_threadNamesMutex;                  ///< 保护线程名表
+QHash<quint32, QString> g_threadNames;      ///< 线程编号 -> 线程名
+}  // namespace
+
+const char* logLevelName(LogLevel level)
+{
+    switch (level)
+    {
+        case Debug:
+            return "DEBUG";
+        case Info:
+            return "INFO";
+        case Warning:
+            return "WARN";
+        case Error:
+            return "ERROR";
+        default:
+            return "UNKNOWN";
+    }
+}
+
+LogArg makeLogArg(const QString& value)
+{
+    LogArg arg;
+    arg.type = LogArg::Type::Text;
+    arg.text = value;
+    return arg;
+}
+
+LogArg makeLogArg(const char* value)
+{
+    return makeLogArg(QString::fromUtf8(value));
+}
+
+LogArg makeLogArg(const QByteArray& value)
+{
+    return makeLogArg(QString::fromUtf8(value));
+}
+
+QString formatLogMessage(const QString& format, const LogArg* args, int count)
+{
+    QString message = format;
+    for (int i = 0; i < count; ++i)
+    {
+        const LogArg& arg = args[i];
+        switch (arg.type)
+        {
+            case LogArg::Type::Integer:
+                message = message.arg(arg.integer);
+                break;
+            case LogArg::Type::Real:
+                message = message.arg(arg.real);
+                break;
+            case LogArg::Type::Text:
+                message = message.arg(arg.text);
+                break;
+        }
+    }
+    return message;
+}
+
+QString logRecordMessage(const LogRecord& record)
+{
+    if (!record.format)
+    {
+        return record.message;
+    }
+    return formatLogMessage(QString::fromUtf8(record.format), record.args.constData(), record.args.size());
+}
+
+quint32 currentLogThreadId()
+{
+    thread_local quint32 threadId = 0;
+    if (threadId == 0)
+    {
+        threadId = g_nextThreadId.fetchAndAddRelaxed(1);
+
+        QString name = QThread::currentThread()->objectName();
+        if (name.isEmpty() && QCoreApplication::instance() &&
+            QThread::currentThread() == QCoreApplication::instance()->thread())
+        {
+            name = "main";
+        }
+
+        QMutexLocker locker(&g_threadNamesMutex);
+        g_threadNames.insert(threadId, name);
+    }
+    return threadId;
+}
+
+QString logThreadName(quint32 threadId)
+{
+    QMutexLocker locker(&g_threadNamesMutex);
+    return g_threadNames.value(threadId);
+}
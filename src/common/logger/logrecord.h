@@ -0,0 +1,155 @@
+/**
+ * @file logrecord.h
+ * @brief 日志记录的数据结构：级别、带类型的参数和一条待写出的日志
+ * @author Developer
+ * @date 2026-10-18
+ * @version 1.0
+ *
+ * @details 日志宏记录的是格式串地址和带类型的参数，调用线程不做格式化：
+ * - 文本输出在写出时才把参数依次替换进格式串
+ * - 二进制日志只写格式串编号和参数本身，格式串在每个文件中只写一次
+ */
+
+#ifndef LOGRECORD_H
+#define LOGRECORD_H
+
+#include <QByteArray>
+#include <QString>
+#include <QVarLengthArray>
+#include <type_traits>
+
+/**
+ * @brief 日志级别枚举
+ */
+enum LogLevel
+{
+    Debug,    ///< 调试信息 - 青色
+    Info,     ///< 一般信息 - 绿色
+    Warning,  ///< 警告信息 - 黄色
+    Error     ///< 错误信息 - 红色
+};
+
+/**
+ * @brief 获取日志级别的名称
+ * @param level 日志级别
+ * @return 级别名称（DEBUG/INFO/WARN/ERROR）
+ */
+const char* logLevelName(LogLevel level);
+
+/**
+ * @brief 带类型的日志参数
+ */
+struct LogArg
+{
+    /**
+     * @brief 参数类型
+     */
+    enum class Type : quint8
+    {
+        Integer = 1,  ///< 有符号整数（布尔、枚举和无符号数也按此保存）
+        Real = 2,     ///< 浮点数
+        Text = 3      ///< 字符串
+    };
+
+    Type type;       ///< 参数类型
+    qint64 integer;  ///< 整数值
+    double real;     ///< 浮点值
+    QString text;    ///< 字符串值
+
+    LogArg() : type(Type::Integer), integer(0), real(0.0) {}
+};
+
+/**
+ * @brief 一条待写出的日志
+ */
+struct LogRecord
+{
+    qint64 monotonicNs;               ///< 单调时钟时间戳（相对于日志系统启动，纳秒）
+    LogLevel level;                   ///< 日志级别
+    quint32 threadId;                 ///< 记录日志的线程编号（进程内从1开始）
+    const char* format;               ///< 格式串（字符串字面量，为空时使用message）
+    QVarLengthArray<LogArg, 4> args;  ///< 格式串参数
+    QString message;                  ///< 未格式化的日志消息（format为空时有效）
+
+    LogRecord() : monotonicNs(0), level(Info), threadId(0), format(nullptr) {}
+};
+
+/**
+ * @brief 把整数参数转换为日志参数
+ * @param value 整数、布尔或枚举值
+ * @return 日志参数
+ */
+template <typename T, typename std::enable_if<std::is_integral<T>::value || std::is_enum<T>::value, int>::type = 0>
+LogArg makeLogArg(T value)
+{
+    LogArg arg;
+    arg.type = LogArg::Type::Integer;
+    arg.integer = static_cast<qint64>(value);
+    return arg;
+}
+
+/**
+ * @brief 把浮点参数转换为日志参数
+ * @param value 浮点值
+ * @return 日志参数
+ */
+template <typename T, typename std::enable_if<std::is_floating_point<T>::value, int>::type = 0>
+LogArg makeLogArg(T value)
+{
+    LogArg arg;
+    arg.type = LogArg::Type::Real;
+    arg.real = static_cast<double>(value);
+    return arg;
+}
+
+/**
+ * @brief 把字符串参数转换为日志参数
+ * @param value 字符串
+ * @return 日志参数
+ */
+LogArg makeLogArg(const QString& value);
+
+/**
+ * @brief 把C字符串参数（UTF-8）转换为日志参数
+ * @param value C字符串
+ * @return 日志参数
+ */
+LogArg makeLogArg(const char* value);
+
+/**
+ * @brief 把字节数组参数（UTF-8）转换为日志参数
+ * @param value 字节数组
+ * @return 日志参数
+ */
+LogArg makeLogArg(const QByteArray& value);
+
+/**
+ * @brief 把格式串和参数格式化为文本，参数依次替换 %1、%2 ...
+ * @param format 格式串
+ * @param args 参数数组
+ * @param count 参数个数
+ * @return 格式化后的文本
+ */
+QString formatLogMessage(const QString& format, const LogArg* args, int count);
+
+/**
+ * @brief 获取日志记录的文本消息
+ * @param record 日志记录
+ * @return 文本消息
+ */
+QString logRecordMessage(const LogRecord& record);
+
+/**
+ * @brief 获取当前线程的日志线程编号（首次调用时分配并登记线程名）
+ * @return 线程编号
+ */
+quint32 currentLogThreadId();
+
+/**
+ * @brief 获取日志线程编号对应的线程名
+ * @param threadId 线程编号
+ * @return 线程名（未命名的线程为空）
+ */
+QString logThreadName(quint32 threadId);
+
+#endif  // LOGRECORD_H
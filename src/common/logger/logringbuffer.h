@@ -0,0 +1,153 @@
+/**
+ * @file logringbuffer.h
+ * @brief 多生产者单消费者的无锁环形缓冲区，用于异步日志
+ * @author Developer
+ * @date 2026-10-18
+ * @version 1.0
+ *
+ * @details 每个槽位带一个序号，生产者用一次CAS占用写入位置，写完后发布序号：
+ * - 生产者之间只竞争写入位置，不持有任何锁，缓冲区满时立即返回失败，由调用方决定等待或丢弃
+ * - 只允许一个消费者，读取位置只由消费者修改，其他线程只读取它来估计元素数
+ * - 容量向上取整为2的幂，下标用位与计算
+ */
+
+#ifndef LOGRINGBUFFER_H
+#define LOGRINGBUFFER_H
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+/**
+ * @brief 多生产者单消费者无锁环形缓冲区
+ * @tparam T 元素类型（需可默认构造和移动）
+ */
+template <typename T>
+class LogRingBuffer
+{
+   public:
+    /**
+     * @brief 构造函数
+     * @param capacity 最小容量（向上取整为2的幂，至少为2）
+     */
+    explicit LogRingBuffer(std::size_t capacity)
+    {
+        std::size_t size = 2;
+        while (size < capacity)
+        {
+            size <<= 1;
+        }
+        m_mask = size - 1;
+        m_cells.reset(new Cell[size]);
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            m_cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+        m_enqueuePos.store(0, std::memory_order_relaxed);
+        m_dequeuePos.store(0, std::memory_order_relaxed);
+    }
+
+    LogRingBuffer(const LogRingBuffer&) = delete;
+    LogRingBuffer& operator=(const LogRingBuffer&) = delete;
+
+    /**
+     * @brief 写入一个元素（可在任意线程并发调用）
+     * @param value 元素，成功时被移走，失败时保持不变
+     * @return 是否成功（缓冲区满时返回false）
+     */
+    bool tryPush(T& value)
+    {
+        Cell* cell = nullptr;
+        std::size_t pos = m_enqueuePos.load(std::memory_order_relaxed);
+        while (true)
+        {
+            cell = &m_cells[pos & m_mask];
+            std::size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            std::ptrdiff_t diff = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(pos);
+            if (diff == 0)
+            {
+                if (m_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                {
+                    break;
+                }
+            }
+            else if (diff < 0)
+            {
+                // 槽位还没有被消费者释放，缓冲区已满
+                return false;
+            }
+            else
+            {
+                pos = m_enqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+
+        cell->value = std::move(value);
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief 取出一个元素（只能由唯一的消费者调用）
+     * @param value 输出参数，取出的元素
+     * @return 是否成功（缓冲区为空或下一个槽位尚未写完时返回false）
+     */
+    bool tryPop(T& value)
+    {
+        std::size_t pos = m_dequeuePos.load(std::memory_order_relaxed);
+        Cell& cell = m_cells[pos & m_mask];
+        std::size_t sequence = cell.sequence.load(std::memory_order_acquire);
+        if (static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(pos + 1) < 0)
+        {
+            return false;
+        }
+
+        value = std::move(cell.value);
+        cell.value = T();
+        cell.sequence.store(pos + m_mask + 1, std::memory_order_release);
+        m_dequeuePos.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief 获取容量
+     * @return 容量
+     */
+    std::size_t capacity() const { return m_mask + 1; }
+
+    /**
+     * @brief 获取已占用的写入位置总数（含尚未写完的元素）
+     * @return 写入总数
+     */
+    std::size_t pushedCount() const { return m_enqueuePos.load(std::memory_order_acquire); }
+
+    /**
+     * @brief 获取近似的元素数（消费者以外的线程调用时只是估计值）
+     * @return 元素数
+     */
+    std::size_t sizeApprox() const { return pushedCount() - poppedCount(); }
+
+    /**
+     * @brief 获取已取出的元素总数
+     * @return 取出总数
+     */
+    std::size_t poppedCount() const { return m_dequeuePos.load(std::memory_order_acquire); }
+
+   private:
+    /**
+     * @brief 槽位
+     */
+    struct Cell
+    {
+        std::atomic<std::size_t> sequence;  ///< 序号，等于写入位置时可写，等于写入位置+1时可读
+        T value;                            ///< 元素
+    };
+
+    std::unique_ptr<Cell[]> m_cells;                    ///< 槽位数组
+    std::size_t m_mask;                                 ///< 下标掩码（容量-1）
+    alignas(64) std::atomic<std::size_t> m_enqueuePos;  ///< 下一个写入位置（生产者共享）
+    alignas(64) std::atomic<std::size_t> m_dequeuePos;  ///< 下一个读取位置（仅消费者修改）
+};
+
+#endif  // LOGRINGBUFFER_H
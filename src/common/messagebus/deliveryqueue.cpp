@@ -0,0 +1,59 @@
+/**
+ * @file deliveryqueue.cpp
+ * @brief 消息总线异步发布的按线程投递队列实现
+ * @author Developer
+ * @date 2026-10-18
+ * @version 1.0
+ */
+
+#include "common/messagebus/deliveryqueue.h"
+#include <QMutexLocker>
+#include "common/messagebus/messagebus.h"
+
+DeliveryQueue::DeliveryQueue() : QObject(nullptr), m_drainScheduled(false) {}
+
+void DeliveryQueue::enqueue(const Message& message, bool coalesce)
+{
+    bool schedule = false;
+    {
+        QMutexLocker locker(&m_mutex);
+        if (coalesce)
+        {
+            int type = static_cast<int>(message.type);
+            auto it = m_coalescedIndex.constFind(type);
+            if (it != m_coalescedIndex.constEnd())
+            {
+                // 旧消息尚未分发，用最新的值替换，分发事件已经投递过
+                m_pending[it.value()] = message;
+                return;
+            }
+            m_coalescedIndex.insert(type, m_pending.size());
+        }
+        m_pending.append(message);
+        schedule = !m_drainScheduled;
+        m_drainScheduled = true;
+    }
+
+    // 每个分发周期只投递一个事件，之后追加的消息由同一次 drain 处理
+    if (schedule)
+    {
+        QMetaObject::invokeMethod(this, &DeliveryQueue::drain, Qt::QueuedConnection);
+    }
+}
+
+void DeliveryQueue::drain()
+{
+    QVector<Message> batch;
+    {
+        QMutexLocker locker(&m_mutex);
+        batch.swap(m_pending);
+        m_coalescedIndex.clear();
+        m_drainScheduled = false;
+    }
+
+    MessageBus& bus = MessageBus::instance();
+    for (const Message& message : batch)
+    {
+        bus.deliverQueued(message, this);
+    }
+}
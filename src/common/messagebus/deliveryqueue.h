@@ -0,0 +1,55 @@
+/**
+ * @file deliveryqueue.h
+ * @brief 消息总线异步发布的按线程投递队列
+ * @author Developer
+ * @date 2026-10-18
+ * @version 1.0
+ *
+ * @details 每个有订阅者的线程对应一个投递队列，队列对象属于该线程：
+ * - 异步发布的消息追加到接收者所在线程的队列中，队列由空变为非空时才向该线程投递一个事件
+ * - 事件处理时一次取出队列中的全部消息，在该线程上依次分发给属于该线程的订阅者
+ * - 合并类型的消息在队列中只保留最新的一条，新消息替换尚未分发的旧消息（位置不变）
+ */
+
+#ifndef DELIVERYQUEUE_H
+#define DELIVERYQUEUE_H
+
+#include <QHash>
+#include <QMutex>
+#include <QObject>
+#include <QVector>
+#include "common/messagebus/messagetypes.h"
+
+/**
+ * @brief 按线程投递队列
+ */
+class DeliveryQueue : public QObject
+{
+    Q_OBJECT
+
+   public:
+    /**
+     * @brief 构造函数（队列随后移动到其服务的线程）
+     */
+    DeliveryQueue();
+
+    /**
+     * @brief 追加一条待分发的消息（可在任意线程调用）
+     * @param message 消息对象
+     * @param coalesce 是否与队列中同类型的消息合并（只保留最新的一条）
+     */
+    void enqueue(const Message& message, bool coalesce);
+
+   private:
+    /**
+     * @brief 取出全部待分发的消息并在当前线程分发（在队列所属线程调用）
+     */
+    void drain();
+
+    QMutex m_mutex;                    ///< 保护待分发队列
+    QVector<Message> m_pending;        ///< 待分发的消息，按发布顺序排列
+    QHash<int, int> m_coalescedIndex;  ///< 合并类型 -> 该类型消息在 m_pending 中的位置
+    bool m_drainScheduled;             ///< 是否已投递分发事件且尚未处理
+};
+
+#endif  // DELIVERYQUEUE_H
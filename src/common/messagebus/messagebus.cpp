@@ -9,9 +9,11 @@
 #include "messagebus.h"
 #include <QCoreApplication>
 #include <QMutexLocker>
-#include <QRandomGenerator>
+#include <QDeadlineTimer>
 #include <QThread>
+#include <QVarLengthArray>
 #include <QWaitCondition>
+#include <algorithm>
 #include "common/logger/logger.h"
 
 MessageBus& MessageBus::instance()
@@ -20,63 +22,98 @@ MessageBus& MessageBus::instance()
     return instance;
 }
 
-MessageBus::MessageBus() : QObject(nullptr), m_nextSubscriptionId(1), m_enabled(true)
+MessageBus::MessageBus()
+    : QObject(nullptr), m_nextSubscriptionId(1), m_enabled(true), m_requestTimer(new QTimer(this)), m_nextRequestId(1)
 {
     qRegisterMetaType<Message>("Message");
     qRegisterMetaType<MessageType>("MessageType");
     qRegisterMetaType<MessagePriority>("MessagePriority");
 
-    connect(
-        this, &MessageBus::messagePublished, this, [this](const Message& message) { dispatchMessage(message); },
-        Qt::QueuedConnection);
+    m_requestClock.start();
+    m_requestTimer->setSingleShot(true);
+    connect(m_requestTimer, &QTimer::timeout, this, [this]() { expireRequests(); });
 
-    Logger::instance().debug("消息总线初始化完成");
+    LOG_DEBUG("消息总线初始化完成");
 }
 
 MessageBus::~MessageBus()
 {
+    QList<PendingRequest> pending;
+    {
+        QMutexLocker requestLocker(&m_requestMutex);
+        pending = m_pendingRequests.values();
+        m_pendingRequests.clear();
+        m_requestDeadlines.clear();
+    }
+    for (PendingRequest& request : pending)
+    {
+        completeRequest(request, nullptr);
+    }
+
     QMutexLocker locker(&m_mutex);
     m_subscribers.clear();
     m_subscriptionTypes.clear();
+    m_channelSubscriptions.clear();
     m_receiverSubscriptions.clear();
-    Logger::instance().debug("消息总线销毁");
+    LOG_DEBUG("消息总线销毁");
 }
 
 int MessageBus::subscribe(MessageType type, QObject* receiver, MessageHandler handler, int priority)
 {
     if (!receiver || !handler)
     {
-        Logger::instance().warning("订阅失败：接收者或处理函数无效");
+        LOG_WARNING("订阅失败：接收者或处理函数无效");
         return -1;
     }
 
     QMutexLocker locker(&m_mutex);
 
+    if (SubscriberTable::slotOf(type) < 0)
+    {
+        LOG_WARNING("订阅失败：消息类型 %1 超出分发表范围", static_cast<int>(type));
+        return -1;
+    }
+
     int subscriptionId = generateSubscriptionId();
+    SubscriberInfo info(subscriptionId, receiver, handler, priority);
+    info.queue = deliveryQueueFor(receiver->thread());
+    int count = insertSubscriber(SubscriberTable::slotOf(type), info);
+    m_subscriptionTypes[subscriptionId] = type;
+    trackReceiver(receiver, subscriptionId);
 
-    SubscriberInfo info(receiver, handler, priority);
+    LOG_DEBUG("订阅消息成功 - 类型: %1, 订阅ID: %2, 接收者: %3", static_cast<int>(type), subscriptionId,
+              receiver->metaObject() ? receiver->metaObject()->className() : "Unknown");
 
-    QList<SubscriberInfo>& subscribers = m_subscribers[type];
-    subscribers.append(info);
-    std::sort(subscribers.begin(), subscribers.end(),
-              [](const SubscriberInfo& a, const SubscriberInfo& b) { return a.priority > b.priority; });
+    emit subscriberCountChanged(type, count);
 
-    m_subscriptionTypes[subscriptionId] = type;
-    m_receiverSubscriptions[receiver].insert(subscriptionId);
+    return subscriptionId;
+}
 
-    if (receiver != this)
+int MessageBus::subscribeChannel(int channelId, QObject* receiver, std::function<void(const void*)> handler,
+                                 int priority)
+{
+    if (!receiver)
     {
-        connect(
-            receiver, &QObject::destroyed, this, [this, receiver]() { unsubscribeAll(receiver); },
-            Qt::DirectConnection);
+        LOG_WARNING("订阅失败：接收者无效");
+        return -1;
     }
 
-    Logger::instance().debug(QString("订阅消息成功 - 类型: %1, 订阅ID: %2, 接收者: %3")
-                                 .arg(static_cast<int>(type))
-                                 .arg(subscriptionId)
-                                 .arg(receiver->metaObject() ? receiver->metaObject()->className() : "Unknown"));
+    int slot = SubscriberTable::channelSlot(channelId);
+    if (slot < 0)
+    {
+        LOG_WARNING("订阅失败：类型化通道 %1 超出分发表预留范围", channelId);
+        return -1;
+    }
+
+    QMutexLocker locker(&m_mutex);
+
+    int subscriptionId = generateSubscriptionId();
+    insertSubscriber(slot, SubscriberInfo(subscriptionId, receiver, std::move(handler), priority));
+    m_channelSubscriptions[subscriptionId] = slot;
+    trackReceiver(receiver, subscriptionId);
 
-    emit subscriberCountChanged(type, subscribers.size());
+    LOG_DEBUG("订阅类型化通道成功 - 通道: %1, 订阅ID: %2, 接收者: %3", channelId, subscriptionId,
+              receiver->metaObject() ? receiver->metaObject()->className() : "Unknown");
 
     return subscriptionId;
 }
@@ -96,37 +133,53 @@ bool MessageBus::unsubscribe(int subscriptionId)
 {
     QMutexLocker locker(&m_mutex);
 
-    if (!m_subscriptionTypes.contains(subscriptionId))
+    bool isChannel = m_channelSubscriptions.contains(subscriptionId);
+    if (!isChannel && !m_subscriptionTypes.contains(subscriptionId))
     {
-        Logger::instance().warning(QString("取消订阅失败：未找到订阅ID %1").arg(subscriptionId));
+        LOG_WARNING("取消订阅失败：未找到订阅ID %1", subscriptionId);
         return false;
     }
 
-    MessageType type = m_subscriptionTypes[subscriptionId];
-    m_subscriptionTypes.remove(subscriptionId);
+    MessageType type = MessageType::None;
+    int slot = -1;
+    if (isChannel)
+    {
+        slot = m_channelSubscriptions.take(subscriptionId);
+    }
+    else
+    {
+        type = m_subscriptionTypes.take(subscriptionId);
+        slot = SubscriberTable::slotOf(type);
+    }
 
-    for (auto it = m_receiverSubscriptions.begin(); it != m_receiverSubscriptions.end(); ++it)
+    QObject* receiver = nullptr;
+    int remaining = removeSubscribers(slot,
+                                      [subscriptionId, &receiver](const SubscriberInfo& info)
+                                      {
+                                          if (info.subscriptionId != subscriptionId)
+                                          {
+                                              return false;
+                                          }
+                                          receiver = info.receiver;
+                                          return true;
+                                      });
+
+    auto it = m_receiverSubscriptions.find(receiver);
+    if (it != m_receiverSubscriptions.end())
     {
         it.value().remove(subscriptionId);
         if (it.value().isEmpty())
         {
             m_receiverSubscriptions.erase(it);
-            break;
         }
     }
 
-    QList<SubscriberInfo>& subscribers = m_subscribers[type];
-    for (int i = subscribers.size() - 1; i >= 0; --i)
+    LOG_DEBUG("取消订阅成功 - 订阅ID: %1", subscriptionId);
+    if (!isChannel)
     {
-        if (subscribers[i].receiver == nullptr)
-        {
-            subscribers.removeAt(i);
-        }
+        emit subscriberCountChanged(type, remaining);
     }
 
-    Logger::instance().debug(QString("取消订阅成功 - 订阅ID: %1").arg(subscriptionId));
-    emit subscriberCountChanged(type, subscribers.size());
-
     return true;
 }
 
@@ -142,37 +195,57 @@ void MessageBus::unsubscribeAll(QObject* receiver)
         return;
     }
 
-    QSet<int> subscriptionIds = m_receiverSubscriptions[receiver];
-    m_receiverSubscriptions.remove(receiver);
+    QSet<int> subscriptionIds = m_receiverSubscriptions.take(receiver);
 
+    QList<MessageType> types;
     for (int subscriptionId : subscriptionIds)
     {
-        if (m_subscriptionTypes.contains(subscriptionId))
+        auto it = m_subscriptionTypes.find(subscriptionId);
+        if (it == m_subscriptionTypes.end())
         {
-            MessageType type = m_subscriptionTypes[subscriptionId];
-            m_subscriptionTypes.remove(subscriptionId);
-
-            QList<SubscriberInfo>& subscribers = m_subscribers[type];
-            for (int i = subscribers.size() - 1; i >= 0; --i)
-            {
-                if (subscribers[i].receiver == receiver)
-                {
-                    subscribers.removeAt(i);
-                }
-            }
+            continue;
+        }
+        if (!types.contains(it.value()))
+        {
+            types.append(it.value());
+        }
+        m_subscriptionTypes.erase(it);
+    }
 
-            emit subscriberCountChanged(type, subscribers.size());
+    QList<int> channelSlots;
+    for (int subscriptionId : subscriptionIds)
+    {
+        auto it = m_channelSubscriptions.find(subscriptionId);
+        if (it == m_channelSubscriptions.end())
+        {
+            continue;
+        }
+        if (!channelSlots.contains(it.value()))
+        {
+            channelSlots.append(it.value());
         }
+        m_channelSubscriptions.erase(it);
+    }
+
+    // 每个消息类型和通道只替换一次快照
+    auto isReceiver = [receiver](const SubscriberInfo& info) { return info.receiver == receiver; };
+    for (MessageType type : types)
+    {
+        int remaining = removeSubscribers(SubscriberTable::slotOf(type), isReceiver);
+        emit subscriberCountChanged(type, remaining);
+    }
+    for (int slot : channelSlots)
+    {
+        removeSubscribers(slot, isReceiver);
     }
 
-    Logger::instance().debug(QString("取消所有订阅 - 接收者: %1, 数量: %2")
-                                 .arg(receiver->metaObject() ? receiver->metaObject()->className() : "Unknown")
-                                 .arg(subscriptionIds.size()));
+    LOG_DEBUG("取消所有订阅 - 接收者: %1, 数量: %2",
+              receiver->metaObject() ? receiver->metaObject()->className() : "Unknown", subscriptionIds.size());
 }
 
 void MessageBus::publish(MessageType type, const QVariant& data, const QString& sender, MessagePriority priority)
 {
-    if (!m_enabled)
+    if (!m_enabled.load(std::memory_order_relaxed))
     {
         return;
     }
@@ -180,14 +253,14 @@ void MessageBus::publish(MessageType type, const QVariant& data, const QString&
     Message message(type, data, sender);
     message.priority = priority;
 
-    Logger::instance().debug(QString("发布消息(同步) - 类型: %1, 发送者: %2").arg(static_cast<int>(type)).arg(sender));
+    LOG_DEBUG("发布消息(同步) - 类型: %1, 发送者: %2", static_cast<int>(type), sender);
 
     dispatchMessage(message);
 }
 
 void MessageBus::publishAsync(MessageType type, const QVariant& data, const QString& sender, MessagePriority priority)
 {
-    if (!m_enabled)
+    if (!m_enabled.load(std::memory_order_relaxed))
     {
         return;
     }
@@ -195,14 +268,45 @@ void MessageBus::publishAsync(MessageType type, const QVariant& data, const QStr
     Message message(type, data, sender);
     message.priority = priority;
 
-    Logger::instance().debug(QString("发布消息(异步) - 类型: %1, 发送者: %2").arg(static_cast<int>(type)).arg(sender));
+    LOG_DEBUG("发布消息(异步) - 类型: %1, 发送者: %2", static_cast<int>(type), sender);
+
+    int slot = SubscriberTable::slotOf(type);
+    bool coalesce = m_subscribers.isCoalesced(slot);
+    {
+        // 每个线程的队列只追加一次，队列由空变为非空时才向该线程投递事件
+        SubscriberTable::ReadGuard guard(m_subscribers);
+        const SubscriberList* subscribers = m_subscribers.snapshot(slot);
+        if (subscribers)
+        {
+            QVarLengthArray<DeliveryQueue*, 4> queued;
+            for (const SubscriberInfo& info : *subscribers)
+            {
+                DeliveryQueue* queue = info.queue.get();
+                if (queue && !queued.contains(queue))
+                {
+                    queued.append(queue);
+                    queue->enqueue(message, coalesce);
+                }
+            }
+        }
+    }
 
     emit messagePublished(message);
 }
 
+void MessageBus::setCoalescing(MessageType type, bool coalesce)
+{
+    m_subscribers.setCoalesced(SubscriberTable::slotOf(type), coalesce);
+}
+
+bool MessageBus::isCoalescing(MessageType type) const
+{
+    return m_subscribers.isCoalesced(SubscriberTable::slotOf(type));
+}
+
 void MessageBus::publishMessage(const Message& message)
 {
-    if (!m_enabled)
+    if (!m_enabled.load(std::memory_order_relaxed))
     {
         return;
     }
@@ -213,57 +317,72 @@ void MessageBus::publishMessage(const Message& message)
 Message MessageBus::sendRequest(MessageType type, const QVariant& data, const QString& sender, int timeout)
 {
     Message request(type, data, sender);
-    request.timestamp = QDateTime::currentDateTime();
-
-    QMutex waitMutex;
-    QWaitCondition waitCondition;
-    Message response;
-    bool responseReceived = false;
+    request.correlationId = QString("req_%1").arg(m_nextRequestId.fetch_add(1, std::memory_order_relaxed));
 
-    QString correlationId =
-        QString("req_%1_%2").arg(QDateTime::currentMSecsSinceEpoch()).arg(QRandomGenerator::global()->bounded(1000000));
-    request.correlationId = correlationId;
+    // 同步等待自己计时，不依赖总线线程的定时器（调用线程可能正是总线所在线程）
+    QFuture<Message> future = registerRequest(request.correlationId, -1);
+    dispatchMessage(request);
 
-    int subscriptionId = subscribe(
-        type, this,
-        [&](const Message& msg)
+    QDeadlineTimer deadline = timeout < 0 ? QDeadlineTimer(QDeadlineTimer::Forever) : QDeadlineTimer(timeout);
+    PendingRequest expired;
+    bool timedOut = false;
+    {
+        QMutexLocker locker(&m_requestMutex);
+        while (!future.isFinished())
         {
-            if (msg.correlationId == correlationId)
+            if (!m_requestFinished.wait(&m_requestMutex, deadline))
             {
-                QMutexLocker locker(&waitMutex);
-                response = msg;
-                responseReceived = true;
-                waitCondition.wakeAll();
+                break;
             }
-        },
-        1000);
+        }
+        timedOut = !future.isFinished() && takeRequest(request.correlationId, expired);
+    }
+
+    if (timedOut)
+    {
+        completeRequest(expired, nullptr);
+        LOG_WARNING("请求超时 - 类型: %1, 关联ID: %2", static_cast<int>(type), request.correlationId);
+        return Message();
+    }
+
+    // 响应方已经取走请求，稍后即会完成
+    future.waitForFinished();
+    return future.isCanceled() ? Message() : future.result();
+}
+
+QFuture<Message> MessageBus::requestAsync(MessageType type, const QVariant& data, const QString& sender, int timeout)
+{
+    Message request(type, data, sender);
+    request.correlationId = QString("req_%1").arg(m_nextRequestId.fetch_add(1, std::memory_order_relaxed));
 
+    // 先登记再分发，处理函数中直接响应时请求已在表中
+    QFuture<Message> future = registerRequest(request.correlationId, timeout);
     dispatchMessage(request);
+    return future;
+}
 
+bool MessageBus::respond(const Message& request, const QVariant& data, const QString& sender)
+{
+    if (request.correlationId.isEmpty())
     {
-        QMutexLocker locker(&waitMutex);
-        if (!responseReceived)
-        {
-            if (timeout < 0)
-            {
-                waitCondition.wait(&waitMutex);
-            }
-            else
-            {
-                waitCondition.wait(&waitMutex, timeout);
-            }
-        }
+        LOG_WARNING("响应失败：请求没有关联ID - 类型: %1", static_cast<int>(request.type));
+        return false;
     }
 
-    unsubscribe(subscriptionId);
+    Message response(request.type, data, sender);
+    response.correlationId = request.correlationId;
 
-    if (!responseReceived)
+    PendingRequest pending;
     {
-        Logger::instance().warning(
-            QString("请求超时 - 类型: %1, 关联ID: %2").arg(static_cast<int>(type)).arg(correlationId));
+        QMutexLocker locker(&m_requestMutex);
+        if (!takeRequest(request.correlationId, pending))
+        {
+            return false;
+        }
     }
 
-    return response;
+    completeRequest(pending, &response);
+    return true;
 }
 
 int MessageBus::registerResponseHandler(MessageType type, QObject* receiver, MessageHandler handler)
@@ -273,8 +392,9 @@ int MessageBus::registerResponseHandler(MessageType type, QObject* receiver, Mes
 
 int MessageBus::subscriberCount(MessageType type) const
 {
-    QMutexLocker locker(&m_mutex);
-    return m_subscribers.value(type).size();
+    SubscriberTable::ReadGuard guard(m_subscribers);
+    const SubscriberList* subscribers = m_subscribers.snapshot(SubscriberTable::slotOf(type));
+    return subscribers ? subscribers->size() : 0;
 }
 
 void MessageBus::cleanup()
@@ -284,78 +404,313 @@ void MessageBus::cleanup()
 
 void MessageBus::setEnabled(bool enabled)
 {
-    m_enabled = enabled;
-    Logger::instance().info(QString("消息总线%1").arg(enabled ? "已启用" : "已禁用"));
+    m_enabled.store(enabled, std::memory_order_relaxed);
+    LOG_INFO("消息总线%1", enabled ? "已启用" : "已禁用");
 }
 
 bool MessageBus::isEnabled() const
 {
-    return m_enabled;
+    return m_enabled.load(std::memory_order_relaxed);
 }
 
 void MessageBus::dispatchMessage(const Message& message)
 {
-    QMutexLocker locker(&m_mutex);
+    // 快照发布后不再修改，处理函数中取消订阅只会替换快照，不影响本次遍历
+    SubscriberTable::ReadGuard guard(m_subscribers);
+    const SubscriberList* subscribers = m_subscribers.snapshot(SubscriberTable::slotOf(message.type));
+    if (!subscribers)
+    {
+        LOG_DEBUG("消息无订阅者 - 类型: %1", static_cast<int>(message.type));
+        return;
+    }
 
-    if (!m_subscribers.contains(message.type))
+    for (const SubscriberInfo& info : *subscribers)
+    {
+        invokeHandler(info, message);
+    }
+}
+
+void MessageBus::deliverQueued(const Message& message, const DeliveryQueue* queue)
+{
+    // 分发时读取当前快照，排队期间取消的订阅（包括已销毁的接收者）不会再收到消息
+    SubscriberTable::ReadGuard guard(m_subscribers);
+    const SubscriberList* subscribers = m_subscribers.snapshot(SubscriberTable::slotOf(message.type));
+    if (!subscribers)
     {
-        Logger::instance().debug(QString("消息无订阅者 - 类型: %1").arg(static_cast<int>(message.type)));
         return;
     }
 
-    QList<SubscriberInfo> subscribers = m_subscribers[message.type];
+    for (const SubscriberInfo& info : *subscribers)
+    {
+        if (info.queue.get() == queue)
+        {
+            invokeHandler(info, message);
+        }
+    }
+}
+
+void MessageBus::invokeHandler(const SubscriberInfo& info, const Message& message)
+{
+    try
+    {
+        info.handler(message);
+    }
+    catch (const std::exception& e)
+    {
+        LOG_ERROR("消息处理异常 - 类型: %1, 错误: %2", static_cast<int>(message.type), e.what());
+    }
+    catch (...)
+    {
+        LOG_ERROR("消息处理未知异常 - 类型: %1", static_cast<int>(message.type));
+    }
+}
+
+std::shared_ptr<DeliveryQueue> MessageBus::deliveryQueueFor(QThread* thread)
+{
+    if (!thread)
+    {
+        thread = this->thread();
+    }
+
+    std::shared_ptr<DeliveryQueue> queue = m_deliveryQueues.value(thread).lock();
+    if (queue)
+    {
+        return queue;
+    }
+
+    // 队列可能在其他线程上释放，用 deleteLater 交给所属线程销毁，已投递的分发事件先于销毁处理
+    DeliveryQueue* created = new DeliveryQueue();
+    created->moveToThread(thread);
+    queue.reset(created, [](DeliveryQueue* expired) { expired->deleteLater(); });
+    m_deliveryQueues.insert(thread, queue);
+    LOG_DEBUG("创建投递队列 - 线程: %1", QString::number(reinterpret_cast<quintptr>(thread), 16));
+    return queue;
+}
+
+void MessageBus::cleanupInvalidSubscribers()
+{
+    QMutexLocker locker(&m_mutex);
+
+    QList<int> affectedSlots;
+    for (MessageType type : m_subscriptionTypes)
+    {
+        int slot = SubscriberTable::slotOf(type);
+        if (!affectedSlots.contains(slot))
+        {
+            affectedSlots.append(slot);
+        }
+    }
+    for (int slot : m_channelSubscriptions)
+    {
+        if (!affectedSlots.contains(slot))
+        {
+            affectedSlots.append(slot);
+        }
+    }
+
+    for (int slot : affectedSlots)
+    {
+        removeSubscribers(slot, [](const SubscriberInfo& info) { return info.receiver == nullptr; });
+    }
+
+    LOG_DEBUG("清理无效订阅者完成");
+}
+
+int MessageBus::insertSubscriber(int slot, const SubscriberInfo& info)
+{
+    // 复制当前快照，按优先级插入到同优先级订阅的末尾，保持先订阅先处理
+    SubscriberList subscribers;
+    if (const SubscriberList* current = m_subscribers.snapshot(slot))
+    {
+        subscribers = *current;
+    }
+    auto position = std::upper_bound(subscribers.begin(), subscribers.end(), info.priority,
+                                     [](int prio, const SubscriberInfo& other) { return prio > other.priority; });
+    subscribers.insert(position, info);
+    m_subscribers.replace(slot, subscribers);
+    return subscribers.size();
+}
+
+void MessageBus::trackReceiver(QObject* receiver, int subscriptionId)
+{
+    bool newReceiver = !m_receiverSubscriptions.contains(receiver);
+    m_receiverSubscriptions[receiver].insert(subscriptionId);
+
+    if (newReceiver && receiver != this)
+    {
+        connect(
+            receiver, &QObject::destroyed, this, [this, receiver]() { unsubscribeAll(receiver); },
+            Qt::DirectConnection);
+    }
+}
+
+int MessageBus::removeSubscribers(int slot, const std::function<bool(const SubscriberInfo&)>& shouldRemove)
+{
+    const SubscriberList* current = m_subscribers.snapshot(slot);
+    if (!current)
+    {
+        return 0;
+    }
 
-    QList<SubscriberInfo> validSubscribers;
-    for (const SubscriberInfo& info : subscribers)
+    SubscriberList subscribers;
+    subscribers.reserve(current->size());
+    for (const SubscriberInfo& info : *current)
     {
-        if (info.receiver != nullptr)
+        if (!shouldRemove(info))
         {
-            validSubscribers.append(info);
+            subscribers.append(info);
         }
     }
 
-    if (validSubscribers.size() != subscribers.size())
+    if (subscribers.size() != current->size())
     {
-        m_subscribers[message.type] = validSubscribers;
+        m_subscribers.replace(slot, subscribers);
     }
+    return subscribers.size();
+}
 
-    locker.unlock();
+void MessageBus::dispatchPayload(int slot, const void* payload)
+{
+    SubscriberTable::ReadGuard guard(m_subscribers);
+    const SubscriberList* subscribers = m_subscribers.snapshot(slot);
+    if (!subscribers)
+    {
+        return;
+    }
 
-    for (const SubscriberInfo& info : validSubscribers)
+    for (const SubscriberInfo& info : *subscribers)
     {
         try
         {
-            info.handler(message);
+            info.payloadHandler(payload);
         }
         catch (const std::exception& e)
         {
-            Logger::instance().error(
-                QString("消息处理异常 - 类型: %1, 错误: %2").arg(static_cast<int>(message.type)).arg(e.what()));
+            LOG_ERROR("类型化通道处理异常 - 槽位: %1, 错误: %2", slot, e.what());
         }
         catch (...)
         {
-            Logger::instance().error(QString("消息处理未知异常 - 类型: %1").arg(static_cast<int>(message.type)));
+            LOG_ERROR("类型化通道处理未知异常 - 槽位: %1", slot);
         }
     }
 }
 
-void MessageBus::cleanupInvalidSubscribers()
+QFuture<Message> MessageBus::registerRequest(const QString& correlationId, int timeout)
 {
-    QMutexLocker locker(&m_mutex);
+    PendingRequest pending;
+    pending.promise = std::make_shared<QPromise<Message>>();
+    pending.promise->start();
+    QFuture<Message> future = pending.promise->future();
+
+    bool earliest = false;
+    {
+        QMutexLocker locker(&m_requestMutex);
+        if (timeout >= 0)
+        {
+            pending.deadlineMs = m_requestClock.elapsed() + timeout;
+            m_requestDeadlines.insert(pending.deadlineMs, correlationId);
+            earliest = (m_requestDeadlines.firstKey() == pending.deadlineMs);
+        }
+        m_pendingRequests.insert(correlationId, pending);
+    }
+
+    // 只有新请求成为最早到期的请求时才需要重新设置定时器
+    if (earliest)
+    {
+        if (QThread::currentThread() == thread())
+        {
+            armRequestTimer();
+        }
+        else
+        {
+            QMetaObject::invokeMethod(this, [this]() { armRequestTimer(); }, Qt::QueuedConnection);
+        }
+    }
+    return future;
+}
+
+bool MessageBus::takeRequest(const QString& correlationId, PendingRequest& pending)
+{
+    auto it = m_pendingRequests.find(correlationId);
+    if (it == m_pendingRequests.end())
+    {
+        return false;
+    }
 
-    for (auto it = m_subscribers.begin(); it != m_subscribers.end(); ++it)
+    pending = it.value();
+    m_pendingRequests.erase(it);
+    if (pending.deadlineMs >= 0)
     {
-        QList<SubscriberInfo>& subscribers = it.value();
-        for (int i = subscribers.size() - 1; i >= 0; --i)
+        m_requestDeadlines.remove(pending.deadlineMs, correlationId);
+    }
+    return true;
+}
+
+void MessageBus::completeRequest(PendingRequest& pending, const Message* response)
+{
+    // 在锁外完成，future 上同步执行的后续处理可以再次发起请求
+    if (response)
+    {
+        pending.promise->addResult(*response);
+    }
+    else
+    {
+        pending.promise->future().cancel();
+    }
+    pending.promise->finish();
+
+    QMutexLocker locker(&m_requestMutex);
+    m_requestFinished.wakeAll();
+}
+
+void MessageBus::armRequestTimer()
+{
+    QMutexLocker locker(&m_requestMutex);
+    if (m_requestDeadlines.isEmpty())
+    {
+        m_requestTimer->stop();
+        return;
+    }
+
+    qint64 wait = m_requestDeadlines.firstKey() - m_requestClock.elapsed();
+    m_requestTimer->start(static_cast<int>(qMax<qint64>(0, wait)));
+}
+
+void MessageBus::expireRequests()
+{
+    QList<PendingRequest> expired;
+    QStringList expiredIds;
+    {
+        QMutexLocker locker(&m_requestMutex);
+        qint64 now = m_requestClock.elapsed();
+        while (!m_requestDeadlines.isEmpty() && m_requestDeadlines.firstKey() <= now)
         {
-            if (subscribers[i].receiver == nullptr)
+            auto first = m_requestDeadlines.begin();
+            QString correlationId = first.value();
+            PendingRequest pending;
+            if (!takeRequest(correlationId, pending))
             {
-                subscribers.removeAt(i);
+                m_requestDeadlines.erase(first);
+                continue;
             }
+            expired.append(pending);
+            expiredIds.append(correlationId);
         }
     }
 
-    Logger::instance().debug("清理无效订阅者完成");
+    for (int i = 0; i < expired.size(); ++i)
+    {
+        completeRequest(expired[i], nullptr);
+        LOG_WARNING("请求超时 - 关联ID: %1", expiredIds[i]);
+    }
+
+    armRequestTimer();
+}
+
+int MessageBus::allocateChannelId()
+{
+    static std::atomic<int> nextChannelId(0);
+    return nextChannelId.fetch_add(1, std::memory_order_relaxed);
 }
 
 int MessageBus::generateSubscriptionId()
@@ -9,41 +9,38 @@
  * - 类型安全的消息传递
  * - 支持同步和异步消息处理
  * - 支持消息过滤和优先级
- * - 线程安全
- * - 支持请求-响应模式
+ * - 线程安全：订阅者按消息类型保存为不可变快照，发布时无锁读取，订阅和取消订阅时整体替换快照
+ * - 支持请求-响应模式：请求按关联ID登记，响应方调用 respond 完成请求方持有的 QFuture，超时的请求被取消
+ * - 类型化通道：以负载类型作为通道，负载按引用直接交给订阅者，不经过 QVariant，也不在发布时分配内存
+ * - 异步发布按接收者所在线程投递：每个线程一个投递队列，一个分发周期只投递一个事件，可按消息类型合并
  */
 
 #ifndef MESSAGEBUS_H
 #define MESSAGEBUS_H
 
+#include <QElapsedTimer>
+#include <QFuture>
+#include <QHash>
 #include <QList>
 #include <QMap>
 #include <QMutex>
 #include <QMutexLocker>
 #include <QObject>
+#include <QPromise>
 #include <QSet>
+#include <QTimer>
+#include <QThread>
+#include <QWaitCondition>
+#include <atomic>
 #include <functional>
+#include <memory>
+#include <type_traits>
+#include "common/messagebus/deliveryqueue.h"
+#include "common/messagebus/subscribertable.h"
 #include "messagetypes.h"
 
 class MessageBus;
 
-/**
- * @brief 消息订阅者信息结构
- */
-struct SubscriberInfo
-{
-    QObject* receiver;                            ///< 接收者对象
-    std::function<void(const Message&)> handler;  ///< 消息处理函数
-    int priority;                                 ///< 订阅优先级
-
-    SubscriberInfo() : receiver(nullptr), priority(0) {}
-
-    SubscriberInfo(QObject* obj, std::function<void(const Message&)> func, int prio = 0)
-        : receiver(obj), handler(func), priority(prio)
-    {
-    }
-};
-
 /**
  * @brief 消息总线类，实现模块间的解耦通信
  * 
@@ -62,6 +59,10 @@ struct SubscriberInfo
  * // 发布消息
  * MessageBus::instance().publish(MessageType::DatabaseProjectAdded, 
  *     QVariant::fromValue(projectInfo), "DatabaseManager");
+ *
+ * // 类型化通道
+ * MessageBus::instance().subscribe<ProgressEvent>(this, [](const ProgressEvent& event) { ... });
+ * MessageBus::instance().publish(ProgressEvent{current, total});
  * @endcode
  */
 class MessageBus : public QObject
@@ -99,7 +100,23 @@ class MessageBus : public QObject
                                  int priority = 0);
 
     /**
-     * @brief 取消订阅
+     * @brief 订阅类型化通道（负载类型即通道）
+     * @tparam T 负载类型
+     * @param receiver 接收者对象（用于生命周期管理）
+     * @param handler 处理函数，参数为 const T&
+     * @param priority 订阅优先级（数值越大优先级越高）
+     * @return 订阅ID，用于取消订阅；通道数超出分发表预留范围时返回-1
+     */
+    template <typename T, typename Handler>
+    int subscribe(QObject* receiver, Handler handler, int priority = 0)
+    {
+        return subscribeChannel(
+            channelId<std::decay_t<T>>(), receiver,
+            [handler](const void* payload) { handler(*static_cast<const std::decay_t<T>*>(payload)); }, priority);
+    }
+
+    /**
+     * @brief 取消订阅（按消息类型和按类型化通道的订阅都适用）
      * @param subscriptionId 订阅ID
      * @return 是否成功取消
      */
@@ -122,7 +139,21 @@ class MessageBus : public QObject
                  MessagePriority priority = MessagePriority::Normal);
 
     /**
-     * @brief 发布消息（异步方式，通过信号槽）
+     * @brief 在类型化通道上同步发布，负载按引用交给订阅者，不复制也不装箱（可为只能移动的类型）
+     * @tparam T 负载类型
+     * @param payload 负载
+     */
+    template <typename T>
+    void publish(const T& payload)
+    {
+        if (m_enabled.load(std::memory_order_relaxed))
+        {
+            dispatchPayload(SubscriberTable::channelSlot(channelId<T>()), &payload);
+        }
+    }
+
+    /**
+     * @brief 发布消息（异步方式），处理函数在各接收者订阅时所在的线程上执行（该线程需运行事件循环）
      * @param type 消息类型
      * @param data 消息数据
      * @param sender 发送者标识
@@ -131,6 +162,20 @@ class MessageBus : public QObject
     void publishAsync(MessageType type, const QVariant& data = QVariant(), const QString& sender = QString(),
                       MessagePriority priority = MessagePriority::Normal);
 
+    /**
+     * @brief 设置消息类型在异步发布时是否合并：尚未分发的旧消息被最新的消息替换（适用于进度、状态等只关心最新值的消息）
+     * @param type 消息类型
+     * @param coalesce 是否合并
+     */
+    void setCoalescing(MessageType type, bool coalesce);
+
+    /**
+     * @brief 检查消息类型在异步发布时是否合并
+     * @param type 消息类型
+     * @return 是否合并
+     */
+    bool isCoalescing(MessageType type) const;
+
     /**
      * @brief 发布消息对象
      * @param message 消息对象
@@ -138,21 +183,41 @@ class MessageBus : public QObject
     void publishMessage(const Message& message);
 
     /**
-     * @brief 发送请求并等待响应（同步）
+     * @brief 发送请求并等待响应（同步，会阻塞调用线程，GUI线程应使用 requestAsync）
      * @param type 请求消息类型
      * @param data 请求数据
      * @param sender 发送者标识
      * @param timeout 超时时间（毫秒），-1表示无限等待
-     * @return 响应消息
+     * @return 响应消息，超时时返回空消息
      */
     Message sendRequest(MessageType type, const QVariant& data = QVariant(), const QString& sender = QString(),
                         int timeout = 5000);
 
     /**
-     * @brief 注册响应处理器
+     * @brief 发送请求，不等待响应
+     * @param type 请求消息类型
+     * @param data 请求数据
+     * @param sender 发送者标识
+     * @param timeout 超时时间（毫秒），-1表示不超时；超时后 future 被取消
+     * @return 响应消息的 future，可用 then 挂接后续处理
+     */
+    QFuture<Message> requestAsync(MessageType type, const QVariant& data = QVariant(),
+                                  const QString& sender = QString(), int timeout = 5000);
+
+    /**
+     * @brief 响应请求（可在任意线程调用，也可在处理请求之后稍晚调用）
+     * @param request 收到的请求消息
+     * @param data 响应数据
+     * @param sender 响应方标识
+     * @return 是否完成了等待中的请求（请求已超时或已被响应时返回false）
+     */
+    bool respond(const Message& request, const QVariant& data = QVariant(), const QString& sender = QString());
+
+    /**
+     * @brief 注册请求处理器（收到请求后应调用 respond）
      * @param type 请求消息类型
      * @param receiver 接收者对象
-     * @param handler 响应处理函数
+     * @param handler 请求处理函数
      * @return 订阅ID
      */
     int registerResponseHandler(MessageType type, QObject* receiver, MessageHandler handler);
@@ -183,7 +248,7 @@ class MessageBus : public QObject
 
    signals:
     /**
-     * @brief 消息发布信号（用于异步发布）
+     * @brief 消息发布信号（异步发布的消息放入投递队列后发出，供观察者使用）
      * @param message 消息对象
      */
     void messagePublished(const Message& message);
@@ -196,35 +261,170 @@ class MessageBus : public QObject
     void subscriberCountChanged(MessageType type, int count);
 
    private:
+    /**
+     * @brief 等待响应的请求
+     */
+    struct PendingRequest
+    {
+        std::shared_ptr<QPromise<Message>> promise;  ///< 响应消息的 promise
+        qint64 deadlineMs;                           ///< 截止时间（相对 m_requestClock 的毫秒数，-1表示不超时）
+
+        PendingRequest() : deadlineMs(-1) {}
+    };
+
     MessageBus();
     ~MessageBus();
     MessageBus(const MessageBus&) = delete;
     MessageBus& operator=(const MessageBus&) = delete;
 
+    /**
+     * @brief 登记等待响应的请求
+     * @param correlationId 关联ID
+     * @param timeout 超时时间（毫秒），-1表示不超时
+     * @return 响应消息的 future
+     */
+    QFuture<Message> registerRequest(const QString& correlationId, int timeout);
+
+    /**
+     * @brief 从请求表中取出等待中的请求（调用方需持有 m_requestMutex）
+     * @param correlationId 关联ID
+     * @param pending 输出参数，取出的请求
+     * @return 请求是否仍在等待
+     */
+    bool takeRequest(const QString& correlationId, PendingRequest& pending);
+
+    /**
+     * @brief 完成已取出的请求并唤醒同步等待方（调用方不得持有 m_requestMutex）
+     * @param pending 请求
+     * @param response 响应消息，为nullptr时取消请求
+     */
+    void completeRequest(PendingRequest& pending, const Message* response);
+
+    /**
+     * @brief 按最早的截止时间启动超时定时器（在总线所在线程调用）
+     */
+    void armRequestTimer();
+
+    /**
+     * @brief 取消所有已超时的请求
+     */
+    void expireRequests();
+
     /**
      * @brief 处理消息分发
      * @param message 消息对象
      */
     void dispatchMessage(const Message& message);
 
+    /**
+     * @brief 把投递队列中取出的消息分发给属于该队列的订阅者（在队列所属线程调用）
+     * @param message 消息对象
+     * @param queue 投递队列
+     */
+    void deliverQueued(const Message& message, const DeliveryQueue* queue);
+
+    /**
+     * @brief 调用订阅者的消息处理函数，捕获并记录异常
+     * @param info 订阅者信息
+     * @param message 消息对象
+     */
+    void invokeHandler(const SubscriberInfo& info, const Message& message);
+
+    /**
+     * @brief 获取线程的投递队列，不存在时创建（调用方需持有 m_mutex）
+     * @param thread 接收者所在线程
+     * @return 投递队列，最后一个引用它的订阅被移除后释放
+     */
+    std::shared_ptr<DeliveryQueue> deliveryQueueFor(QThread* thread);
+
     /**
      * @brief 清理无效的订阅者
      */
     void cleanupInvalidSubscribers();
 
+    /**
+     * @brief 把订阅插入到槽位的订阅者快照中并发布新快照（调用方需持有 m_mutex）
+     * @param slot 槽位
+     * @param info 订阅者信息
+     * @return 插入后的订阅者数量
+     */
+    int insertSubscriber(int slot, const SubscriberInfo& info);
+
+    /**
+     * @brief 记录接收者的订阅，首次出现的接收者在销毁时自动取消订阅（调用方需持有 m_mutex）
+     * @param receiver 接收者对象
+     * @param subscriptionId 订阅ID
+     */
+    void trackReceiver(QObject* receiver, int subscriptionId);
+
+    /**
+     * @brief 从槽位的订阅者快照中移除订阅并发布新快照（调用方需持有 m_mutex）
+     * @param slot 槽位
+     * @param shouldRemove 判断订阅是否应被移除
+     * @return 移除后的订阅者数量
+     */
+    int removeSubscribers(int slot, const std::function<bool(const SubscriberInfo&)>& shouldRemove);
+
+    /**
+     * @brief 订阅类型化通道
+     * @param channelId 通道编号
+     * @param receiver 接收者对象
+     * @param handler 负载处理函数
+     * @param priority 订阅优先级
+     * @return 订阅ID，失败时返回-1
+     */
+    int subscribeChannel(int channelId, QObject* receiver, std::function<void(const void*)> handler, int priority);
+
+    /**
+     * @brief 把负载分发给类型化通道的订阅者
+     * @param slot 通道槽位
+     * @param payload 负载地址
+     */
+    void dispatchPayload(int slot, const void* payload);
+
+    /**
+     * @brief 获取负载类型的通道编号（每个类型首次使用时分配一次，之后只读取局部静态变量）
+     * @tparam T 负载类型
+     * @return 通道编号
+     */
+    template <typename T>
+    static int channelId()
+    {
+        static const int id = allocateChannelId();
+        return id;
+    }
+
+    /**
+     * @brief 分配一个新的通道编号
+     * @return 通道编号
+     */
+    static int allocateChannelId();
+
     /**
      * @brief 生成唯一的订阅ID
      * @return 订阅ID
      */
     int generateSubscriptionId();
 
-    QMap<MessageType, QList<SubscriberInfo>> m_subscribers;  ///< 按消息类型分组的订阅者
-    QMap<int, MessageType> m_subscriptionTypes;              ///< 订阅ID到消息类型的映射
-    QMap<QObject*, QSet<int>> m_receiverSubscriptions;       ///< 接收者到订阅ID的映射
-    mutable QMutex m_mutex;                                  ///< 互斥锁
-    int m_nextSubscriptionId;                                ///< 下一个订阅ID
-    bool m_enabled;                                          ///< 是否启用
+    SubscriberTable m_subscribers;                      ///< 按消息类型索引的订阅者快照
+    QMap<int, MessageType> m_subscriptionTypes;         ///< 订阅ID到消息类型的映射
+    QMap<int, int> m_channelSubscriptions;              ///< 类型化通道的订阅ID到槽位的映射
+    QMap<QObject*, QSet<int>> m_receiverSubscriptions;  ///< 接收者到订阅ID的映射
+    mutable QMutex m_mutex;                             ///< 互斥锁，串行化订阅表的修改（分发不加锁）
+    int m_nextSubscriptionId;                           ///< 下一个订阅ID
+    std::atomic<bool> m_enabled;                        ///< 是否启用
+
+    QHash<QThread*, std::weak_ptr<DeliveryQueue>> m_deliveryQueues;  ///< 线程 -> 投递队列（受 m_mutex 保护）
+
+    QMutex m_requestMutex;                             ///< 保护请求表
+    QWaitCondition m_requestFinished;                  ///< 有请求完成（唤醒同步等待的 sendRequest）
+    QHash<QString, PendingRequest> m_pendingRequests;  ///< 关联ID -> 等待响应的请求
+    QMultiMap<qint64, QString> m_requestDeadlines;     ///< 截止时间 -> 关联ID，按时间排序
+    QElapsedTimer m_requestClock;                      ///< 请求截止时间的时钟
+    QTimer* m_requestTimer;                            ///< 超时定时器，在最早的截止时间触发
+    std::atomic<quint64> m_nextRequestId;              ///< 下一个请求序号
 
+    friend class DeliveryQueue;
     friend class MessageBusTest;
 };
 
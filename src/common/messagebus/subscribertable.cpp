@@ -0,0 +1,151 @@
+/**
+ * @file subscribertable.cpp
+ * @brief 订阅者表实现
+ * @author Developer
+ * @date 2026-10-18
+ * @version 1.0
+ */
+
+#include "common/messagebus/subscribertable.h"
+
+namespace
+{
+std::atomic<int> g_nextReaderStripe(0);  ///< 下一个线程分配的读区间分片
+}  // namespace
+
+SubscriberTable::ReadGuard::ReadGuard(const SubscriberTable& table) : m_counter(table.readerCounter())
+{
+    // 计数增加必须先于读取快照指针，修改方据此判断旧快照是否仍可能被读取
+    m_counter.fetch_add(1, std::memory_order_seq_cst);
+}
+
+SubscriberTable::ReadGuard::~ReadGuard()
+{
+    m_counter.fetch_sub(1, std::memory_order_release);
+}
+
+SubscriberTable::SubscriberTable()
+{
+    for (std::atomic<const SubscriberList*>& slot : m_slots)
+    {
+        slot.store(nullptr, std::memory_order_relaxed);
+    }
+    for (std::atomic<bool>& coalesced : m_coalesced)
+    {
+        coalesced.store(false, std::memory_order_relaxed);
+    }
+}
+
+SubscriberTable::~SubscriberTable()
+{
+    for (std::atomic<const SubscriberList*>& slot : m_slots)
+    {
+        delete slot.load(std::memory_order_relaxed);
+    }
+    qDeleteAll(m_retired);
+}
+
+int SubscriberTable::slotOf(MessageType type)
+{
+    static_assert(static_cast<int>(MessageType::DatabaseMessagesEnd) % 1000 < kGroupSlots, "数据库消息超出分组槽位");
+    static_assert(static_cast<int>(MessageType::ParseMessagesEnd) % 1000 < kGroupSlots, "解析消息超出分组槽位");
+    static_assert(static_cast<int>(MessageType::AIMessagesEnd) % 1000 < kGroupSlots, "AI消息超出分组槽位");
+    static_assert(static_cast<int>(MessageType::UIMessagesEnd) % 1000 < kGroupSlots, "UI消息超出分组槽位");
+    static_assert(static_cast<int>(MessageType::SystemMessagesEnd) % 1000 < kGroupSlots, "系统消息超出分组槽位");
+
+    int value = static_cast<int>(type);
+    int group = value / 1000;
+    int offset = value % 1000;
+    if (value < 0 || group >= kMessageTypeSlots / kGroupSlots || offset >= kGroupSlots)
+    {
+        return -1;
+    }
+    return group * kGroupSlots + offset;
+}
+
+int SubscriberTable::channelSlot(int channelId)
+{
+    if (channelId < 0 || channelId >= kChannelSlots)
+    {
+        return -1;
+    }
+    return kMessageTypeSlots + channelId;
+}
+
+void SubscriberTable::setCoalesced(int slot, bool coalesce)
+{
+    if (slot >= 0 && slot < kSlotCount)
+    {
+        m_coalesced[slot].store(coalesce, std::memory_order_relaxed);
+    }
+}
+
+bool SubscriberTable::isCoalesced(int slot) const
+{
+    return slot >= 0 && slot < kSlotCount && m_coalesced[slot].load(std::memory_order_relaxed);
+}
+
+const SubscriberList* SubscriberTable::snapshot(int slot) const
+{
+    if (slot < 0 || slot >= kSlotCount)
+    {
+        return nullptr;
+    }
+    return m_slots[slot].load(std::memory_order_seq_cst);
+}
+
+void SubscriberTable::replace(int slot, const SubscriberList& subscribers)
+{
+    if (slot < 0 || slot >= kSlotCount)
+    {
+        return;
+    }
+
+    const SubscriberList* next = subscribers.isEmpty() ? nullptr : new SubscriberList(subscribers);
+    const SubscriberList* previous = m_slots[slot].exchange(next, std::memory_order_seq_cst);
+    if (previous)
+    {
+        m_retired.append(previous);
+    }
+    reclaim();
+}
+
+void SubscriberTable::clear()
+{
+    for (std::atomic<const SubscriberList*>& slot : m_slots)
+    {
+        const SubscriberList* previous = slot.exchange(nullptr, std::memory_order_seq_cst);
+        if (previous)
+        {
+            m_retired.append(previous);
+        }
+    }
+    reclaim();
+}
+
+std::atomic<int>& SubscriberTable::readerCounter() const
+{
+    thread_local int stripe = g_nextReaderStripe.fetch_add(1, std::memory_order_relaxed) % kReaderStripes;
+    return m_readers[stripe].active;
+}
+
+void SubscriberTable::reclaim()
+{
+    if (m_retired.isEmpty())
+    {
+        return;
+    }
+
+    // 旧快照已经从槽位上摘下，此后进入读区间的读取方只会读到新快照；
+    // 此刻所有计数都为0说明没有读取方还持有旧快照
+    for (const ReaderStripe& stripe : m_readers)
+    {
+        if (stripe.active.load(std::memory_order_seq_cst) != 0)
+        {
+            return;
+        }
+    }
+
+    qDeleteAll(m_retired);
+    m_retired.clear();
+}
@@ -0,0 +1,176 @@
+/**
+ * @file subscribertable.h
+ * @brief 消息总线的订阅者表：按消息类型索引的不可变快照，分发时无锁读取
+ * @author Developer
+ * @date 2026-10-18
+ * @version 1.0
+ *
+ * @details 每个消息类型和每个类型化通道对应分发表中的一个槽位，槽位保存一份按优先级排好序的订阅者快照：
+ * - 读取方（消息分发）进入读区间后直接读取快照指针，不加锁，也不修改快照的引用计数
+ * - 修改方（订阅、取消订阅）复制旧快照、修改后整体替换，旧快照放入待回收列表
+ * - 读区间计数按线程分散到多个缓存行上，修改方发现所有计数都为0时释放待回收的快照
+ */
+
+#ifndef SUBSCRIBERTABLE_H
+#define SUBSCRIBERTABLE_H
+
+#include <QObject>
+#include <QVector>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include "common/messagebus/messagetypes.h"
+
+class DeliveryQueue;
+
+/**
+ * @brief 消息订阅者信息结构
+ */
+struct SubscriberInfo
+{
+    int subscriptionId;                               ///< 订阅ID
+    QObject* receiver;                                ///< 接收者对象
+    std::function<void(const Message&)> handler;      ///< 消息处理函数（按 MessageType 订阅）
+    std::function<void(const void*)> payloadHandler;  ///< 负载处理函数（按类型化通道订阅，参数指向负载）
+    int priority;                                     ///< 订阅优先级
+    std::shared_ptr<DeliveryQueue> queue;             ///< 接收者订阅时所在线程的投递队列（异步发布使用）
+
+    SubscriberInfo() : subscriptionId(-1), receiver(nullptr), priority(0) {}
+
+    SubscriberInfo(int id, QObject* obj, std::function<void(const Message&)> func, int prio = 0)
+        : subscriptionId(id), receiver(obj), handler(func), priority(prio)
+    {
+    }
+
+    SubscriberInfo(int id, QObject* obj, std::function<void(const void*)> func, int prio = 0)
+        : subscriptionId(id), receiver(obj), payloadHandler(func), priority(prio)
+    {
+    }
+};
+
+/**
+ * @brief 一个消息类型的订阅者快照（按优先级从高到低排列，发布后不再修改）
+ */
+using SubscriberList = QVector<SubscriberInfo>;
+
+/**
+ * @brief 订阅者表
+ *
+ * @details 修改方之间需要由调用方互斥；读取方可在任意线程并发读取，读取前须构造 ReadGuard，
+ * 快照指针只在 ReadGuard 的生存期内有效。
+ */
+class SubscriberTable
+{
+   public:
+    /**
+     * @brief 读区间：生存期内读到的快照不会被释放
+     */
+    class ReadGuard
+    {
+       public:
+        /**
+         * @brief 进入读区间
+         * @param table 订阅者表
+         */
+        explicit ReadGuard(const SubscriberTable& table);
+
+        /**
+         * @brief 离开读区间
+         */
+        ~ReadGuard();
+
+        ReadGuard(const ReadGuard&) = delete;
+        ReadGuard& operator=(const ReadGuard&) = delete;
+
+       private:
+        std::atomic<int>& m_counter;  ///< 当前线程使用的读区间计数
+    };
+
+    SubscriberTable();
+    ~SubscriberTable();
+
+    SubscriberTable(const SubscriberTable&) = delete;
+    SubscriberTable& operator=(const SubscriberTable&) = delete;
+
+    /**
+     * @brief 读取槽位的订阅者快照（读取方须持有 ReadGuard，修改方须持有调用方的互斥锁）
+     * @param slot 槽位（slotOf 或 channelSlot 的返回值）
+     * @return 订阅者快照，没有订阅者或槽位无效时返回nullptr
+     */
+    const SubscriberList* snapshot(int slot) const;
+
+    /**
+     * @brief 替换槽位的订阅者快照（修改方调用），旧快照在没有读取方时释放
+     * @param slot 槽位
+     * @param subscribers 新的订阅者列表，为空时清除该槽位的快照
+     */
+    void replace(int slot, const SubscriberList& subscribers);
+
+    /**
+     * @brief 清除所有快照（修改方调用）
+     */
+    void clear();
+
+    /**
+     * @brief 获取消息类型在分发表中的槽位
+     * @param type 消息类型
+     * @return 槽位，消息类型超出分发表范围时返回-1
+     */
+    static int slotOf(MessageType type);
+
+    /**
+     * @brief 获取类型化通道在分发表中的槽位
+     * @param channelId 通道编号（从0开始）
+     * @return 槽位，通道编号超出预留范围时返回-1
+     */
+    static int channelSlot(int channelId);
+
+    /**
+     * @brief 设置槽位的消息在异步投递时是否合并（只保留最新的一条）
+     * @param slot 槽位
+     * @param coalesce 是否合并
+     */
+    void setCoalesced(int slot, bool coalesce);
+
+    /**
+     * @brief 槽位的消息在异步投递时是否合并（可在任意线程调用）
+     * @param slot 槽位
+     * @return 是否合并
+     */
+    bool isCoalesced(int slot) const;
+
+   private:
+    /**
+     * @brief 读区间计数，独占一个缓存行
+     */
+    struct alignas(64) ReaderStripe
+    {
+        std::atomic<int> active;  ///< 处于读区间的读取方数量
+
+        ReaderStripe() : active(0) {}
+    };
+
+    /**
+     * @brief 获取当前线程使用的读区间计数
+     * @return 读区间计数
+     */
+    std::atomic<int>& readerCounter() const;
+
+    /**
+     * @brief 在没有读取方时释放所有待回收的快照（修改方调用）
+     */
+    void reclaim();
+
+    static const int kGroupSlots = 32;                                ///< 每组消息类型占用的槽位数（组内偏移须小于此值）
+    static const int kMessageTypeSlots = 10 * kGroupSlots;            ///< 消息类型的槽位数（按千位分为10组）
+    static const int kChannelSlots = 64;                              ///< 为类型化通道预留的槽位数
+    static const int kSlotCount = kMessageTypeSlots + kChannelSlots;  ///< 槽位总数
+    static const int kReaderStripes = 16;                             ///< 读区间计数的分片数
+
+    std::atomic<const SubscriberList*> m_slots[kSlotCount];  ///< 按槽位索引的订阅者快照
+    mutable ReaderStripe m_readers[kReaderStripes];          ///< 分片的读区间计数
+    std::atomic<bool> m_coalesced[kSlotCount];               ///< 按槽位索引的异步投递合并标志
+    QVector<const SubscriberList*> m_retired;                ///< 待回收的旧快照（仅修改方访问）
+};
+
+#endif  // SUBSCRIBERTABLE_H
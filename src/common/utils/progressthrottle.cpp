@@ -0,0 +1,87 @@
+/**
+ * @file progressthrottle.cpp
+ * @brief 进度节流器实现
+ * @author Developer
+ * @date 2026-10-18
+ * @version 1.0
+ */
+
+#include "common/utils/progressthrottle.h"
+#include <QtGlobal>
+
+ProgressThrottle::ProgressThrottle(int frameRate, QObject* parent)
+    : QObject(parent), m_nextDueMs(0), m_intervalMs(0), m_timer(new QTimer(this)), m_pending(false)
+{
+    m_clock.start();
+    m_timer->setSingleShot(true);
+    connect(m_timer, &QTimer::timeout, this, &ProgressThrottle::onTimeout);
+
+    setFrameRate(frameRate);
+}
+
+void ProgressThrottle::setFrameRate(int frameRate)
+{
+    m_intervalMs.storeRelaxed(frameRate > 0 ? qMax(1, 1000 / frameRate) : 0);
+}
+
+bool ProgressThrottle::tryAcquire()
+{
+    qint64 now = m_clock.elapsed();
+    qint64 nextDue = m_nextDueMs.loadRelaxed();
+    if (now < nextDue)
+    {
+        return false;
+    }
+
+    // 多个线程同时到达时只有一个能占用本帧
+    return m_nextDueMs.testAndSetRelaxed(nextDue, now + m_intervalMs.loadRelaxed());
+}
+
+void ProgressThrottle::request()
+{
+    if (tryAcquire())
+    {
+        m_timer->stop();
+        m_pending = false;
+        emit due();
+        return;
+    }
+
+    m_pending = true;
+    if (!m_timer->isActive())
+    {
+        qint64 wait = m_nextDueMs.loadRelaxed() - m_clock.elapsed();
+        m_timer->start(static_cast<int>(qMax<qint64>(0, wait)));
+    }
+}
+
+void ProgressThrottle::flush()
+{
+    m_timer->stop();
+    if (m_pending)
+    {
+        deliver();
+    }
+}
+
+void ProgressThrottle::reset()
+{
+    m_timer->stop();
+    m_pending = false;
+    m_nextDueMs.storeRelaxed(0);
+}
+
+void ProgressThrottle::onTimeout()
+{
+    if (m_pending)
+    {
+        deliver();
+    }
+}
+
+void ProgressThrottle::deliver()
+{
+    m_pending = false;
+    m_nextDueMs.storeRelaxed(m_clock.elapsed() + m_intervalMs.loadRelaxed());
+    emit due();
+}
@@ -0,0 +1,102 @@
+/**
+ * @file progressthrottle.h
+ * @brief 进度节流器，把高频的进度更新合并为固定帧率的通知
+ * @author Developer
+ * @date 2026-10-18
+ * @version 1.0
+ *
+ * @details 使用方式：调用方自己保存最新的进度状态，每次状态变化时调用 request()，
+ * 在 due() 信号中发出最新状态。
+ * - 距上次通知已超过一个帧间隔时立即通知，否则在间隔结束时补发一次，期间的更新只保留最新状态
+ * - 结束前调用 flush() 立即发出尚未通知的状态
+ * - tryAcquire() 只做限速判断，不依赖事件循环，可在任意线程调用；被拒绝的更新不会补发
+ */
+
+#ifndef PROGRESSTHROTTLE_H
+#define PROGRESSTHROTTLE_H
+
+#include <QAtomicInteger>
+#include <QElapsedTimer>
+#include <QObject>
+#include <QTimer>
+
+/**
+ * @brief 进度节流器类
+ */
+class ProgressThrottle : public QObject
+{
+    Q_OBJECT
+
+   public:
+    /**
+     * @brief 构造函数
+     * @param frameRate 每秒最多通知次数
+     * @param parent 父对象
+     */
+    explicit ProgressThrottle(int frameRate = 20, QObject* parent = nullptr);
+
+    /**
+     * @brief 设置每秒最多通知次数
+     * @param frameRate 每秒通知次数（不大于0时不限速）
+     */
+    void setFrameRate(int frameRate);
+
+    /**
+     * @brief 获取通知间隔
+     * @return 间隔（毫秒）
+     */
+    int intervalMs() const { return m_intervalMs.loadRelaxed(); }
+
+    /**
+     * @brief 检查现在是否可以通知，可以时占用本帧（线程安全）
+     * @return 是否可以通知
+     */
+    bool tryAcquire();
+
+    /**
+     * @brief 标记进度已变化，按帧率发出 due() 信号（只能在节流器所在线程调用）
+     */
+    void request();
+
+    /**
+     * @brief 立即发出尚未通知的更新
+     */
+    void flush();
+
+    /**
+     * @brief 丢弃尚未通知的更新，下一次更新立即通知
+     */
+    void reset();
+
+    /**
+     * @brief 检查是否有尚未通知的更新
+     * @return 是否有待通知的更新
+     */
+    bool isPending() const { return m_pending; }
+
+   signals:
+    /**
+     * @brief 应发出最新进度的信号
+     */
+    void due();
+
+   private slots:
+    /**
+     * @brief 帧间隔结束，补发期间被合并的更新
+     */
+    void onTimeout();
+
+   private:
+    /**
+     * @brief 发出通知并开始新的帧间隔
+     */
+    void deliver();
+
+    QElapsedTimer m_clock;               ///< 单调时钟
+    QAtomicInteger<qint64> m_nextDueMs;  ///< 下一次允许通知的时间（m_clock时间，毫秒）
+    QAtomicInt m_intervalMs;             ///< 通知间隔（毫秒）
+    QTimer* m_timer;                     ///< 补发定时器
+    bool m_pending;                      ///< 是否有尚未通知的更新
+};
+
+#endif  // PROGRESSTHROTTLE_H
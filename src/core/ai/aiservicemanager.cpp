@@ -11,24 +11,50 @@
 #include <QJsonParseError>
 #include <QNetworkRequest>
 #include <QUuid>
+#include <algorithm>
 #include "common/logger/logger.h"
+#include "core/ai/recordingnetworkmanager.h"
+#include "core/ai/requestfingerprint.h"
+#include "core/ai/tokenestimator.h"
+#include "core/models/errorhandler.h"
+
+namespace
+{
+const int kExpectedOutputTokens = 2000;  ///< 单个函数分析预计输出token数，用于TPM预算
+const int kLatencyWindow = 200;          ///< 用于计算p95的最近成功响应数
+const int kMinLatencySamples = 20;       ///< 开始对冲所需的最少样本数
+const qint64 kMinHedgeDelayMs = 1000;    ///< 对冲延迟下限（毫秒）
+const int kFunctionPromptVersion = 1;    ///< 函数分析提示词版本，修改buildFunctionPrompt时递增
+}  // namespace
 
 AIServiceManager::AIServiceManager(QObject* parent)
     : QObject(parent),
       m_networkManager(nullptr),
-      m_rateLimit(60),
-      m_lastRequestTime(0),
+      m_coalescedCount(0),
+      m_latencyCursor(0),
+      m_hedgingEnabled(false),
+      m_hedgeBudgetPercent(5),
+      m_primarySent(0),
+      m_hedgesSent(0),
+      m_hedgeWins(0),
+      m_rateLimiter(new DualRateLimiter(60, 0, this)),
+      m_endpointPool(new EndpointPool(this)),
+      m_poolMode(false),
+      m_maxConcurrentRequests(1),
       m_processTimer(new QTimer(this)),
-      m_timeoutTimer(new QTimer(this)),
-      m_timeoutMs(120000)
+      m_timeoutMs(120000),
+      m_completedCount(0),
+      m_failedCount(0),
+      m_tokensSent(0),
+      m_tokensReceived(0)
 {
 
-    m_networkManager = new QNetworkAccessManager(this);
+    m_networkManager = new RecordingNetworkManager(this);
+    m_processTimer->setSingleShot(true);
 
     connect(m_processTimer, &QTimer::timeout, this, &AIServiceManager::onProcessQueue);
-    connect(m_timeoutTimer, &QTimer::timeout, this, &AIServiceManager::onRequestTimeout);
 
-    Logger::instance().info("AI服务管理器初始化完成");
+    LOG_INFO("AI服务管理器初始化完成");
 }
 
 AIServiceManager::~AIServiceManager()
@@ -39,10 +65,6 @@ AIServiceManager::~AIServiceManager()
     {
         m_processTimer->stop();
     }
-    if (m_timeoutTimer->isActive())
-    {
-        m_timeoutTimer->stop();
-    }
 }
 
 AIServiceManager& AIServiceManager::instance()
@@ -57,10 +79,10 @@ void AIServiceManager::analyzeCode(const QString& code)
 
     AIConfig config = AIConfigManager::instance().getCurrentConfig();
 
-    if (!AIConfigManager::instance().isConfigValid(config))
+    if (!m_poolMode && !AIConfigManager::instance().isConfigValid(config))
     {
         emit analysisFailed("AI配置不完整，请先配置AI服务！");
-        Logger::instance().error("AI配置不完整，无法分析代码");
+        LOG_ERROR("AI配置不完整，无法分析代码");
         return;
     }
 
@@ -80,10 +102,7 @@ void AIServiceManager::analyzeCode(const QString& code)
     m_pendingRequests[request.requestId] = request;
     m_requestQueue.enqueue(request);
 
-    if (m_requestQueue.size() == 1)
-    {
-        processQueue();
-    }
+    processQueue();
 }
 
 void AIServiceManager::analyzeFunction(const ExtractedFunction& func, const QString& requestId)
@@ -92,14 +111,15 @@ void AIServiceManager::analyzeFunction(const ExtractedFunction& func, const QStr
 
     AIConfig config = AIConfigManager::instance().getCurrentConfig();
 
-    if (!AIConfigManager::instance().isConfigValid(config))
+    if (!m_poolMode && !AIConfigManager::instance().isConfigValid(config))
     {
         AIAnalysisResponse response;
         response.requestId = requestId;
         response.success = false;
         response.errorMessage = "AI配置不完整，请先配置AI服务！";
+        response.errorType = ProcessErrorType::AIConfigError;
         emit functionAnalysisComplete(response);
-        Logger::instance().error("AI配置不完整，无法分析代码");
+        LOG_ERROR("AI配置不完整，无法分析代码");
         return;
     }
 
@@ -109,18 +129,18 @@ void AIServiceManager::analyzeFunction(const ExtractedFunction& func, const QStr
     request.createTime = QDateTime::currentDateTime();
 
     m_pendingRequests[requestId] = request;
-    m_requestQueue.enqueue(request);
+    enqueueRequest(request);
 
-    if (m_requestQueue.size() == 1)
-    {
-        processQueue();
-    }
+    processQueue();
 }
 
 void AIServiceManager::analyzeFunctions(const QVector<ExtractedFunction>& functions)
 {
     QMutexLocker locker(&m_mutex);
 
+    // 先重置统计，入队时合并的重复请求才会计入本次运行
+    beginRun();
+
     for (const auto& func : functions)
     {
         AIAnalysisRequest request;
@@ -129,15 +149,25 @@ void AIServiceManager::analyzeFunctions(const QVector<ExtractedFunction>& functi
         request.createTime = QDateTime::currentDateTime();
 
         m_pendingRequests[request.requestId] = request;
-        m_requestQueue.enqueue(request);
+        enqueueRequest(request);
     }
 
-    m_startTime = QDateTime::currentDateTime();
+    processQueue();
+}
 
-    if (m_requestQueue.size() == functions.size())
-    {
-        processQueue();
-    }
+void AIServiceManager::beginRun()
+{
+    QMutexLocker locker(&m_mutex);
+
+    m_startTime = QDateTime::currentDateTime();
+    m_completedCount = 0;
+    m_failedCount = 0;
+    m_tokensSent = 0;
+    m_tokensReceived = 0;
+    m_primarySent = 0;
+    m_hedgesSent = 0;
+    m_hedgeWins = 0;
+    m_coalescedCount = 0;
 }
 
 void AIServiceManager::cancelRequest()
@@ -150,25 +180,53 @@ void AIServiceManager::cancelAllRequests()
 {
     QMutexLocker locker(&m_mutex);
 
-    for (auto it = m_activeRequests.begin(); it != m_activeRequests.end(); ++it)
+    // 归还被中止请求占用的端点并发和速率预算，否则端点池会一直认为这些请求仍在进行
+    for (auto it = m_activeRequests.constBegin(); it != m_activeRequests.constEnd(); ++it)
+    {
+        releaseAttempt(it.key(), m_requestEndpoints.value(it.key(), -1), m_rateTickets.value(it.key()), false);
+    }
+    for (auto it = m_hedges.constBegin(); it != m_hedges.constEnd(); ++it)
+    {
+        releaseAttempt(it.key(), it.value().endpointIndex, it.value().ticket, false);
+    }
+
+    QList<QNetworkReply*> replies = m_activeRequests.values();
+    m_activeRequests.clear();
+    for (QNetworkReply* reply : replies)
     {
-        if (it.value())
+        if (reply)
         {
-            it.value()->abort();
-            it.value()->deleteLater();
+            disconnect(reply, nullptr, this, nullptr);
+            reply->abort();
+            reply->deleteLater();
         }
     }
-    m_activeRequests.clear();
+
+    for (const AIHedgeAttempt& hedge : m_hedges)
+    {
+        disconnect(hedge.reply, nullptr, this, nullptr);
+        hedge.reply->abort();
+        hedge.reply->deleteLater();
+    }
+    m_hedges.clear();
+    m_flightLeaders.clear();
+    m_requestFingerprints.clear();
+    m_flightFollowers.clear();
 
     m_requestQueue.clear();
     m_pendingRequests.clear();
+    m_requestStartTimes.clear();
+    m_rateTickets.clear();
+    m_estimatedPromptTokens.clear();
+    m_requestEndpoints.clear();
+    m_failoverExcludes.clear();
 
     if (m_processTimer->isActive())
     {
         m_processTimer->stop();
     }
 
-    Logger::instance().info("已取消所有AI分析请求");
+    LOG_INFO("已取消所有AI分析请求");
 }
 
 RequestQueueStatus AIServiceManager::getQueueStatus() const
@@ -179,75 +237,118 @@ RequestQueueStatus AIServiceManager::getQueueStatus() const
     status.totalRequests = m_requestQueue.size() + m_activeRequests.size();
     status.pendingRequests = m_requestQueue.size();
     status.activeRequests = m_activeRequests.size();
-    status.completedRequests = 0;
-    status.failedRequests = 0;
+    status.completedRequests = m_completedCount;
+    status.failedRequests = m_failedCount;
     status.startTime = m_startTime;
     status.elapsedTime = m_startTime.msecsTo(QDateTime::currentDateTime());
+    status.tokensSent = m_tokensSent;
+    status.tokensReceived = m_tokensReceived;
 
     return status;
 }
 
 void AIServiceManager::setRateLimit(int requestsPerMinute)
 {
-    QMutexLocker locker(&m_mutex);
-    m_rateLimit = requestsPerMinute;
-    Logger::instance().info(QString("速率限制已设置为每分钟 %1 次").arg(requestsPerMinute));
+    m_rateLimiter->setRequestsPerMinute(requestsPerMinute);
+    LOG_INFO("速率限制已设置为每分钟 %1 次", requestsPerMinute);
 }
 
-void AIServiceManager::setTimeout(int timeoutMs)
+void AIServiceManager::setTokenRateLimit(int tokensPerMinute)
 {
-    QMutexLocker locker(&m_mutex);
-    m_timeoutMs = timeoutMs;
-    Logger::instance().info(QString("请求超时时间已设置为 %1 毫秒").arg(timeoutMs));
+    m_rateLimiter->setTokensPerMinute(tokensPerMinute);
+    LOG_INFO("token速率限制已设置为每分钟 %1 个", tokensPerMinute);
 }
 
-void AIServiceManager::onRequestTimeout()
+void AIServiceManager::setMaxConcurrentRequests(int maxConcurrent)
 {
     QMutexLocker locker(&m_mutex);
+    m_maxConcurrentRequests = qMax(1, maxConcurrent);
+    LOG_INFO("最大并发请求数已设置为 %1", m_maxConcurrentRequests);
+}
 
-    Logger::instance().error(QString("请求超时 (%1 ms)").arg(m_timeoutMs));
+DualRateLimiter* AIServiceManager::rateLimiter() const
+{
+    return m_rateLimiter;
+}
 
-    for (auto it = m_activeRequests.begin(); it != m_activeRequests.end(); ++it)
+int AIServiceManager::setEndpointPool(const QStringList& configNames, const BatchProcessConfig& breakerConfig)
+{
+    QMutexLocker locker(&m_mutex);
+
+    // 进行中的请求按端点索引登记，重建端点列表后这些索引会指向其他端点
+    if (!m_activeRequests.isEmpty() || !m_hedges.isEmpty())
     {
-        QString requestId = it.key();
-        QNetworkReply* reply = it.value();
+        LOG_WARNING("仍有进行中的请求，无法重新配置端点池");
+        return -1;
+    }
 
-        if (reply)
+    QVector<AIConfig> configs;
+    for (const QString& name : configNames)
+    {
+        if (AIConfigManager::instance().hasConfig(name))
         {
-            reply->abort();
-            reply->deleteLater();
+            configs.append(AIConfigManager::instance().loadConfig(name));
         }
-
-        AIAnalysisResponse response;
-        response.requestId = requestId;
-        response.success = false;
-        response.errorMessage = QString("请求超时 (%1 秒)").arg(m_timeoutMs / 1000);
-
-        if (m_pendingRequests.contains(requestId))
+        else
         {
-            response.retryCount = m_pendingRequests.value(requestId).retryCount;
-            response.functionName = m_pendingRequests.value(requestId).function.name;
-            m_pendingRequests.remove(requestId);
+            LOG_WARNING("端点池中的AI配置不存在: %1", name);
         }
+    }
 
-        emit functionAnalysisComplete(response);
+    int count = m_endpointPool->setEndpoints(configs, breakerConfig.breakerFailureThreshold,
+                                             breakerConfig.breakerOpenDuration);
+    if (count < 0)
+    {
+        return -1;
     }
+    m_poolMode = count > 0;
+    m_failoverExcludes.clear();
 
-    m_activeRequests.clear();
-    m_requestStartTimes.clear();
+    if (m_poolMode)
+    {
+        LOG_INFO("端点池模式已启用，共 %1 个端点", count);
+    }
+    else
+    {
+        LOG_INFO("端点池模式已关闭，使用当前AI配置");
+    }
+    return count;
+}
 
-    emit queueStatusChanged(getQueueStatus());
+bool AIServiceManager::isPoolMode() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_poolMode;
+}
 
-    processQueue();
+void AIServiceManager::setHedging(bool enabled, int budgetPercent)
+{
+    QMutexLocker locker(&m_mutex);
+    m_hedgingEnabled = enabled;
+    m_hedgeBudgetPercent = qBound(0, budgetPercent, 100);
+    if (enabled)
+    {
+        LOG_INFO("对冲请求已启用，额外负载预算 %1%", m_hedgeBudgetPercent);
+    }
+    else
+    {
+        LOG_INFO("对冲请求已关闭");
+    }
 }
 
-void AIServiceManager::onReplyFinished(QNetworkReply* reply)
+void AIServiceManager::setTimeout(int timeoutMs)
 {
     QMutexLocker locker(&m_mutex);
+    m_timeoutMs = timeoutMs;
+    LOG_INFO("请求超时时间已设置为 %1 毫秒", timeoutMs);
+}
 
-    m_timeoutTimer->stop();
+void AIServiceManager::onReplyFinished(QNetworkReply* reply)
+{
+    QMutexLocker locker(&m_mutex);
 
     QString requestId;
+    bool isHedge = false;
     for (auto it = m_activeRequests.begin(); it != m_activeRequests.end(); ++it)
     {
         if (it.value() == reply)
@@ -256,10 +357,42 @@ void AIServiceManager::onReplyFinished(QNetworkReply* reply)
             break;
         }
     }
+    if (requestId.isEmpty())
+    {
+        for (auto it = m_hedges.begin(); it != m_hedges.end(); ++it)
+        {
+            if (it.value().reply == reply)
+            {
+                requestId = it.key();
+                isHedge = true;
+                break;
+            }
+        }
+    }
 
-    m_activeRequests.remove(requestId);
-    m_requestStartTimes.remove(requestId);
-    reply->deleteLater();
+    // 先处理限流：先返回的一份失败时 resolveHedge 会直接丢弃它，429同样须暂停对应端点
+    int replyEndpoint = isHedge ? m_hedges.value(requestId).endpointIndex : m_requestEndpoints.value(requestId, -1);
+    int httpStatus = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+    if (httpStatus == 429)
+    {
+        // 服务端限流：按Retry-After暂停限速器（端点池模式下只暂停该端点），避免其他请求继续触发429
+        bool ok = false;
+        int retryAfterSec = QString::fromLatin1(reply->rawHeader("Retry-After")).toInt(&ok);
+        qint64 backoffMs = (ok && retryAfterSec > 0) ? retryAfterSec * 1000LL : 10000LL;
+        if (replyEndpoint >= 0)
+        {
+            m_endpointPool->backoff(replyEndpoint, backoffMs);
+        }
+        else
+        {
+            m_rateLimiter->backoff(backoffMs);
+        }
+    }
+
+    if (m_hedges.contains(requestId) && !resolveHedge(reply, requestId, isHedge))
+    {
+        return;
+    }
 
     AIAnalysisResponse response;
     response.requestId = requestId;
@@ -269,12 +402,30 @@ void AIServiceManager::onReplyFinished(QNetworkReply* reply)
         response.responseTime = QDateTime::currentMSecsSinceEpoch() - m_requestStartTimes.value(requestId);
     }
 
-    if (reply->error() != QNetworkReply::NoError)
+    m_activeRequests.remove(requestId);
+    m_requestStartTimes.remove(requestId);
+    reply->deleteLater();
+
+    int endpointIndex = m_requestEndpoints.value(requestId, -1);
+
+    if (reply->error() == QNetworkReply::OperationCanceledError || reply->error() == QNetworkReply::TimeoutError)
+    {
+        response.success = false;
+        response.errorMessage = QString("请求超时 (%1 秒)").arg(m_timeoutMs / 1000);
+        response.errorType = ProcessErrorType::AITimeoutError;
+        LOG_ERROR("%1", response.errorMessage);
+    }
+    else if (reply->error() != QNetworkReply::NoError)
     {
         response.success = false;
         response.errorMessage = "网络请求失败: " + reply->errorString();
-        response.retryCount = m_pendingRequests.value(requestId).retryCount;
-        Logger::instance().error(response.errorMessage);
+        response.errorType =
+            (httpStatus == 429) ? ProcessErrorType::AIRateLimitError : ProcessErrorType::AIRequestError;
+        if (httpStatus > 0)
+        {
+            response.errorMessage += QString(" (HTTP %1)").arg(httpStatus);
+        }
+        LOG_ERROR("%1", response.errorMessage);
     }
     else
     {
@@ -287,17 +438,20 @@ void AIServiceManager::onReplyFinished(QNetworkReply* reply)
         {
             response.success = false;
             response.errorMessage = "解析响应JSON失败: " + error.errorString();
-            Logger::instance().error(response.errorMessage);
+            response.errorType = ProcessErrorType::AIResponseError;
+            LOG_ERROR("%1", response.errorMessage);
         }
         else
         {
             QString aiResponse = parseResponseJson(jsonDoc);
+            recordUsage(jsonDoc.object(), requestId, aiResponse, response);
 
             if (aiResponse.isEmpty())
             {
                 response.success = false;
                 response.errorMessage = "AI响应格式错误";
-                Logger::instance().error(response.errorMessage);
+                response.errorType = ProcessErrorType::AIResponseError;
+                LOG_ERROR("%1", response.errorMessage);
             }
             else
             {
@@ -340,26 +494,71 @@ void AIServiceManager::onReplyFinished(QNetworkReply* reply)
                         }
                     }
 
-                    Logger::instance().info("AI分析完成，函数名称: " + functionName);
+                    LOG_INFO("AI分析完成，函数名称: %1", functionName);
                 }
                 else
                 {
                     response.success = false;
                     response.errorMessage = "无法从AI响应中提取函数信息";
-                    Logger::instance().error(response.errorMessage);
+                    response.errorType = ProcessErrorType::AIResponseError;
+                    LOG_ERROR("%1", response.errorMessage);
                 }
             }
         }
     }
 
+    if (endpointIndex >= 0)
+    {
+        m_endpointPool->finish(endpointIndex, m_rateTickets.value(requestId),
+                               response.promptTokens + response.completionTokens, response.success,
+                               ErrorHandler::isEndpointError(response.errorType));
+        m_requestEndpoints.remove(requestId);
+
+        if (!response.success && tryFailover(requestId, endpointIndex, response))
+        {
+            m_rateTickets.remove(requestId);
+            m_estimatedPromptTokens.remove(requestId);
+            processQueue();
+            return;
+        }
+    }
+    m_failoverExcludes.remove(requestId);
+
+    if (m_requestFingerprints.contains(requestId))
+    {
+        m_flightLeaders.remove(m_requestFingerprints.take(requestId));
+    }
+
     if (m_pendingRequests.contains(requestId))
     {
         response.retryCount = m_pendingRequests.value(requestId).retryCount;
         response.functionName = m_pendingRequests.value(requestId).function.name;
         m_pendingRequests.remove(requestId);
     }
+    m_rateTickets.remove(requestId);
+    m_estimatedPromptTokens.remove(requestId);
 
-    AIConfig config = AIConfigManager::instance().getCurrentConfig();
+    if (response.success)
+    {
+        m_completedCount++;
+
+        if (m_latencySamples.size() < kLatencyWindow)
+        {
+            m_latencySamples.append(response.responseTime);
+        }
+        else
+        {
+            m_latencySamples[m_latencyCursor] = response.responseTime;
+            m_latencyCursor = (m_latencyCursor + 1) % kLatencyWindow;
+        }
+    }
+    else
+    {
+        m_failedCount++;
+    }
+
+    AIConfig config = (endpointIndex >= 0) ? m_endpointPool->endpointConfig(endpointIndex)
+                                           : AIConfigManager::instance().getCurrentConfig();
     response.aiModel = config.defaultModel;
     response.analyzeTime = QDateTime::currentDateTime();
 
@@ -367,7 +566,153 @@ void AIServiceManager::onReplyFinished(QNetworkReply* reply)
 
     emit analysisComplete(response.functionName, response.functionDescription);
 
+    completeFollowers(requestId, response);
+
     processQueue();
+
+    if (m_requestQueue.isEmpty() && m_activeRequests.isEmpty())
+    {
+        if (m_poolMode)
+        {
+            m_endpointPool->logSummary();
+        }
+        if (m_coalescedCount > 0)
+        {
+            LOG_INFO("相同内容的请求合并 %1 次", m_coalescedCount);
+        }
+        if (m_hedgesSent > 0)
+        {
+            LOG_INFO("对冲请求统计: 主请求 %1, 对冲副本 %2, 副本先返回 %3", m_primarySent, m_hedgesSent, m_hedgeWins);
+        }
+    }
+}
+
+void AIServiceManager::onHedgeDue(const QString& requestId)
+{
+    QMutexLocker locker(&m_mutex);
+
+    if (!m_hedgingEnabled || !m_activeRequests.contains(requestId) || m_hedges.contains(requestId) ||
+        !m_pendingRequests.contains(requestId))
+    {
+        return;
+    }
+
+    // 额外负载预算：对冲副本数不超过主请求数的budgetPercent%
+    if (static_cast<qint64>(m_hedgesSent + 1) * 100 > static_cast<qint64>(m_hedgeBudgetPercent) * m_primarySent)
+    {
+        return;
+    }
+
+    int estimatedTokens = m_estimatedPromptTokens.value(requestId) + kExpectedOutputTokens;
+    int primaryEndpoint = m_requestEndpoints.value(requestId, -1);
+
+    AIHedgeAttempt hedge;
+    hedge.endpointIndex = -1;
+    if (m_poolMode)
+    {
+        qint64 waitTime = 0;
+        hedge.endpointIndex = m_endpointPool->select(estimatedTokens, waitTime, primaryEndpoint);
+        if (hedge.endpointIndex < 0)
+        {
+            return;
+        }
+        hedge.ticket = m_endpointPool->begin(hedge.endpointIndex, estimatedTokens);
+    }
+    else
+    {
+        if (m_rateLimiter->acquireDelay(estimatedTokens) > 0)
+        {
+            return;
+        }
+        hedge.ticket = m_rateLimiter->reserve(estimatedTokens);
+    }
+
+    AIConfig config = (hedge.endpointIndex >= 0) ? m_endpointPool->endpointConfig(hedge.endpointIndex)
+                                                 : AIConfigManager::instance().getCurrentConfig();
+    const AIAnalysisRequest& request = m_pendingRequests[requestId];
+    hedge.reply = postRequest(config, buildFunctionPrompt(request.function));
+    m_hedges.insert(requestId, hedge);
+    m_hedgesSent++;
+
+    LOG_INFO("请求耗时超过p95，发送对冲副本，函数: %1，端点: %2", request.function.name, config.configName);
+}
+
+bool AIServiceManager::resolveHedge(QNetworkReply* reply, const QString& requestId, bool isHedge)
+{
+    AIHedgeAttempt hedge = m_hedges.take(requestId);
+    QNetworkReply* primary = m_activeRequests.value(requestId);
+    int primaryEndpoint = m_requestEndpoints.value(requestId, -1);
+    qint64 primaryTicket = m_rateTickets.value(requestId);
+    bool failed = reply->error() != QNetworkReply::NoError;
+    bool endpointError = failed && reply->error() != QNetworkReply::OperationCanceledError;
+
+    if (failed)
+    {
+        // 先返回的一份失败时丢弃它，由另一份决定最终结果
+        if (isHedge)
+        {
+            releaseAttempt(requestId, hedge.endpointIndex, hedge.ticket, endpointError);
+        }
+        else
+        {
+            releaseAttempt(requestId, primaryEndpoint, primaryTicket, endpointError);
+            m_activeRequests[requestId] = hedge.reply;
+            m_requestEndpoints[requestId] = hedge.endpointIndex;
+            m_rateTickets[requestId] = hedge.ticket;
+        }
+        reply->deleteLater();
+        return false;
+    }
+
+    // 先成功返回的一份被采用，中止另一份
+    QNetworkReply* loser = isHedge ? primary : hedge.reply;
+    disconnect(loser, nullptr, this, nullptr);
+    loser->abort();
+    loser->deleteLater();
+
+    if (isHedge)
+    {
+        releaseAttempt(requestId, primaryEndpoint, primaryTicket, false);
+        m_activeRequests[requestId] = reply;
+        m_requestEndpoints[requestId] = hedge.endpointIndex;
+        m_rateTickets[requestId] = hedge.ticket;
+        m_hedgeWins++;
+    }
+    else
+    {
+        releaseAttempt(requestId, hedge.endpointIndex, hedge.ticket, false);
+    }
+    return true;
+}
+
+void AIServiceManager::releaseAttempt(const QString& requestId, int endpointIndex, qint64 ticket, bool endpointError)
+{
+    int promptTokens = m_estimatedPromptTokens.value(requestId);
+    if (endpointIndex < 0)
+    {
+        m_rateLimiter->reconcile(ticket, promptTokens);
+    }
+    else if (endpointError)
+    {
+        m_endpointPool->finish(endpointIndex, ticket, promptTokens, false, true);
+    }
+    else
+    {
+        m_endpointPool->release(endpointIndex, ticket, promptTokens);
+    }
+}
+
+qint64 AIServiceManager::hedgeDelay() const
+{
+    if (m_latencySamples.size() < kMinLatencySamples)
+    {
+        return -1;
+    }
+
+    QVector<qint64> samples = m_latencySamples;
+    int p95Index = (samples.size() * 95) / 100;
+    std::nth_element(samples.begin(), samples.begin() + p95Index, samples.end());
+    return qMax(samples[p95Index], kMinHedgeDelayMs);
 }
 
 void AIServiceManager::onProcessQueue()
@@ -375,9 +720,8 @@ void AIServiceManager::onProcessQueue()
     processQueue();
 }
 
-QString AIServiceManager::buildRequestUrl() const
+QString AIServiceManager::buildRequestUrl(const AIConfig& config) const
 {
-    AIConfig config = AIConfigManager::instance().getCurrentConfig();
     QString url = config.baseUrl;
     if (!url.endsWith("/"))
     {
@@ -387,10 +731,8 @@ QString AIServiceManager::buildRequestUrl() const
     return url;
 }
 
-QJsonObject AIServiceManager::buildRequestJson(const QString& prompt) const
+QJsonObject AIServiceManager::buildRequestJson(const QString& prompt, const AIConfig& config) const
 {
-    AIConfig config = AIConfigManager::instance().getCurrentConfig();
-
     QJsonObject messageObj;
     messageObj["role"] = "user";
     messageObj["content"] = prompt;
@@ -450,7 +792,7 @@ bool AIServiceManager::extractFunctionInfo(const QString& aiResponse, QString& f
 
     if (jsonStart == -1 || jsonEnd == -1 || jsonEnd <= jsonStart)
     {
-        Logger::instance().error("AI响应中未找到有效的JSON对象");
+        LOG_ERROR("AI响应中未找到有效的JSON对象");
         return false;
     }
 
@@ -461,15 +803,14 @@ bool AIServiceManager::extractFunctionInfo(const QString& aiResponse, QString& f
 
     if (error.error != QJsonParseError::NoError)
     {
-        Logger::instance().error("解析AI响应JSON失败: " + error.errorString());
-        Logger::instance().error("JSON位置 " + QString::number(error.offset) +
-                                 " 附近内容: " + jsonStr.mid(qMax(0, error.offset - 50), 100));
+        LOG_ERROR("解析AI响应JSON失败: %1", error.errorString());
+        LOG_ERROR("JSON位置 %1 附近内容: %2", error.offset, jsonStr.mid(qMax(0, error.offset - 50), 100));
         return false;
     }
 
     if (!jsonDoc.isObject())
     {
-        Logger::instance().error("AI响应不是有效的JSON对象");
+        LOG_ERROR("AI响应不是有效的JSON对象");
         return false;
     }
 
@@ -482,7 +823,7 @@ bool AIServiceManager::extractFunctionInfo(const QString& aiResponse, QString& f
 
     if (functionName.isEmpty())
     {
-        Logger::instance().warning("AI响应中缺少function_name字段或为空");
+        LOG_WARNING("AI响应中缺少function_name字段或为空");
         functionName = "unknown_function";
     }
 
@@ -493,7 +834,7 @@ bool AIServiceManager::extractFunctionInfo(const QString& aiResponse, QString& f
 
     if (functionDescription.isEmpty())
     {
-        Logger::instance().warning("AI响应中缺少function_description字段或为空");
+        LOG_WARNING("AI响应中缺少function_description字段或为空");
         functionDescription = "暂无描述";
     }
 
@@ -546,58 +887,201 @@ void AIServiceManager::processQueue()
 {
     QMutexLocker locker(&m_mutex);
 
-    if (m_requestQueue.isEmpty())
+    // 端点池模式下由各端点的并发上限约束，总并发为各端点之和
+    int maxActive = m_poolMode ? m_endpointPool->totalCapacity() : m_maxConcurrentRequests;
+
+    while (!m_requestQueue.isEmpty() && m_activeRequests.size() < maxActive)
     {
-        if (m_processTimer->isActive())
+        const AIAnalysisRequest& next = m_requestQueue.head();
+        QString prompt = buildFunctionPrompt(next.function);
+        int estimatedTokens = TokenEstimator::estimateRequest(prompt, kExpectedOutputTokens);
+
+        qint64 waitTime = 0;
+        int endpointIndex = -1;
+        if (m_poolMode)
         {
-            m_processTimer->stop();
+            endpointIndex =
+                m_endpointPool->select(estimatedTokens, waitTime, m_failoverExcludes.value(next.requestId, -1));
         }
-        emit queueStatusChanged(getQueueStatus());
-        return;
+        else
+        {
+            waitTime = m_rateLimiter->acquireDelay(estimatedTokens);
+        }
+
+        // 端点池返回-1且waitTime<0表示所有端点并发已满，等待进行中的请求结束后再调度
+        if (waitTime > 0 || (m_poolMode && endpointIndex < 0))
+        {
+            if (waitTime > 0 && !m_processTimer->isActive())
+            {
+                m_processTimer->start(static_cast<int>(waitTime));
+            }
+            break;
+        }
+
+        sendRequest(m_requestQueue.dequeue(), prompt, estimatedTokens, endpointIndex);
     }
 
-    qint64 currentTime = QDateTime::currentMSecsSinceEpoch();
-    qint64 minInterval = 60000 / m_rateLimit;
+    if (m_requestQueue.isEmpty() && m_processTimer->isActive())
+    {
+        m_processTimer->stop();
+    }
 
-    if (currentTime - m_lastRequestTime < minInterval)
+    emit queueStatusChanged(getQueueStatus());
+}
+
+void AIServiceManager::sendRequest(const AIAnalysisRequest& request, const QString& prompt, int estimatedTokens,
+                                   int endpointIndex)
+{
+    AIConfig config = (endpointIndex >= 0) ? m_endpointPool->endpointConfig(endpointIndex)
+                                           : AIConfigManager::instance().getCurrentConfig();
+
+    QNetworkReply* reply = postRequest(config, prompt);
+
+    m_activeRequests[request.requestId] = reply;
+    m_requestStartTimes[request.requestId] = QDateTime::currentMSecsSinceEpoch();
+    m_rateTickets[request.requestId] = (endpointIndex >= 0) ? m_endpointPool->begin(endpointIndex, estimatedTokens)
+                                                            : m_rateLimiter->reserve(estimatedTokens);
+    m_estimatedPromptTokens[request.requestId] = estimatedTokens - kExpectedOutputTokens;
+    m_requestEndpoints[request.requestId] = endpointIndex;
+    m_primarySent++;
+
+    if (m_hedgingEnabled)
     {
-        qint64 waitTime = minInterval - (currentTime - m_lastRequestTime);
-        if (!m_processTimer->isActive())
+        qint64 delay = hedgeDelay();
+        if (delay > 0)
         {
-            m_processTimer->start(waitTime);
+            QString requestId = request.requestId;
+            QTimer::singleShot(delay, this, [this, requestId]() { onHedgeDue(requestId); });
         }
+    }
+
+    LOG_INFO("已发送AI分析请求，函数: %1，端点: %2，预估 %3 token", request.function.name, config.configName, estimatedTokens);
+}
+
+void AIServiceManager::enqueueRequest(const AIAnalysisRequest& request)
+{
+    const ExtractedFunction& func = request.function;
+
+    // 端点池模式下端点在发送时才选定（还可能故障转移或对冲到其他端点），
+    // 只有所有端点使用同一模型时，结果才与具体端点无关，可以合并
+    QString model = m_poolMode ? m_endpointPool->commonModel()
+                               : AIConfigManager::instance().getCurrentConfig().defaultModel;
+    if (model.isEmpty())
+    {
+        m_requestQueue.enqueue(request);
         return;
     }
 
-    sendRequest(m_requestQueue.dequeue());
+    QString fingerprint =
+        RequestFingerprint::compute(func.signature + "\n" + func.body, func.language, model, kFunctionPromptVersion);
+
+    QString leaderId = m_flightLeaders.value(fingerprint);
+    if (!leaderId.isEmpty())
+    {
+        m_flightFollowers[leaderId].append(request.requestId);
+        m_coalescedCount++;
+        LOG_INFO("函数 %1 与进行中的请求内容相同，等待其结果", func.name);
+        return;
+    }
+
+    m_flightLeaders.insert(fingerprint, request.requestId);
+    m_requestFingerprints.insert(request.requestId, fingerprint);
+    m_requestQueue.enqueue(request);
 }
 
-void AIServiceManager::sendRequest(const AIAnalysisRequest& request)
+void AIServiceManager::completeFollowers(const QString& leaderId, const AIAnalysisResponse& response)
 {
-    AIConfig config = AIConfigManager::instance().getCurrentConfig();
+    QStringList followers = m_flightFollowers.take(leaderId);
+    for (const QString& followerId : followers)
+    {
+        if (!m_pendingRequests.contains(followerId))
+        {
+            continue;
+        }
+
+        // 共享领头请求的分析结果，token已计入领头请求
+        AIAnalysisResponse followerResponse = response;
+        followerResponse.requestId = followerId;
+        followerResponse.functionName = m_pendingRequests.take(followerId).function.name;
+        followerResponse.promptTokens = 0;
+        followerResponse.completionTokens = 0;
+        followerResponse.responseTime = 0;
+
+        if (followerResponse.success)
+        {
+            m_completedCount++;
+        }
+        else
+        {
+            m_failedCount++;
+        }
 
-    QString prompt = buildFunctionPrompt(request.function);
+        emit functionAnalysisComplete(followerResponse);
+        emit analysisComplete(followerResponse.functionName, followerResponse.functionDescription);
+    }
+}
 
-    QUrl url(buildRequestUrl());
+QNetworkReply* AIServiceManager::postRequest(const AIConfig& config, const QString& prompt)
+{
+    QUrl url(buildRequestUrl(config));
     QNetworkRequest networkRequest(url);
     networkRequest.setHeader(QNetworkRequest::ContentTypeHeader, "application/json");
     networkRequest.setRawHeader("Authorization", QString("Bearer %1").arg(config.apiKey).toUtf8());
+    networkRequest.setTransferTimeout(m_timeoutMs);
 
-    QJsonObject jsonObj = buildRequestJson(prompt);
+    QJsonObject jsonObj = buildRequestJson(prompt, config);
     QJsonDocument jsonDoc(jsonObj);
-    QByteArray jsonData = jsonDoc.toJson();
+    QByteArray jsonData = jsonDoc.toJson(QJsonDocument::Compact);
 
     QNetworkReply* reply = m_networkManager->post(networkRequest, jsonData);
+    connect(reply, &QNetworkReply::finished, this, [this, reply]() { onReplyFinished(reply); });
+    return reply;
+}
 
-    m_activeRequests[request.requestId] = reply;
-    m_requestStartTimes[request.requestId] = QDateTime::currentMSecsSinceEpoch();
-    m_lastRequestTime = QDateTime::currentMSecsSinceEpoch();
+bool AIServiceManager::tryFailover(const QString& requestId, int failedEndpoint, const AIAnalysisResponse& response)
+{
+    if (!ErrorHandler::isEndpointError(response.errorType) || !m_pendingRequests.contains(requestId))
+    {
+        return false;
+    }
 
-    connect(reply, &QNetworkReply::finished, this, [this, reply]() { onReplyFinished(reply); });
+    // 每个请求最多在其他端点上各尝试一次
+    AIAnalysisRequest request = m_pendingRequests.value(requestId);
+    if (request.retryCount + 1 >= m_endpointPool->size())
+    {
+        return false;
+    }
 
-    m_timeoutTimer->start(m_timeoutMs);
+    request.retryCount++;
+    m_pendingRequests[requestId] = request;
+    m_failoverExcludes[requestId] = failedEndpoint;
+    m_requestQueue.prepend(request);
 
-    Logger::instance().info(QString("已发送AI分析请求，函数: %1").arg(request.function.name));
+    LOG_WARNING("端点 %1 请求失败，转移到其他端点重试: %2", m_endpointPool->endpointConfig(failedEndpoint).configName,
+                request.function.name);
+    return true;
+}
 
-    emit queueStatusChanged(getQueueStatus());
+void AIServiceManager::recordUsage(const QJsonObject& rootObj, const QString& requestId, const QString& aiResponse,
+                                   AIAnalysisResponse& response)
+{
+    QJsonObject usageObj = rootObj["usage"].toObject();
+    if (!usageObj.isEmpty())
+    {
+        response.promptTokens = usageObj["prompt_tokens"].toInt();
+        response.completionTokens = usageObj["completion_tokens"].toInt();
+    }
+    else
+    {
+        response.promptTokens = m_estimatedPromptTokens.value(requestId);
+        response.completionTokens = TokenEstimator::estimate(aiResponse);
+    }
+
+    m_tokensSent += response.promptTokens;
+    m_tokensReceived += response.completionTokens;
+
+    if (m_rateTickets.contains(requestId) && m_requestEndpoints.value(requestId, -1) < 0)
+    {
+        m_rateLimiter->reconcile(m_rateTickets.value(requestId), response.promptTokens + response.completionTokens);
+    }
 }
@@ -9,20 +9,39 @@
 #ifndef AISERVICEMANAGER_H
 #define AISERVICEMANAGER_H
 
+#include <QHash>
 #include <QJsonArray>
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QMap>
-#include <QMutex>
+#include <QRecursiveMutex>
 #include <QNetworkAccessManager>
 #include <QNetworkReply>
 #include <QObject>
 #include <QQueue>
 #include <QTimer>
+#include <QVector>
 #include "core/ai/aiconfigmanager.h"
+#include "core/ai/endpointpool.h"
 #include "core/models/batchconfig.h"
+#include "core/models/dualratelimiter.h"
 #include "core/models/extractedfunction.h"
 
+/**
+ * @brief 对冲副本
+ */
+struct AIHedgeAttempt
+{
+    QNetworkReply* reply;  ///< 副本的网络回复
+    int endpointIndex;     ///< 副本使用的端点索引
+    qint64 ticket;         ///< 副本的速率限制器登记凭据
+
+    /**
+     * @brief 默认构造函数
+     */
+    AIHedgeAttempt() : reply(nullptr), endpointIndex(-1), ticket(0) {}
+};
+
 class AIServiceManager : public QObject
 {
     Q_OBJECT
@@ -55,6 +74,12 @@ class AIServiceManager : public QObject
      */
     void analyzeFunctions(const QVector<ExtractedFunction>& functions);
 
+    /**
+     * @brief 开始新的一次运行：重置请求数、token数、对冲和合并统计
+     * @details analyzeFunctions 会自动调用；逐个调用 analyzeFunction 的调用方在开始一批请求前调用
+     */
+    void beginRun();
+
     /**
      * @brief 取消当前的分析请求
      */
@@ -77,6 +102,48 @@ class AIServiceManager : public QObject
      */
     void setRateLimit(int requestsPerMinute);
 
+    /**
+     * @brief 设置token速率限制
+     * @param tokensPerMinute 每分钟token数（0表示不限制）
+     */
+    void setTokenRateLimit(int tokensPerMinute);
+
+    /**
+     * @brief 设置最大并发请求数
+     * @param maxConcurrent 最大并发请求数（至少为1）
+     */
+    void setMaxConcurrentRequests(int maxConcurrent);
+
+    /**
+     * @brief 获取共享的速率限制器，供其他直接访问AI服务的模块共用同一份RPM/TPM预算
+     * @return 速率限制器指针
+     */
+    DualRateLimiter* rateLimiter() const;
+
+    /**
+     * @brief 启用端点池模式，请求按加权最少未完成数分配到多个AI配置
+     * @param configNames 参与分配的AI配置名称；为空时关闭端点池模式，恢复使用当前配置
+     * @param breakerConfig 各端点熔断器的失败阈值和冷却时间
+     * @return 实际加入端点池的端点数；仍有进行中的请求时不做修改并返回-1
+     */
+    int setEndpointPool(const QStringList& configNames,
+                        const BatchProcessConfig& breakerConfig = BatchProcessConfig());
+
+    /**
+     * @brief 是否处于端点池模式
+     * @return 是否处于端点池模式
+     */
+    bool isPoolMode() const;
+
+    /**
+     * @brief 设置对冲请求
+     * @details 请求耗时超过近期成功响应的p95后，向同一或其他端点发送一份副本，
+     *          采用先成功返回的结果并中止另一份；副本数量受额外负载预算约束
+     * @param enabled 是否启用
+     * @param budgetPercent 对冲副本数占主请求数的上限（百分比）
+     */
+    void setHedging(bool enabled, int budgetPercent = 5);
+
     /**
      * @brief 设置请求超时时间
      * @param timeoutMs 超时时间（毫秒）
@@ -128,9 +195,10 @@ class AIServiceManager : public QObject
     void onProcessQueue();
 
     /**
-     * @brief 请求超时槽函数
+     * @brief 对冲延迟到期槽函数，请求仍未完成时发送副本
+     * @param requestId 请求ID
      */
-    void onRequestTimeout();
+    void onHedgeDue(const QString& requestId);
 
    private:
     /**
@@ -146,16 +214,18 @@ class AIServiceManager : public QObject
 
     /**
      * @brief 构建请求URL
+     * @param config 目标端点的AI配置
      * @return 请求URL字符串
      */
-    QString buildRequestUrl() const;
+    QString buildRequestUrl(const AIConfig& config) const;
 
     /**
      * @brief 构建请求JSON对象
      * @param prompt 请求提示词
+     * @param config 目标端点的AI配置
      * @return 请求JSON对象
      */
-    QJsonObject buildRequestJson(const QString& prompt) const;
+    QJsonObject buildRequestJson(const QString& prompt, const AIConfig& config) const;
 
     /**
      * @brief 解析响应JSON
@@ -188,24 +258,114 @@ class AIServiceManager : public QObject
     /**
      * @brief 发送请求
      * @param request 请求
+     * @param prompt 请求提示词
+     * @param estimatedTokens 估算的token占用
+     * @param endpointIndex 端点池中的端点索引，-1表示使用当前配置
+     */
+    void sendRequest(const AIAnalysisRequest& request, const QString& prompt, int estimatedTokens, int endpointIndex);
+
+    /**
+     * @brief 将请求加入队列；已有相同内容的请求在排队或进行中时，改为等待其结果
+     * @details 合并键包含模型；端点池中各端点使用不同模型时无法在入队时确定模型，不合并
+     * @param request 请求
+     */
+    void enqueueRequest(const AIAnalysisRequest& request);
+
+    /**
+     * @brief 将领头请求的结果分发给等待同一结果的请求
+     * @param leaderId 领头请求ID
+     * @param response 领头请求的响应
+     */
+    void completeFollowers(const QString& leaderId, const AIAnalysisResponse& response);
+
+    /**
+     * @brief 构建并发送HTTP请求
+     * @param config 目标端点的AI配置
+     * @param prompt 请求提示词
+     * @return 网络回复对象
+     */
+    QNetworkReply* postRequest(const AIConfig& config, const QString& prompt);
+
+    /**
+     * @brief 释放一次未被采用的请求尝试占用的速率和端点配额
+     * @param requestId 请求ID
+     * @param endpointIndex 端点索引，-1表示当前配置
+     * @param ticket 速率限制器登记凭据
+     * @param endpointError 是否因端点异常失败（计入端点熔断器）
      */
-    void sendRequest(const AIAnalysisRequest& request);
+    void releaseAttempt(const QString& requestId, int endpointIndex, qint64 ticket, bool endpointError);
 
-    mutable QMutex m_mutex;
+    /**
+     * @brief 处理对冲中的请求的某一份回复
+     * @param reply 完成的回复
+     * @param requestId 请求ID
+     * @param isHedge 是否为对冲副本
+     * @return 返回true表示该回复被采用，继续按正常流程处理；false表示已处理完毕
+     */
+    bool resolveHedge(QNetworkReply* reply, const QString& requestId, bool isHedge);
+
+    /**
+     * @brief 计算当前对冲延迟（近期成功响应耗时的p95）
+     * @return 延迟（毫秒），样本不足时返回-1
+     */
+    qint64 hedgeDelay() const;
+
+    /**
+     * @brief 端点池模式下尝试将失败请求转移到其他端点
+     * @param requestId 请求ID
+     * @param failedEndpoint 失败的端点索引
+     * @param response 失败的响应
+     * @return 已重新入队返回true，调用方不再上报该失败
+     */
+    bool tryFailover(const QString& requestId, int failedEndpoint, const AIAnalysisResponse& response);
+
+    /**
+     * @brief 从响应中读取usage并更新token统计
+     * @param rootObj 响应JSON根对象
+     * @param requestId 请求ID
+     * @param aiResponse AI响应内容（usage缺失时用于估算）
+     * @param response 输出参数，写入token数
+     */
+    void recordUsage(const QJsonObject& rootObj, const QString& requestId, const QString& aiResponse,
+                     AIAnalysisResponse& response);
+
+    mutable QRecursiveMutex m_mutex;
     QNetworkAccessManager* m_networkManager;
 
     QQueue<AIAnalysisRequest> m_requestQueue;
     QMap<QString, QNetworkReply*> m_activeRequests;
     QMap<QString, AIAnalysisRequest> m_pendingRequests;
     QMap<QString, qint64> m_requestStartTimes;
-
-    int m_rateLimit;
-    qint64 m_lastRequestTime;
+    QMap<QString, qint64> m_rateTickets;
+    QMap<QString, int> m_estimatedPromptTokens;
+    QMap<QString, int> m_requestEndpoints;
+    QMap<QString, int> m_failoverExcludes;
+
+    QMap<QString, AIHedgeAttempt> m_hedges;
+    QHash<QString, QString> m_flightLeaders;
+    QMap<QString, QString> m_requestFingerprints;
+    QMap<QString, QStringList> m_flightFollowers;
+    int m_coalescedCount;
+    QVector<qint64> m_latencySamples;
+    int m_latencyCursor;
+    bool m_hedgingEnabled;
+    int m_hedgeBudgetPercent;
+    int m_primarySent;
+    int m_hedgesSent;
+    int m_hedgeWins;
+
+    DualRateLimiter* m_rateLimiter;
+    EndpointPool* m_endpointPool;
+    bool m_poolMode;
+    int m_maxConcurrentRequests;
     QTimer* m_processTimer;
-    QTimer* m_timeoutTimer;
     int m_timeoutMs;
 
     QDateTime m_startTime;
+    int m_completedCount;
+    int m_failedCount;
+    qint64 m_tokensSent;
+    qint64 m_tokensReceived;
 };
 
 #endif
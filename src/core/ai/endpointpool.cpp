@@ -0,0 +1,277 @@
+/**
+ * @file endpointpool.cpp
+ * @brief AI服务端点池实现
+ * @author Developer
+ * @date 2026-10-18
+ * @version 1.0
+ */
+
+#include "core/ai/endpointpool.h"
+#include <algorithm>
+#include "common/logger/logger.h"
+
+EndpointPool::EndpointPool(QObject* parent) : QObject(parent) {}
+
+int EndpointPool::setEndpoints(const QVector<AIConfig>& configs, int breakerFailureThreshold,
+                               int breakerOpenDuration)
+{
+    QMutexLocker locker(&m_mutex);
+
+    if (hasOutstanding())
+    {
+        Logger::instance().warning("端点池仍有进行中的请求，拒绝重建");
+        return -1;
+    }
+    deleteEndpoints();
+
+    for (const AIConfig& config : configs)
+    {
+        if (config.baseUrl.isEmpty() || config.apiKey.isEmpty() || config.defaultModel.isEmpty())
+        {
+            Logger::instance().warning("端点池忽略不完整的AI配置: " + config.configName);
+            continue;
+        }
+
+        PoolEndpoint endpoint;
+        endpoint.config = config;
+        endpoint.config.poolWeight = qMax(1, config.poolWeight);
+        endpoint.config.maxConcurrent = qMax(1, config.maxConcurrent);
+        endpoint.limiter = new DualRateLimiter(config.requestsPerMinute, config.tokensPerMinute, this);
+        endpoint.breaker = new CircuitBreaker(config.configName, breakerFailureThreshold, breakerOpenDuration, this);
+        m_endpoints.append(endpoint);
+
+        Logger::instance().info(QString("端点池加入端点: %1 (权重 %2, 并发 %3, RPM %4, TPM %5)")
+                                    .arg(config.configName)
+                                    .arg(endpoint.config.poolWeight)
+                                    .arg(endpoint.config.maxConcurrent)
+                                    .arg(config.requestsPerMinute)
+                                    .arg(config.tokensPerMinute));
+    }
+
+    return m_endpoints.size();
+}
+
+bool EndpointPool::clear()
+{
+    QMutexLocker locker(&m_mutex);
+
+    if (hasOutstanding())
+    {
+        Logger::instance().warning("端点池仍有进行中的请求，拒绝清空");
+        return false;
+    }
+    deleteEndpoints();
+    return true;
+}
+
+int EndpointPool::size() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_endpoints.size();
+}
+
+int EndpointPool::totalCapacity() const
+{
+    QMutexLocker locker(&m_mutex);
+
+    int capacity = 0;
+    for (const PoolEndpoint& endpoint : m_endpoints)
+    {
+        capacity += endpoint.config.maxConcurrent;
+    }
+    return capacity;
+}
+
+int EndpointPool::select(int estimatedTokens, qint64& waitTime, int excludeIndex)
+{
+    QMutexLocker locker(&m_mutex);
+
+    waitTime = -1;
+
+    QVector<int> candidates;
+    for (int i = 0; i < m_endpoints.size(); ++i)
+    {
+        const PoolEndpoint& endpoint = m_endpoints[i];
+        if (endpoint.outstanding >= endpoint.config.maxConcurrent)
+        {
+            continue;
+        }
+
+        qint64 delay = qMax(endpoint.limiter->acquireDelay(estimatedTokens), endpoint.breaker->remainingOpenTime());
+        if (delay > 0)
+        {
+            waitTime = (waitTime < 0) ? delay : qMin(waitTime, delay);
+            continue;
+        }
+
+        if (i == excludeIndex && m_endpoints.size() > 1)
+        {
+            continue;
+        }
+        candidates.append(i);
+    }
+
+    // outstanding / weight 最小者优先；交叉相乘避免浮点比较
+    std::sort(candidates.begin(), candidates.end(),
+              [this](int a, int b)
+              {
+                  const PoolEndpoint& ea = m_endpoints[a];
+                  const PoolEndpoint& eb = m_endpoints[b];
+                  qint64 lhs = static_cast<qint64>(ea.outstanding) * eb.config.poolWeight;
+                  qint64 rhs = static_cast<qint64>(eb.outstanding) * ea.config.poolWeight;
+                  if (lhs != rhs)
+                  {
+                      return lhs < rhs;
+                  }
+                  return ea.config.poolWeight > eb.config.poolWeight;
+              });
+
+    for (int index : candidates)
+    {
+        // 半开状态的熔断器只放行一个探测请求，未被放行时继续尝试下一个端点
+        if (m_endpoints[index].breaker->allowRequest())
+        {
+            return index;
+        }
+    }
+
+    return -1;
+}
+
+qint64 EndpointPool::begin(int index, int estimatedTokens)
+{
+    QMutexLocker locker(&m_mutex);
+
+    if (index < 0 || index >= m_endpoints.size())
+    {
+        return 0;
+    }
+
+    PoolEndpoint& endpoint = m_endpoints[index];
+    endpoint.outstanding++;
+    return endpoint.limiter->reserve(estimatedTokens);
+}
+
+void EndpointPool::finish(int index, qint64 ticket, int actualTokens, bool success, bool endpointError)
+{
+    QMutexLocker locker(&m_mutex);
+
+    if (index < 0 || index >= m_endpoints.size())
+    {
+        return;
+    }
+
+    PoolEndpoint& endpoint = m_endpoints[index];
+    endpoint.outstanding = qMax(0, endpoint.outstanding - 1);
+    endpoint.limiter->reconcile(ticket, actualTokens);
+
+    if (success)
+    {
+        endpoint.completedCount++;
+        endpoint.breaker->recordSuccess();
+    }
+    else
+    {
+        endpoint.failedCount++;
+        if (endpointError)
+        {
+            endpoint.breaker->recordFailure();
+        }
+        else
+        {
+            // 响应内容错误说明端点本身可达
+            endpoint.breaker->recordSuccess();
+        }
+    }
+}
+
+void EndpointPool::release(int index, qint64 ticket, int actualTokens)
+{
+    QMutexLocker locker(&m_mutex);
+
+    if (index < 0 || index >= m_endpoints.size())
+    {
+        return;
+    }
+
+    PoolEndpoint& endpoint = m_endpoints[index];
+    endpoint.outstanding = qMax(0, endpoint.outstanding - 1);
+    endpoint.limiter->reconcile(ticket, actualTokens);
+}
+
+void EndpointPool::backoff(int index, qint64 milliseconds)
+{
+    QMutexLocker locker(&m_mutex);
+
+    if (index >= 0 && index < m_endpoints.size())
+    {
+        m_endpoints[index].limiter->backoff(milliseconds);
+    }
+}
+
+AIConfig EndpointPool::endpointConfig(int index) const
+{
+    QMutexLocker locker(&m_mutex);
+
+    if (index < 0 || index >= m_endpoints.size())
+    {
+        return AIConfig();
+    }
+    return m_endpoints[index].config;
+}
+
+QString EndpointPool::commonModel() const
+{
+    QMutexLocker locker(&m_mutex);
+
+    if (m_endpoints.isEmpty())
+    {
+        return QString();
+    }
+
+    const QString& model = m_endpoints.first().config.defaultModel;
+    for (const PoolEndpoint& endpoint : m_endpoints)
+    {
+        if (endpoint.config.defaultModel != model)
+        {
+            return QString();
+        }
+    }
+    return model;
+}
+
+void EndpointPool::logSummary() const
+{
+    QMutexLocker locker(&m_mutex);
+
+    for (const PoolEndpoint& endpoint : m_endpoints)
+    {
+        Logger::instance().info(QString("端点 %1: 成功 %2, 失败 %3, 熔断器%4")
+                                    .arg(endpoint.config.configName)
+                                    .arg(endpoint.completedCount)
+                                    .arg(endpoint.failedCount)
+                                    .arg(CircuitBreaker::stateToString(endpoint.breaker->state())));
+    }
+}
+
+bool EndpointPool::hasOutstanding() const
+{
+    for (const PoolEndpoint& endpoint : m_endpoints)
+    {
+        if (endpoint.outstanding > 0)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+void EndpointPool::deleteEndpoints()
+{
+    for (PoolEndpoint& endpoint : m_endpoints)
+    {
+        delete endpoint.limiter;
+        delete endpoint.breaker;
+    }
+    m_endpoints.clear();
+}
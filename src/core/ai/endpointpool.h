@@ -0,0 +1,163 @@
+/**
+ * @file endpointpool.h
+ * @brief AI服务端点池，在多个AI配置（端点或密钥）之间分配请求
+ * @author Developer
+ * @date 2026-10-18
+ * @version 1.0
+ */
+
+#ifndef ENDPOINTPOOL_H
+#define ENDPOINTPOOL_H
+
+#include <QMutex>
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include "core/models/aiconfig.h"
+#include "core/models/circuitbreaker.h"
+#include "core/models/dualratelimiter.h"
+
+/**
+ * @brief 端点池中的单个端点
+ */
+struct PoolEndpoint
+{
+    AIConfig config;           ///< 端点对应的AI配置
+    DualRateLimiter* limiter;  ///< 端点独立的RPM/TPM限制器
+    CircuitBreaker* breaker;   ///< 端点独立的熔断器
+    int outstanding;           ///< 进行中的请求数
+    int completedCount;        ///< 成功请求数
+    int failedCount;           ///< 失败请求数
+
+    /**
+     * @brief 默认构造函数
+     */
+    PoolEndpoint() : limiter(nullptr), breaker(nullptr), outstanding(0), completedCount(0), failedCount(0) {}
+};
+
+/**
+ * @brief AI服务端点池类
+ *
+ * @details 路由规则（加权最少未完成请求）：
+ * - 跳过并发已满、速率预算不足或熔断器打开的端点
+ * - 在剩余端点中选择 outstanding / weight 最小者，相同时优先权重大的端点
+ * 每个端点拥有独立的限制器和熔断器，总吞吐为各端点配额之和。
+ */
+class EndpointPool : public QObject
+{
+    Q_OBJECT
+
+   public:
+    /**
+     * @brief 构造函数
+     * @param parent 父对象
+     */
+    explicit EndpointPool(QObject* parent = nullptr);
+
+    /**
+     * @brief 用一组AI配置重建端点池
+     * @details 进行中的请求以端点索引登记，重建后索引会指向其他端点，因此仍有请求未结束时拒绝重建
+     * @param configs AI配置列表，无效配置会被忽略
+     * @param breakerFailureThreshold 各端点熔断器的连续失败阈值
+     * @param breakerOpenDuration 各端点熔断器打开后的冷却时间（毫秒）
+     * @return 实际加入的端点数；仍有进行中的请求时不做修改并返回-1
+     */
+    int setEndpoints(const QVector<AIConfig>& configs, int breakerFailureThreshold, int breakerOpenDuration);
+
+    /**
+     * @brief 清空端点池
+     * @return 是否成功；仍有进行中的请求时不做修改并返回false
+     */
+    bool clear();
+
+    /**
+     * @brief 获取端点数量
+     * @return 端点数量
+     */
+    int size() const;
+
+    /**
+     * @brief 获取所有端点的并发上限之和
+     * @return 并发上限之和
+     */
+    int totalCapacity() const;
+
+    /**
+     * @brief 选择一个可用端点
+     * @param estimatedTokens 请求估算的token占用
+     * @param waitTime 输出参数，无可用端点时最早可用的等待时间（毫秒）；
+     *                 所有端点都因并发已满而不可用时为-1，表示等待请求完成
+     * @param excludeIndex 需要避开的端点（故障转移时传入上次失败的端点），-1表示不排除
+     * @return 端点索引，无可用端点返回-1
+     */
+    int select(int estimatedTokens, qint64& waitTime, int excludeIndex = -1);
+
+    /**
+     * @brief 登记即将发送到端点的请求
+     * @param index 端点索引
+     * @param estimatedTokens 估算的token占用
+     * @return 速率限制器登记凭据
+     */
+    qint64 begin(int index, int estimatedTokens);
+
+    /**
+     * @brief 登记请求结束
+     * @param index 端点索引
+     * @param ticket begin()返回的凭据
+     * @param actualTokens 实际消耗的token数
+     * @param success 请求是否成功
+     * @param endpointError 失败是否由端点异常引起（计入熔断器）
+     */
+    void finish(int index, qint64 ticket, int actualTokens, bool success, bool endpointError);
+
+    /**
+     * @brief 释放被主动中止的请求（如对冲请求中落败的一方），不计入成功或失败
+     * @param index 端点索引
+     * @param ticket begin()返回的凭据
+     * @param actualTokens 已消耗的token数（通常为提示词token数）
+     */
+    void release(int index, qint64 ticket, int actualTokens);
+
+    /**
+     * @brief 端点返回429时暂停该端点
+     * @param index 端点索引
+     * @param milliseconds 暂停时长（毫秒）
+     */
+    void backoff(int index, qint64 milliseconds);
+
+    /**
+     * @brief 获取端点配置
+     * @param index 端点索引
+     * @return AI配置
+     */
+    AIConfig endpointConfig(int index) const;
+
+    /**
+     * @brief 获取所有端点共同使用的模型
+     * @return 模型名称；端点使用不同模型或端点池为空时返回空字符串
+     */
+    QString commonModel() const;
+
+    /**
+     * @brief 输出各端点的请求统计到日志
+     */
+    void logSummary() const;
+
+   private:
+    /**
+     * @brief 是否有进行中的请求（调用方须已持有锁）
+     * @return 是否有进行中的请求
+     */
+    bool hasOutstanding() const;
+
+    /**
+     * @brief 释放所有端点（调用方须已持有锁）
+     */
+    void deleteEndpoints();
+
+    mutable QMutex m_mutex;             ///< 互斥锁
+    QVector<PoolEndpoint> m_endpoints;  ///< 端点列表
+};
+
+#endif  // ENDPOINTPOOL_H
@@ -0,0 +1,332 @@
+/**
+ * @file recordingnetworkmanager.cpp
+ * @brief 支持录制与回放的网络访问管理器实现
+ * @author Developer
+ * @date 2026-10-18
+ * @version 1.0
+ */
+
+#include "core/ai/recordingnetworkmanager.h"
+#include <cstring>
+#include "common/logger/logger.h"
+
+namespace
+{
+/**
+ * @brief 获取请求方法名
+ * @param op 请求操作
+ * @param request 网络请求
+ * @return 请求方法名
+ */
+QByteArray operationVerb(QNetworkAccessManager::Operation op, const QNetworkRequest& request)
+{
+    switch (op)
+    {
+        case QNetworkAccessManager::HeadOperation:
+            return "HEAD";
+        case QNetworkAccessManager::GetOperation:
+            return "GET";
+        case QNetworkAccessManager::PutOperation:
+            return "PUT";
+        case QNetworkAccessManager::PostOperation:
+            return "POST";
+        case QNetworkAccessManager::DeleteOperation:
+            return "DELETE";
+        default:
+            return request.attribute(QNetworkRequest::CustomVerbAttribute).toByteArray();
+    }
+}
+}  // namespace
+
+RecordingNetworkManager::RecordingNetworkManager(QObject* parent) : QNetworkAccessManager(parent) {}
+
+QNetworkReply* RecordingNetworkManager::createRequest(Operation op, const QNetworkRequest& request,
+                                                      QIODevice* outgoingData)
+{
+    ResponseRecorder& recorder = ResponseRecorder::instance();
+    RecorderMode mode = recorder.mode();
+    if (mode == RecorderMode::Off)
+    {
+        return QNetworkAccessManager::createRequest(op, request, outgoingData);
+    }
+
+    // peek不移动读取位置，请求体仍可被真实请求完整发送
+    QByteArray body = outgoingData ? outgoingData->peek(outgoingData->bytesAvailable()) : QByteArray();
+    QString key = ResponseRecorder::requestKey(operationVerb(op, request), request.url().path(), body);
+
+    if (mode == RecorderMode::Record)
+    {
+        QNetworkReply* inner = QNetworkAccessManager::createRequest(op, request, outgoingData);
+        return new RecordingReply(inner, key, this);
+    }
+
+    RecordedResponse record;
+    bool found = recorder.lookup(key, record);
+    if (!found)
+    {
+        Logger::instance().warning("回放文件中没有匹配的请求: " + request.url().toString());
+    }
+    return new ReplayReply(op, request, record, found, recorder.replaySpeed(), this);
+}
+
+RecordingReply::RecordingReply(QNetworkReply* inner, const QString& key, QObject* parent)
+    : QNetworkReply(parent), m_inner(inner)
+{
+    m_inner->setParent(this);
+    setRequest(m_inner->request());
+    setOperation(m_inner->operation());
+    setUrl(m_inner->url());
+    open(QIODevice::ReadOnly | QIODevice::Unbuffered);
+
+    m_record.key = key;
+    m_clock.start();
+
+    connect(m_inner, &QNetworkReply::metaDataChanged, this,
+            [this]()
+            {
+                copyMetaData();
+                m_record.headersAtMs = m_clock.elapsed();
+                emit metaDataChanged();
+            });
+
+    connect(m_inner, &QNetworkReply::readyRead, this,
+            [this]()
+            {
+                QByteArray data = m_inner->readAll();
+                if (data.isEmpty())
+                {
+                    return;
+                }
+
+                RecordedChunk chunk;
+                chunk.offsetMs = m_clock.elapsed();
+                chunk.data = data;
+                m_record.chunks.append(chunk);
+
+                m_buffer.append(data);
+                emit readyRead();
+            });
+
+    connect(m_inner, &QNetworkReply::errorOccurred, this,
+            [this](QNetworkReply::NetworkError code)
+            {
+                setError(code, m_inner->errorString());
+                emit errorOccurred(code);
+            });
+
+    connect(m_inner, &QNetworkReply::finished, this,
+            [this]()
+            {
+                copyMetaData();
+
+                QByteArray rest = m_inner->readAll();
+                if (!rest.isEmpty())
+                {
+                    RecordedChunk chunk;
+                    chunk.offsetMs = m_clock.elapsed();
+                    chunk.data = rest;
+                    m_record.chunks.append(chunk);
+                    m_buffer.append(rest);
+                }
+
+                m_record.finishedAtMs = m_clock.elapsed();
+                QNetworkReply::NetworkError code = m_inner->error();
+                m_record.networkError = code;
+                m_record.errorString = (code == QNetworkReply::NoError) ? QString() : m_inner->errorString();
+
+                // 被主动中止的请求（取消、对冲落败）不代表服务端的行为，不录制
+                if (code != QNetworkReply::OperationCanceledError)
+                {
+                    ResponseRecorder::instance().append(m_record);
+                }
+
+                setFinished(true);
+                emit readChannelFinished();
+                emit finished();
+            });
+}
+
+void RecordingReply::abort()
+{
+    m_inner->abort();
+}
+
+qint64 RecordingReply::bytesAvailable() const
+{
+    return m_buffer.size() + QNetworkReply::bytesAvailable();
+}
+
+bool RecordingReply::isSequential() const
+{
+    return true;
+}
+
+qint64 RecordingReply::readData(char* data, qint64 maxSize)
+{
+    if (m_buffer.isEmpty())
+    {
+        return isFinished() ? -1 : 0;
+    }
+
+    qint64 size = qMin<qint64>(maxSize, m_buffer.size());
+    std::memcpy(data, m_buffer.constData(), static_cast<size_t>(size));
+    m_buffer.remove(0, size);
+    return size;
+}
+
+void RecordingReply::copyMetaData()
+{
+    QVariant status = m_inner->attribute(QNetworkRequest::HttpStatusCodeAttribute);
+    if (!status.isValid())
+    {
+        return;
+    }
+
+    setAttribute(QNetworkRequest::HttpStatusCodeAttribute, status);
+    setAttribute(QNetworkRequest::HttpReasonPhraseAttribute,
+                 m_inner->attribute(QNetworkRequest::HttpReasonPhraseAttribute));
+
+    m_record.httpStatus = status.toInt();
+    m_record.reasonPhrase = m_inner->attribute(QNetworkRequest::HttpReasonPhraseAttribute).toByteArray();
+    m_record.headers = m_inner->rawHeaderPairs();
+    for (const auto& header : m_record.headers)
+    {
+        setRawHeader(header.first, header.second);
+    }
+}
+
+ReplayReply::ReplayReply(QNetworkAccessManager::Operation op, const QNetworkRequest& request,
+                         const RecordedResponse& record, bool found, double speed, QObject* parent)
+    : QNetworkReply(parent), m_record(record), m_speed(speed), m_timer(new QTimer(this)), m_step(0)
+{
+    setRequest(request);
+    setOperation(op);
+    setUrl(request.url());
+    open(QIODevice::ReadOnly | QIODevice::Unbuffered);
+
+    if (!found)
+    {
+        m_record = RecordedResponse();
+        m_record.networkError = QNetworkReply::ContentNotFoundError;
+        m_record.errorString = "回放文件中没有匹配的请求";
+    }
+
+    m_timer->setSingleShot(true);
+    connect(m_timer, &QTimer::timeout, this, &ReplayReply::onStep);
+
+    // 调用方在post()返回后才连接信号，第一个事件必须异步发出
+    m_clock.start();
+    scheduleNext();
+}
+
+void ReplayReply::abort()
+{
+    if (isFinished())
+    {
+        return;
+    }
+
+    m_timer->stop();
+    setError(QNetworkReply::OperationCanceledError, "Operation canceled");
+    emit errorOccurred(QNetworkReply::OperationCanceledError);
+    setFinished(true);
+    emit finished();
+}
+
+qint64 ReplayReply::bytesAvailable() const
+{
+    return m_buffer.size() + QNetworkReply::bytesAvailable();
+}
+
+bool ReplayReply::isSequential() const
+{
+    return true;
+}
+
+qint64 ReplayReply::readData(char* data, qint64 maxSize)
+{
+    if (m_buffer.isEmpty())
+    {
+        return isFinished() ? -1 : 0;
+    }
+
+    qint64 size = qMin<qint64>(maxSize, m_buffer.size());
+    std::memcpy(data, m_buffer.constData(), static_cast<size_t>(size));
+    m_buffer.remove(0, size);
+    return size;
+}
+
+void ReplayReply::onStep()
+{
+    const int chunkCount = m_record.chunks.size();
+
+    // 事件处理中调用方可能中止应答，每个事件后都要检查是否已结束
+    while (!isFinished() && m_step <= chunkCount + 1)
+    {
+        if (scaled(stepOffset(m_step)) > m_clock.elapsed())
+        {
+            scheduleNext();
+            return;
+        }
+
+        int step = m_step++;
+        if (step == 0)
+        {
+            if (m_record.httpStatus > 0)
+            {
+                setAttribute(QNetworkRequest::HttpStatusCodeAttribute, m_record.httpStatus);
+                setAttribute(QNetworkRequest::HttpReasonPhraseAttribute, m_record.reasonPhrase);
+                for (const auto& header : m_record.headers)
+                {
+                    setRawHeader(header.first, header.second);
+                }
+                emit metaDataChanged();
+            }
+        }
+        else if (step <= chunkCount)
+        {
+            m_buffer.append(m_record.chunks[step - 1].data);
+            emit readyRead();
+        }
+        else
+        {
+            if (m_record.networkError != QNetworkReply::NoError)
+            {
+                auto code = static_cast<QNetworkReply::NetworkError>(m_record.networkError);
+                setError(code, m_record.errorString);
+                emit errorOccurred(code);
+            }
+            setFinished(true);
+            emit readChannelFinished();
+            emit finished();
+        }
+    }
+}
+
+void ReplayReply::scheduleNext()
+{
+    qint64 delay = qMax<qint64>(0, scaled(stepOffset(m_step)) - m_clock.elapsed());
+    m_timer->start(static_cast<int>(delay));
+}
+
+qint64 ReplayReply::stepOffset(int step) const
+{
+    if (step == 0)
+    {
+        return m_record.headersAtMs;
+    }
+    if (step <= m_record.chunks.size())
+    {
+        return m_record.chunks[step - 1].offsetMs;
+    }
+    return m_record.finishedAtMs;
+}
+
+qint64 ReplayReply::scaled(qint64 offsetMs) const
+{
+    if (m_speed <= 0.0)
+    {
+        return 0;
+    }
+    return static_cast<qint64>(offsetMs / m_speed);
+}
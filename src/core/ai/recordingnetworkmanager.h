@@ -0,0 +1,183 @@
+/**
+ * @file recordingnetworkmanager.h
+ * @brief 支持录制与回放的网络访问管理器
+ * @author Developer
+ * @date 2026-10-18
+ * @version 1.0
+ *
+ * @details 根据ResponseRecorder的当前模式创建应答：
+ * - Off：直接返回真实的网络应答
+ * - Record：返回包装真实应答的RecordingReply，透传数据的同时记录时间和内容
+ * - Replay：返回ReplayReply，按录制的时间偏移（除以回放速度）重新发出响应头、数据块和错误
+ * 对调用方而言三种应答的信号和读取方式完全一致，SSE解析、JSON解码等CPU侧代码不需要区分。
+ */
+
+#ifndef RECORDINGNETWORKMANAGER_H
+#define RECORDINGNETWORKMANAGER_H
+
+#include <QElapsedTimer>
+#include <QNetworkAccessManager>
+#include <QNetworkReply>
+#include <QTimer>
+#include "core/ai/responserecorder.h"
+
+/**
+ * @brief 支持录制与回放的网络访问管理器类
+ */
+class RecordingNetworkManager : public QNetworkAccessManager
+{
+    Q_OBJECT
+
+   public:
+    /**
+     * @brief 构造函数
+     * @param parent 父对象
+     */
+    explicit RecordingNetworkManager(QObject* parent = nullptr);
+
+   protected:
+    /**
+     * @brief 创建网络应答
+     * @param op 请求操作
+     * @param request 网络请求
+     * @param outgoingData 请求体
+     * @return 网络应答
+     */
+    QNetworkReply* createRequest(Operation op, const QNetworkRequest& request, QIODevice* outgoingData) override;
+};
+
+/**
+ * @brief 录制应答类，包装真实应答并记录响应
+ */
+class RecordingReply : public QNetworkReply
+{
+    Q_OBJECT
+
+   public:
+    /**
+     * @brief 构造函数
+     * @param inner 真实的网络应答（由本对象接管）
+     * @param key 请求指纹
+     * @param parent 父对象
+     */
+    RecordingReply(QNetworkReply* inner, const QString& key, QObject* parent = nullptr);
+
+    /**
+     * @brief 中止请求
+     */
+    void abort() override;
+
+    /**
+     * @brief 获取可读字节数
+     * @return 可读字节数
+     */
+    qint64 bytesAvailable() const override;
+
+    /**
+     * @brief 是否为顺序设备
+     * @return 始终为true
+     */
+    bool isSequential() const override;
+
+   protected:
+    /**
+     * @brief 读取数据
+     * @param data 输出缓冲区
+     * @param maxSize 最大读取字节数
+     * @return 实际读取字节数
+     */
+    qint64 readData(char* data, qint64 maxSize) override;
+
+   private:
+    /**
+     * @brief 从真实应答复制响应头和状态
+     */
+    void copyMetaData();
+
+    QNetworkReply* m_inner;     ///< 真实的网络应答
+    QByteArray m_buffer;        ///< 尚未被读取的数据
+    QElapsedTimer m_clock;      ///< 请求计时
+    RecordedResponse m_record;  ///< 正在录制的响应
+};
+
+/**
+ * @brief 回放应答类，按录制的时间重新发出响应
+ */
+class ReplayReply : public QNetworkReply
+{
+    Q_OBJECT
+
+   public:
+    /**
+     * @brief 构造函数
+     * @param op 请求操作
+     * @param request 网络请求
+     * @param record 录制的响应；未找到录制时传入found=false
+     * @param found 是否找到录制
+     * @param speed 回放速度倍数（0表示不等待）
+     * @param parent 父对象
+     */
+    ReplayReply(QNetworkAccessManager::Operation op, const QNetworkRequest& request, const RecordedResponse& record,
+                bool found, double speed, QObject* parent = nullptr);
+
+    /**
+     * @brief 中止请求
+     */
+    void abort() override;
+
+    /**
+     * @brief 获取可读字节数
+     * @return 可读字节数
+     */
+    qint64 bytesAvailable() const override;
+
+    /**
+     * @brief 是否为顺序设备
+     * @return 始终为true
+     */
+    bool isSequential() const override;
+
+   protected:
+    /**
+     * @brief 读取数据
+     * @param data 输出缓冲区
+     * @param maxSize 最大读取字节数
+     * @return 实际读取字节数
+     */
+    qint64 readData(char* data, qint64 maxSize) override;
+
+   private slots:
+    /**
+     * @brief 发出到期的回放事件
+     */
+    void onStep();
+
+   private:
+    /**
+     * @brief 安排下一个回放事件
+     */
+    void scheduleNext();
+
+    /**
+     * @brief 获取回放事件的录制时间偏移
+     * @param step 事件序号
+     * @return 录制的时间偏移（毫秒）
+     */
+    qint64 stepOffset(int step) const;
+
+    /**
+     * @brief 将录制的时间偏移换算为回放时间
+     * @param offsetMs 录制的时间偏移（毫秒）
+     * @return 回放时间偏移（毫秒）
+     */
+    qint64 scaled(qint64 offsetMs) const;
+
+    RecordedResponse m_record;  ///< 录制的响应
+    double m_speed;             ///< 回放速度倍数
+    QByteArray m_buffer;        ///< 尚未被读取的数据
+    QElapsedTimer m_clock;      ///< 回放计时
+    QTimer* m_timer;            ///< 回放定时器
+    int m_step;                 ///< 下一个事件（0为响应头，1..n为数据块，n+1为结束）
+};
+
+#endif  // RECORDINGNETWORKMANAGER_H
@@ -0,0 +1,68 @@
+/**
+ * @file requestfingerprint.cpp
+ * @brief AI请求指纹实现
+ * @author Developer
+ * @date 2026-10-18
+ * @version 1.0
+ */
+
+#include "core/ai/requestfingerprint.h"
+#include <QCryptographicHash>
+
+QByteArray RequestFingerprint::normalizeCode(const QString& code)
+{
+    QByteArray utf8 = code.toUtf8();
+    QByteArray normalized;
+    normalized.reserve(utf8.size());
+
+    // 保留换行和行首缩进（Python等语言的代码块由缩进决定），只去掉行尾空白并统一换行符
+    qsizetype lineEnd = 0;
+    for (qsizetype i = 0; i < utf8.size(); ++i)
+    {
+        char c = utf8[i];
+        if (c == '\r' || c == '\n')
+        {
+            if (c == '\r' && i + 1 < utf8.size() && utf8[i + 1] == '\n')
+            {
+                ++i;
+            }
+            normalized.truncate(lineEnd);
+            normalized.append('\n');
+            lineEnd = normalized.size();
+            continue;
+        }
+        normalized.append(c);
+        if (c != ' ' && c != '\t' && c != '\f' && c != '\v')
+        {
+            lineEnd = normalized.size();
+        }
+    }
+    normalized.truncate(lineEnd);
+
+    // 去掉首尾的空行
+    while (normalized.endsWith('\n'))
+    {
+        normalized.chop(1);
+    }
+    qsizetype firstLine = 0;
+    while (firstLine < normalized.size() && normalized[firstLine] == '\n')
+    {
+        ++firstLine;
+    }
+    return normalized.mid(firstLine);
+}
+
+QString RequestFingerprint::compute(const QString& code, const QString& language, const QString& model,
+                                    int promptVersion)
+{
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(normalizeCode(code));
+    hash.addData(QByteArrayView("\n", 1));
+    hash.addData(language.toUtf8());
+    hash.addData(QByteArrayView("\n", 1));
+    hash.addData(model.toUtf8());
+    hash.addData(QByteArrayView("\n", 1));
+    hash.addData(QByteArray::number(promptVersion));
+
+    return QString::fromLatin1(hash.result().toHex());
+}
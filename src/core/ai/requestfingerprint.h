@@ -0,0 +1,43 @@
+/**
+ * @file requestfingerprint.h
+ * @brief AI请求指纹，用于识别内容相同的分析请求
+ * @author Developer
+ * @date 2026-10-18
+ * @version 1.0
+ *
+ * @details 指纹由规范化后的代码、语言、模型和提示词版本共同决定：
+ * - 代码统一为LF换行，去除行尾空白和首尾空行；行首缩进和换行保留，缩进不同的代码（如Python的代码块）指纹不同
+ * - 修改提示词模板时需要递增提示词版本，避免新旧请求被视为相同
+ */
+
+#ifndef REQUESTFINGERPRINT_H
+#define REQUESTFINGERPRINT_H
+
+#include <QByteArray>
+#include <QString>
+
+/**
+ * @brief AI请求指纹类
+ */
+class RequestFingerprint
+{
+   public:
+    /**
+     * @brief 规范化代码（统一换行符，去除行尾空白）
+     * @param code 源代码
+     * @return 规范化后的UTF-8代码
+     */
+    static QByteArray normalizeCode(const QString& code);
+
+    /**
+     * @brief 计算请求指纹
+     * @param code 源代码
+     * @param language 语言类型
+     * @param model 使用的AI模型
+     * @param promptVersion 提示词版本
+     * @return 十六进制指纹字符串
+     */
+    static QString compute(const QString& code, const QString& language, const QString& model, int promptVersion);
+};
+
+#endif  // REQUESTFINGERPRINT_H
@@ -0,0 +1,237 @@
+/**
+ * @file responserecorder.cpp
+ * @brief AI响应录制与回放存储实现
+ * @author Developer
+ * @date 2026-10-18
+ * @version 1.0
+ */
+
+#include "core/ai/responserecorder.h"
+#include <QCryptographicHash>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include "common/logger/logger.h"
+
+void RecordedResponse::fromJson(const QJsonObject& json)
+{
+    key = json["key"].toString();
+    httpStatus = json["status"].toInt();
+    reasonPhrase = json["reason"].toString().toUtf8();
+    headersAtMs = json["headersAt"].toInteger();
+    finishedAtMs = json["finishedAt"].toInteger();
+    networkError = json["error"].toInt();
+    errorString = json["errorString"].toString();
+
+    headers.clear();
+    const QJsonArray headersArray = json["headers"].toArray();
+    for (const QJsonValue& value : headersArray)
+    {
+        QJsonArray pair = value.toArray();
+        headers.append(qMakePair(pair.at(0).toString().toUtf8(), pair.at(1).toString().toUtf8()));
+    }
+
+    chunks.clear();
+    const QJsonArray chunksArray = json["chunks"].toArray();
+    for (const QJsonValue& value : chunksArray)
+    {
+        QJsonObject chunkObj = value.toObject();
+        RecordedChunk chunk;
+        chunk.offsetMs = chunkObj["t"].toInteger();
+        chunk.data = QByteArray::fromBase64(chunkObj["data"].toString().toLatin1());
+        chunks.append(chunk);
+    }
+}
+
+QJsonObject RecordedResponse::toJson() const
+{
+    QJsonObject json;
+    json["key"] = key;
+    json["status"] = httpStatus;
+    json["reason"] = QString::fromUtf8(reasonPhrase);
+    json["headersAt"] = headersAtMs;
+    json["finishedAt"] = finishedAtMs;
+    json["error"] = networkError;
+    json["errorString"] = errorString;
+
+    QJsonArray headersArray;
+    for (const auto& header : headers)
+    {
+        headersArray.append(QJsonArray{QString::fromUtf8(header.first), QString::fromUtf8(header.second)});
+    }
+    json["headers"] = headersArray;
+
+    QJsonArray chunksArray;
+    for (const RecordedChunk& chunk : chunks)
+    {
+        QJsonObject chunkObj;
+        chunkObj["t"] = chunk.offsetMs;
+        chunkObj["data"] = QString::fromLatin1(chunk.data.toBase64());
+        chunksArray.append(chunkObj);
+    }
+    json["chunks"] = chunksArray;
+
+    return json;
+}
+
+ResponseRecorder::ResponseRecorder()
+    : m_mode(RecorderMode::Off), m_speed(1.0), m_recordedCount(0), m_replayHits(0), m_replayMisses(0)
+{
+}
+
+ResponseRecorder::~ResponseRecorder() {}
+
+ResponseRecorder& ResponseRecorder::instance()
+{
+    static ResponseRecorder instance;
+    return instance;
+}
+
+bool ResponseRecorder::startRecording(const QString& filePath)
+{
+    QMutexLocker locker(&m_mutex);
+    resetLocked();
+
+    m_file.setFileName(filePath);
+    if (!m_file.open(QIODevice::WriteOnly | QIODevice::Append))
+    {
+        Logger::instance().error("无法打开AI响应录制文件: " + filePath + ", 错误: " + m_file.errorString());
+        return false;
+    }
+
+    m_mode = RecorderMode::Record;
+    Logger::instance().info("开始录制AI响应: " + filePath);
+    return true;
+}
+
+bool ResponseRecorder::startReplay(const QString& filePath, double speed)
+{
+    QMutexLocker locker(&m_mutex);
+    resetLocked();
+
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        Logger::instance().error("无法打开AI响应录制文件: " + filePath + ", 错误: " + file.errorString());
+        return false;
+    }
+
+    int count = 0;
+    while (!file.atEnd())
+    {
+        QByteArray line = file.readLine().trimmed();
+        if (line.isEmpty())
+        {
+            continue;
+        }
+
+        QJsonParseError error;
+        QJsonDocument doc = QJsonDocument::fromJson(line, &error);
+        if (error.error != QJsonParseError::NoError || !doc.isObject())
+        {
+            Logger::instance().warning("跳过无法解析的录制记录: " + error.errorString());
+            continue;
+        }
+
+        RecordedResponse response;
+        response.fromJson(doc.object());
+        m_records[response.key].append(response);
+        count++;
+    }
+
+    m_mode = RecorderMode::Replay;
+    m_speed = qMax(0.0, speed);
+    Logger::instance().info(QString("开始回放AI响应: %1 (%2 条记录, %3 个不同请求, 速度 %4x)")
+                                .arg(filePath)
+                                .arg(count)
+                                .arg(m_records.size())
+                                .arg(m_speed));
+    return true;
+}
+
+void ResponseRecorder::stop()
+{
+    QMutexLocker locker(&m_mutex);
+    resetLocked();
+}
+
+RecorderMode ResponseRecorder::mode() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_mode;
+}
+
+double ResponseRecorder::replaySpeed() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_speed;
+}
+
+QString ResponseRecorder::requestKey(const QByteArray& verb, const QString& urlPath, const QByteArray& body)
+{
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(verb);
+    hash.addData(QByteArrayView("\n", 1));
+    hash.addData(urlPath.toUtf8());
+    hash.addData(QByteArrayView("\n", 1));
+    hash.addData(body);
+
+    return QString::fromLatin1(hash.result().toHex());
+}
+
+void ResponseRecorder::append(const RecordedResponse& response)
+{
+    QMutexLocker locker(&m_mutex);
+
+    if (m_mode != RecorderMode::Record || !m_file.isOpen())
+    {
+        return;
+    }
+
+    m_file.write(QJsonDocument(response.toJson()).toJson(QJsonDocument::Compact));
+    m_file.write("\n");
+    m_file.flush();
+    m_recordedCount++;
+}
+
+bool ResponseRecorder::lookup(const QString& key, RecordedResponse& response)
+{
+    QMutexLocker locker(&m_mutex);
+
+    auto it = m_records.constFind(key);
+    if (it == m_records.constEnd() || it->isEmpty())
+    {
+        m_replayMisses++;
+        return false;
+    }
+
+    int& cursor = m_cursors[key];
+    response = it->at(cursor % it->size());
+    cursor++;
+    m_replayHits++;
+    return true;
+}
+
+void ResponseRecorder::resetLocked()
+{
+    if (m_mode == RecorderMode::Record)
+    {
+        Logger::instance().info(QString("停止录制AI响应，共录制 %1 条").arg(m_recordedCount));
+    }
+    else if (m_mode == RecorderMode::Replay)
+    {
+        Logger::instance().info(QString("停止回放AI响应，命中 %1 次，未命中 %2 次").arg(m_replayHits).arg(m_replayMisses));
+    }
+
+    if (m_file.isOpen())
+    {
+        m_file.close();
+    }
+
+    m_mode = RecorderMode::Off;
+    m_speed = 1.0;
+    m_records.clear();
+    m_cursors.clear();
+    m_recordedCount = 0;
+    m_replayHits = 0;
+    m_replayMisses = 0;
+}
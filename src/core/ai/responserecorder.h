@@ -0,0 +1,181 @@
+/**
+ * @file responserecorder.h
+ * @brief AI响应录制与回放存储，用于可复现的流水线基准测试
+ * @author Developer
+ * @date 2026-10-18
+ * @version 1.0
+ *
+ * @details 录制文件为JSON Lines格式，每行一条响应记录：
+ * - 请求指纹（请求方法 + URL路径 + 请求体的SHA-1），不包含主机名，同一请求发往不同端点时可共用录制
+ * - HTTP状态、响应头、每个数据块相对请求开始的时间偏移和内容、最终的网络错误
+ * 回放时同一指纹的多条记录按录制顺序轮流使用。
+ */
+
+#ifndef RESPONSERECORDER_H
+#define RESPONSERECORDER_H
+
+#include <QByteArray>
+#include <QFile>
+#include <QHash>
+#include <QJsonObject>
+#include <QList>
+#include <QMutex>
+#include <QPair>
+#include <QString>
+#include <QVector>
+
+/**
+ * @brief 录制模式枚举
+ */
+enum class RecorderMode
+{
+    Off,     ///< 不录制也不回放，直接访问网络
+    Record,  ///< 访问网络并录制响应
+    Replay   ///< 不访问网络，从录制文件回放响应
+};
+
+/**
+ * @brief 录制的数据块
+ */
+struct RecordedChunk
+{
+    qint64 offsetMs;  ///< 相对请求开始的时间偏移（毫秒）
+    QByteArray data;  ///< 数据内容
+
+    /**
+     * @brief 默认构造函数
+     */
+    RecordedChunk() : offsetMs(0) {}
+};
+
+/**
+ * @brief 录制的响应
+ */
+struct RecordedResponse
+{
+    QString key;                                   ///< 请求指纹
+    int httpStatus;                                ///< HTTP状态码（0表示未收到响应头）
+    QByteArray reasonPhrase;                       ///< HTTP状态说明
+    QList<QPair<QByteArray, QByteArray>> headers;  ///< 响应头
+    qint64 headersAtMs;                            ///< 收到响应头的时间偏移（毫秒）
+    QVector<RecordedChunk> chunks;                 ///< 响应数据块
+    qint64 finishedAtMs;                           ///< 响应结束的时间偏移（毫秒）
+    int networkError;                              ///< 网络错误码（QNetworkReply::NetworkError）
+    QString errorString;                           ///< 网络错误信息
+
+    /**
+     * @brief 默认构造函数
+     */
+    RecordedResponse() : httpStatus(0), headersAtMs(0), finishedAtMs(0), networkError(0) {}
+
+    /**
+     * @brief 从JSON对象加载记录
+     * @param json JSON对象
+     */
+    void fromJson(const QJsonObject& json);
+
+    /**
+     * @brief 转换为JSON对象
+     * @return JSON对象
+     */
+    QJsonObject toJson() const;
+};
+
+/**
+ * @brief AI响应录制与回放存储类（单例）
+ */
+class ResponseRecorder
+{
+   public:
+    /**
+     * @brief 获取单例实例
+     * @return 实例引用
+     */
+    static ResponseRecorder& instance();
+
+    ResponseRecorder(const ResponseRecorder&) = delete;
+    ResponseRecorder& operator=(const ResponseRecorder&) = delete;
+
+    /**
+     * @brief 开始录制，之后的AI请求响应追加写入文件
+     * @param filePath 录制文件路径
+     * @return 是否成功
+     */
+    bool startRecording(const QString& filePath);
+
+    /**
+     * @brief 开始回放，之后的AI请求不再访问网络
+     * @param filePath 录制文件路径
+     * @param speed 回放速度倍数（1为原始速度，0表示不等待立即返回）
+     * @return 是否成功
+     */
+    bool startReplay(const QString& filePath, double speed = 1.0);
+
+    /**
+     * @brief 停止录制或回放，恢复直接访问网络
+     */
+    void stop();
+
+    /**
+     * @brief 获取当前模式
+     * @return 当前模式
+     */
+    RecorderMode mode() const;
+
+    /**
+     * @brief 获取回放速度倍数
+     * @return 回放速度倍数
+     */
+    double replaySpeed() const;
+
+    /**
+     * @brief 计算请求指纹
+     * @param verb 请求方法
+     * @param urlPath URL路径
+     * @param body 请求体
+     * @return 十六进制指纹字符串
+     */
+    static QString requestKey(const QByteArray& verb, const QString& urlPath, const QByteArray& body);
+
+    /**
+     * @brief 保存一条录制的响应
+     * @param response 响应记录
+     */
+    void append(const RecordedResponse& response);
+
+    /**
+     * @brief 查找回放用的响应
+     * @param key 请求指纹
+     * @param response 输出参数，找到的响应记录
+     * @return 是否找到
+     */
+    bool lookup(const QString& key, RecordedResponse& response);
+
+   private:
+    /**
+     * @brief 私有构造函数
+     */
+    ResponseRecorder();
+
+    /**
+     * @brief 析构函数
+     */
+    ~ResponseRecorder();
+
+    /**
+     * @brief 关闭文件并清空状态（调用方需持有锁）
+     */
+    void resetLocked();
+
+    mutable QMutex m_mutex;                               ///< 互斥锁
+    RecorderMode m_mode;                                  ///< 当前模式
+    double m_speed;                                       ///< 回放速度倍数
+    QFile m_file;                                         ///< 录制文件
+    QHash<QString, QVector<RecordedResponse>> m_records;  ///< 回放记录（按指纹分组）
+    QHash<QString, int> m_cursors;                        ///< 各指纹下一条要使用的记录
+    int m_recordedCount;                                  ///< 已录制的响应数
+    int m_replayHits;                                     ///< 回放命中次数
+    int m_replayMisses;                                   ///< 回放未命中次数
+};
+
+#endif  // RESPONSERECORDER_H
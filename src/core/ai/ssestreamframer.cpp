@@ -0,0 +1,457 @@
+/**
+ * @file ssestreamframer.cpp
+ * @brief SSE流式响应分帧器实现
+ * @author Developer
+ * @date 2026-10-18
+ * @version 1.0
+ */
+
+#include "core/ai/ssestreamframer.h"
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+const char kDataField[] = "data:";
+const char kDeltaKey[] = "\"delta\"";
+const char kContentKey[] = "content";
+const char kUsageKey[] = "\"usage\"";
+
+bool isJsonWhitespace(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+const char* skipWhitespace(const char* p, const char* end)
+{
+    while (p < end && isJsonWhitespace(*p))
+    {
+        ++p;
+    }
+    return p;
+}
+
+int hexValue(char c)
+{
+    if (c >= '0' && c <= '9')
+    {
+        return c - '0';
+    }
+    if (c >= 'a' && c <= 'f')
+    {
+        return c - 'a' + 10;
+    }
+    if (c >= 'A' && c <= 'F')
+    {
+        return c - 'A' + 10;
+    }
+    return -1;
+}
+
+bool readHex4(const char* p, const char* end, uint& value)
+{
+    if (end - p < 4)
+    {
+        return false;
+    }
+    value = 0;
+    for (int i = 0; i < 4; ++i)
+    {
+        int digit = hexValue(p[i]);
+        if (digit < 0)
+        {
+            return false;
+        }
+        value = (value << 4) | static_cast<uint>(digit);
+    }
+    return true;
+}
+
+void appendUtf8(QByteArray& out, uint codePoint)
+{
+    if (codePoint < 0x80)
+    {
+        out.append(static_cast<char>(codePoint));
+    }
+    else if (codePoint < 0x800)
+    {
+        out.append(static_cast<char>(0xC0 | (codePoint >> 6)));
+        out.append(static_cast<char>(0x80 | (codePoint & 0x3F)));
+    }
+    else if (codePoint < 0x10000)
+    {
+        out.append(static_cast<char>(0xE0 | (codePoint >> 12)));
+        out.append(static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F)));
+        out.append(static_cast<char>(0x80 | (codePoint & 0x3F)));
+    }
+    else
+    {
+        out.append(static_cast<char>(0xF0 | (codePoint >> 18)));
+        out.append(static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F)));
+        out.append(static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F)));
+        out.append(static_cast<char>(0x80 | (codePoint & 0x3F)));
+    }
+}
+
+/**
+ * 解码JSON字符串，p指向起始引号之后的位置。
+ * out为空时仅跳过字符串。成功返回结束引号之后的位置，失败返回nullptr。
+ */
+const char* decodeString(const char* p, const char* end, QByteArray* out)
+{
+    while (p < end)
+    {
+        const char* runStart = p;
+        while (p < end && *p != '"' && *p != '\\')
+        {
+            ++p;
+        }
+        if (out && p > runStart)
+        {
+            out->append(runStart, p - runStart);
+        }
+        if (p >= end)
+        {
+            return nullptr;
+        }
+        if (*p == '"')
+        {
+            return p + 1;
+        }
+
+        ++p;
+        if (p >= end)
+        {
+            return nullptr;
+        }
+
+        char escaped = *p++;
+        char plain = 0;
+        switch (escaped)
+        {
+            case '"':
+            case '\\':
+            case '/':
+                plain = escaped;
+                break;
+            case 'b':
+                plain = '\b';
+                break;
+            case 'f':
+                plain = '\f';
+                break;
+            case 'n':
+                plain = '\n';
+                break;
+            case 'r':
+                plain = '\r';
+                break;
+            case 't':
+                plain = '\t';
+                break;
+            case 'u':
+            {
+                uint codePoint = 0;
+                if (!readHex4(p, end, codePoint))
+                {
+                    return nullptr;
+                }
+                p += 4;
+
+                if (codePoint >= 0xD800 && codePoint <= 0xDBFF)
+                {
+                    uint low = 0;
+                    if (end - p >= 6 && p[0] == '\\' && p[1] == 'u' && readHex4(p + 2, end, low) && low >= 0xDC00 &&
+                        low <= 0xDFFF)
+                    {
+                        codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (low - 0xDC00);
+                        p += 6;
+                    }
+                    else
+                    {
+                        codePoint = 0xFFFD;
+                    }
+                }
+                else if (codePoint >= 0xDC00 && codePoint <= 0xDFFF)
+                {
+                    codePoint = 0xFFFD;
+                }
+
+                if (out)
+                {
+                    appendUtf8(*out, codePoint);
+                }
+                continue;
+            }
+            default:
+                return nullptr;
+        }
+
+        if (out)
+        {
+            out->append(plain);
+        }
+    }
+    return nullptr;
+}
+
+/**
+ * 跳过一个JSON值（字符串、对象、数组或字面量），返回值之后的位置，失败返回nullptr。
+ */
+const char* skipValue(const char* p, const char* end)
+{
+    p = skipWhitespace(p, end);
+    if (p >= end)
+    {
+        return nullptr;
+    }
+
+    if (*p == '"')
+    {
+        return decodeString(p + 1, end, nullptr);
+    }
+
+    if (*p == '{' || *p == '[')
+    {
+        int depth = 0;
+        while (p < end)
+        {
+            char c = *p;
+            if (c == '"')
+            {
+                p = decodeString(p + 1, end, nullptr);
+                if (!p)
+                {
+                    return nullptr;
+                }
+                continue;
+            }
+            if (c == '{' || c == '[')
+            {
+                ++depth;
+            }
+            else if (c == '}' || c == ']')
+            {
+                --depth;
+                if (depth == 0)
+                {
+                    return p + 1;
+                }
+            }
+            ++p;
+        }
+        return nullptr;
+    }
+
+    while (p < end && *p != ',' && *p != '}' && *p != ']' && !isJsonWhitespace(*p))
+    {
+        ++p;
+    }
+    return p;
+}
+}  // namespace
+
+SseStreamFramer::SseStreamFramer() : m_readPos(0) {}
+
+void SseStreamFramer::append(const QByteArray& chunk)
+{
+    if (m_readPos > 0)
+    {
+        m_buffer.remove(0, m_readPos);
+        m_readPos = 0;
+    }
+    m_buffer.append(chunk);
+}
+
+bool SseStreamFramer::nextDataPayload(QByteArrayView& payload)
+{
+    const qsizetype fieldLength = sizeof(kDataField) - 1;
+
+    while (true)
+    {
+        const qsizetype lineEnd = m_buffer.indexOf('\n', m_readPos);
+        if (lineEnd < 0)
+        {
+            return false;
+        }
+
+        const char* lineBegin = m_buffer.constData() + m_readPos;
+        qsizetype lineLength = lineEnd - m_readPos;
+        m_readPos = lineEnd + 1;
+
+        if (lineLength > 0 && lineBegin[lineLength - 1] == '\r')
+        {
+            --lineLength;
+        }
+
+        if (lineLength < fieldLength || std::memcmp(lineBegin, kDataField, fieldLength) != 0)
+        {
+            continue;
+        }
+
+        const char* valueBegin = lineBegin + fieldLength;
+        const char* valueEnd = lineBegin + lineLength;
+        while (valueBegin < valueEnd && isJsonWhitespace(*valueBegin))
+        {
+            ++valueBegin;
+        }
+        while (valueEnd > valueBegin && isJsonWhitespace(*(valueEnd - 1)))
+        {
+            --valueEnd;
+        }
+
+        if (valueBegin == valueEnd)
+        {
+            continue;
+        }
+
+        payload = QByteArrayView(valueBegin, valueEnd - valueBegin);
+        return true;
+    }
+}
+
+void SseStreamFramer::finish()
+{
+    if (m_readPos < m_buffer.size() && !m_buffer.endsWith('\n'))
+    {
+        m_buffer.append('\n');
+    }
+}
+
+void SseStreamFramer::clear()
+{
+    m_buffer.clear();
+    m_readPos = 0;
+}
+
+qsizetype SseStreamFramer::pendingBytes() const
+{
+    return m_buffer.size() - m_readPos;
+}
+
+bool SseStreamFramer::isDoneMarker(QByteArrayView payload)
+{
+    return payload.size() == 6 && std::memcmp(payload.data(), "[DONE]", 6) == 0;
+}
+
+bool SseStreamFramer::containsUsage(QByteArrayView payload)
+{
+    const char* begin = payload.data();
+    const char* end = begin + payload.size();
+    const char* p = std::search(begin, end, kUsageKey, kUsageKey + sizeof(kUsageKey) - 1);
+    if (p == end)
+    {
+        return false;
+    }
+
+    // 部分服务在每个事件中都携带"usage": null，只有对象值才视为有效统计
+    p = skipWhitespace(p + sizeof(kUsageKey) - 1, end);
+    if (p >= end || *p != ':')
+    {
+        return false;
+    }
+    p = skipWhitespace(p + 1, end);
+    return p < end && *p == '{';
+}
+
+SseDeltaResult SseStreamFramer::extractDeltaContent(QByteArrayView payload, QByteArray& utf8Content)
+{
+    const char* begin = payload.data();
+    const char* end = begin + payload.size();
+    const char* keyBegin = kDeltaKey;
+    const char* keyEnd = kDeltaKey + sizeof(kDeltaKey) - 1;
+
+    const char* p = std::search(begin, end, keyBegin, keyEnd);
+    if (p == end)
+    {
+        return SseDeltaResult::Fallback;
+    }
+
+    p = skipWhitespace(p + (keyEnd - keyBegin), end);
+    if (p >= end || *p != ':')
+    {
+        return SseDeltaResult::Fallback;
+    }
+    p = skipWhitespace(p + 1, end);
+    if (p >= end || *p != '{')
+    {
+        return SseDeltaResult::Fallback;
+    }
+    ++p;
+
+    const qsizetype contentKeyLength = sizeof(kContentKey) - 1;
+
+    while (true)
+    {
+        p = skipWhitespace(p, end);
+        if (p >= end)
+        {
+            return SseDeltaResult::Fallback;
+        }
+        if (*p == '}')
+        {
+            return SseDeltaResult::NoContent;
+        }
+        if (*p != '"')
+        {
+            return SseDeltaResult::Fallback;
+        }
+
+        const char* nameBegin = p + 1;
+        const char* nameEnd = decodeString(nameBegin, end, nullptr);
+        if (!nameEnd)
+        {
+            return SseDeltaResult::Fallback;
+        }
+        const bool isContent =
+            (nameEnd - 1 - nameBegin) == contentKeyLength && std::memcmp(nameBegin, kContentKey, contentKeyLength) == 0;
+
+        p = skipWhitespace(nameEnd, end);
+        if (p >= end || *p != ':')
+        {
+            return SseDeltaResult::Fallback;
+        }
+        p = skipWhitespace(p + 1, end);
+        if (p >= end)
+        {
+            return SseDeltaResult::Fallback;
+        }
+
+        if (isContent)
+        {
+            if (*p == 'n')
+            {
+                return SseDeltaResult::NoContent;
+            }
+            if (*p != '"')
+            {
+                return SseDeltaResult::Fallback;
+            }
+
+            const qsizetype originalSize = utf8Content.size();
+            if (!decodeString(p + 1, end, &utf8Content))
+            {
+                utf8Content.truncate(originalSize);
+                return SseDeltaResult::Fallback;
+            }
+            return SseDeltaResult::Content;
+        }
+
+        p = skipValue(p, end);
+        if (!p)
+        {
+            return SseDeltaResult::Fallback;
+        }
+        p = skipWhitespace(p, end);
+        if (p < end && *p == ',')
+        {
+            ++p;
+            continue;
+        }
+        if (p < end && *p == '}')
+        {
+            return SseDeltaResult::NoContent;
+        }
+        return SseDeltaResult::Fallback;
+    }
+}
@@ -0,0 +1,110 @@
+/**
+ * @file ssestreamframer.h
+ * @brief SSE流式响应分帧器，基于字节缓冲区和读游标进行零拷贝行切分
+ * @author Developer
+ * @date 2026-10-18
+ * @version 1.0
+ *
+ * @details 该分帧器用于替代"整块转UTF-16后split"的处理方式：
+ * - 网络数据以字节形式追加到缓冲区，不做编码转换
+ * - 通过读游标逐行切分，不对剩余数据重复切分
+ * - 返回的data负载为指向内部缓冲区的视图，不产生拷贝
+ * - 提供delta.content字段的快速提取，避免每个事件构建QJsonDocument
+ */
+
+#ifndef SSESTREAMFRAMER_H
+#define SSESTREAMFRAMER_H
+
+#include <QByteArray>
+#include <QByteArrayView>
+
+/**
+ * @brief delta.content快速提取结果
+ */
+enum class SseDeltaResult
+{
+    Content,    ///< 成功提取到content内容
+    NoContent,  ///< 事件中没有content（如仅包含role的首个事件）
+    Fallback    ///< 结构不符合快速路径，需要完整JSON解析
+};
+
+/**
+ * @brief SSE流式响应分帧器类
+ *
+ * @details 典型用法：
+ * @code
+ * framer.append(reply->readAll());
+ * QByteArrayView payload;
+ * while (framer.nextDataPayload(payload))
+ * {
+ *     // payload 在下一次 append() 之前有效
+ * }
+ * @endcode
+ */
+class SseStreamFramer
+{
+   public:
+    /**
+     * @brief 构造函数
+     */
+    SseStreamFramer();
+
+    /**
+     * @brief 追加网络数据块
+     * @param chunk 原始字节数据
+     * @note 追加前会丢弃已读取的部分，之前返回的视图随之失效
+     */
+    void append(const QByteArray& chunk);
+
+    /**
+     * @brief 获取下一个完整的data字段负载
+     * @param payload 输出参数，去除"data:"前缀和首尾空白后的负载视图
+     * @return 是否取得负载；缓冲区中没有完整行时返回false
+     * @note 非data字段（event、id、注释行）和空行会被跳过
+     */
+    bool nextDataPayload(QByteArrayView& payload);
+
+    /**
+     * @brief 结束输入，将末尾未以换行结束的数据视为完整的一行
+     */
+    void finish();
+
+    /**
+     * @brief 清空缓冲区和读游标
+     */
+    void clear();
+
+    /**
+     * @brief 获取尚未消费的字节数
+     * @return 未消费字节数
+     */
+    qsizetype pendingBytes() const;
+
+    /**
+     * @brief 检查负载是否为流结束标记[DONE]
+     * @param payload data负载
+     * @return 是否为结束标记
+     */
+    static bool isDoneMarker(QByteArrayView payload);
+
+    /**
+     * @brief 检查负载中是否带有usage统计对象（通常只出现在最后一个事件中）
+     * @param payload data负载
+     * @return usage字段存在且为对象时返回true
+     */
+    static bool containsUsage(QByteArrayView payload);
+
+    /**
+     * @brief 快速提取choices[0].delta.content字段
+     * @param payload data负载（JSON对象文本）
+     * @param utf8Content 输出参数，解码后的内容以UTF-8追加到末尾
+     * @return 提取结果，返回Fallback时utf8Content保持不变
+     */
+    static SseDeltaResult extractDeltaContent(QByteArrayView payload, QByteArray& utf8Content);
+
+   private:
+    QByteArray m_buffer;  ///< 字节缓冲区
+    qsizetype m_readPos;  ///< 读游标，指向下一行的起始位置
+};
+
+#endif  // SSESTREAMFRAMER_H
@@ -0,0 +1,53 @@
+/**
+ * @file tokenestimator.cpp
+ * @brief Token数量估算器实现
+ * @author Developer
+ * @date 2026-10-18
+ * @version 1.0
+ */
+
+#include "core/ai/tokenestimator.h"
+#include <climits>
+
+namespace
+{
+const int kMessageOverheadTokens = 8;  ///< 每条消息的格式开销（角色、分隔符等）
+
+bool isCjk(char16_t c)
+{
+    return (c >= 0x3040 && c <= 0x30FF) || (c >= 0x3400 && c <= 0x4DBF) || (c >= 0x4E00 && c <= 0x9FFF) ||
+           (c >= 0xAC00 && c <= 0xD7AF) || (c >= 0xF900 && c <= 0xFAFF) || (c >= 0xFF00 && c <= 0xFFEF);
+}
+}  // namespace
+
+int TokenEstimator::estimate(const QString& text)
+{
+    qint64 asciiChars = 0;
+    qint64 cjkChars = 0;
+    qint64 otherChars = 0;
+
+    for (QChar ch : text)
+    {
+        char16_t c = ch.unicode();
+        if (c < 0x80)
+        {
+            asciiChars++;
+        }
+        else if (isCjk(c))
+        {
+            cjkChars++;
+        }
+        else
+        {
+            otherChars++;
+        }
+    }
+
+    qint64 tokens = (asciiChars + 3) / 4 + cjkChars + (otherChars + 1) / 2;
+    return static_cast<int>(qMin<qint64>(tokens, INT_MAX));
+}
+
+int TokenEstimator::estimateRequest(const QString& prompt, int expectedOutputTokens)
+{
+    return estimate(prompt) + kMessageOverheadTokens + qMax(0, expectedOutputTokens);
+}
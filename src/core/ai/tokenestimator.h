@@ -0,0 +1,42 @@
+/**
+ * @file tokenestimator.h
+ * @brief Token数量估算器，用于在发送请求前估算提示词消耗的token
+ * @author Developer
+ * @date 2026-10-18
+ * @version 1.0
+ *
+ * @details 估算规则参考常见BPE分词器的经验值：
+ * - ASCII文本约每4个字符1个token
+ * - 中日韩字符约每个字符1个token
+ * - 其他非ASCII字符约每2个字符1个token
+ * 估算值只用于速率预算，实际消耗以响应中的usage字段为准。
+ */
+
+#ifndef TOKENESTIMATOR_H
+#define TOKENESTIMATOR_H
+
+#include <QString>
+
+/**
+ * @brief Token数量估算器类
+ */
+class TokenEstimator
+{
+   public:
+    /**
+     * @brief 估算文本的token数
+     * @param text 文本
+     * @return 估算的token数
+     */
+    static int estimate(const QString& text);
+
+    /**
+     * @brief 估算一次请求在TPM预算中占用的token数（提示词 + 预留输出）
+     * @param prompt 请求提示词
+     * @param expectedOutputTokens 预期输出token数
+     * @return 估算的token数
+     */
+    static int estimateRequest(const QString& prompt, int expectedOutputTokens);
+};
+
+#endif  // TOKENESTIMATOR_H
@@ -11,8 +11,10 @@
 #include <QSettings>
 #include <QUuid>
 #include "common/logger/logger.h"
+#include "core/ai/aiconfigmanager.h"
 #include "core/ai/aiservicemanager.h"
 #include "core/database/databasemanager.h"
+#include "core/models/errorhandler.h"
 
 BatchProcessManager& BatchProcessManager::instance()
 {
@@ -22,18 +24,28 @@ BatchProcessManager& BatchProcessManager::instance()
 
 BatchProcessManager::BatchProcessManager(QObject* parent)
     : QObject(parent),
+      m_pendingRetries(0),
+      m_runGeneration(0),
+      m_breaker(nullptr),
+      m_breakerWaiting(false),
       m_state(BatchProcessState::Idle),
       m_successCount(0),
       m_failedCount(0),
       m_skippedCount(0),
       m_totalCount(0),
       m_currentIndex(0),
-      m_processTimer(new QTimer(this))
+      m_processTimer(new QTimer(this)),
+      m_progressThrottle(new ProgressThrottle(20, this))
 {
+    m_processTimer->setSingleShot(true);
 
     connect(m_processTimer, &QTimer::timeout, this, &BatchProcessManager::onProcessNext);
+    connect(m_progressThrottle, &ProgressThrottle::due, this,
+            [this]() { emit batchProgress(m_currentIndex, m_totalCount, m_progressFunction); });
+    connect(&AIServiceManager::instance(), &AIServiceManager::functionAnalysisComplete, this,
+            &BatchProcessManager::onAIAnalysisComplete);
 
-    Logger::instance().info("BatchProcessManager 初始化完成");
+    LOG_INFO("BatchProcessManager 初始化完成");
 }
 
 BatchProcessManager::~BatchProcessManager()
@@ -70,7 +82,7 @@ void BatchProcessManager::setState(BatchProcessState newState)
                 stateStr = "已取消";
                 break;
         }
-        Logger::instance().info("批量处理状态变化: " + stateStr);
+        LOG_INFO("批量处理状态变化: %1", stateStr);
     }
 }
 
@@ -80,7 +92,7 @@ void BatchProcessManager::startBatchProcessing(const QVector<ExtractedFunction>&
 
     if (m_state == BatchProcessState::Running)
     {
-        Logger::instance().warning("批量处理已在运行中");
+        LOG_WARNING("批量处理已在运行中");
         return;
     }
 
@@ -88,12 +100,24 @@ void BatchProcessManager::startBatchProcessing(const QVector<ExtractedFunction>&
     m_processedFunctions.clear();
     m_failedFunctions.clear();
     m_activeRequests.clear();
+    m_retryDelays.clear();
+    m_pendingRetries = 0;
+    m_runGeneration++;
+    m_breakerWaiting = false;
+
+    QString endpoint = AIConfigManager::instance().getCurrentConfig().baseUrl;
+    m_breaker = ErrorHandler::instance().circuitBreaker(endpoint);
+    m_breaker->setFailureThreshold(m_config.breakerFailureThreshold);
+    m_breaker->setOpenDuration(m_config.breakerOpenDuration);
+    AIServiceManager::instance().setMaxConcurrentRequests(m_config.maxConcurrentRequests);
+    AIServiceManager::instance().beginRun();
 
     m_successCount = 0;
     m_failedCount = 0;
     m_skippedCount = 0;
     m_totalCount = functions.size();
     m_currentIndex = 0;
+    m_progressThrottle->reset();
 
     for (const auto& func : functions)
     {
@@ -105,7 +129,7 @@ void BatchProcessManager::startBatchProcessing(const QVector<ExtractedFunction>&
         loadProcessState();
     }
 
-    Logger::instance().info(QString("开始批量处理，共 %1 个函数").arg(m_totalCount));
+    LOG_INFO("开始批量处理，共 %1 个函数", m_totalCount);
 
     setState(BatchProcessState::Running);
 
@@ -140,7 +164,7 @@ void BatchProcessManager::pauseProcessing()
         saveProcessState();
     }
 
-    Logger::instance().info("批量处理已暂停");
+    LOG_INFO("批量处理已暂停");
 }
 
 void BatchProcessManager::resumeProcessing()
@@ -152,7 +176,7 @@ void BatchProcessManager::resumeProcessing()
         return;
     }
 
-    Logger::instance().info("恢复批量处理");
+    LOG_INFO("恢复批量处理");
 
     setState(BatchProcessState::Running);
     processNext();
@@ -173,10 +197,15 @@ void BatchProcessManager::cancelProcessing()
     }
 
     setState(BatchProcessState::Cancelled);
+    m_progressThrottle->reset();
+
+    // 丢弃尚未到期的延迟重试
+    m_runGeneration++;
+    m_pendingRetries = 0;
 
     clearProcessState();
 
-    Logger::instance().info("批量处理已取消");
+    LOG_INFO("批量处理已取消");
 
     emit batchCompleted(m_successCount, m_failedCount, m_skippedCount);
 }
@@ -191,7 +220,7 @@ void BatchProcessManager::setConfig(const BatchProcessConfig& config)
 {
     QMutexLocker locker(&m_mutex);
     m_config = config;
-    Logger::instance().info("批量处理配置已更新");
+    LOG_INFO("批量处理配置已更新");
 }
 
 BatchProcessConfig BatchProcessManager::getConfig() const
@@ -236,42 +265,102 @@ void BatchProcessManager::onAIAnalysisComplete(const AIAnalysisResponse& respons
 
     if (response.success)
     {
+        if (m_breaker)
+        {
+            m_breaker->recordSuccess();
+        }
+
         m_successCount++;
         m_processedFunctions.insert(func.name);
-        Logger::instance().info(QString("函数分析成功: %1").arg(func.name));
+        m_retryDelays.remove(func.name);
+        LOG_INFO("函数分析成功: %1", func.name);
 
         emit functionProcessed(func, true, "分析成功");
     }
     else
     {
-        int retryCount = m_failedFunctions.value(func.name, 0) + 1;
+        ProcessErrorType errorType =
+            (response.errorType == ProcessErrorType::None) ? ProcessErrorType::AIRequestError : response.errorType;
+
+        if (m_breaker && ErrorHandler::isEndpointError(errorType))
+        {
+            m_breaker->recordFailure();
+        }
 
-        if (retryCount <= m_config.maxRetryCount)
+        ProcessError error(errorType, response.errorMessage, func.name);
+        error.retryCount = m_failedFunctions.value(func.name, 0);
+        ErrorAction action = ErrorHandler::instance().handleError(error);
+
+        int retryCount = error.retryCount + 1;
+
+        if (action == ErrorAction::Abort)
+        {
+            // 配置类错误重试无意义：函数放回队首并暂停，等待用户修正后恢复
+            m_processQueue.prepend(func);
+            LOG_ERROR("函数分析遇到不可重试的错误，暂停批量处理: %1", func.name);
+            pauseProcessing();
+            return;
+        }
+
+        bool retryable = (action == ErrorAction::Retry || action == ErrorAction::Pause);
+        if (retryable && retryCount <= m_config.maxRetryCount)
         {
             m_failedFunctions[func.name] = retryCount;
-            m_processQueue.enqueue(func);
-            Logger::instance().warning(
-                QString("函数分析失败，将重试 (%1/%2): %3").arg(retryCount).arg(m_config.maxRetryCount).arg(func.name));
+            scheduleRetry(func);
+            LOG_WARNING("函数分析失败，将重试 (%1/%2): %3", retryCount, m_config.maxRetryCount, func.name);
         }
         else
         {
             m_failedCount++;
             m_failedFunctions.remove(func.name);
-            Logger::instance().error(QString("函数分析失败，已达最大重试次数: %1").arg(func.name));
+            m_retryDelays.remove(func.name);
+            LOG_ERROR("函数分析失败，不再重试: %1", func.name);
 
             emit functionProcessed(func, false, response.errorMessage);
         }
     }
 
     m_currentIndex++;
-    emit batchProgress(m_currentIndex, m_totalCount, func.name);
+    reportProgress(func.name);
 
-    if (m_state == BatchProcessState::Running)
+    if (m_state == BatchProcessState::Running && !m_processTimer->isActive())
     {
         m_processTimer->start(m_config.requestInterval);
     }
 }
 
+void BatchProcessManager::onRetryDue(const ExtractedFunction& func, quint64 generation)
+{
+    QMutexLocker locker(&m_mutex);
+
+    if (generation != m_runGeneration)
+    {
+        return;
+    }
+
+    m_pendingRetries--;
+    m_processQueue.enqueue(func);
+
+    if (m_state == BatchProcessState::Running && m_activeRequests.size() < qMax(1, m_config.maxConcurrentRequests) &&
+        !m_processTimer->isActive())
+    {
+        processNext();
+    }
+}
+
+void BatchProcessManager::scheduleRetry(const ExtractedFunction& func)
+{
+    int previousDelay = m_retryDelays.value(func.name, m_config.retryDelay);
+    int delay = ErrorHandler::instance().nextRetryDelay(previousDelay, m_config.retryDelay, m_config.maxRetryDelay);
+    m_retryDelays[func.name] = delay;
+    m_pendingRetries++;
+
+    quint64 generation = m_runGeneration;
+    QTimer::singleShot(delay, this, [this, func, generation]() { onRetryDue(func, generation); });
+
+    LOG_INFO("函数 %1 将在 %2 毫秒后重试", func.name, delay);
+}
+
 void BatchProcessManager::processNext()
 {
     QMutexLocker locker(&m_mutex);
@@ -281,55 +370,100 @@ void BatchProcessManager::processNext()
         return;
     }
 
-    if (m_processQueue.isEmpty())
+    // 保持最多 maxConcurrentRequests 个请求在途，每个请求完成后再补位
+    int maxActive = qMax(1, m_config.maxConcurrentRequests);
+    while (m_activeRequests.size() < maxActive)
     {
-        if (m_activeRequests.isEmpty())
+        if (m_processQueue.isEmpty())
         {
-            completeBatch();
+            if (m_activeRequests.isEmpty() && m_pendingRetries == 0)
+            {
+                completeBatch();
+            }
+            return;
         }
-        return;
-    }
 
-    ExtractedFunction func = m_processQueue.dequeue();
+        ExtractedFunction func = m_processQueue.head();
 
-    if (m_config.skipExisting && functionExists(func))
-    {
-        m_skippedCount++;
-        m_processedFunctions.insert(func.name);
-        m_currentIndex++;
+        if (m_config.skipExisting && functionExists(func))
+        {
+            m_processQueue.dequeue();
+            m_skippedCount++;
+            m_processedFunctions.insert(func.name);
+            m_currentIndex++;
 
-        Logger::instance().info(QString("跳过已存在的函数: %1").arg(func.name));
-        emit functionProcessed(func, true, "已存在，跳过");
-        emit batchProgress(m_currentIndex, m_totalCount, func.name);
+            LOG_INFO("跳过已存在的函数: %1", func.name);
+            emit functionProcessed(func, true, "已存在，跳过");
+            reportProgress(func.name);
 
-        m_processTimer->start(0);
-        return;
-    }
+            m_processTimer->start(0);
+            return;
+        }
 
-    QString requestId = generateRequestId();
-    m_activeRequests[requestId] = func;
+        if (m_breaker && !m_breaker->allowRequest())
+        {
+            // 熔断期间函数留在队列中等待，冷却结束（或半开探测返回）后再派发
+            qint64 waitTime = qMax<qint64>(m_breaker->remainingOpenTime(), m_config.requestInterval);
+            if (!m_breakerWaiting)
+            {
+                m_breakerWaiting = true;
+                LOG_WARNING("AI服务熔断中，暂停派发，剩余 %1 个函数等待恢复", m_processQueue.size());
+            }
+            if (m_activeRequests.isEmpty())
+            {
+                m_processTimer->start(static_cast<int>(waitTime));
+            }
+            return;
+        }
+
+        if (m_breakerWaiting)
+        {
+            m_breakerWaiting = false;
+            LOG_INFO("AI服务熔断器%1，恢复派发", CircuitBreaker::stateToString(m_breaker->state()));
+        }
+
+        m_processQueue.dequeue();
+
+        QString requestId = generateRequestId();
+        m_activeRequests[requestId] = func;
+
+        LOG_INFO("开始分析函数 (%1/%2): %3", m_currentIndex + 1, m_totalCount, func.name);
 
-    Logger::instance().info(
-        QString("开始分析函数 (%1/%2): %3").arg(m_currentIndex + 1).arg(m_totalCount).arg(func.name));
+        reportProgress(func.name);
 
-    emit batchProgress(m_currentIndex, m_totalCount, func.name);
+        AIServiceManager& aiService = AIServiceManager::instance();
+        aiService.analyzeFunction(func, requestId);
 
-    AIServiceManager& aiService = AIServiceManager::instance();
-    aiService.analyzeFunction(func, requestId);
+        // 配置了请求间隔时，相邻两次派发之间仍按间隔错开
+        if (m_config.requestInterval > 0)
+        {
+            if (m_activeRequests.size() < maxActive)
+            {
+                m_processTimer->start(m_config.requestInterval);
+            }
+            return;
+        }
+    }
 }
 
 void BatchProcessManager::completeBatch()
 {
+    m_progressThrottle->flush();
     setState(BatchProcessState::Completed);
 
-    Logger::instance().info(
-        QString("批量处理完成: 成功 %1, 失败 %2, 跳过 %3").arg(m_successCount).arg(m_failedCount).arg(m_skippedCount));
+    LOG_INFO("批量处理完成: 成功 %1, 失败 %2, 跳过 %3", m_successCount, m_failedCount, m_skippedCount);
 
     clearProcessState();
 
     emit batchCompleted(m_successCount, m_failedCount, m_skippedCount);
 }
 
+void BatchProcessManager::reportProgress(const QString& functionName)
+{
+    m_progressFunction = functionName;
+    m_progressThrottle->request();
+}
+
 void BatchProcessManager::saveProcessState()
 {
     QSettings settings("CodeAtlas", "BatchProcess");
@@ -351,7 +485,7 @@ void BatchProcessManager::saveProcessState()
 
     settings.sync();
 
-    Logger::instance().info("处理状态已保存");
+    LOG_INFO("处理状态已保存");
 }
 
 void BatchProcessManager::loadProcessState()
@@ -378,8 +512,7 @@ void BatchProcessManager::loadProcessState()
     m_totalCount = settings.value("totalCount", 0).toInt();
     m_currentIndex = settings.value("currentIndex", 0).toInt();
 
-    Logger::instance().info(
-        QString("已加载处理状态: 已处理 %1, 待重试 %2").arg(m_processedFunctions.size()).arg(m_failedFunctions.size()));
+    LOG_INFO("已加载处理状态: 已处理 %1, 待重试 %2", m_processedFunctions.size(), m_failedFunctions.size());
 }
 
 void BatchProcessManager::clearProcessState()
@@ -10,12 +10,14 @@
 #define BATCHPROCESSMANAGER_H
 
 #include <QMap>
-#include <QMutex>
 #include <QObject>
 #include <QQueue>
+#include <QRecursiveMutex>
 #include <QSet>
 #include <QTimer>
+#include "common/utils/progressthrottle.h"
 #include "core/models/batchconfig.h"
+#include "core/models/circuitbreaker.h"
 #include "core/models/extractedfunction.h"
 
 /**
@@ -23,6 +25,9 @@
  * 
  * 该类负责协调多个函数的批量AI分析，包括任务队列管理、
  * 进度追踪、错误处理、断点续传等功能。
+ * 最多同时保持 maxConcurrentRequests 个分析请求在途，任一请求完成后补派下一个函数。
+ * 失败的请求按去相关抖动退避延迟后重新入队；服务端点的熔断器打开期间暂停派发，
+ * 队列中的函数保持等待，不消耗重试次数。
  */
 class BatchProcessManager : public QObject
 {
@@ -97,7 +102,7 @@ class BatchProcessManager : public QObject
 
    signals:
     /**
-     * @brief 整体进度信号
+     * @brief 整体进度信号（按固定帧率合并，只发出最新进度）
      * @param current 当前处理的函数索引
      * @param total 总函数数量
      * @param functionName 当前处理的函数名
@@ -138,6 +143,13 @@ class BatchProcessManager : public QObject
      */
     void onAIAnalysisComplete(const AIAnalysisResponse& response);
 
+    /**
+     * @brief 延迟重试到期槽函数
+     * @param func 待重试的函数
+     * @param generation 安排重试时的运行批次，与当前批次不一致时丢弃
+     */
+    void onRetryDue(const ExtractedFunction& func, quint64 generation);
+
    private:
     /**
      * @brief 构造函数
@@ -161,6 +173,12 @@ class BatchProcessManager : public QObject
      */
     void processNext();
 
+    /**
+     * @brief 安排失败函数的延迟重试
+     * @param func 失败的函数
+     */
+    void scheduleRetry(const ExtractedFunction& func);
+
     /**
      * @brief 保存处理状态（断点续传）
      */
@@ -181,6 +199,12 @@ class BatchProcessManager : public QObject
      */
     void completeBatch();
 
+    /**
+     * @brief 记录最新进度并请求发送进度信号
+     * @param functionName 当前处理的函数名
+     */
+    void reportProgress(const QString& functionName);
+
     /**
      * @brief 检查函数是否已存在
      * @param func 函数信息
@@ -206,6 +230,15 @@ class BatchProcessManager : public QObject
     // 活跃请求
     QMap<QString, ExtractedFunction> m_activeRequests;
 
+    // 重试退避状态（函数名 -> 上一次重试延迟）
+    QMap<QString, int> m_retryDelays;
+    int m_pendingRetries;
+    quint64 m_runGeneration;
+
+    // 当前服务端点的熔断器
+    CircuitBreaker* m_breaker;
+    bool m_breakerWaiting;
+
     // 状态管理
     BatchProcessState m_state;
     BatchProcessConfig m_config;
@@ -220,8 +253,12 @@ class BatchProcessManager : public QObject
     // 定时器
     QTimer* m_processTimer;
 
-    // 互斥锁
-    mutable QMutex m_mutex;
+    // 进度信号节流（连续跳过已存在的函数时，逐个发信号会使界面频繁重绘）
+    ProgressThrottle* m_progressThrottle;
+    QString m_progressFunction;
+
+    // 互斥锁（processNext等内部函数会在已加锁的公共函数中被调用，需可重入）
+    mutable QRecursiveMutex m_mutex;
 };
 
 #endif  // BATCHPROCESSMANAGER_H
@@ -891,6 +891,78 @@ bool DatabaseManager::deleteFunctionsByProject(int projectId)
     return true;
 }
 
+QVector<FunctionData> DatabaseManager::getFunctionsByFile(int projectId, const QString& filePath)
+{
+    QVector<FunctionData> functions;
+
+    if (!checkInitialized())
+    {
+        return functions;
+    }
+
+    QSqlQuery query;
+    query.prepare(
+        "SELECT id, project_id, key, value, signature, return_type, parameters, file_path, start_line, end_line, "
+        "language, flowchart, sequence_diagram, structure_diagram, ai_model, create_time, analyze_time "
+        "FROM functions WHERE project_id = ? AND file_path = ? ORDER BY start_line ASC");
+    query.addBindValue(projectId);
+    query.addBindValue(filePath);
+
+    if (query.exec())
+    {
+        while (query.next())
+        {
+            FunctionData data;
+            data.id = query.value(0).toInt();
+            data.projectId = query.value(1).toInt();
+            data.key = query.value(2).toString();
+            data.value = query.value(3).toString();
+            data.signature = query.value(4).toString();
+            data.returnType = query.value(5).toString();
+            data.parameters = query.value(6).toString();
+            data.filePath = query.value(7).toString();
+            data.startLine = query.value(8).toInt();
+            data.endLine = query.value(9).toInt();
+            data.language = query.value(10).toString();
+            data.flowchart = query.value(11).toString();
+            data.sequenceDiagram = query.value(12).toString();
+            data.structureDiagram = query.value(13).toString();
+            data.aiModel = query.value(14).toString();
+            data.createTime = query.value(15).toDateTime();
+            data.analyzeTime = query.value(16).toDateTime();
+            functions.append(data);
+        }
+    }
+    else
+    {
+        m_lastError = "获取文件函数列表失败: " + query.lastError().text();
+        Logger::instance().error(m_lastError);
+    }
+
+    return functions;
+}
+
+bool DatabaseManager::deleteFunctionsByFile(int projectId, const QString& filePath)
+{
+    if (!checkInitialized())
+    {
+        return false;
+    }
+
+    QSqlQuery query;
+    query.prepare("DELETE FROM functions WHERE project_id = ? AND file_path = ?");
+    query.addBindValue(projectId);
+    query.addBindValue(filePath);
+
+    if (!query.exec())
+    {
+        return handleQueryError(query, "删除文件函数");
+    }
+
+    Logger::instance().info("删除文件函数成功: " + filePath);
+    return true;
+}
+
 bool DatabaseManager::functionExistsByKeyAndPath(const QString& key, const QString& filePath)
 {
     if (!checkInitialized())
@@ -218,6 +218,22 @@ class DatabaseManager : public IDatabaseManager
      */
     bool deleteFunctionsByProject(int projectId);
 
+    /**
+     * @brief 获取项目中某个源文件的所有函数（包含签名、行号等完整字段）
+     * @param projectId 项目ID
+     * @param filePath 源文件路径（相对于项目根目录）
+     * @return 函数列表
+     */
+    QVector<FunctionData> getFunctionsByFile(int projectId, const QString& filePath);
+
+    /**
+     * @brief 删除项目中某个源文件的所有函数
+     * @param projectId 项目ID
+     * @param filePath 源文件路径（相对于项目根目录）
+     * @return 删除是否成功
+     */
+    bool deleteFunctionsByFile(int projectId, const QString& filePath);
+
     /**
      * @brief 检查函数是否存在（按key和filePath组合）
      * @param key 函数名称
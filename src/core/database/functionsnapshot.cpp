@@ -0,0 +1,466 @@
+/**
+ * @file functionsnapshot.cpp
+ * @brief 只读的函数字典快照实现
+ * @author Developer
+ * @date 2026-10-18
+ * @version 1.0
+ */
+
+#include "core/database/functionsnapshot.h"
+#include <QSaveFile>
+#include <QtEndian>
+#include <cstring>
+#include "common/logger/logger.h"
+
+namespace
+{
+const char kMagic[4] = {'C', 'A', 'S', 'N'};            ///< 文件头魔数
+const quint32 kFormatVersion = 1;                       ///< 文件格式版本
+const int kHeaderSize = 64;                             ///< 文件头字节数
+const int kEntrySize = 32;                              ///< 每个条目的字节数
+const quint64 kInitialSeed = 0x9E3779B97F4A7C15ULL;     ///< 第一次尝试的哈希种子
+const int kMaxSeedAttempts = 16;                        ///< 构造失败时最多更换种子的次数
+const quint32 kMaxDisplacement = 1u << 20;              ///< 单个桶尝试的最大位移值
+const quint32 kFreeSlot = 0xFFFFFFFFu;                  ///< 尚未分配的槽位
+const quint64 kHashMultiplier = 0xC6A4A7935BD1E995ULL;  ///< 哈希乘数（MurmurHash64A）
+
+/**
+ * @brief 计算名称的64位哈希（MurmurHash64A）
+ * @param data 名称
+ * @param length 字节数
+ * @param seed 种子
+ * @return 哈希值
+ */
+quint64 snapshotHash(const char* data, size_t length, quint64 seed)
+{
+    const int shift = 47;
+    quint64 hash = seed ^ (static_cast<quint64>(length) * kHashMultiplier);
+
+    const char* blocksEnd = data + (length & ~static_cast<size_t>(7));
+    for (const char* p = data; p != blocksEnd; p += 8)
+    {
+        quint64 block = qFromLittleEndian<quint64>(p);
+        block *= kHashMultiplier;
+        block ^= block >> shift;
+        block *= kHashMultiplier;
+        hash ^= block;
+        hash *= kHashMultiplier;
+    }
+
+    const uchar* tail = reinterpret_cast<const uchar*>(blocksEnd);
+    switch (length & 7)
+    {
+        case 7:
+            hash ^= static_cast<quint64>(tail[6]) << 48;
+            [[fallthrough]];
+        case 6:
+            hash ^= static_cast<quint64>(tail[5]) << 40;
+            [[fallthrough]];
+        case 5:
+            hash ^= static_cast<quint64>(tail[4]) << 32;
+            [[fallthrough]];
+        case 4:
+            hash ^= static_cast<quint64>(tail[3]) << 24;
+            [[fallthrough]];
+        case 3:
+            hash ^= static_cast<quint64>(tail[2]) << 16;
+            [[fallthrough]];
+        case 2:
+            hash ^= static_cast<quint64>(tail[1]) << 8;
+            [[fallthrough]];
+        case 1:
+            hash ^= static_cast<quint64>(tail[0]);
+            hash *= kHashMultiplier;
+    }
+
+    hash ^= hash >> shift;
+    hash *= kHashMultiplier;
+    hash ^= hash >> shift;
+    return hash;
+}
+
+/**
+ * @brief 追加一个小端固定宽度整数
+ */
+template <typename T>
+void appendFixed(QByteArray& out, T value)
+{
+    char buffer[sizeof(T)];
+    qToLittleEndian(value, buffer);
+    out.append(buffer, sizeof(T));
+}
+
+/**
+ * @brief 检查 [offset, offset + length) 是否位于 [0, size) 内（不会溢出）
+ */
+bool inRange(quint64 offset, quint64 length, quint64 size)
+{
+    return offset <= size && length <= size - offset;
+}
+}  // namespace
+
+void FunctionSnapshotBuilder::add(const QByteArray& key, const QByteArray& value)
+{
+    if (m_indexes.contains(key))
+    {
+        return;
+    }
+    m_indexes.insert(key, m_keys.size());
+    m_keys.append(key);
+    m_values.append(value);
+}
+
+int FunctionSnapshotBuilder::size() const
+{
+    return m_keys.size();
+}
+
+bool FunctionSnapshotBuilder::write(const QString& path)
+{
+    m_lastError.clear();
+    quint32 count = static_cast<quint32>(m_keys.size());
+
+    QVector<qint32> buckets;
+    QVector<quint32> slotOwner;
+    quint64 seed = kInitialSeed;
+    if (count > 0)
+    {
+        bool built = false;
+        for (int attempt = 0; attempt < kMaxSeedAttempts && !built; ++attempt)
+        {
+            built = buildHash(seed, buckets, slotOwner);
+            if (!built)
+            {
+                seed = seed * kHashMultiplier + 1;
+            }
+        }
+        if (!built)
+        {
+            m_lastError = QString("无法为 %1 个函数名称构造完美哈希").arg(count);
+            Logger::instance().error(m_lastError);
+            return false;
+        }
+    }
+
+    // 按槽位顺序写条目和字符串池，相邻槽位的条目在文件中也相邻
+    QByteArray entries;
+    QByteArray pool;
+    entries.reserve(static_cast<int>(count) * kEntrySize);
+    for (quint32 slot = 0; slot < count; ++slot)
+    {
+        const QByteArray& key = m_keys[slotOwner[slot]];
+        const QByteArray& value = m_values[slotOwner[slot]];
+        appendFixed<quint64>(entries, static_cast<quint64>(pool.size()));
+        pool.append(key).append('\0');
+        appendFixed<quint64>(entries, static_cast<quint64>(pool.size()));
+        pool.append(value).append('\0');
+        appendFixed<quint32>(entries, static_cast<quint32>(key.size()));
+        appendFixed<quint32>(entries, static_cast<quint32>(value.size()));
+        appendFixed<quint32>(entries, static_cast<quint32>(snapshotHash(key.constData(), key.size(), seed)));
+        appendFixed<quint32>(entries, 0);
+    }
+
+    QByteArray bucketTable;
+    bucketTable.reserve(buckets.size() * 4 + 8);
+    for (qint32 bucket : buckets)
+    {
+        appendFixed<qint32>(bucketTable, bucket);
+    }
+    while ((kHeaderSize + bucketTable.size()) % 8 != 0)
+    {
+        bucketTable.append('\0');
+    }
+
+    quint64 bucketOffset = kHeaderSize;
+    quint64 entryOffset = bucketOffset + static_cast<quint64>(bucketTable.size());
+    quint64 poolOffset = entryOffset + static_cast<quint64>(entries.size());
+    quint64 fileSize = poolOffset + static_cast<quint64>(pool.size());
+
+    QByteArray header;
+    header.append(kMagic, sizeof(kMagic));
+    appendFixed<quint32>(header, kFormatVersion);
+    appendFixed<quint32>(header, count);
+    appendFixed<quint32>(header, static_cast<quint32>(buckets.size()));
+    appendFixed<quint64>(header, seed);
+    appendFixed<quint64>(header, bucketOffset);
+    appendFixed<quint64>(header, entryOffset);
+    appendFixed<quint64>(header, poolOffset);
+    appendFixed<quint64>(header, static_cast<quint64>(pool.size()));
+    appendFixed<quint64>(header, fileSize);
+
+    // 写到临时文件后替换，正在映射旧文件的读取方继续使用旧内容
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly))
+    {
+        m_lastError = "无法创建快照文件: " + file.errorString();
+        Logger::instance().error(m_lastError);
+        return false;
+    }
+    file.write(header);
+    file.write(bucketTable);
+    file.write(entries);
+    file.write(pool);
+    if (!file.commit())
+    {
+        m_lastError = "写入快照文件失败: " + file.errorString();
+        Logger::instance().error(m_lastError);
+        return false;
+    }
+
+    Logger::instance().info(QString("函数字典快照已生成: %1（%2 个函数）").arg(path).arg(count));
+    return true;
+}
+
+QString FunctionSnapshotBuilder::lastError() const
+{
+    return m_lastError;
+}
+
+bool FunctionSnapshotBuilder::buildHash(quint64 seed, QVector<qint32>& buckets, QVector<quint32>& slotOwner) const
+{
+    const quint32 count = static_cast<quint32>(m_keys.size());
+    buckets.fill(0, static_cast<int>(count));
+    slotOwner.fill(kFreeSlot, static_cast<int>(count));
+
+    // 按桶分组（计数排序）
+    QVector<quint32> bucketOf(static_cast<int>(count));
+    QVector<quint32> bucketStart(static_cast<int>(count) + 1, 0);
+    for (quint32 i = 0; i < count; ++i)
+    {
+        bucketOf[i] = static_cast<quint32>(snapshotHash(m_keys[i].constData(), m_keys[i].size(), seed) % count);
+        ++bucketStart[bucketOf[i] + 1];
+    }
+    quint32 maxBucketSize = 0;
+    for (quint32 b = 0; b < count; ++b)
+    {
+        maxBucketSize = qMax(maxBucketSize, bucketStart[b + 1]);
+        bucketStart[b + 1] += bucketStart[b];
+    }
+    QVector<quint32> members(static_cast<int>(count));
+    QVector<quint32> fill = bucketStart;
+    for (quint32 i = 0; i < count; ++i)
+    {
+        members[fill[bucketOf[i]]++] = i;
+    }
+
+    QVector<QVector<quint32>> bucketsBySize(static_cast<int>(maxBucketSize) + 1);
+    for (quint32 b = 0; b < count; ++b)
+    {
+        bucketsBySize[bucketStart[b + 1] - bucketStart[b]].append(b);
+    }
+
+    // 从大桶开始，为每个桶找一个位移值，使桶内名称落到互不相同的空槽位
+    QVector<bool> taken(static_cast<int>(count), false);
+    QVector<quint32> slots;
+    for (quint32 size = maxBucketSize; size >= 2; --size)
+    {
+        for (quint32 b : bucketsBySize[size])
+        {
+            bool placed = false;
+            for (quint32 displacement = 1; displacement <= kMaxDisplacement && !placed; ++displacement)
+            {
+                slots.clear();
+                placed = true;
+                for (quint32 m = bucketStart[b]; m < bucketStart[b + 1]; ++m)
+                {
+                    const QByteArray& key = m_keys[members[m]];
+                    quint32 slot =
+                        static_cast<quint32>(snapshotHash(key.constData(), key.size(), seed + displacement) % count);
+                    if (taken[slot] || slots.contains(slot))
+                    {
+                        placed = false;
+                        break;
+                    }
+                    slots.append(slot);
+                }
+                if (placed)
+                {
+                    for (int j = 0; j < slots.size(); ++j)
+                    {
+                        taken[slots[j]] = true;
+                        slotOwner[slots[j]] = members[bucketStart[b] + j];
+                    }
+                    buckets[b] = static_cast<qint32>(displacement);
+                }
+            }
+            if (!placed)
+            {
+                return false;
+            }
+        }
+    }
+
+    // 只有一个名称的桶直接指向剩余的空槽位
+    quint32 freeSlot = 0;
+    if (maxBucketSize >= 1)
+    {
+        for (quint32 b : bucketsBySize[1])
+        {
+            while (taken[freeSlot])
+            {
+                ++freeSlot;
+            }
+            taken[freeSlot] = true;
+            slotOwner[freeSlot] = members[bucketStart[b]];
+            buckets[b] = -static_cast<qint32>(freeSlot) - 1;
+        }
+    }
+    return true;
+}
+
+FunctionSnapshot::FunctionSnapshot()
+    : m_data(nullptr),
+      m_fileSize(0),
+      m_keyCount(0),
+      m_bucketCount(0),
+      m_seed(0),
+      m_buckets(nullptr),
+      m_entries(nullptr),
+      m_pool(nullptr),
+      m_poolSize(0)
+{
+}
+
+FunctionSnapshot::~FunctionSnapshot()
+{
+    close();
+}
+
+bool FunctionSnapshot::open(const QString& path)
+{
+    close();
+    m_lastError.clear();
+
+    m_file.setFileName(path);
+    if (!m_file.open(QIODevice::ReadOnly))
+    {
+        return fail("无法打开快照文件: " + m_file.errorString());
+    }
+    m_fileSize = static_cast<quint64>(m_file.size());
+    if (m_fileSize < static_cast<quint64>(kHeaderSize))
+    {
+        return fail("快照文件过小: " + path);
+    }
+
+    // 只读共享映射，多个进程打开同一个快照时共用页缓存
+    m_data = m_file.map(0, m_file.size());
+    if (!m_data)
+    {
+        return fail("无法映射快照文件: " + m_file.errorString());
+    }
+
+    if (std::memcmp(m_data, kMagic, sizeof(kMagic)) != 0)
+    {
+        return fail("不是函数字典快照文件: " + path);
+    }
+    quint32 version = qFromLittleEndian<quint32>(m_data + 4);
+    if (version != kFormatVersion)
+    {
+        return fail(QString("不支持的快照格式版本: %1").arg(version));
+    }
+
+    m_keyCount = qFromLittleEndian<quint32>(m_data + 8);
+    m_bucketCount = qFromLittleEndian<quint32>(m_data + 12);
+    m_seed = qFromLittleEndian<quint64>(m_data + 16);
+    quint64 bucketOffset = qFromLittleEndian<quint64>(m_data + 24);
+    quint64 entryOffset = qFromLittleEndian<quint64>(m_data + 32);
+    quint64 poolOffset = qFromLittleEndian<quint64>(m_data + 40);
+    m_poolSize = qFromLittleEndian<quint64>(m_data + 48);
+    quint64 fileSize = qFromLittleEndian<quint64>(m_data + 56);
+
+    // 只检查文件头和各段的边界，条目在查找时检查，打开快照不需要读遍整个文件
+    bool valid = fileSize == m_fileSize && (m_keyCount == 0 || m_bucketCount > 0) &&
+                 inRange(bucketOffset, static_cast<quint64>(m_bucketCount) * 4, m_fileSize) &&
+                 inRange(entryOffset, static_cast<quint64>(m_keyCount) * kEntrySize, m_fileSize) &&
+                 inRange(poolOffset, m_poolSize, m_fileSize) &&
+                 (m_poolSize == 0 || m_data[poolOffset + m_poolSize - 1] == '\0');
+    if (!valid)
+    {
+        return fail("快照文件已损坏: " + path);
+    }
+
+    m_buckets = m_data + bucketOffset;
+    m_entries = m_data + entryOffset;
+    m_pool = reinterpret_cast<const char*>(m_data + poolOffset);
+    return true;
+}
+
+void FunctionSnapshot::close()
+{
+    if (m_data)
+    {
+        m_file.unmap(const_cast<uchar*>(m_data));
+    }
+    m_file.close();
+    m_data = nullptr;
+    m_fileSize = 0;
+    m_keyCount = 0;
+    m_bucketCount = 0;
+    m_buckets = nullptr;
+    m_entries = nullptr;
+    m_pool = nullptr;
+    m_poolSize = 0;
+}
+
+bool FunctionSnapshot::lookup(const char* key, size_t length, const char** value, size_t* valueLength) const
+{
+    if (m_keyCount == 0 || key == nullptr)
+    {
+        return false;
+    }
+
+    quint64 hash = snapshotHash(key, length, m_seed);
+    qint32 displacement = qFromLittleEndian<qint32>(m_buckets + (hash % m_bucketCount) * 4);
+    quint64 slot = displacement < 0
+                       ? static_cast<quint64>(-(static_cast<qint64>(displacement) + 1))
+                       : snapshotHash(key, length, m_seed + static_cast<quint32>(displacement)) % m_keyCount;
+    if (slot >= m_keyCount)
+    {
+        return false;
+    }
+
+    // 先比较哈希和长度，不匹配的名称不会访问字符串池
+    const uchar* entry = m_entries + slot * kEntrySize;
+    if (qFromLittleEndian<quint32>(entry + 24) != static_cast<quint32>(hash) ||
+        qFromLittleEndian<quint32>(entry + 16) != length)
+    {
+        return false;
+    }
+
+    quint64 keyOffset = qFromLittleEndian<quint64>(entry);
+    quint64 valueOffset = qFromLittleEndian<quint64>(entry + 8);
+    quint64 storedValueLength = qFromLittleEndian<quint32>(entry + 20);
+    if (!inRange(keyOffset, length + 1, m_poolSize) || !inRange(valueOffset, storedValueLength + 1, m_poolSize) ||
+        std::memcmp(m_pool + keyOffset, key, length) != 0)
+    {
+        return false;
+    }
+
+    if (value)
+    {
+        *value = m_pool + valueOffset;
+    }
+    if (valueLength)
+    {
+        *valueLength = static_cast<size_t>(storedValueLength);
+    }
+    return true;
+}
+
+quint32 FunctionSnapshot::size() const
+{
+    return m_keyCount;
+}
+
+QString FunctionSnapshot::lastError() const
+{
+    return m_lastError;
+}
+
+bool FunctionSnapshot::fail(const QString& error)
+{
+    close();
+    m_lastError = error;
+    Logger::instance().error(error);
+    return false;
+}
@@ -0,0 +1,145 @@
+/**
+ * @file functionsnapshot.h
+ * @brief 只读的函数字典快照：函数名称 -> 函数介绍，内存映射后用最小完美哈希查找
+ * @author Developer
+ * @date 2026-10-18
+ * @version 1.0
+ *
+ * @details 文件格式（整数均为小端，偏移量均相对文件开头，除非另有说明）：
+ * - 文件头64字节："CASN"、u32版本、u32函数数n、u32桶数、u64哈希种子、u64桶表偏移、u64条目表偏移、
+ *   u64字符串池偏移、u64字符串池大小、u64文件大小
+ * - 桶表：每个桶一个i32。名称按 hash(种子) 分桶；值为负数v时名称位于槽位 -v-1，
+ *   否则位于槽位 hash(种子 + v) % n（哈希-位移法构造的最小完美哈希，n个名称恰好占满n个槽位）
+ * - 条目表：每个槽位32字节：u64名称偏移、u64介绍偏移（相对字符串池）、u32名称长度、u32介绍长度、
+ *   u32名称哈希低32位、u32保留
+ * - 字符串池：名称和介绍的UTF-8文本，各以0结尾，查找结果可以直接作为C字符串使用
+ * 快照不可修改，生成时整体写入临时文件后替换，已映射旧文件的读取方不受影响；
+ * 多个进程映射同一个文件时共享操作系统的页缓存。
+ */
+
+#ifndef FUNCTIONSNAPSHOT_H
+#define FUNCTIONSNAPSHOT_H
+
+#include <QByteArray>
+#include <QFile>
+#include <QHash>
+#include <QString>
+#include <QVector>
+#include <cstddef>
+
+/**
+ * @brief 快照生成器
+ */
+class FunctionSnapshotBuilder
+{
+   public:
+    /**
+     * @brief 添加一个函数（同名函数只保留第一次添加的介绍）
+     * @param key 函数名称（UTF-8）
+     * @param value 函数介绍（UTF-8）
+     */
+    void add(const QByteArray& key, const QByteArray& value);
+
+    /**
+     * @brief 获取已添加的函数数
+     * @return 函数数
+     */
+    int size() const;
+
+    /**
+     * @brief 构造最小完美哈希并写出快照文件（先写临时文件，成功后替换目标文件）
+     * @param path 快照文件路径
+     * @return 是否成功
+     */
+    bool write(const QString& path);
+
+    /**
+     * @brief 获取最后一次错误信息
+     * @return 错误信息
+     */
+    QString lastError() const;
+
+   private:
+    /**
+     * @brief 用指定种子构造桶表和槽位分配
+     * @param seed 哈希种子
+     * @param buckets 输出参数，桶表
+     * @param slotOwner 输出参数，槽位 -> 函数下标
+     * @return 是否成功（某个桶找不到可用的位移值时返回false，换种子重试）
+     */
+    bool buildHash(quint64 seed, QVector<qint32>& buckets, QVector<quint32>& slotOwner) const;
+
+    QVector<QByteArray> m_keys;        ///< 函数名称
+    QVector<QByteArray> m_values;      ///< 函数介绍
+    QHash<QByteArray, int> m_indexes;  ///< 函数名称 -> 下标（用于去重）
+    QString m_lastError;               ///< 最后一次错误信息
+};
+
+/**
+ * @brief 快照读取器（打开后只读，可在多个线程中同时查找）
+ */
+class FunctionSnapshot
+{
+   public:
+    FunctionSnapshot();
+    ~FunctionSnapshot();
+
+    FunctionSnapshot(const FunctionSnapshot&) = delete;
+    FunctionSnapshot& operator=(const FunctionSnapshot&) = delete;
+
+    /**
+     * @brief 以只读方式映射快照文件并检查文件头
+     * @param path 快照文件路径
+     * @return 是否成功
+     */
+    bool open(const QString& path);
+
+    /**
+     * @brief 解除映射并关闭文件
+     */
+    void close();
+
+    /**
+     * @brief 查找函数介绍（不分配内存）
+     * @param key 函数名称（UTF-8）
+     * @param length 名称字节数
+     * @param value 输出参数，指向映射内存中以0结尾的介绍，在 close 前有效
+     * @param valueLength 输出参数（可为nullptr），介绍字节数
+     * @return 是否找到
+     */
+    bool lookup(const char* key, size_t length, const char** value, size_t* valueLength) const;
+
+    /**
+     * @brief 获取快照中的函数数
+     * @return 函数数
+     */
+    quint32 size() const;
+
+    /**
+     * @brief 获取最后一次错误信息
+     * @return 错误信息
+     */
+    QString lastError() const;
+
+   private:
+    /**
+     * @brief 记录错误并关闭文件
+     * @param error 错误信息
+     * @return false（统一返回 false）
+     */
+    bool fail(const QString& error);
+
+    QFile m_file;            ///< 快照文件（映射期间保持打开）
+    const uchar* m_data;     ///< 映射的文件内容
+    quint64 m_fileSize;      ///< 文件大小
+    quint32 m_keyCount;      ///< 函数数（槽位数）
+    quint32 m_bucketCount;   ///< 桶数
+    quint64 m_seed;          ///< 哈希种子
+    const uchar* m_buckets;  ///< 桶表
+    const uchar* m_entries;  ///< 条目表
+    const char* m_pool;      ///< 字符串池
+    quint64 m_poolSize;      ///< 字符串池大小
+    QString m_lastError;     ///< 最后一次错误信息
+};
+
+#endif  // FUNCTIONSNAPSHOT_H
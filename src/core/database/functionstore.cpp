@@ -0,0 +1,509 @@
+/**
+ * @file functionstore.cpp
+ * @brief 面向批量读写的函数表访问类实现
+ * @author Developer
+ * @date 2026-10-18
+ * @version 1.0
+ */
+
+#include "core/database/functionstore.h"
+#include <QDateTime>
+#include <QHash>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QSet>
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QThread>
+#include <QVariant>
+#include <atomic>
+#include "common/logger/logger.h"
+#include "core/database/functionsnapshot.h"
+
+namespace
+{
+const int kBusyTimeoutMs = 5000;  ///< 写锁被占用时的最长等待时间
+const int kExistsChunk = 500;     ///< 批量查询时每条语句的参数个数（低于SQLite的参数上限）
+
+const char* const kInsertSql =
+    "INSERT OR IGNORE INTO functions (project_id, key, value, signature, file_path, start_line, end_line, "
+    "language, create_time) VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?)";
+
+const char* const kUpsertSql =
+    "INSERT INTO functions (project_id, key, value, signature, file_path, start_line, end_line, language, "
+    "create_time) VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?) "
+    "ON CONFLICT(key, file_path) DO UPDATE SET project_id = excluded.project_id, value = excluded.value, "
+    "signature = excluded.signature, start_line = excluded.start_line, end_line = excluded.end_line, "
+    "language = excluded.language";
+
+const char* const kCursorColumns =
+    "SELECT id, project_id, key, value, signature, file_path, language, start_line, end_line FROM functions ";
+
+std::atomic<quint64> g_nextStoreId(1);  ///< 下一个句柄编号
+
+/**
+ * @brief 仍未析构的句柄编号（线程据此释放已关闭句柄的连接）
+ */
+QSet<quint64>& liveStores()
+{
+    static QSet<quint64> stores;
+    return stores;
+}
+
+QMutex& liveStoresMutex()
+{
+    static QMutex mutex;
+    return mutex;
+}
+
+/**
+ * @brief 一个线程在一个句柄上的状态
+ */
+struct ThreadState
+{
+    QString connectionName;  ///< 连接名称，为空表示尚未创建连接
+    QString lastError;       ///< 最后一次错误信息
+    QByteArray errorUtf8;    ///< lastError 的UTF-8副本
+};
+
+/**
+ * @brief 释放连接
+ * @param connectionName 连接名称
+ */
+void removeConnection(const QString& connectionName)
+{
+    if (connectionName.isEmpty())
+    {
+        return;
+    }
+    {
+        QSqlDatabase db = QSqlDatabase::database(connectionName, false);
+        db.close();
+    }
+    QSqlDatabase::removeDatabase(connectionName);
+}
+
+/**
+ * @brief 当前线程在各句柄上的状态，线程退出时释放所有连接
+ */
+struct ThreadStates
+{
+    QHash<quint64, ThreadState> states;  ///< 句柄编号 -> 状态
+
+    ~ThreadStates()
+    {
+        for (const ThreadState& state : states)
+        {
+            removeConnection(state.connectionName);
+        }
+    }
+
+    /**
+     * @brief 释放已析构的句柄留在当前线程的连接
+     */
+    void pruneClosed()
+    {
+        QMutexLocker locker(&liveStoresMutex());
+        for (auto it = states.begin(); it != states.end();)
+        {
+            if (liveStores().contains(it.key()))
+            {
+                ++it;
+                continue;
+            }
+            removeConnection(it.value().connectionName);
+            it = states.erase(it);
+        }
+    }
+};
+
+thread_local ThreadStates t_states;
+
+/**
+ * @brief 把可为空的字符串绑定为文本，空字符串绑定为空串而不是NULL（NULL 不参与唯一约束）
+ * @param text 字符串
+ * @return 绑定值
+ */
+QVariant textValue(const QString& text)
+{
+    return text.isNull() ? QVariant(QString("")) : QVariant(text);
+}
+
+/**
+ * @brief 转义 LIKE 模式中的通配符
+ * @param text 文本
+ * @return 转义后的文本（转义字符为反斜杠）
+ */
+QString escapeLike(const QString& text)
+{
+    QString escaped = text;
+    escaped.replace("\\", "\\\\");
+    escaped.replace("%", "\\%");
+    escaped.replace("_", "\\_");
+    return escaped;
+}
+}  // namespace
+
+FunctionCursor::FunctionCursor(const QSqlQuery& query) : m_query(query) {}
+
+bool FunctionCursor::next()
+{
+    if (m_query.next())
+    {
+        return true;
+    }
+    if (m_query.lastError().isValid())
+    {
+        m_lastError = "读取查询结果失败: " + m_query.lastError().text();
+    }
+    // 读完后立即结束语句，释放读事务
+    m_query.finish();
+    return false;
+}
+
+QVariant FunctionCursor::value(Column column) const
+{
+    return m_query.value(static_cast<int>(column));
+}
+
+QString FunctionCursor::lastError() const
+{
+    return m_lastError;
+}
+
+FunctionStore::FunctionStore(const QString& dbPath)
+    : m_id(g_nextStoreId.fetch_add(1, std::memory_order_relaxed)), m_dbPath(dbPath)
+{
+    QMutexLocker locker(&liveStoresMutex());
+    liveStores().insert(m_id);
+}
+
+FunctionStore::~FunctionStore()
+{
+    {
+        QMutexLocker locker(&liveStoresMutex());
+        liveStores().remove(m_id);
+    }
+
+    auto it = t_states.states.find(m_id);
+    if (it != t_states.states.end())
+    {
+        removeConnection(it.value().connectionName);
+        t_states.states.erase(it);
+    }
+}
+
+bool FunctionStore::open()
+{
+    QSqlDatabase db;
+    return threadConnection(db);
+}
+
+bool FunctionStore::writeFunctions(const QVector<FunctionRecord>& records, bool replaceExisting, int* affected)
+{
+    if (affected)
+    {
+        *affected = 0;
+    }
+
+    QSqlDatabase db;
+    if (!threadConnection(db))
+    {
+        return false;
+    }
+    if (records.isEmpty())
+    {
+        return true;
+    }
+
+    if (!db.transaction())
+    {
+        return fail("开始事务失败: " + db.lastError().text());
+    }
+
+    QSqlQuery query(db);
+    if (!query.prepare(replaceExisting ? kUpsertSql : kInsertSql))
+    {
+        QString error = query.lastError().text();
+        db.rollback();
+        return fail("准备批量写入语句失败: " + error);
+    }
+
+    QDateTime now = QDateTime::currentDateTime();
+    int written = 0;
+    for (int i = 0; i < records.size(); ++i)
+    {
+        const FunctionRecord& record = records[i];
+        if (record.key.trimmed().isEmpty())
+        {
+            db.rollback();
+            return fail(QString("第 %1 条记录的函数名称为空").arg(i));
+        }
+
+        query.bindValue(0, record.projectId > 0 ? QVariant(record.projectId) : QVariant());
+        query.bindValue(1, record.key);
+        query.bindValue(2, textValue(record.value));
+        query.bindValue(3, record.signature);
+        query.bindValue(4, textValue(record.filePath));
+        query.bindValue(5, record.startLine);
+        query.bindValue(6, record.endLine);
+        query.bindValue(7, record.language);
+        query.bindValue(8, now);
+        if (!query.exec())
+        {
+            QString error = query.lastError().text();
+            db.rollback();
+            return fail(QString("批量写入第 %1 条记录失败: %2").arg(i).arg(error));
+        }
+        written += qMax(0, query.numRowsAffected());
+    }
+
+    if (!db.commit())
+    {
+        QString error = db.lastError().text();
+        db.rollback();
+        return fail("提交批量写入失败: " + error);
+    }
+
+    if (affected)
+    {
+        *affected = written;
+    }
+    return true;
+}
+
+bool FunctionStore::functionsExist(const QStringList& keys, QVector<bool>& exists)
+{
+    exists.fill(false, keys.size());
+
+    QSqlDatabase db;
+    if (!threadConnection(db))
+    {
+        return false;
+    }
+    if (keys.isEmpty())
+    {
+        return true;
+    }
+
+    // 读事务保证各分块看到同一个快照，也避免每条语句单独加锁
+    if (!db.transaction())
+    {
+        return fail("开始事务失败: " + db.lastError().text());
+    }
+
+    QSqlQuery chunkQuery(db);
+    int preparedSize = 0;
+    for (int begin = 0; begin < keys.size(); begin += kExistsChunk)
+    {
+        int size = qMin(kExistsChunk, keys.size() - begin);
+        if (size != preparedSize)
+        {
+            QString placeholders = QString("?,").repeated(size);
+            placeholders.chop(1);
+            if (!chunkQuery.prepare(QString("SELECT DISTINCT key FROM functions WHERE key IN (%1)").arg(placeholders)))
+            {
+                QString error = chunkQuery.lastError().text();
+                db.rollback();
+                return fail("准备批量查询语句失败: " + error);
+            }
+            preparedSize = size;
+        }
+
+        for (int i = 0; i < size; ++i)
+        {
+            chunkQuery.bindValue(i, keys[begin + i]);
+        }
+        if (!chunkQuery.exec())
+        {
+            QString error = chunkQuery.lastError().text();
+            db.rollback();
+            return fail("批量查询函数失败: " + error);
+        }
+
+        QSet<QString> found;
+        while (chunkQuery.next())
+        {
+            found.insert(chunkQuery.value(0).toString());
+        }
+        for (int i = 0; i < size; ++i)
+        {
+            exists[begin + i] = found.contains(keys[begin + i]);
+        }
+    }
+
+    db.commit();
+    return true;
+}
+
+std::unique_ptr<FunctionCursor> FunctionStore::openCursor(FunctionFilter filter, const QVariant& argument)
+{
+    QSqlDatabase db;
+    if (!threadConnection(db))
+    {
+        return nullptr;
+    }
+
+    // 只向前的查询按需逐行读取，不在内存中缓存结果集；不加 ORDER BY，避免排序需要读完全部结果
+    QSqlQuery query(db);
+    query.setForwardOnly(true);
+    QString sql = kCursorColumns;
+    switch (filter)
+    {
+        case FunctionFilter::Project:
+            query.prepare(sql + "WHERE project_id = ?");
+            query.addBindValue(argument.toInt());
+            break;
+        case FunctionFilter::Key:
+            query.prepare(sql + "WHERE key = ?");
+            query.addBindValue(argument.toString());
+            break;
+        case FunctionFilter::KeyPrefix:
+        {
+            // 用区间代替 LIKE，可以走函数名称索引；U+10FFFF 的UTF-8编码大于任何以前缀开头的名称
+            QString prefix = argument.toString();
+            query.prepare(sql + "WHERE key >= ? AND key <= ?");
+            query.addBindValue(prefix);
+            query.addBindValue(prefix + QString::fromUcs4(U"\U0010FFFF"));
+            break;
+        }
+        case FunctionFilter::Text:
+        {
+            QString pattern = "%" + escapeLike(argument.toString()) + "%";
+            query.prepare(sql + "WHERE key LIKE ? ESCAPE '\\' OR signature LIKE ? ESCAPE '\\' "
+                                "OR value LIKE ? ESCAPE '\\'");
+            query.addBindValue(pattern);
+            query.addBindValue(pattern);
+            query.addBindValue(pattern);
+            break;
+        }
+        case FunctionFilter::All:
+            query.prepare(sql);
+            break;
+    }
+
+    if (!query.exec())
+    {
+        fail("执行函数查询失败: " + query.lastError().text());
+        return nullptr;
+    }
+    return std::unique_ptr<FunctionCursor>(new FunctionCursor(query));
+}
+
+bool FunctionStore::exportSnapshot(const QString& path, int* count)
+{
+    if (count)
+    {
+        *count = 0;
+    }
+
+    std::unique_ptr<FunctionCursor> cursor = openCursor(FunctionFilter::All, QVariant());
+    if (!cursor)
+    {
+        return false;
+    }
+
+    FunctionSnapshotBuilder builder;
+    while (cursor->next())
+    {
+        builder.add(cursor->value(FunctionCursor::Key).toString().toUtf8(),
+                    cursor->value(FunctionCursor::Value).toString().toUtf8());
+    }
+    if (!cursor->lastError().isEmpty())
+    {
+        return fail(cursor->lastError());
+    }
+    cursor.reset();
+
+    if (!builder.write(path))
+    {
+        return fail(builder.lastError());
+    }
+    if (count)
+    {
+        *count = builder.size();
+    }
+    return true;
+}
+
+QString FunctionStore::lastError() const
+{
+    auto it = t_states.states.constFind(m_id);
+    return it != t_states.states.constEnd() ? it.value().lastError : QString();
+}
+
+const QByteArray& FunctionStore::lastErrorUtf8() const
+{
+    static const QByteArray empty;
+    auto it = t_states.states.constFind(m_id);
+    return it != t_states.states.constEnd() ? it.value().errorUtf8 : empty;
+}
+
+bool FunctionStore::threadConnection(QSqlDatabase& db)
+{
+    auto it = t_states.states.find(m_id);
+    if (it != t_states.states.end() && !it.value().connectionName.isEmpty())
+    {
+        clearError();
+        db = QSqlDatabase::database(it.value().connectionName, false);
+        return true;
+    }
+
+    // 新建连接前顺便释放已关闭句柄留下的连接
+    t_states.pruneClosed();
+    t_states.states[m_id];
+    clearError();
+
+    QString connectionName = QString("function_store_%1_%2")
+                                 .arg(m_id)
+                                 .arg(reinterpret_cast<quintptr>(QThread::currentThreadId()), 0, 16);
+    db = QSqlDatabase::addDatabase("QSQLITE", connectionName);
+    db.setDatabaseName(m_dbPath);
+    db.setConnectOptions(QString("QSQLITE_BUSY_TIMEOUT=%1").arg(kBusyTimeoutMs));
+    if (!db.open())
+    {
+        QString error = db.lastError().text();
+        db = QSqlDatabase();
+        QSqlDatabase::removeDatabase(connectionName);
+        return fail("无法打开数据库: " + error);
+    }
+
+    QSqlQuery query(db);
+    query.exec("PRAGMA journal_mode=WAL");
+    query.exec("PRAGMA synchronous=NORMAL");
+    if (!query.exec("SELECT 1 FROM sqlite_master WHERE type = 'table' AND name = 'functions'") || !query.next())
+    {
+        query = QSqlQuery();
+        db.close();
+        db = QSqlDatabase();
+        QSqlDatabase::removeDatabase(connectionName);
+        return fail("数据库中没有functions表，请先初始化数据库: " + m_dbPath);
+    }
+
+    t_states.states[m_id].connectionName = connectionName;
+    return true;
+}
+
+void FunctionStore::setLastError(const QString& error)
+{
+    ThreadState& state = t_states.states[m_id];
+    state.lastError = error;
+    state.errorUtf8 = error.toUtf8();
+    Logger::instance().error(error);
+}
+
+bool FunctionStore::fail(const QString& error)
+{
+    setLastError(error);
+    return false;
+}
+
+void FunctionStore::clearError()
+{
+    ThreadState& state = t_states.states[m_id];
+    if (!state.lastError.isEmpty())
+    {
+        state.lastError.clear();
+        state.errorUtf8.clear();
+    }
+}
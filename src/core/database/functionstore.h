@@ -0,0 +1,214 @@
+/**
+ * @file functionstore.h
+ * @brief 面向批量读写的函数表访问类，可被多个线程同时使用
+ * @author Developer
+ * @date 2026-10-18
+ * @version 1.0
+ *
+ * @details 与 DatabaseManager 单例不同，每个 FunctionStore 是一个独立的数据库句柄：
+ * - 每个调用线程首次使用时创建自己的SQLite连接（Qt的数据库连接不能跨线程使用），线程退出时释放
+ * - 连接启用WAL和忙等待，多个线程可以同时读，写操作由SQLite串行化
+ * - 批量写入和批量查询各在一个事务中完成，语句只准备一次
+ * - 错误信息按线程保存，一个线程的失败不会覆盖其他线程的错误信息
+ * - 查询以游标返回，逐行从SQLite读取，结果集再大也只占用固定的内存
+ */
+
+#ifndef FUNCTIONSTORE_H
+#define FUNCTIONSTORE_H
+
+#include <QByteArray>
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QString>
+#include <QStringList>
+#include <QVariant>
+#include <QVector>
+#include <memory>
+
+/**
+ * @brief 批量写入使用的函数记录（只包含导入时常用的字段）
+ */
+struct FunctionRecord
+{
+    int projectId;      ///< 所属项目ID，小于等于0表示不属于任何项目
+    QString key;        ///< 函数名称
+    QString value;      ///< 函数介绍（Markdown格式）
+    QString signature;  ///< 函数签名
+    QString filePath;   ///< 源文件路径（与函数名称一起唯一确定一个函数）
+    int startLine;      ///< 起始行号
+    int endLine;        ///< 结束行号
+    QString language;   ///< 编程语言
+
+    FunctionRecord() : projectId(0), startLine(0), endLine(0) {}
+};
+
+/**
+ * @brief 函数查询的过滤方式
+ */
+enum class FunctionFilter
+{
+    Project,    ///< 按项目ID
+    Key,        ///< 按函数名称精确匹配
+    KeyPrefix,  ///< 按函数名称前缀（使用函数名称索引，按名称排序）
+    Text,       ///< 函数名称、签名或介绍中包含指定文本（不区分ASCII大小写，全表扫描）
+    All         ///< 所有函数（忽略过滤参数）
+};
+
+/**
+ * @brief 函数查询游标，按行向前读取
+ *
+ * @details 游标使用打开它的线程的连接，只能在该线程使用，并须在句柄析构前释放。
+ */
+class FunctionCursor
+{
+   public:
+    /**
+     * @brief 结果列
+     */
+    enum Column
+    {
+        Id,         ///< 函数ID
+        ProjectId,  ///< 所属项目ID（不属于任何项目时为NULL）
+        Key,        ///< 函数名称
+        Value,      ///< 函数介绍
+        Signature,  ///< 函数签名
+        FilePath,   ///< 源文件路径
+        Language,   ///< 编程语言
+        StartLine,  ///< 起始行号
+        EndLine     ///< 结束行号
+    };
+
+    /**
+     * @brief 移动到下一行
+     * @return 是否有下一行；读完或出错时返回false，出错时 lastError 不为空
+     */
+    bool next();
+
+    /**
+     * @brief 读取当前行的列
+     * @param column 列
+     * @return 列的值
+     */
+    QVariant value(Column column) const;
+
+    /**
+     * @brief 获取最后一次错误信息
+     * @return 错误信息，没有错误时为空
+     */
+    QString lastError() const;
+
+   private:
+    friend class FunctionStore;
+
+    /**
+     * @brief 构造函数（由 FunctionStore::openCursor 创建）
+     * @param query 已执行的只向前查询
+     */
+    explicit FunctionCursor(const QSqlQuery& query);
+
+    QSqlQuery m_query;    ///< 只向前查询
+    QString m_lastError;  ///< 最后一次错误信息
+};
+
+/**
+ * @brief 函数表批量访问类
+ *
+ * @details 除构造和析构外的成员函数都可以在任意线程并发调用；析构前调用方须保证没有其他线程仍在使用。
+ * 析构时只释放当前线程的连接，其他线程的连接在这些线程下次创建连接或退出时释放。
+ */
+class FunctionStore
+{
+   public:
+    /**
+     * @brief 构造函数（不打开连接）
+     * @param dbPath 数据库文件路径（须是已由 DatabaseManager 初始化过表结构的数据库）
+     */
+    explicit FunctionStore(const QString& dbPath);
+
+    ~FunctionStore();
+
+    FunctionStore(const FunctionStore&) = delete;
+    FunctionStore& operator=(const FunctionStore&) = delete;
+
+    /**
+     * @brief 为当前线程打开连接并检查表结构
+     * @return 是否成功
+     */
+    bool open();
+
+    /**
+     * @brief 在一个事务中批量写入函数，任何一条失败时整批回滚
+     * @param records 函数记录
+     * @param replaceExisting 为true时更新（函数名称, 源文件路径）相同的已有函数，为false时跳过已有函数
+     * @param affected 输出参数（可为nullptr），实际插入或更新的行数
+     * @return 是否成功
+     */
+    bool writeFunctions(const QVector<FunctionRecord>& records, bool replaceExisting, int* affected = nullptr);
+
+    /**
+     * @brief 在一个读事务中批量检查函数名称是否存在
+     * @param keys 函数名称
+     * @param exists 输出参数，与 keys 一一对应
+     * @return 是否成功
+     */
+    bool functionsExist(const QStringList& keys, QVector<bool>& exists);
+
+    /**
+     * @brief 在当前线程打开函数查询游标
+     * @param filter 过滤方式
+     * @param argument 过滤参数（项目ID、函数名称、名称前缀或搜索文本）
+     * @return 游标，失败时返回nullptr
+     */
+    std::unique_ptr<FunctionCursor> openCursor(FunctionFilter filter, const QVariant& argument);
+
+    /**
+     * @brief 把所有函数的名称和介绍导出为只读快照（见 FunctionSnapshot），同名函数保留最早添加的一个
+     * @param path 快照文件路径
+     * @param count 输出参数（可为nullptr），快照中的函数数
+     * @return 是否成功
+     */
+    bool exportSnapshot(const QString& path, int* count = nullptr);
+
+    /**
+     * @brief 获取当前线程在本句柄上最后一次错误信息
+     * @return 错误信息，没有错误时为空
+     */
+    QString lastError() const;
+
+    /**
+     * @brief 获取当前线程在本句柄上最后一次错误信息的UTF-8副本（在本线程下次调用本句柄前有效）
+     * @return 错误信息
+     */
+    const QByteArray& lastErrorUtf8() const;
+
+    /**
+     * @brief 记录当前线程在本句柄上的错误信息（供调用方报告参数错误）
+     * @param error 错误信息
+     */
+    void setLastError(const QString& error);
+
+   private:
+    /**
+     * @brief 获取当前线程的连接，首次使用时创建并配置
+     * @param db 输出参数，连接
+     * @return 是否成功
+     */
+    bool threadConnection(QSqlDatabase& db);
+
+    /**
+     * @brief 记录当前线程的错误信息
+     * @param error 错误信息
+     * @return false（统一返回 false）
+     */
+    bool fail(const QString& error);
+
+    /**
+     * @brief 清除当前线程的错误信息
+     */
+    void clearError();
+
+    quint64 m_id;      ///< 句柄编号（进程内唯一，用于区分各线程中的连接）
+    QString m_dbPath;  ///< 数据库文件路径
+};
+
+#endif  // FUNCTIONSTORE_H
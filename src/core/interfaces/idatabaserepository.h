@@ -61,6 +61,8 @@ class IFunctionRepository
     virtual FunctionData getFunctionById(int id) = 0;
     virtual FunctionData getFunctionByKey(const QString& key) = 0;
     virtual QVector<FunctionData> getFunctionsByProject(int projectId) = 0;
+    virtual QVector<FunctionData> getFunctionsByFile(int projectId, const QString& filePath) = 0;
+    virtual bool deleteFunctionsByFile(int projectId, const QString& filePath) = 0;
     virtual bool functionExists(const QString& key) = 0;
     virtual bool functionExistsByKeyAndPath(const QString& key, const QString& filePath) = 0;
     virtual int addFunctionsBatch(const QVector<FunctionData>& functions) = 0;
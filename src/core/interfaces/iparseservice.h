@@ -89,6 +89,12 @@ class IParseService : public QObject
      */
     void parseProgress(const ParseProgress& progress);
 
+    /**
+     * @brief 一批函数保存完成信号（文件夹解析期间逐批发出）
+     * @param functions 已保存的函数摘要
+     */
+    void functionsPersisted(const QVector<FunctionSummary>& functions);
+
     /**
      * @brief 解析失败信号
      * @param error 错误信息
@@ -25,11 +25,15 @@ struct AIConfig
     QString apiKey;         ///< API密钥
     QString defaultModel;   ///< 默认选中的模型
     QStringList modelList;  ///< 支持的模型列表
+    int poolWeight;         ///< 端点池模式下的路由权重
+    int requestsPerMinute;  ///< 端点池模式下该端点每分钟请求数上限（0表示不限制）
+    int tokensPerMinute;    ///< 端点池模式下该端点每分钟token数上限（0表示不限制）
+    int maxConcurrent;      ///< 端点池模式下该端点最大并发请求数
 
     /**
      * @brief 默认构造函数
      */
-    AIConfig() : provider("其他") {}
+    AIConfig() : provider("其他"), poolWeight(1), requestsPerMinute(60), tokensPerMinute(0), maxConcurrent(2) {}
 
     /**
      * @brief 从JSON对象加载配置
@@ -42,6 +46,10 @@ struct AIConfig
         baseUrl = json["baseUrl"].toString();
         apiKey = json["apiKey"].toString();
         defaultModel = json["defaultModel"].toString();
+        poolWeight = json["poolWeight"].toInt(1);
+        requestsPerMinute = json["requestsPerMinute"].toInt(60);
+        tokensPerMinute = json["tokensPerMinute"].toInt(0);
+        maxConcurrent = json["maxConcurrent"].toInt(2);
 
         modelList.clear();
         QJsonArray modelsArray = json["modelList"].toArray();
@@ -63,6 +71,10 @@ struct AIConfig
         json["baseUrl"] = baseUrl;
         json["apiKey"] = apiKey;
         json["defaultModel"] = defaultModel;
+        json["poolWeight"] = poolWeight;
+        json["requestsPerMinute"] = requestsPerMinute;
+        json["tokensPerMinute"] = tokensPerMinute;
+        json["maxConcurrent"] = maxConcurrent;
 
         QJsonArray modelsArray;
         for (const QString& model : modelList)
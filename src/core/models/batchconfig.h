@@ -15,6 +15,7 @@
 #include <QSet>
 #include <QString>
 #include "core/models/extractedfunction.h"
+#include "core/models/processerror.h"
 
 /**
  * @brief 批量处理状态枚举
@@ -33,13 +34,16 @@ enum class BatchProcessState
  */
 struct BatchProcessConfig
 {
-    int maxConcurrentRequests = 1;  ///< 最大并发请求数
-    int requestTimeout = 60000;     ///< 请求超时时间（毫秒）
-    int maxRetryCount = 3;          ///< 最大重试次数
-    int retryDelay = 2000;          ///< 重试延迟（毫秒）
-    int requestInterval = 1000;     ///< 请求间隔（毫秒，用于速率限制）
-    bool skipExisting = true;       ///< 是否跳过已存在的函数
-    bool enableCheckpoint = true;   ///< 是否启用断点续传
+    int maxConcurrentRequests = 1;    ///< 最大并发请求数
+    int requestTimeout = 60000;       ///< 请求超时时间（毫秒）
+    int maxRetryCount = 3;            ///< 最大重试次数
+    int retryDelay = 2000;            ///< 重试基础延迟（毫秒，抖动退避的下限）
+    int maxRetryDelay = 60000;        ///< 重试延迟上限（毫秒）
+    int requestInterval = 1000;       ///< 请求间隔（毫秒，用于速率限制）
+    bool skipExisting = true;         ///< 是否跳过已存在的函数
+    bool enableCheckpoint = true;     ///< 是否启用断点续传
+    int breakerFailureThreshold = 5;  ///< 熔断器连续失败阈值
+    int breakerOpenDuration = 30000;  ///< 熔断器打开后的冷却时间（毫秒）
 
     /**
      * @brief 默认构造函数
@@ -81,6 +85,8 @@ struct RequestQueueStatus
     int failedRequests;     ///< 失败请求数
     QDateTime startTime;    ///< 开始时间
     qint64 elapsedTime;     ///< 已用时间（毫秒）
+    qint64 tokensSent;      ///< 本次运行已发送的token数（提示词）
+    qint64 tokensReceived;  ///< 本次运行已接收的token数（输出）
 
     /**
      * @brief 默认构造函数
@@ -91,7 +97,9 @@ struct RequestQueueStatus
           activeRequests(0),
           completedRequests(0),
           failedRequests(0),
-          elapsedTime(0)
+          elapsedTime(0),
+          tokensSent(0),
+          tokensReceived(0)
     {
     }
 };
@@ -133,59 +141,23 @@ struct AIAnalysisResponse
     qint64 responseTime;          ///< 响应时间（毫秒）
     QString aiModel;              ///< 使用的AI模型
     QDateTime analyzeTime;        ///< 分析时间
+    int promptTokens;             ///< 提示词token数（来自usage，缺失时为估算值）
+    int completionTokens;         ///< 输出token数（来自usage）
+    ProcessErrorType errorType;   ///< 失败时的错误类型
 
     /**
      * @brief 默认构造函数
      */
-    AIAnalysisResponse() : success(false), retryCount(0), responseTime(0), analyzeTime(QDateTime::currentDateTime()) {}
-};
-
-/**
- * @brief 错误类型枚举
- */
-enum class ProcessErrorType
-{
-    None,              ///< 无错误
-    FileNotFound,      ///< 文件不存在
-    FileReadError,     ///< 文件读取错误
-    ParseError,        ///< 解析错误
-    AIConfigError,     ///< AI配置错误
-    AIRequestError,    ///< AI请求错误
-    AIRateLimitError,  ///< AI速率限制错误
-    AITimeoutError,    ///< AI超时错误
-    AIResponseError,   ///< AI响应错误
-    DatabaseError,     ///< 数据库错误
-    DuplicateError,    ///< 重复错误
-    UnknownError       ///< 未知错误
-};
-
-/**
- * @brief 错误信息结构
- */
-struct ProcessError
-{
-    ProcessErrorType type;  ///< 错误类型
-    QString message;        ///< 错误消息
-    QString functionName;   ///< 相关函数名
-    int retryCount;         ///< 重试次数
-    bool recoverable;       ///< 是否可恢复
-
-    /**
-     * @brief 默认构造函数
-     */
-    ProcessError() : type(ProcessErrorType::None), retryCount(0), recoverable(true) {}
-};
-
-/**
- * @brief 错误处理动作枚举
- */
-enum class ErrorAction
-{
-    Retry,           ///< 重试
-    Skip,            ///< 跳过
-    Abort,           ///< 中止
-    Pause,           ///< 暂停等待用户确认
-    SaveAndContinue  ///< 保存状态并继续下一个
+    AIAnalysisResponse()
+        : success(false),
+          retryCount(0),
+          responseTime(0),
+          analyzeTime(QDateTime::currentDateTime()),
+          promptTokens(0),
+          completionTokens(0),
+          errorType(ProcessErrorType::None)
+    {
+    }
 };
 
 #endif  // BATCHCONFIG_H
@@ -0,0 +1,183 @@
+/**
+ * @file circuitbreaker.cpp
+ * @brief 熔断器实现
+ * @author Developer
+ * @date 2026-10-18
+ * @version 1.0
+ */
+
+#include "core/models/circuitbreaker.h"
+#include "common/logger/logger.h"
+
+namespace
+{
+const int kMaxOpenDurationMultiplier = 8;  ///< 冷却时间最多放大到基础值的倍数
+}  // namespace
+
+CircuitBreaker::CircuitBreaker(const QString& name, int failureThreshold, int openDurationMs, QObject* parent)
+    : QObject(parent),
+      m_name(name),
+      m_state(CircuitState::Closed),
+      m_failureThreshold(qMax(1, failureThreshold)),
+      m_baseOpenDuration(qMax(0, openDurationMs)),
+      m_openDuration(qMax(0, openDurationMs)),
+      m_consecutiveFailures(0),
+      m_openedAt(0),
+      m_probeStartedAt(-1),
+      m_rejectedCount(0)
+{
+    m_clock.start();
+}
+
+void CircuitBreaker::setFailureThreshold(int failureThreshold)
+{
+    QMutexLocker locker(&m_mutex);
+    m_failureThreshold = qMax(1, failureThreshold);
+}
+
+void CircuitBreaker::setOpenDuration(int openDurationMs)
+{
+    QMutexLocker locker(&m_mutex);
+    m_baseOpenDuration = qMax(0, openDurationMs);
+    m_openDuration = m_baseOpenDuration;
+}
+
+bool CircuitBreaker::allowRequest()
+{
+    QMutexLocker locker(&m_mutex);
+
+    qint64 now = m_clock.elapsed();
+
+    if (m_state == CircuitState::Closed)
+    {
+        return true;
+    }
+
+    if (m_state == CircuitState::Open)
+    {
+        if (now - m_openedAt < m_openDuration)
+        {
+            m_rejectedCount++;
+            return false;
+        }
+        transitionTo(CircuitState::HalfOpen);
+    }
+
+    // 半开状态只放行一个探测请求；探测结果迟迟未回（如被取消）时，超过冷却时间后允许重新探测
+    if (m_probeStartedAt >= 0 && now - m_probeStartedAt < m_openDuration)
+    {
+        m_rejectedCount++;
+        return false;
+    }
+
+    m_probeStartedAt = now;
+    return true;
+}
+
+void CircuitBreaker::recordSuccess()
+{
+    QMutexLocker locker(&m_mutex);
+
+    m_consecutiveFailures = 0;
+    if (m_state != CircuitState::Closed)
+    {
+        m_openDuration = m_baseOpenDuration;
+        transitionTo(CircuitState::Closed);
+    }
+}
+
+void CircuitBreaker::recordFailure()
+{
+    QMutexLocker locker(&m_mutex);
+
+    m_consecutiveFailures++;
+
+    if (m_state == CircuitState::HalfOpen)
+    {
+        m_openDuration = qMin(m_openDuration * 2, m_baseOpenDuration * kMaxOpenDurationMultiplier);
+        transitionTo(CircuitState::Open);
+    }
+    else if (m_state == CircuitState::Closed && m_consecutiveFailures >= m_failureThreshold)
+    {
+        transitionTo(CircuitState::Open);
+    }
+}
+
+void CircuitBreaker::reset()
+{
+    QMutexLocker locker(&m_mutex);
+
+    m_consecutiveFailures = 0;
+    m_openDuration = m_baseOpenDuration;
+    transitionTo(CircuitState::Closed);
+}
+
+CircuitState CircuitBreaker::state() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_state;
+}
+
+qint64 CircuitBreaker::remainingOpenTime() const
+{
+    QMutexLocker locker(&m_mutex);
+
+    if (m_state != CircuitState::Open)
+    {
+        return 0;
+    }
+    return qMax<qint64>(0, m_openedAt + m_openDuration - m_clock.elapsed());
+}
+
+qint64 CircuitBreaker::rejectedCount() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_rejectedCount;
+}
+
+QString CircuitBreaker::stateToString(CircuitState state)
+{
+    switch (state)
+    {
+        case CircuitState::Closed:
+            return "关闭";
+        case CircuitState::Open:
+            return "打开";
+        case CircuitState::HalfOpen:
+            return "半开";
+        default:
+            return "未知";
+    }
+}
+
+void CircuitBreaker::transitionTo(CircuitState newState)
+{
+    m_probeStartedAt = -1;
+
+    if (newState == CircuitState::Open)
+    {
+        m_openedAt = m_clock.elapsed();
+    }
+
+    if (m_state == newState)
+    {
+        return;
+    }
+
+    CircuitState oldState = m_state;
+    m_state = newState;
+
+    if (newState == CircuitState::Open)
+    {
+        Logger::instance().warning(QString("熔断器打开: %1，连续失败 %2 次，%3 毫秒后尝试恢复")
+                                       .arg(m_name)
+                                       .arg(m_consecutiveFailures)
+                                       .arg(m_openDuration));
+    }
+    else
+    {
+        Logger::instance().info(QString("熔断器状态变化: %1 -> %2").arg(m_name, stateToString(newState)));
+    }
+
+    emit stateChanged(oldState, newState);
+}
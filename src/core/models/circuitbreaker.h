@@ -0,0 +1,138 @@
+/**
+ * @file circuitbreaker.h
+ * @brief 熔断器，在AI服务端持续失败时暂停请求派发
+ * @author Developer
+ * @date 2026-10-18
+ * @version 1.0
+ */
+
+#ifndef CIRCUITBREAKER_H
+#define CIRCUITBREAKER_H
+
+#include <QElapsedTimer>
+#include <QMutex>
+#include <QObject>
+#include <QString>
+
+/**
+ * @brief 熔断器状态枚举
+ */
+enum class CircuitState
+{
+    Closed,   ///< 关闭（正常放行请求）
+    Open,     ///< 打开（拒绝所有请求，等待冷却）
+    HalfOpen  ///< 半开（仅放行一个探测请求）
+};
+
+/**
+ * @brief 熔断器类
+ *
+ * @details 状态转换规则：
+ * - Closed：连续失败次数达到阈值后转为Open
+ * - Open：冷却时间结束后，下一次allowRequest()转为HalfOpen并放行一个探测请求
+ * - HalfOpen：探测成功转为Closed；探测失败重新转为Open，且冷却时间翻倍（有上限）
+ * 熔断器本身不发送请求，调用方在派发前调用allowRequest()，收到结果后调用recordSuccess()/recordFailure()。
+ */
+class CircuitBreaker : public QObject
+{
+    Q_OBJECT
+
+   public:
+    /**
+     * @brief 构造函数
+     * @param name 熔断器名称（通常为服务端点URL，用于日志）
+     * @param failureThreshold 连续失败阈值
+     * @param openDurationMs 打开后的冷却时间（毫秒）
+     * @param parent 父对象
+     */
+    explicit CircuitBreaker(const QString& name, int failureThreshold = 5, int openDurationMs = 30000,
+                            QObject* parent = nullptr);
+
+    /**
+     * @brief 设置连续失败阈值
+     * @param failureThreshold 连续失败阈值
+     */
+    void setFailureThreshold(int failureThreshold);
+
+    /**
+     * @brief 设置冷却时间
+     * @param openDurationMs 打开后的冷却时间（毫秒）
+     */
+    void setOpenDuration(int openDurationMs);
+
+    /**
+     * @brief 检查是否允许发送请求
+     * @return 允许发送返回true；Open状态或半开探测进行中返回false
+     */
+    bool allowRequest();
+
+    /**
+     * @brief 记录一次成功
+     */
+    void recordSuccess();
+
+    /**
+     * @brief 记录一次失败
+     */
+    void recordFailure();
+
+    /**
+     * @brief 重置为关闭状态
+     */
+    void reset();
+
+    /**
+     * @brief 获取当前状态
+     * @return 当前状态
+     */
+    CircuitState state() const;
+
+    /**
+     * @brief 获取距冷却结束的剩余时间
+     * @return 剩余时间（毫秒），非Open状态返回0
+     */
+    qint64 remainingOpenTime() const;
+
+    /**
+     * @brief 获取被拒绝（短路）的请求次数
+     * @return 自创建以来allowRequest()返回false的次数
+     */
+    qint64 rejectedCount() const;
+
+    /**
+     * @brief 将状态转换为字符串
+     * @param state 熔断器状态
+     * @return 状态字符串
+     */
+    static QString stateToString(CircuitState state);
+
+   signals:
+    /**
+     * @brief 状态变化信号
+     * @details 在持有熔断器内部锁时发出，直接连接的槽函数不能再调用本熔断器的方法
+     * @param oldState 原状态
+     * @param newState 新状态
+     */
+    void stateChanged(CircuitState oldState, CircuitState newState);
+
+   private:
+    /**
+     * @brief 切换状态（调用方需持有锁）
+     * @param newState 新状态
+     */
+    void transitionTo(CircuitState newState);
+
+    mutable QMutex m_mutex;     ///< 互斥锁
+    QElapsedTimer m_clock;      ///< 单调时钟
+    QString m_name;             ///< 熔断器名称
+    CircuitState m_state;       ///< 当前状态
+    int m_failureThreshold;     ///< 连续失败阈值
+    int m_baseOpenDuration;     ///< 基础冷却时间（毫秒）
+    int m_openDuration;         ///< 当前冷却时间（毫秒，半开探测失败后翻倍）
+    int m_consecutiveFailures;  ///< 连续失败次数
+    qint64 m_openedAt;          ///< 进入Open状态的时间
+    qint64 m_probeStartedAt;    ///< 半开探测开始时间，-1表示没有进行中的探测
+    qint64 m_rejectedCount;     ///< 被拒绝（短路）的请求次数
+};
+
+#endif  // CIRCUITBREAKER_H
@@ -0,0 +1,149 @@
+/**
+ * @file dualratelimiter.cpp
+ * @brief 双维度速率限制器实现
+ * @author Developer
+ * @date 2026-10-18
+ * @version 1.0
+ */
+
+#include "core/models/dualratelimiter.h"
+#include "common/logger/logger.h"
+
+namespace
+{
+const qint64 kWindowMs = 60000;  ///< 滑动窗口长度（毫秒）
+}  // namespace
+
+DualRateLimiter::DualRateLimiter(int requestsPerMinute, int tokensPerMinute, QObject* parent)
+    : QObject(parent),
+      m_windowTokens(0),
+      m_requestsPerMinute(qMax(0, requestsPerMinute)),
+      m_tokensPerMinute(qMax(0, tokensPerMinute)),
+      m_backoffUntil(0),
+      m_nextTicket(1)
+{
+    m_clock.start();
+}
+
+void DualRateLimiter::setRequestsPerMinute(int requestsPerMinute)
+{
+    QMutexLocker locker(&m_mutex);
+    m_requestsPerMinute = qMax(0, requestsPerMinute);
+    Logger::instance().info(QString("速率限制器设置: 每分钟 %1 次请求").arg(m_requestsPerMinute));
+}
+
+void DualRateLimiter::setTokensPerMinute(int tokensPerMinute)
+{
+    QMutexLocker locker(&m_mutex);
+    m_tokensPerMinute = qMax(0, tokensPerMinute);
+    Logger::instance().info(QString("速率限制器设置: 每分钟 %1 个token").arg(m_tokensPerMinute));
+}
+
+int DualRateLimiter::requestsPerMinute() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_requestsPerMinute;
+}
+
+int DualRateLimiter::tokensPerMinute() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_tokensPerMinute;
+}
+
+qint64 DualRateLimiter::acquireDelay(int estimatedTokens) const
+{
+    QMutexLocker locker(&m_mutex);
+
+    qint64 now = m_clock.elapsed();
+    prune(now);
+
+    qint64 delay = qMax<qint64>(0, m_backoffUntil - now);
+
+    if (m_requestsPerMinute > 0 && m_window.size() >= m_requestsPerMinute)
+    {
+        // 需要等到足够多的旧请求滑出窗口，使窗口内请求数降到限制以下
+        const WindowEntry& entry = m_window[m_window.size() - m_requestsPerMinute];
+        delay = qMax(delay, entry.time + kWindowMs - now);
+    }
+
+    if (m_tokensPerMinute > 0 && m_windowTokens > 0 && m_windowTokens + estimatedTokens > m_tokensPerMinute)
+    {
+        // 单个请求超过TPM上限时只能等窗口完全清空后发送
+        qint64 excess = m_windowTokens + estimatedTokens - m_tokensPerMinute;
+        qint64 freed = 0;
+        for (int i = 0; i < m_window.size(); ++i)
+        {
+            freed += m_window[i].tokens;
+            if (freed >= excess || i == m_window.size() - 1)
+            {
+                delay = qMax(delay, m_window[i].time + kWindowMs - now);
+                break;
+            }
+        }
+    }
+
+    return qMax<qint64>(0, delay);
+}
+
+qint64 DualRateLimiter::reserve(int estimatedTokens)
+{
+    QMutexLocker locker(&m_mutex);
+
+    qint64 now = m_clock.elapsed();
+    prune(now);
+
+    WindowEntry entry;
+    entry.time = now;
+    entry.tokens = qMax(0, estimatedTokens);
+    entry.ticket = m_nextTicket++;
+    m_window.append(entry);
+    m_windowTokens += entry.tokens;
+
+    return entry.ticket;
+}
+
+void DualRateLimiter::reconcile(qint64 ticket, int actualTokens)
+{
+    QMutexLocker locker(&m_mutex);
+
+    for (WindowEntry& entry : m_window)
+    {
+        if (entry.ticket == ticket)
+        {
+            m_windowTokens += qMax(0, actualTokens) - entry.tokens;
+            entry.tokens = qMax(0, actualTokens);
+            return;
+        }
+    }
+}
+
+void DualRateLimiter::backoff(qint64 delayMs)
+{
+    QMutexLocker locker(&m_mutex);
+    m_backoffUntil = qMax(m_backoffUntil, m_clock.elapsed() + qMax<qint64>(0, delayMs));
+    Logger::instance().warning(QString("速率限制器暂停发送 %1 毫秒").arg(delayMs));
+}
+
+int DualRateLimiter::windowRequests() const
+{
+    QMutexLocker locker(&m_mutex);
+    prune(m_clock.elapsed());
+    return m_window.size();
+}
+
+qint64 DualRateLimiter::windowTokens() const
+{
+    QMutexLocker locker(&m_mutex);
+    prune(m_clock.elapsed());
+    return m_windowTokens;
+}
+
+void DualRateLimiter::prune(qint64 now) const
+{
+    while (!m_window.isEmpty() && m_window.first().time + kWindowMs <= now)
+    {
+        m_windowTokens -= m_window.first().tokens;
+        m_window.removeFirst();
+    }
+}
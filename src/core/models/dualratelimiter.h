@@ -0,0 +1,130 @@
+/**
+ * @file dualratelimiter.h
+ * @brief 双维度速率限制器（每分钟请求数 + 每分钟token数）
+ * @author Developer
+ * @date 2026-10-18
+ * @version 1.0
+ */
+
+#ifndef DUALRATELIMITER_H
+#define DUALRATELIMITER_H
+
+#include <QElapsedTimer>
+#include <QList>
+#include <QMutex>
+#include <QObject>
+
+/**
+ * @brief 双维度速率限制器类
+ *
+ * @details 采用60秒滑动窗口同时统计请求数和token数：
+ * - 发送前通过acquireDelay()查询需要等待的时间，不阻塞调用线程
+ * - 发送时通过reserve()按估算token数登记占用
+ * - 收到usage后通过reconcile()用实际token数修正登记值
+ * - 服务端返回429时可通过backoff()暂停所有发送
+ * RPM或TPM设置为0表示该维度不限制。
+ */
+class DualRateLimiter : public QObject
+{
+    Q_OBJECT
+
+   public:
+    /**
+     * @brief 构造函数
+     * @param requestsPerMinute 每分钟允许的请求数（0表示不限制）
+     * @param tokensPerMinute 每分钟允许的token数（0表示不限制）
+     * @param parent 父对象
+     */
+    explicit DualRateLimiter(int requestsPerMinute = 60, int tokensPerMinute = 0, QObject* parent = nullptr);
+
+    /**
+     * @brief 设置每分钟请求数限制
+     * @param requestsPerMinute 每分钟允许的请求数（0表示不限制）
+     */
+    void setRequestsPerMinute(int requestsPerMinute);
+
+    /**
+     * @brief 设置每分钟token数限制
+     * @param tokensPerMinute 每分钟允许的token数（0表示不限制）
+     */
+    void setTokensPerMinute(int tokensPerMinute);
+
+    /**
+     * @brief 获取每分钟请求数限制
+     * @return 每分钟请求数
+     */
+    int requestsPerMinute() const;
+
+    /**
+     * @brief 获取每分钟token数限制
+     * @return 每分钟token数
+     */
+    int tokensPerMinute() const;
+
+    /**
+     * @brief 查询发送一个请求前需要等待的时间
+     * @param estimatedTokens 请求预计占用的token数
+     * @return 需要等待的毫秒数，0表示可以立即发送
+     */
+    qint64 acquireDelay(int estimatedTokens) const;
+
+    /**
+     * @brief 登记一次请求占用
+     * @param estimatedTokens 请求预计占用的token数
+     * @return 登记凭据，用于后续修正
+     */
+    qint64 reserve(int estimatedTokens);
+
+    /**
+     * @brief 用实际消耗修正登记的token数
+     * @param ticket reserve()返回的登记凭据
+     * @param actualTokens 实际消耗的token数
+     */
+    void reconcile(qint64 ticket, int actualTokens);
+
+    /**
+     * @brief 暂停发送一段时间（如收到429响应）
+     * @param delayMs 暂停时间（毫秒）
+     */
+    void backoff(qint64 delayMs);
+
+    /**
+     * @brief 获取当前窗口内的请求数
+     * @return 请求数
+     */
+    int windowRequests() const;
+
+    /**
+     * @brief 获取当前窗口内的token数
+     * @return token数
+     */
+    qint64 windowTokens() const;
+
+   private:
+    /**
+     * @brief 窗口记录
+     */
+    struct WindowEntry
+    {
+        qint64 time;    ///< 登记时间（毫秒，单调时钟）
+        int tokens;     ///< 占用的token数
+        qint64 ticket;  ///< 登记凭据
+    };
+
+    /**
+     * @brief 移除滑出窗口的记录
+     * @param now 当前时间（毫秒，单调时钟）
+     */
+    void prune(qint64 now) const;
+
+    mutable QMutex m_mutex;               ///< 互斥锁
+    QElapsedTimer m_clock;                ///< 单调时钟
+    mutable QList<WindowEntry> m_window;  ///< 滑动窗口记录（按时间排序）
+    mutable qint64 m_windowTokens;        ///< 窗口内token总数
+    int m_requestsPerMinute;              ///< 每分钟请求数限制
+    int m_tokensPerMinute;                ///< 每分钟token数限制
+    qint64 m_backoffUntil;                ///< 暂停发送的截止时间
+    qint64 m_nextTicket;                  ///< 下一个登记凭据
+};
+
+#endif  // DUALRATELIMITER_H
@@ -7,6 +7,7 @@
  */
 
 #include "core/models/errorhandler.h"
+#include <QRandomGenerator>
 
 ErrorHandler& ErrorHandler::instance()
 {
@@ -66,6 +67,35 @@ int ErrorHandler::getRetryDelay(int retryCount) const
     return qMin(delay, 60000);
 }
 
+int ErrorHandler::nextRetryDelay(int previousDelay, int baseDelay, int maxDelay) const
+{
+    baseDelay = qMax(1, baseDelay);
+    maxDelay = qMax(baseDelay, maxDelay);
+
+    qint64 upper = qMax<qint64>(baseDelay, static_cast<qint64>(previousDelay) * 3);
+    qint64 delay = baseDelay + static_cast<qint64>(QRandomGenerator::global()->bounded(upper - baseDelay + 1));
+    return static_cast<int>(qMin<qint64>(delay, maxDelay));
+}
+
+CircuitBreaker* ErrorHandler::circuitBreaker(const QString& endpoint)
+{
+    QMutexLocker locker(&m_mutex);
+
+    CircuitBreaker* breaker = m_breakers.value(endpoint, nullptr);
+    if (!breaker)
+    {
+        breaker = new CircuitBreaker(endpoint, 5, 30000, this);
+        m_breakers.insert(endpoint, breaker);
+    }
+    return breaker;
+}
+
+bool ErrorHandler::isEndpointError(ProcessErrorType type)
+{
+    return type == ProcessErrorType::AIRequestError || type == ProcessErrorType::AIRateLimitError ||
+           type == ProcessErrorType::AITimeoutError;
+}
+
 QString ErrorHandler::errorTypeToString(ProcessErrorType type)
 {
     switch (type)
@@ -9,16 +9,18 @@
 #ifndef ERRORHANDLER_H
 #define ERRORHANDLER_H
 
+#include <QHash>
 #include <QMutex>
 #include <QObject>
 #include "common/logger/logger.h"
+#include "core/models/circuitbreaker.h"
 #include "core/models/processerror.h"
 
 /**
  * @brief 错误处理器类
  * 
  * 该类负责处理各类错误，包括确定错误处理策略、
- * 计算重试延迟时间等功能。
+ * 计算重试延迟时间、按服务端点维护熔断器等功能。
  */
 class ErrorHandler : public QObject
 {
@@ -48,6 +50,31 @@ class ErrorHandler : public QObject
      */
     int getRetryDelay(int retryCount) const;
 
+    /**
+     * @brief 计算下一次重试延迟（去相关抖动指数退避）
+     * @details delay = min(maxDelay, random(baseDelay, previousDelay * 3))，
+     *          各请求的重试时间相互错开，避免服务端恢复时被同步重试再次压垮
+     * @param previousDelay 上一次的延迟（首次重试传baseDelay）
+     * @param baseDelay 基础延迟（毫秒）
+     * @param maxDelay 延迟上限（毫秒）
+     * @return 延迟时间（毫秒）
+     */
+    int nextRetryDelay(int previousDelay, int baseDelay, int maxDelay) const;
+
+    /**
+     * @brief 获取服务端点对应的熔断器（不存在时创建）
+     * @param endpoint 服务端点（如API基础URL）
+     * @return 熔断器指针，由ErrorHandler持有
+     */
+    CircuitBreaker* circuitBreaker(const QString& endpoint);
+
+    /**
+     * @brief 判断错误是否由服务端点异常引起（计入熔断器失败次数）
+     * @param type 错误类型
+     * @return 是否为服务端点相关的瞬时错误
+     */
+    static bool isEndpointError(ProcessErrorType type);
+
     /**
      * @brief 将错误类型转换为字符串
      * @param type 错误类型
@@ -74,6 +101,7 @@ class ErrorHandler : public QObject
     void initErrorActions();
 
     QMap<ProcessErrorType, ErrorAction> m_errorActions;  ///< 错误处理策略映射
+    QHash<QString, CircuitBreaker*> m_breakers;          ///< 各服务端点的熔断器
     mutable QMutex m_mutex;                              ///< 互斥锁
 };
 
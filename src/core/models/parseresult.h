@@ -33,6 +33,38 @@ struct ParseProgress
     ParseProgress() : current(0), total(0), successCount(0), failedCount(0), skippedCount(0) {}
 };
 
+/**
+ * @brief 已保存函数的摘要，流式结果模式下代替完整的函数数据
+ *
+ * @details 不含函数介绍和图表等大字段；key 与 filePath 组合在函数表中唯一，可据此从数据库取回完整数据。
+ */
+struct FunctionSummary
+{
+    int projectId;     ///< 所属项目ID
+    QString key;       ///< 函数名称
+    QString filePath;  ///< 源文件路径
+    int startLine;     ///< 起始行号
+    int endLine;       ///< 结束行号
+
+    /**
+     * @brief 默认构造函数
+     */
+    FunctionSummary() : projectId(0), startLine(0), endLine(0) {}
+
+    /**
+     * @brief 从函数数据构造摘要
+     * @param data 函数数据
+     */
+    explicit FunctionSummary(const FunctionData& data)
+        : projectId(data.projectId),
+          key(data.key),
+          filePath(data.filePath),
+          startLine(data.startLine),
+          endLine(data.endLine)
+    {
+    }
+};
+
 /**
  * @brief 解析结果结构
  */
@@ -43,6 +75,8 @@ struct ParseResult
     int successCount;                 ///< 成功数量
     int failedCount;                  ///< 失败数量
     int skippedCount;                 ///< 跳过数量
+    int functionCount;                ///< 保存的函数总数
+    bool streamed;                    ///< 是否为流式结果（函数已通过信号逐批交出，functions为空）
     QVector<FunctionData> functions;  ///< 提取的函数列表
     QString errorMessage;             ///< 错误信息
     QDateTime timestamp;              ///< 时间戳
@@ -51,7 +85,13 @@ struct ParseResult
      * @brief 默认构造函数
      */
     ParseResult()
-        : success(false), successCount(0), failedCount(0), skippedCount(0), timestamp(QDateTime::currentDateTime())
+        : success(false),
+          successCount(0),
+          failedCount(0),
+          skippedCount(0),
+          functionCount(0),
+          streamed(false),
+          timestamp(QDateTime::currentDateTime())
     {
     }
 };
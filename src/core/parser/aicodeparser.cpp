@@ -14,32 +14,59 @@
 #include <QJsonDocument>
 #include <QJsonParseError>
 #include <QNetworkRequest>
+#include <QRegularExpression>
 #include <QTextStream>
+#include <algorithm>
 #include "common/logger/logger.h"
 #include "core/ai/aiconfigmanager.h"
+#include "core/ai/aiservicemanager.h"
+#include "core/ai/recordingnetworkmanager.h"
+#include "core/ai/requestfingerprint.h"
+#include "core/ai/tokenestimator.h"
+#include "core/parser/codechunker.h"
+#include "core/parser/functionparser.h"
+
+namespace
+{
+const int kMaxOutputTokens = 16000;       ///< 单次请求最大输出token数
+const int kMinOutputTokens = 2000;        ///< 描述请求最小输出token数
+const int kTokensPerDescription = 1200;   ///< 单个函数描述预估输出token数
+const int kHybridCodeCharBudget = 24000;  ///< 单个描述请求中函数代码总字符预算
+const int kMaxFunctionBodyChars = 12000;  ///< 单个函数体最大字符数，超出部分截断
+const int kMaxChunkChars = 48000;         ///< AI提取模式下单个片段最大字符数
+const int kChunkOverlapLines = 20;        ///< 相邻片段之间的重叠行数
+}  // namespace
 
 AICodeParser::AICodeParser(QObject* parent)
     : QObject(parent),
       m_networkManager(nullptr),
-      m_currentReply(nullptr),
-      m_timeoutTimer(nullptr),
+      m_dispatchTimer(nullptr),
       m_isParsing(false),
       m_timeoutMs(300000),  // 5分钟超时时间
-      m_receivedTokens(0)
+      m_maxConcurrentRequests(4),
+      m_receivedTokens(0),
+      m_extractionMode(AIExtractionMode::Hybrid),
+      m_hybridActive(false),
+      m_currentTotalLines(0),
+      m_totalUnits(0),
+      m_startedUnits(0),
+      m_failedUnits(0),
+      m_promptTokens(0),
+      m_completionTokens(0)
 {
 
-    m_networkManager = new QNetworkAccessManager(this);
-    m_timeoutTimer = new QTimer(this);
-    m_timeoutTimer->setSingleShot(true);
+    m_networkManager = new RecordingNetworkManager(this);
+    m_dispatchTimer = new QTimer(this);
+    m_dispatchTimer->setSingleShot(true);
 
-    connect(m_timeoutTimer, &QTimer::timeout, this, &AICodeParser::onTimeout);
+    connect(m_dispatchTimer, &QTimer::timeout, this, &AICodeParser::dispatchUnits);
 
-    Logger::instance().info("AI代码解析器初始化完成");
+    LOG_INFO("AI代码解析器初始化完成");
 }
 
 AICodeParser::~AICodeParser()
 {
-    cancelParsing();
+    abortActiveReplies();
 }
 
 AICodeParser& AICodeParser::instance()
@@ -60,12 +87,12 @@ void AICodeParser::parseFile(const QString& filePath)
     if (!AIConfigManager::instance().isConfigValid(config))
     {
         emit parseFailed("AI配置不完整，请先配置AI服务！");
-        Logger::instance().error("AI配置不完整，无法解析文件");
+        LOG_ERROR("AI配置不完整，无法解析文件");
         return;
     }
 
     emit parseProgress("读取文件", "正在读取文件内容...");
-    Logger::instance().info("开始解析文件: " + filePath);
+    LOG_INFO("开始解析文件: %1", filePath);
 
     QString code;
     if (!readFileContent(filePath, code))
@@ -75,7 +102,7 @@ void AICodeParser::parseFile(const QString& filePath)
     }
 
     QString language = detectLanguage(filePath);
-    Logger::instance().info(QString("检测到语言类型: %1, 文件大小: %2 字节").arg(language).arg(code.size()));
+    LOG_INFO("检测到语言类型: %1, 文件大小: %2 字节", language, code.size());
 
     parseCode(code, language, filePath);
 }
@@ -92,63 +119,115 @@ void AICodeParser::parseCode(const QString& code, const QString& language, const
     if (!AIConfigManager::instance().isConfigValid(config))
     {
         emit parseFailed("AI配置不完整，请先配置AI服务！");
-        Logger::instance().error("AI配置不完整，无法解析代码");
+        LOG_ERROR("AI配置不完整，无法解析代码");
         return;
     }
 
     m_isParsing = true;
     m_currentFilePath = filePath;
     m_currentLanguage = language;
+    m_currentTotalLines = countLines(code);
+    m_pendingUnits.clear();
+    m_localFunctions.clear();
+    m_describedFunctions.clear();
+    m_duplicateOf.clear();
+    m_collectedFunctions.clear();
+    m_failedUnits = 0;
+    m_lastUnitError.clear();
+    m_promptTokens = 0;
+    m_completionTokens = 0;
 
     emit parseProgress("构建请求", "正在构建AI分析请求...");
 
-    QString prompt = buildParsePrompt(code, language, filePath);
-    Logger::instance().info(QString("构建Prompt完成, 长度: %1 字符").arg(prompt.size()));
+    m_hybridActive = m_extractionMode == AIExtractionMode::Hybrid && buildHybridUnits(code, language, filePath);
+    if (!m_hybridActive)
+    {
+        buildChunkUnits(code, language, filePath);
+    }
+
+    m_totalUnits = m_pendingUnits.size();
+    m_startedUnits = 0;
+    m_receivedTokens = 0;
+    LOG_INFO("请求URL: %1", buildRequestUrl());
+    LOG_INFO("使用模型: %1", config.defaultModel);
+
+    dispatchUnits();
+}
 
-    QString urlStr = buildRequestUrl();
-    Logger::instance().info("请求URL: " + urlStr);
-    Logger::instance().info("使用模型: " + config.defaultModel);
+void AICodeParser::dispatchUnits()
+{
+    DualRateLimiter* limiter = AIServiceManager::instance().rateLimiter();
+
+    while (!m_pendingUnits.isEmpty() && m_activeUnits.size() < m_maxConcurrentRequests)
+    {
+        const AIParseUnit& next = m_pendingUnits.first();
+        int estimatedTokens = TokenEstimator::estimateRequest(next.prompt, next.maxTokens);
 
-    QUrl requestUrl(urlStr);
+        qint64 waitTime = limiter->acquireDelay(estimatedTokens);
+        if (waitTime > 0)
+        {
+            if (!m_dispatchTimer->isActive())
+            {
+                LOG_INFO("速率预算不足，%1 毫秒后继续发送", waitTime);
+                m_dispatchTimer->start(static_cast<int>(waitTime));
+            }
+            break;
+        }
+
+        startUnit(m_pendingUnits.takeFirst(), estimatedTokens);
+    }
+}
+
+void AICodeParser::startUnit(const AIParseUnit& unit, int estimatedTokens)
+{
+    AIConfig config = AIConfigManager::instance().getCurrentConfig();
+    m_startedUnits++;
+
+    QUrl requestUrl(buildRequestUrl());
     QNetworkRequest request(requestUrl);
     request.setHeader(QNetworkRequest::ContentTypeHeader, "application/json");
     request.setRawHeader("Authorization", QString("Bearer %1").arg(config.apiKey).toUtf8());
     request.setRawHeader("Accept", "application/json");
+    request.setTransferTimeout(m_timeoutMs);
 
-    QJsonObject jsonObj = buildRequestJson(prompt);
+    QJsonObject jsonObj = buildRequestJson(unit.prompt, unit.maxTokens);
     QJsonDocument jsonDoc(jsonObj);
-    QByteArray jsonData = jsonDoc.toJson();
+    QByteArray jsonData = jsonDoc.toJson(QJsonDocument::Compact);
 
-    Logger::instance().info(QString("请求JSON大小: %1 字节").arg(jsonData.size()));
+    LOG_INFO("请求JSON大小: %1 字节 (%2/%3)", jsonData.size(), m_startedUnits, m_totalUnits);
 
-    m_currentReply = m_networkManager->post(request, jsonData);
+    QNetworkReply* reply = m_networkManager->post(request, jsonData);
 
-    connect(m_currentReply, &QNetworkReply::finished, this, &AICodeParser::onReplyFinished);
-    connect(m_currentReply, QOverload<QNetworkReply::NetworkError>::of(&QNetworkReply::errorOccurred), this,
-            &AICodeParser::onNetworkError);
-    connect(m_currentReply, &QNetworkReply::readyRead, this, &AICodeParser::onReadyRead);
+    AIUnitContext context;
+    context.unit = unit;
+    context.estimatedTokens = estimatedTokens;
+    context.rateTicket = AIServiceManager::instance().rateLimiter()->reserve(estimatedTokens);
+    m_activeUnits.insert(reply, context);
 
-    m_timeoutTimer->start(m_timeoutMs);
-    m_streamBuffer.clear();
-    m_streamContent.clear();
-    m_receivedTokens = 0;
+    connect(reply, &QNetworkReply::finished, this, [this, reply]() { onReplyFinished(reply); });
+    connect(reply, &QNetworkReply::errorOccurred, this,
+            [this, reply](QNetworkReply::NetworkError error) { onNetworkError(reply, error); });
+    connect(reply, &QNetworkReply::readyRead, this, [this, reply]() { onReadyRead(reply); });
 
-    emit parseProgress("发送请求", "已发送AI分析请求，等待响应...");
-    Logger::instance().info("已发送AI代码解析请求，文件: " + filePath);
+    if (m_totalUnits > 1)
+    {
+        emit parseProgress("发送请求",
+                           QString("已发送AI分析请求 (%1/%2)，等待响应...").arg(m_startedUnits).arg(m_totalUnits));
+    }
+    else
+    {
+        emit parseProgress("发送请求", "已发送AI分析请求，等待响应...");
+    }
+    LOG_INFO("已发送AI代码解析请求，文件: %1", m_currentFilePath);
 }
 
 void AICodeParser::cancelParsing()
 {
-    m_timeoutTimer->stop();
-
-    if (m_currentReply)
-    {
-        m_currentReply->abort();
-        m_currentReply->deleteLater();
-        m_currentReply = nullptr;
-    }
+    m_dispatchTimer->stop();
+    abortActiveReplies();
+    m_pendingUnits.clear();
     m_isParsing = false;
-    Logger::instance().info("已取消AI代码解析");
+    LOG_INFO("已取消AI代码解析");
     emit parseCancelled();
 }
 
@@ -189,174 +268,300 @@ void AICodeParser::setTimeout(int timeoutMs)
     m_timeoutMs = timeoutMs;
 }
 
-void AICodeParser::onReplyFinished()
+void AICodeParser::setExtractionMode(AIExtractionMode mode)
 {
-    m_timeoutTimer->stop();
-    m_isParsing = false;
+    m_extractionMode = mode;
+}
 
-    if (!m_currentReply)
-    {
-        Logger::instance().error("onReplyFinished: m_currentReply 为空");
-        return;
-    }
+AIExtractionMode AICodeParser::extractionMode() const
+{
+    return m_extractionMode;
+}
 
-    QNetworkReply* reply = m_currentReply;
-    m_currentReply = nullptr;
+void AICodeParser::setMaxConcurrentRequests(int maxConcurrent)
+{
+    m_maxConcurrentRequests = qMax(1, maxConcurrent);
+}
 
-    Logger::instance().info("收到AI响应");
+void AICodeParser::abortActiveReplies()
+{
+    QList<QNetworkReply*> replies = m_activeUnits.keys();
+    m_activeUnits.clear();
 
-    if (reply->error() != QNetworkReply::NoError)
+    for (QNetworkReply* reply : replies)
+    {
+        disconnect(reply, nullptr, this, nullptr);
+        reply->abort();
+        reply->deleteLater();
+    }
+}
+
+void AICodeParser::onReplyFinished(QNetworkReply* reply)
+{
+    auto it = m_activeUnits.find(reply);
+    if (it == m_activeUnits.end())
     {
-        QString error = "网络请求失败: " + reply->errorString() + " (错误码: " + QString::number(reply->error()) + ")";
-        Logger::instance().error(error);
-        emit parseFailed(error);
+        LOG_ERROR("onReplyFinished: 未找到对应的请求上下文");
         reply->deleteLater();
         return;
     }
 
-    if (!m_streamBuffer.trimmed().isEmpty())
+    AIUnitContext context = it.value();
+    m_activeUnits.erase(it);
+
+    LOG_INFO("收到AI响应");
+
+    QString unitError;
+    if (reply->error() == QNetworkReply::OperationCanceledError || reply->error() == QNetworkReply::TimeoutError)
     {
-        parseSSELine(m_streamBuffer);
-        m_streamBuffer.clear();
+        unitError = QString("请求超时 (%1 秒)，请检查网络连接或增加超时时间").arg(m_timeoutMs / 1000);
     }
+    else if (reply->error() != QNetworkReply::NoError)
+    {
+        unitError = "网络请求失败: " + reply->errorString() + " (错误码: " + QString::number(reply->error()) + ")";
+    }
+    else
+    {
+        context.sseFramer.append(reply->readAll());
+        context.sseFramer.finish();
+        QByteArrayView payload;
+        while (context.sseFramer.nextDataPayload(payload))
+        {
+            parseSSEPayload(payload, context);
+        }
 
+        QString aiResponse = QString::fromUtf8(context.streamContent);
+        recordUsage(context, aiResponse);
+        if (aiResponse.isEmpty())
+        {
+            unitError = "AI响应为空";
+        }
+        else
+        {
+            LOG_INFO("AI响应内容长度: %1 字符", aiResponse.size());
+            emit parseProgress("解析响应", "正在解析AI响应...");
+            handleUnitResponse(context.unit, aiResponse, unitError);
+        }
+    }
     reply->deleteLater();
 
-    QString aiResponse = m_streamContent;
+    if (!unitError.isEmpty())
+    {
+        m_failedUnits++;
+        m_lastUnitError = unitError;
+        LOG_ERROR("%1", unitError);
+    }
 
-    if (aiResponse.isEmpty())
+    if (!m_pendingUnits.isEmpty())
     {
-        emit parseFailed("AI响应为空");
-        Logger::instance().error("AI响应为空");
+        dispatchUnits();
         return;
     }
 
-    Logger::instance().info(QString("AI响应内容长度: %1 字符").arg(aiResponse.size()));
+    if (m_activeUnits.isEmpty())
+    {
+        finishParsing();
+    }
+}
 
-    emit parseProgress("解析响应", "正在解析AI响应...");
+void AICodeParser::recordUsage(const AIUnitContext& context, const QString& aiResponse)
+{
+    int promptTokens = context.promptTokens;
+    int completionTokens = context.completionTokens;
+    if (promptTokens == 0 && completionTokens == 0)
+    {
+        promptTokens = context.estimatedTokens - context.unit.maxTokens;
+        completionTokens = TokenEstimator::estimate(aiResponse);
+    }
 
-    AIParseResult result = parseAIResponse(aiResponse, m_currentFilePath, m_currentLanguage);
+    m_promptTokens += promptTokens;
+    m_completionTokens += completionTokens;
+    AIServiceManager::instance().rateLimiter()->reconcile(context.rateTicket, promptTokens + completionTokens);
+}
 
-    AIConfig config = AIConfigManager::instance().getCurrentConfig();
-    result.aiModel = config.defaultModel;
+bool AICodeParser::handleUnitResponse(const AIParseUnit& unit, const QString& aiResponse, QString& errorMessage)
+{
+    if (!m_hybridActive)
+    {
+        AIParseResult unitResult = parseAIResponse(aiResponse, m_currentFilePath, m_currentLanguage);
+        if (!unitResult.success)
+        {
+            errorMessage = unitResult.errorMessage;
+            return false;
+        }
+        for (FunctionData& func : unitResult.functions)
+        {
+            func.startLine += unit.lineOffset;
+            func.endLine += unit.lineOffset;
+            m_collectedFunctions.append(func);
+        }
+        return true;
+    }
 
-    if (result.success)
+    QJsonArray descriptions;
+    if (!extractJsonArray(aiResponse, descriptions, errorMessage))
     {
-        emit parseProgress("保存数据", "正在保存解析结果...");
-        emit parseComplete(result);
-        Logger::instance().info(QString("AI代码解析完成，提取到 %1 个函数").arg(result.functions.size()));
+        return false;
     }
-    else
+
+    for (const QJsonValue& value : descriptions)
     {
-        emit parseFailed(result.errorMessage);
-        Logger::instance().error("AI代码解析失败: " + result.errorMessage);
+        QJsonObject descObj = value.toObject();
+        int id = descObj["id"].toInt(-1);
+        if (!unit.functionIds.contains(id))
+        {
+            LOG_WARNING("AI返回了无效的函数编号: %1", id);
+            continue;
+        }
+        m_describedFunctions.insert(id, descObj);
     }
+    return true;
 }
 
-void AICodeParser::onNetworkError(QNetworkReply::NetworkError error)
+void AICodeParser::finishParsing()
 {
-    Logger::instance().error(
-        QString("网络错误: %1 (错误码: %2)").arg(m_currentReply ? m_currentReply->errorString() : "未知").arg(error));
-}
+    m_isParsing = false;
 
-void AICodeParser::onReadyRead()
-{
-    if (!m_currentReply)
+    if (m_failedUnits == m_totalUnits)
     {
+        emit parseFailed(m_lastUnitError);
+        LOG_ERROR("AI代码解析失败: %1", m_lastUnitError);
         return;
     }
 
-    m_timeoutTimer->stop();
-    m_timeoutTimer->start(m_timeoutMs);
+    if (m_failedUnits > 0)
+    {
+        LOG_WARNING("%1/%2 个AI请求失败，相关函数将缺少描述", m_failedUnits, m_totalUnits);
+    }
 
-    QByteArray data = m_currentReply->readAll();
-    m_streamBuffer += QString::fromUtf8(data);
+    AIParseResult result;
+    result.success = true;
+    result.filePath = m_currentFilePath;
+    result.language = m_currentLanguage;
+    result.totalLines = m_currentTotalLines;
+    result.promptTokens = m_promptTokens;
+    result.completionTokens = m_completionTokens;
 
-    QStringList lines = m_streamBuffer.split('\n');
-    m_streamBuffer = lines.takeLast();
+    AIConfig config = AIConfigManager::instance().getCurrentConfig();
+    result.aiModel = config.defaultModel;
 
-    for (const QString& line : lines)
+    if (m_hybridActive)
     {
-        if (line.trimmed().isEmpty())
+        for (int i = 0; i < m_localFunctions.size(); ++i)
         {
-            continue;
+            QJsonObject descObj = m_describedFunctions.value(m_duplicateOf.value(i, i));
+            result.functions.append(
+                mergeLocalFunction(m_localFunctions[i], descObj, m_currentFilePath, m_currentLanguage));
         }
-
-        parseSSELine(line);
+        LOG_INFO("混合模式: %1 个函数中 %2 个获得AI描述", m_localFunctions.size(), m_describedFunctions.size());
     }
-}
-
-bool AICodeParser::parseSSELine(const QString& line)
-{
-    if (!line.startsWith("data: "))
+    else if (m_totalUnits > 1)
     {
-        return false;
+        result.functions = mergeChunkFunctions(m_collectedFunctions);
+        LOG_INFO("分片合并: %1 个片段结果去重后得到 %2 个函数", m_collectedFunctions.size(), result.functions.size());
+    }
+    else
+    {
+        result.functions = m_collectedFunctions;
     }
 
-    QString data = line.mid(6).trimmed();
+    m_localFunctions.clear();
+    m_describedFunctions.clear();
+    m_duplicateOf.clear();
+    m_collectedFunctions.clear();
 
-    if (data == "[DONE]")
+    emit parseProgress("保存数据", "正在保存解析结果...");
+    emit parseComplete(result);
+    LOG_INFO("AI代码解析完成，提取到 %1 个函数，token: 发送 %2 / 接收 %3", result.functions.size(), result.promptTokens,
+             result.completionTokens);
+}
+
+void AICodeParser::onNetworkError(QNetworkReply* reply, QNetworkReply::NetworkError error)
+{
+    LOG_ERROR("网络错误: %1 (错误码: %2)", reply->errorString(), error);
+}
+
+void AICodeParser::onReadyRead(QNetworkReply* reply)
+{
+    auto it = m_activeUnits.find(reply);
+    if (it == m_activeUnits.end())
     {
-        return true;
+        return;
     }
 
-    QJsonParseError parseError;
-    QJsonDocument jsonDoc = QJsonDocument::fromJson(data.toUtf8(), &parseError);
+    AIUnitContext& context = it.value();
+    context.sseFramer.append(reply->readAll());
 
-    if (parseError.error != QJsonParseError::NoError)
+    QByteArrayView payload;
+    while (context.sseFramer.nextDataPayload(payload))
     {
-        Logger::instance().warning("解析SSE数据失败: " + parseError.errorString());
-        return false;
+        parseSSEPayload(payload, context);
     }
+}
 
-    if (!jsonDoc.isObject())
+bool AICodeParser::parseSSEPayload(QByteArrayView payload, AIUnitContext& context)
+{
+    if (SseStreamFramer::isDoneMarker(payload))
     {
-        return false;
+        return true;
     }
 
-    QJsonObject rootObj = jsonDoc.object();
+    // 带usage的事件（通常是最后一个）走完整解析，以便同时读取token统计
+    SseDeltaResult deltaResult = SseStreamFramer::containsUsage(payload)
+                                     ? SseDeltaResult::Fallback
+                                     : SseStreamFramer::extractDeltaContent(payload, context.streamContent);
 
-    if (rootObj.contains("choices"))
+    if (deltaResult == SseDeltaResult::Fallback)
     {
+        QJsonParseError parseError;
+        QJsonDocument jsonDoc = QJsonDocument::fromJson(payload.toByteArray(), &parseError);
+
+        if (parseError.error != QJsonParseError::NoError)
+        {
+            LOG_WARNING("解析SSE数据失败: %1", parseError.errorString());
+            return false;
+        }
+
+        if (!jsonDoc.isObject())
+        {
+            return false;
+        }
+
+        QJsonObject rootObj = jsonDoc.object();
+        if (rootObj["usage"].isObject())
+        {
+            QJsonObject usageObj = rootObj["usage"].toObject();
+            context.promptTokens = usageObj["prompt_tokens"].toInt();
+            context.completionTokens = usageObj["completion_tokens"].toInt();
+        }
+
         QJsonArray choicesArray = rootObj["choices"].toArray();
-        if (!choicesArray.isEmpty())
+        if (choicesArray.isEmpty())
         {
-            QJsonObject choiceObj = choicesArray[0].toObject();
-            if (choiceObj.contains("delta"))
-            {
-                QJsonObject deltaObj = choiceObj["delta"].toObject();
-                if (deltaObj.contains("content"))
-                {
-                    QString content = deltaObj["content"].toString();
-                    m_streamContent += content;
-                    m_receivedTokens++;
-
-                    if (m_receivedTokens % 10 == 0)
-                    {
-                        emit parseProgress("AI处理中",
-                                           QString("正在分析代码... 已接收 %1 个token").arg(m_receivedTokens));
-                    }
-                }
-            }
+            return true;
         }
-    }
 
-    return true;
-}
+        QJsonObject deltaObj = choicesArray[0].toObject()["delta"].toObject();
+        if (!deltaObj.contains("content") || deltaObj["content"].isNull())
+        {
+            return true;
+        }
 
-void AICodeParser::onTimeout()
-{
-    Logger::instance().error(QString("请求超时 (%1 ms)").arg(m_timeoutMs));
+        context.streamContent += deltaObj["content"].toString().toUtf8();
+        deltaResult = SseDeltaResult::Content;
+    }
 
-    if (m_currentReply)
+    if (deltaResult == SseDeltaResult::Content)
     {
-        m_currentReply->abort();
-        m_currentReply->deleteLater();
-        m_currentReply = nullptr;
+        m_receivedTokens++;
+
+        if (m_receivedTokens % 10 == 0)
+        {
+            emit parseProgress("AI处理中", QString("正在分析代码... 已接收 %1 个token").arg(m_receivedTokens));
+        }
     }
-    m_isParsing = false;
 
-    emit parseFailed(QString("请求超时 (%1 秒)，请检查网络连接或增加超时时间").arg(m_timeoutMs / 1000));
+    return true;
 }
 
 QString AICodeParser::buildRequestUrl() const
@@ -371,7 +576,7 @@ QString AICodeParser::buildRequestUrl() const
     return url;
 }
 
-QJsonObject AICodeParser::buildRequestJson(const QString& prompt) const
+QJsonObject AICodeParser::buildRequestJson(const QString& prompt, int maxTokens) const
 {
     AIConfig config = AIConfigManager::instance().getCurrentConfig();
 
@@ -386,9 +591,13 @@ QJsonObject AICodeParser::buildRequestJson(const QString& prompt) const
     jsonObj["model"] = config.defaultModel;
     jsonObj["messages"] = messagesArray;
     jsonObj["temperature"] = 0.3;
-    jsonObj["max_tokens"] = 16000;
+    jsonObj["max_tokens"] = maxTokens;
     jsonObj["stream"] = true;
 
+    QJsonObject streamOptions;
+    streamOptions["include_usage"] = true;
+    jsonObj["stream_options"] = streamOptions;
+
     return jsonObj;
 }
 
@@ -454,6 +663,275 @@ QString AICodeParser::buildParsePrompt(const QString& code, const QString& langu
     return prompt;
 }
 
+QString AICodeParser::buildDescribePrompt(const QVector<int>& functionIds, const QString& language,
+                                          const QString& filePath) const
+{
+    QString codeBlocks;
+    for (int id : functionIds)
+    {
+        const ExtractedFunction& func = m_localFunctions[id];
+        QString body = func.body;
+        if (body.size() > kMaxFunctionBodyChars)
+        {
+            body = body.left(kMaxFunctionBodyChars) + "\n... (函数体过长，后续内容已省略)";
+        }
+        codeBlocks += QString("### id: %1 (第 %2-%3 行)\n```%4\n%5\n%6\n```\n\n")
+                          .arg(id)
+                          .arg(func.startLine)
+                          .arg(func.endLine)
+                          .arg(language)
+                          .arg(func.signature)
+                          .arg(body);
+    }
+
+    QString prompt = QString(
+                         "你是一个专业的代码分析专家。以下是从%1文件中提取的%2个函数，"
+                         "每个函数都标注了编号id。请为每个函数生成说明和图表。\n\n"
+                         "文件路径：%3\n"
+                         "语言：%1\n\n"
+                         "%4"
+                         "请返回JSON数组格式，每个函数一个对象：\n"
+                         "[\n"
+                         "  {\n"
+                         "    \"id\": 函数编号(数字),\n"
+                         "    \"parameters\": [\n"
+                         "      {\"name\": \"参数名\", \"type\": \"参数类型\", "
+                         "\"description\": \"参数说明\"}\n"
+                         "    ],\n"
+                         "    \"description\": \"函数逻辑说明，使用Markdown格式，包括功能概述、参数说明、"
+                         "返回值说明、使用示例和注意事项\",\n"
+                         "    \"flowchart\": \"使用mermaid flowchart语法绘制的函数内部执行流程图\",\n"
+                         "    \"sequence_diagram\": \"使用mermaid sequenceDiagram语法绘制的函数调用时序图"
+                         "（如无外部调用可为空字符串）\",\n"
+                         "    \"structure_diagram\": \"使用mermaid graph语法绘制的模块依赖关系图\"\n"
+                         "  }\n"
+                         "]\n\n"
+                         "重要要求：\n"
+                         "1. 必须为上面列出的每个函数返回一个对象，id与上面的编号一致\n"
+                         "2. 不要返回函数名、签名和行号，这些信息已在本地提取\n"
+                         "3. 函数逻辑说明要详细准确，使用中文\n"
+                         "4. 所有mermaid图表语法必须正确，能够直接渲染\n"
+                         "5. 返回的必须是有效的JSON数组格式")
+                         .arg(language)
+                         .arg(functionIds.size())
+                         .arg(filePath)
+                         .arg(codeBlocks);
+
+    return prompt;
+}
+
+bool AICodeParser::buildHybridUnits(const QString& code, const QString& language, const QString& filePath)
+{
+    FunctionParser& functionParser = FunctionParser::instance();
+    QString localLanguage = localParserLanguage(language);
+    if (!functionParser.isLanguageSupported(localLanguage))
+    {
+        LOG_INFO("语言 %1 不支持本地提取，使用AI提取函数", language);
+        return false;
+    }
+
+    emit parseProgress("提取函数", "正在本地提取函数边界...");
+    ExtractionResult extraction = functionParser.extractFromCode(code, localLanguage);
+    if (extraction.functions.isEmpty())
+    {
+        LOG_INFO("本地未提取到函数，回退到AI提取");
+        return false;
+    }
+    m_localFunctions = extraction.functions;
+
+    // 同一文件中内容相同的函数（如多个宏展开或复制粘贴的实现）只请求一次描述
+    QHash<QString, int> firstByFingerprint;
+    for (int i = 0; i < m_localFunctions.size(); ++i)
+    {
+        const ExtractedFunction& func = m_localFunctions[i];
+        QString fingerprint = RequestFingerprint::compute(func.signature + "\n" + func.body, language, QString(), 0);
+        auto it = firstByFingerprint.constFind(fingerprint);
+        if (it != firstByFingerprint.constEnd())
+        {
+            m_duplicateOf.insert(i, it.value());
+        }
+        else
+        {
+            firstByFingerprint.insert(fingerprint, i);
+        }
+    }
+
+    const int maxFunctionsPerUnit = kMaxOutputTokens / kTokensPerDescription;
+    QVector<int> unitIds;
+    int unitChars = 0;
+
+    auto flushUnit = [&]()
+    {
+        AIParseUnit unit;
+        unit.functionIds = unitIds;
+        unit.prompt = buildDescribePrompt(unitIds, language, filePath);
+        unit.maxTokens = qBound(kMinOutputTokens, int(unitIds.size()) * kTokensPerDescription, kMaxOutputTokens);
+        m_pendingUnits.append(unit);
+        unitIds.clear();
+        unitChars = 0;
+    };
+
+    for (int i = 0; i < m_localFunctions.size(); ++i)
+    {
+        if (m_duplicateOf.contains(i))
+        {
+            continue;
+        }
+
+        const ExtractedFunction& func = m_localFunctions[i];
+        int funcChars = func.signature.size() + qMin(int(func.body.size()), kMaxFunctionBodyChars);
+        if (!unitIds.isEmpty() &&
+            (unitChars + funcChars > kHybridCodeCharBudget || unitIds.size() >= maxFunctionsPerUnit))
+        {
+            flushUnit();
+        }
+        unitIds.append(i);
+        unitChars += funcChars;
+    }
+    if (!unitIds.isEmpty())
+    {
+        flushUnit();
+    }
+
+    LOG_INFO("本地提取到 %1 个函数（%2 个内容重复），打包为 %3 个AI描述请求", m_localFunctions.size(),
+             m_duplicateOf.size(), m_pendingUnits.size());
+    return true;
+}
+
+void AICodeParser::buildChunkUnits(const QString& code, const QString& language, const QString& filePath)
+{
+    QVector<CodeChunk> chunks = CodeChunker::split(code, language, kMaxChunkChars, kChunkOverlapLines);
+
+    for (const CodeChunk& chunk : chunks)
+    {
+        AIParseUnit unit;
+        unit.prompt = buildParsePrompt(chunk.code, language, filePath);
+        unit.maxTokens = kMaxOutputTokens;
+        unit.lineOffset = chunk.startLine - 1;
+
+        if (chunks.size() > 1)
+        {
+            unit.prompt += QString(
+                               "\n\n注意：以上代码是该文件第%1-%2行的片段（文件共%3行）。\n"
+                               "1. start_line和end_line从片段第一行按1开始计数\n"
+                               "2. 片段开头可能包含上一片段末尾的代码作为上下文，其中不完整的函数请忽略")
+                               .arg(chunk.startLine)
+                               .arg(chunk.endLine)
+                               .arg(m_currentTotalLines);
+        }
+        m_pendingUnits.append(unit);
+    }
+
+    if (chunks.size() > 1)
+    {
+        LOG_INFO("文件过大（%1 字符），切分为 %2 个片段并发分析", code.size(), chunks.size());
+    }
+    else
+    {
+        LOG_INFO("构建Prompt完成, 长度: %1 字符", m_pendingUnits.last().prompt.size());
+    }
+}
+
+QVector<FunctionData> AICodeParser::mergeChunkFunctions(QVector<FunctionData> functions) const
+{
+    std::sort(functions.begin(), functions.end(),
+              [](const FunctionData& a, const FunctionData& b)
+              {
+                  if (a.startLine != b.startLine)
+                  {
+                      return a.startLine < b.startLine;
+                  }
+                  return (a.endLine - a.startLine) > (b.endLine - b.startLine);
+              });
+
+    QVector<FunctionData> merged;
+    QHash<QString, QVector<int>> indexBySignature;
+
+    for (const FunctionData& func : functions)
+    {
+        QString signature = func.signature.isEmpty() ? func.key : func.signature;
+        signature.remove(QRegularExpression("\\s+"));
+
+        bool duplicate = false;
+        QVector<int>& candidates = indexBySignature[signature];
+        for (int index : candidates)
+        {
+            FunctionData& existing = merged[index];
+            if (func.startLine <= existing.endLine && existing.startLine <= func.endLine)
+            {
+                // 同一函数出现在相邻片段的重叠区域，保留范围更完整的结果
+                if (func.endLine - func.startLine > existing.endLine - existing.startLine)
+                {
+                    existing = func;
+                }
+                duplicate = true;
+                break;
+            }
+        }
+
+        if (!duplicate)
+        {
+            candidates.append(merged.size());
+            merged.append(func);
+        }
+    }
+
+    return merged;
+}
+
+QString AICodeParser::localParserLanguage(const QString& language) const
+{
+    if (language == "c")
+    {
+        return "cpp";
+    }
+    if (language == "typescript")
+    {
+        return "javascript";
+    }
+    return language;
+}
+
+FunctionData AICodeParser::mergeLocalFunction(const ExtractedFunction& func, const QJsonObject& aiObj,
+                                              const QString& filePath, const QString& language) const
+{
+    FunctionData funcData;
+    funcData.key = func.name;
+    funcData.signature = func.signature;
+    funcData.returnType = func.returnType;
+    funcData.filePath = filePath;
+    funcData.startLine = func.startLine;
+    funcData.endLine = func.endLine;
+    funcData.language = language;
+
+    funcData.value = aiObj["description"].toString();
+    if (funcData.value.isEmpty())
+    {
+        funcData.value = "暂无描述";
+    }
+    funcData.flowchart = aiObj["flowchart"].toString();
+    funcData.sequenceDiagram = aiObj["sequence_diagram"].toString();
+    funcData.structureDiagram = aiObj["structure_diagram"].toString();
+
+    QJsonArray aiParams = aiObj["parameters"].toArray();
+    QJsonArray paramsJsonArray;
+    for (int i = 0; i < func.parameters.size(); ++i)
+    {
+        QJsonObject aiParam = i < aiParams.size() ? aiParams[i].toObject() : QJsonObject();
+        QJsonObject paramJson;
+        paramJson["name"] = func.parameters[i].name;
+        paramJson["type"] = func.parameters[i].type.isEmpty() ? aiParam["type"].toString() : func.parameters[i].type;
+        paramJson["description"] = aiParam["description"].toString();
+        paramsJsonArray.append(paramJson);
+    }
+    funcData.parameters = QJsonDocument(paramsJsonArray).toJson(QJsonDocument::Compact);
+
+    funcData.createTime = QDateTime::currentDateTime();
+    funcData.analyzeTime = QDateTime::currentDateTime();
+
+    return funcData;
+}
+
 AIParseResult AICodeParser::parseAIResponse(const QString& aiResponse, const QString& filePath,
                                             const QString& language) const
 {
@@ -462,6 +940,28 @@ AIParseResult AICodeParser::parseAIResponse(const QString& aiResponse, const QSt
     result.filePath = filePath;
     result.language = language;
 
+    QJsonArray functionsArray;
+    if (!extractJsonArray(aiResponse, functionsArray, result.errorMessage))
+    {
+        return result;
+    }
+
+    for (const QJsonValue& value : functionsArray)
+    {
+        if (value.isObject())
+        {
+            QJsonObject funcObj = value.toObject();
+            FunctionData funcData = parseFunctionFromJson(funcObj, filePath, language);
+            result.functions.append(funcData);
+        }
+    }
+
+    result.success = true;
+    return result;
+}
+
+bool AICodeParser::extractJsonArray(const QString& aiResponse, QJsonArray& array, QString& errorMessage) const
+{
     QString jsonStr = aiResponse.trimmed();
 
     int jsonStart = jsonStr.indexOf('[');
@@ -483,10 +983,10 @@ AIParseResult AICodeParser::parseAIResponse(const QString& aiResponse, const QSt
 
     if (jsonStart == -1 || jsonEnd == -1 || jsonEnd <= jsonStart)
     {
-        result.errorMessage = "无法从AI响应中提取JSON数据";
-        Logger::instance().error(result.errorMessage);
-        Logger::instance().error("AI响应前500字符: " + aiResponse.left(500));
-        return result;
+        errorMessage = "无法从AI响应中提取JSON数据";
+        LOG_ERROR("%1", errorMessage);
+        LOG_ERROR("AI响应前500字符: %1", aiResponse.left(500));
+        return false;
     }
 
     jsonStr = jsonStr.mid(jsonStart, jsonEnd - jsonStart + 1);
@@ -496,64 +996,48 @@ AIParseResult AICodeParser::parseAIResponse(const QString& aiResponse, const QSt
 
     if (error.error != QJsonParseError::NoError)
     {
-        result.errorMessage = "解析JSON失败: " + error.errorString() + " (位置: " + QString::number(error.offset) + ")";
-        Logger::instance().error(result.errorMessage);
-        Logger::instance().error("JSON内容前1000字符: " + jsonStr.left(1000));
-        Logger::instance().error("JSON内容后500字符: " + jsonStr.right(500));
+        errorMessage = "解析JSON失败: " + error.errorString() + " (位置: " + QString::number(error.offset) + ")";
+        LOG_ERROR("%1", errorMessage);
+        LOG_ERROR("JSON内容前1000字符: %1", jsonStr.left(1000));
+        LOG_ERROR("JSON内容后500字符: %1", jsonStr.right(500));
 
         int openBraces = jsonStr.count('{');
         int closeBraces = jsonStr.count('}');
         int openBrackets = jsonStr.count('[');
         int closeBrackets = jsonStr.count(']');
 
-        Logger::instance().error(QString("括号统计: { %1 个, } %2 个, [ %3 个, ] %4 个")
-                                     .arg(openBraces)
-                                     .arg(closeBraces)
-                                     .arg(openBrackets)
-                                     .arg(closeBrackets));
+        LOG_ERROR("括号统计: { %1 个, } %2 个, [ %3 个, ] %4 个", openBraces, closeBraces, openBrackets, closeBrackets);
 
         if (openBraces > closeBraces)
         {
             int missing = openBraces - closeBraces;
             jsonStr += QString("}").repeated(missing);
-            Logger::instance().warning(QString("尝试补充 %1 个缺失的 }").arg(missing));
+            LOG_WARNING("尝试补充 %1 个缺失的 }", missing);
         }
         if (openBrackets > closeBrackets)
         {
             int missing = openBrackets - closeBrackets;
             jsonStr += QString("]").repeated(missing);
-            Logger::instance().warning(QString("尝试补充 %1 个缺失的 ]").arg(missing));
+            LOG_WARNING("尝试补充 %1 个缺失的 ]", missing);
         }
 
         jsonDoc = QJsonDocument::fromJson(jsonStr.toUtf8(), &error);
         if (error.error != QJsonParseError::NoError)
         {
-            result.errorMessage = "JSON修复失败: " + error.errorString();
-            Logger::instance().error(result.errorMessage);
-            return result;
+            errorMessage = "JSON修复失败: " + error.errorString();
+            LOG_ERROR("%1", errorMessage);
+            return false;
         }
     }
 
     if (!jsonDoc.isArray())
     {
-        result.errorMessage = "AI响应不是有效的JSON数组";
-        return result;
-    }
-
-    QJsonArray functionsArray = jsonDoc.array();
-
-    for (const QJsonValue& value : functionsArray)
-    {
-        if (value.isObject())
-        {
-            QJsonObject funcObj = value.toObject();
-            FunctionData funcData = parseFunctionFromJson(funcObj, filePath, language);
-            result.functions.append(funcData);
-        }
+        errorMessage = "AI响应不是有效的JSON数组";
+        return false;
     }
 
-    result.success = true;
-    return result;
+    array = jsonDoc.array();
+    return true;
 }
 
 FunctionData AICodeParser::parseFunctionFromJson(const QJsonObject& jsonObj, const QString& filePath,
@@ -564,7 +1048,7 @@ FunctionData AICodeParser::parseFunctionFromJson(const QJsonObject& jsonObj, con
     funcData.key = jsonObj["name"].toString();
     if (funcData.key.isEmpty())
     {
-        Logger::instance().warning("函数缺少name字段，使用默认值");
+        LOG_WARNING("函数缺少name字段，使用默认值");
         funcData.key = "unknown_function";
     }
 
@@ -582,12 +1066,12 @@ FunctionData AICodeParser::parseFunctionFromJson(const QJsonObject& jsonObj, con
     int endLine = jsonObj["end_line"].toInt(0);
     if (startLine <= 0)
     {
-        Logger::instance().warning(QString("函数 %1 的 start_line 无效: %2").arg(funcData.key).arg(startLine));
+        LOG_WARNING("函数 %1 的 start_line 无效: %2", funcData.key, startLine);
         startLine = 1;
     }
     if (endLine <= 0 || endLine < startLine)
     {
-        Logger::instance().warning(QString("函数 %1 的 end_line 无效: %2").arg(funcData.key).arg(endLine));
+        LOG_WARNING("函数 %1 的 end_line 无效: %2", funcData.key, endLine);
         endLine = startLine;
     }
     funcData.startLine = startLine;
@@ -597,7 +1081,7 @@ FunctionData AICodeParser::parseFunctionFromJson(const QJsonObject& jsonObj, con
     funcData.value = jsonObj["description"].toString();
     if (funcData.value.isEmpty())
     {
-        Logger::instance().warning(QString("函数 %1 缺少描述信息").arg(funcData.key));
+        LOG_WARNING("函数 %1 缺少描述信息", funcData.key);
         funcData.value = "暂无描述";
     }
 
@@ -605,13 +1089,13 @@ FunctionData AICodeParser::parseFunctionFromJson(const QJsonObject& jsonObj, con
     if (!funcData.flowchart.isEmpty() && !funcData.flowchart.trimmed().startsWith("flowchart") &&
         !funcData.flowchart.trimmed().startsWith("graph"))
     {
-        Logger::instance().warning(QString("函数 %1 的 flowchart 格式可能不正确").arg(funcData.key));
+        LOG_WARNING("函数 %1 的 flowchart 格式可能不正确", funcData.key);
     }
 
     funcData.sequenceDiagram = jsonObj["sequence_diagram"].toString();
     if (!funcData.sequenceDiagram.isEmpty() && !funcData.sequenceDiagram.trimmed().startsWith("sequenceDiagram"))
     {
-        Logger::instance().warning(QString("函数 %1 的 sequence_diagram 格式可能不正确").arg(funcData.key));
+        LOG_WARNING("函数 %1 的 sequence_diagram 格式可能不正确", funcData.key);
     }
 
     funcData.structureDiagram = jsonObj["structure_diagram"].toString();
@@ -651,7 +1135,7 @@ bool AICodeParser::readFileContent(const QString& filePath, QString& content) co
     QFile file(filePath);
     if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
     {
-        Logger::instance().error("无法打开文件: " + filePath + ", 错误: " + file.errorString());
+        LOG_ERROR("无法打开文件: %1, 错误: %2", filePath, file.errorString());
         return false;
     }
 
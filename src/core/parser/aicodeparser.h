@@ -11,11 +11,17 @@
  * - 流程图（Mermaid flowchart）
  * - 时序图（Mermaid sequenceDiagram）
  * - 模块依赖图（Mermaid graph）
+ *
+ * 混合模式下函数边界由FunctionParser在本地提取，AI只负责生成描述和图表；
+ * 本地解析器不支持的语言仍由AI完成提取。超大文件在AI提取时按顶层声明边界
+ * 切分为重叠片段，多个片段并发请求后按签名和行号范围合并去重。
  */
 
 #ifndef AICODEPARSER_H
 #define AICODEPARSER_H
 
+#include <QHash>
+#include <QJsonArray>
 #include <QJsonObject>
 #include <QNetworkAccessManager>
 #include <QNetworkReply>
@@ -23,6 +29,8 @@
 #include <QString>
 #include <QTimer>
 #include <QVector>
+#include "core/ai/ssestreamframer.h"
+#include "core/models/extractedfunction.h"
 #include "core/models/functiondata.h"
 
 /**
@@ -37,6 +45,52 @@ struct AIParseResult
     QString errorMessage;             ///< 错误信息
     int totalLines;                   ///< 文件总行数
     QString aiModel;                  ///< 使用的AI模型
+    qint64 promptTokens;              ///< 发送的提示词token数
+    qint64 completionTokens;          ///< 接收的输出token数
+};
+
+/**
+ * @brief AI代码解析模式
+ */
+enum class AIExtractionMode
+{
+    AIOnly,  ///< 整个文件发送给AI，由AI识别并分析所有函数
+    Hybrid   ///< 本地提取函数边界，仅将函数体打包发送给AI生成描述
+};
+
+/**
+ * @brief AI解析工作单元，对应一次AI请求
+ */
+struct AIParseUnit
+{
+    QString prompt;            ///< 请求提示词
+    int maxTokens;             ///< 最大输出token数
+    QVector<int> functionIds;  ///< 包含的本地函数编号（仅混合模式）
+    int lineOffset;            ///< 片段在原文件中的行号偏移（仅AI提取模式）
+
+    /**
+     * @brief 默认构造函数
+     */
+    AIParseUnit() : maxTokens(0), lineOffset(0) {}
+};
+
+/**
+ * @brief 进行中的AI请求上下文，每个网络回复独立持有流式状态
+ */
+struct AIUnitContext
+{
+    AIParseUnit unit;           ///< 对应的工作单元
+    SseStreamFramer sseFramer;  ///< 流式响应分帧器
+    QByteArray streamContent;   ///< 流式响应完整内容（UTF-8，结束时统一解码）
+    qint64 rateTicket;          ///< 速率限制器登记凭据
+    int estimatedTokens;        ///< 发送前估算的token占用（提示词 + 预留输出）
+    int promptTokens;           ///< usage中的提示词token数
+    int completionTokens;       ///< usage中的输出token数
+
+    /**
+     * @brief 默认构造函数
+     */
+    AIUnitContext() : rateTicket(0), estimatedTokens(0), promptTokens(0), completionTokens(0) {}
 };
 
 /**
@@ -100,6 +154,24 @@ class AICodeParser : public QObject
      */
     void setTimeout(int timeoutMs);
 
+    /**
+     * @brief 设置解析模式
+     * @param mode 解析模式
+     */
+    void setExtractionMode(AIExtractionMode mode);
+
+    /**
+     * @brief 设置单个文件的最大并发请求数
+     * @param maxConcurrent 最大并发请求数（至少为1）
+     */
+    void setMaxConcurrentRequests(int maxConcurrent);
+
+    /**
+     * @brief 获取解析模式
+     * @return 当前解析模式
+     */
+    AIExtractionMode extractionMode() const;
+
    signals:
     /**
      * @brief 解析完成信号
@@ -128,19 +200,16 @@ class AICodeParser : public QObject
    private slots:
     /**
      * @brief 网络请求完成槽函数
+     * @param reply 网络回复
      */
-    void onReplyFinished();
+    void onReplyFinished(QNetworkReply* reply);
 
     /**
      * @brief 网络错误槽函数
+     * @param reply 网络回复
      * @param error 网络错误
      */
-    void onNetworkError(QNetworkReply::NetworkError error);
-
-    /**
-     * @brief 超时槽函数
-     */
-    void onTimeout();
+    void onNetworkError(QNetworkReply* reply, QNetworkReply::NetworkError error);
 
    private:
     /**
@@ -163,9 +232,10 @@ class AICodeParser : public QObject
     /**
      * @brief 构建请求JSON对象
      * @param prompt 请求提示词
+     * @param maxTokens 最大输出token数
      * @return 请求JSON对象
      */
-    QJsonObject buildRequestJson(const QString& prompt) const;
+    QJsonObject buildRequestJson(const QString& prompt, int maxTokens) const;
 
     /**
      * @brief 构建代码解析提示词
@@ -176,6 +246,105 @@ class AICodeParser : public QObject
      */
     QString buildParsePrompt(const QString& code, const QString& language, const QString& filePath) const;
 
+    /**
+     * @brief 构建函数描述提示词（混合模式）
+     * @param functionIds 本地函数编号列表
+     * @param language 语言类型
+     * @param filePath 文件路径
+     * @return 提示词
+     */
+    QString buildDescribePrompt(const QVector<int>& functionIds, const QString& language,
+                                const QString& filePath) const;
+
+    /**
+     * @brief 本地提取函数并打包为工作单元（混合模式）
+     * @param code 源代码
+     * @param language 语言类型
+     * @param filePath 文件路径
+     * @return 是否成功，失败时应回退到AI提取
+     */
+    bool buildHybridUnits(const QString& code, const QString& language, const QString& filePath);
+
+    /**
+     * @brief 获取本地解析器对应的语言标识
+     * @param language AI解析器的语言标识
+     * @return FunctionParser使用的语言标识
+     */
+    QString localParserLanguage(const QString& language) const;
+
+    /**
+     * @brief 在并发上限内发送待处理的工作单元
+     */
+    void dispatchUnits();
+
+    /**
+     * @brief 发送单个工作单元的请求
+     * @param unit 工作单元
+     * @param estimatedTokens 估算的token占用
+     */
+    void startUnit(const AIParseUnit& unit, int estimatedTokens);
+
+    /**
+     * @brief 统计单个请求的token消耗并修正速率限制器登记
+     * @param context 请求上下文
+     * @param aiResponse AI响应内容（usage缺失时用于估算）
+     */
+    void recordUsage(const AIUnitContext& context, const QString& aiResponse);
+
+    /**
+     * @brief 构建分片提取的工作单元（AI提取模式）
+     * @param code 源代码
+     * @param language 语言类型
+     * @param filePath 文件路径
+     */
+    void buildChunkUnits(const QString& code, const QString& language, const QString& filePath);
+
+    /**
+     * @brief 合并各片段提取的函数，按签名和行号范围去重
+     * @param functions 各片段提取的函数
+     * @return 去重后的函数列表（按起始行排序）
+     */
+    QVector<FunctionData> mergeChunkFunctions(QVector<FunctionData> functions) const;
+
+    /**
+     * @brief 处理单个工作单元的AI响应
+     * @param unit 工作单元
+     * @param aiResponse AI响应字符串
+     * @param errorMessage 输出参数，错误信息
+     * @return 是否处理成功
+     */
+    bool handleUnitResponse(const AIParseUnit& unit, const QString& aiResponse, QString& errorMessage);
+
+    /**
+     * @brief 所有工作单元完成后汇总结果
+     */
+    void finishParsing();
+
+    /**
+     * @brief 中止所有进行中的网络请求（不触发完成处理）
+     */
+    void abortActiveReplies();
+
+    /**
+     * @brief 从AI响应中提取JSON数组，必要时尝试修复缺失的括号
+     * @param aiResponse AI响应字符串
+     * @param array 输出参数，JSON数组
+     * @param errorMessage 输出参数，错误信息
+     * @return 是否成功
+     */
+    bool extractJsonArray(const QString& aiResponse, QJsonArray& array, QString& errorMessage) const;
+
+    /**
+     * @brief 合并本地提取的函数边界和AI生成的描述
+     * @param func 本地提取的函数
+     * @param aiObj AI返回的描述对象（可能为空）
+     * @param filePath 文件路径
+     * @param language 语言类型
+     * @return 函数数据
+     */
+    FunctionData mergeLocalFunction(const ExtractedFunction& func, const QJsonObject& aiObj, const QString& filePath,
+                                    const QString& language) const;
+
     /**
      * @brief 解析AI响应
      * @param aiResponse AI响应字符串
@@ -212,26 +381,41 @@ class AICodeParser : public QObject
 
     /**
      * @brief 处理流式响应数据
+     * @param reply 网络回复
      */
-    void onReadyRead();
+    void onReadyRead(QNetworkReply* reply);
 
     /**
-     * @brief 解析SSE数据行
-     * @param line 数据行
+     * @brief 解析SSE事件的data负载
+     * @param payload data字段内容（不含"data:"前缀）
+     * @param context 所属请求上下文
      * @return 是否成功解析
      */
-    bool parseSSELine(const QString& line);
-
-    QNetworkAccessManager* m_networkManager;  ///< 网络访问管理器
-    QNetworkReply* m_currentReply;            ///< 当前网络回复
-    QTimer* m_timeoutTimer;                   ///< 超时定时器
-    QString m_currentFilePath;                ///< 当前解析的文件路径
-    QString m_currentLanguage;                ///< 当前解析的语言类型
-    bool m_isParsing;                         ///< 是否正在解析
-    int m_timeoutMs;                          ///< 超时时间（毫秒）
-    QString m_streamBuffer;                   ///< 流式响应缓冲区
-    QString m_streamContent;                  ///< 流式响应完整内容
-    int m_receivedTokens;                     ///< 已接收的token数
+    bool parseSSEPayload(QByteArrayView payload, AIUnitContext& context);
+
+    QNetworkAccessManager* m_networkManager;             ///< 网络访问管理器
+    QHash<QNetworkReply*, AIUnitContext> m_activeUnits;  ///< 进行中的请求上下文
+    QTimer* m_dispatchTimer;                             ///< 等待速率预算的调度定时器
+    QString m_currentFilePath;                           ///< 当前解析的文件路径
+    QString m_currentLanguage;                           ///< 当前解析的语言类型
+    bool m_isParsing;                                    ///< 是否正在解析
+    int m_timeoutMs;                                     ///< 单个请求的传输超时时间（毫秒）
+    int m_maxConcurrentRequests;                         ///< 单个文件的最大并发请求数
+    int m_receivedTokens;                                ///< 已接收的token数（所有请求合计）
+    AIExtractionMode m_extractionMode;                   ///< 解析模式
+    bool m_hybridActive;                                 ///< 当前解析是否使用混合模式
+    int m_currentTotalLines;                             ///< 当前解析代码的总行数
+    QVector<AIParseUnit> m_pendingUnits;                 ///< 待发送的工作单元
+    int m_totalUnits;                                    ///< 工作单元总数
+    int m_startedUnits;                                  ///< 已发送的工作单元数
+    int m_failedUnits;                                   ///< 失败的工作单元数
+    QString m_lastUnitError;                             ///< 最近一次工作单元错误
+    QVector<ExtractedFunction> m_localFunctions;         ///< 本地提取的函数（混合模式）
+    QHash<int, QJsonObject> m_describedFunctions;        ///< AI返回的函数描述，按本地函数编号索引
+    QHash<int, int> m_duplicateOf;                       ///< 内容重复的本地函数编号 -> 首次出现的编号
+    QVector<FunctionData> m_collectedFunctions;          ///< AI提取的函数（AI模式）
+    qint64 m_promptTokens;                               ///< 当前文件已发送的提示词token数
+    qint64 m_completionTokens;                           ///< 当前文件已接收的输出token数
 };
 
 #endif  // AICODEPARSER_H
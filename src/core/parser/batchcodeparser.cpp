@@ -7,11 +7,10 @@
  */
 
 #include "core/parser/batchcodeparser.h"
-#include <QDir>
-#include <QDirIterator>
 #include <QFileInfo>
 #include <QTimer>
 #include "common/logger/logger.h"
+#include "core/parser/directorywalker.h"
 
 BatchCodeParser::BatchCodeParser(IDatabaseManager* dbManager, QObject* parent)
     : QObject(parent),
@@ -19,6 +18,8 @@ BatchCodeParser::BatchCodeParser(IDatabaseManager* dbManager, QObject* parent)
       m_isParsing(false),
       m_skipExisting(true),
       m_cancelled(false),
+      m_streamResults(false),
+      m_progressThrottle(new ProgressThrottle(20, this)),
       m_targetProjectId(-1)
 {
 
@@ -33,7 +34,9 @@ BatchCodeParser::BatchCodeParser(IDatabaseManager* dbManager, QObject* parent)
     connect(&aiParser, &AICodeParser::parseFailed, this, &BatchCodeParser::onFileParseFailed);
     connect(&aiParser, &AICodeParser::parseProgress, this, &BatchCodeParser::onFileParseProgress);
 
-    Logger::instance().info("批量代码解析器初始化完成");
+    connect(m_progressThrottle, &ProgressThrottle::due, this, [this]() { emit batchProgress(m_currentProgress); });
+
+    LOG_INFO("批量代码解析器初始化完成");
 }
 
 BatchCodeParser::~BatchCodeParser()
@@ -49,7 +52,7 @@ void BatchCodeParser::parseFolder(const QString& folderPath, bool recursive)
         return;
     }
 
-    Logger::instance().info("开始扫描文件夹: " + folderPath + ", 递归: " + (recursive ? "是" : "否"));
+    LOG_INFO("开始扫描文件夹: %1, 递归: %2", folderPath, recursive ? "是" : "否");
 
     QStringList files;
     scanFolder(folderPath, files, recursive);
@@ -57,11 +60,11 @@ void BatchCodeParser::parseFolder(const QString& folderPath, bool recursive)
     if (files.isEmpty())
     {
         emit batchFailed("文件夹中没有找到代码文件");
-        Logger::instance().warning("文件夹中没有找到代码文件: " + folderPath);
+        LOG_WARNING("文件夹中没有找到代码文件: %1", folderPath);
         return;
     }
 
-    Logger::instance().info(QString("找到 %1 个代码文件").arg(files.size()));
+    LOG_INFO("找到 %1 个代码文件", files.size());
 
     parseFiles(files);
 }
@@ -89,13 +92,14 @@ void BatchCodeParser::parseFiles(const QStringList& filePaths)
     m_currentProgress.successCount = 0;
     m_currentProgress.failedCount = 0;
     m_currentProgress.skippedCount = 0;
+    m_progressThrottle->reset();
 
     for (const QString& filePath : filePaths)
     {
         m_fileQueue.enqueue(filePath);
     }
 
-    Logger::instance().info(QString("开始批量解析 %1 个文件").arg(filePaths.size()));
+    LOG_INFO("开始批量解析 %1 个文件", filePaths.size());
 
     processNextFile();
 }
@@ -106,10 +110,11 @@ void BatchCodeParser::cancelParsing()
     m_isParsing = false;
 
     m_fileQueue.clear();
+    m_progressThrottle->reset();
 
     AICodeParser::instance().cancelParsing();
 
-    Logger::instance().info("已取消批量解析");
+    LOG_INFO("已取消批量解析");
     emit batchCancelled();
 }
 
@@ -128,6 +133,11 @@ void BatchCodeParser::setFileExtensions(const QStringList& extensions)
     m_allowedExtensions = extensions;
 }
 
+QStringList BatchCodeParser::fileExtensions() const
+{
+    return m_allowedExtensions;
+}
+
 void BatchCodeParser::setExcludeDirectories(const QStringList& directories)
 {
     m_excludeDirectories = directories;
@@ -136,61 +146,30 @@ void BatchCodeParser::setExcludeDirectories(const QStringList& directories)
 void BatchCodeParser::setTargetProject(int projectId)
 {
     m_targetProjectId = projectId;
-    Logger::instance().info(QString("设置批量解析目标项目ID: %1").arg(projectId));
+    LOG_INFO("设置批量解析目标项目ID: %1", projectId);
 }
 
 void BatchCodeParser::setProjectRootPath(const QString& rootPath)
 {
     m_projectRootPath = rootPath;
-    Logger::instance().info(QString("设置项目根路径: %1").arg(rootPath));
+    LOG_INFO("设置项目根路径: %1", rootPath);
 }
 
-void BatchCodeParser::scanFolder(const QString& folderPath, QStringList& files, bool recursive)
+void BatchCodeParser::setStreamResults(bool enabled)
 {
-    QDir dir(folderPath);
-    if (!dir.exists())
-    {
-        Logger::instance().warning("文件夹不存在: " + folderPath);
-        return;
-    }
-
-    QDirIterator::IteratorFlags flags = recursive ? QDirIterator::Subdirectories : QDirIterator::NoIteratorFlags;
-    QDirIterator it(folderPath, QDir::Files | QDir::NoSymLinks, flags);
-
-    while (it.hasNext())
-    {
-        QString filePath = it.next();
-        QFileInfo fileInfo(filePath);
-
-        QString relativePath = dir.relativeFilePath(filePath);
-        bool shouldExclude = false;
-
-        for (const QString& excludeDir : m_excludeDirectories)
-        {
-            if (relativePath.contains(excludeDir + "/") || relativePath.startsWith(excludeDir))
-            {
-                shouldExclude = true;
-                break;
-            }
-        }
-
-        if (shouldExclude)
-        {
-            continue;
-        }
-
-        if (isFileExtensionAllowed(filePath))
-        {
-            files.append(filePath);
-        }
-    }
+    m_streamResults = enabled;
+    LOG_INFO("设置流式结果: %1", enabled ? "是" : "否");
 }
 
-bool BatchCodeParser::isFileExtensionAllowed(const QString& filePath) const
+void BatchCodeParser::scanFolder(const QString& folderPath, QStringList& files, bool recursive)
 {
-    QFileInfo fileInfo(filePath);
-    QString suffix = fileInfo.suffix().toLower();
-    return m_allowedExtensions.contains(suffix);
+    WalkerOptions options;
+    options.fileExtensions = m_allowedExtensions;
+    options.excludeDirectories = m_excludeDirectories;
+    options.recursive = recursive;
+
+    DirectoryWalker walker(options);
+    files.append(walker.collect(folderPath));
 }
 
 void BatchCodeParser::processNextFile()
@@ -214,30 +193,27 @@ void BatchCodeParser::processNextFile()
 
     emitProgress();
 
-    Logger::instance().info(QString("开始解析文件 (%1/%2): %3")
-                                .arg(m_currentProgress.processedFiles + 1)
-                                .arg(m_currentProgress.totalFiles)
-                                .arg(m_currentFile));
+    LOG_INFO("开始解析文件 (%1/%2): %3", m_currentProgress.processedFiles + 1, m_currentProgress.totalFiles, m_currentFile);
 
     AICodeParser::instance().parseFile(m_currentFile);
 }
 
 void BatchCodeParser::emitProgress()
 {
-    emit batchProgress(m_currentProgress);
+    m_progressThrottle->request();
 }
 
 void BatchCodeParser::finishBatch()
 {
     m_isParsing = false;
+    m_progressThrottle->flush();
 
     m_currentResult.success = (m_currentResult.failedCount == 0);
 
-    Logger::instance().info(QString("批量解析完成 - 总计: %1, 成功: %2, 失败: %3, 跳过: %4")
-                                .arg(m_currentResult.totalFiles)
-                                .arg(m_currentResult.successCount)
-                                .arg(m_currentResult.failedCount)
-                                .arg(m_currentResult.skippedCount));
+    LOG_INFO("批量解析完成 - 总计: %1, 成功: %2, 失败: %3, 跳过: %4, 保存函数: %5, token发送: %6, token接收: %7",
+             m_currentResult.totalFiles, m_currentResult.successCount, m_currentResult.failedCount,
+             m_currentResult.skippedCount, m_currentResult.savedFunctionCount, m_currentResult.promptTokens,
+             m_currentResult.completionTokens);
 
     emit batchComplete(m_currentResult);
 }
@@ -246,10 +222,13 @@ void BatchCodeParser::onFileParseComplete(const AIParseResult& result)
 {
     m_processedFiles.insert(m_currentFile);
     m_currentProgress.processedFiles++;
+    m_currentResult.promptTokens += result.promptTokens;
+    m_currentResult.completionTokens += result.completionTokens;
 
     if (result.success && !result.functions.isEmpty())
     {
         int savedCount = 0;
+        QVector<FunctionSummary> saved;
 
         QString relativePath = result.filePath;
         if (!m_projectRootPath.isEmpty() && result.filePath.startsWith(m_projectRootPath))
@@ -267,7 +246,7 @@ void BatchCodeParser::onFileParseComplete(const AIParseResult& result)
             {
                 m_currentProgress.skippedCount++;
                 m_currentResult.skippedCount++;
-                Logger::instance().info("跳过已存在的函数: " + funcData.key);
+                LOG_INFO("跳过已存在的函数: %1", funcData.key);
             }
             else
             {
@@ -289,31 +268,38 @@ void BatchCodeParser::onFileParseComplete(const AIParseResult& result)
                 if (m_dbManager->addFunction(data))
                 {
                     savedCount++;
-                    m_currentResult.allFunctions.append(data);
+                    m_currentResult.savedFunctionCount++;
+                    saved.append(FunctionSummary(data));
+                    if (!m_streamResults)
+                    {
+                        m_currentResult.allFunctions.append(data);
+                    }
                 }
             }
         }
 
+        if (!saved.isEmpty())
+        {
+            emit functionsSaved(saved);
+        }
+
         m_currentResult.successCount++;
         m_currentProgress.successCount++;
 
-        Logger::instance().info(QString("文件解析成功: %1, 提取 %2 个函数, 保存 %3 个")
-                                    .arg(m_currentFile)
-                                    .arg(result.functions.size())
-                                    .arg(savedCount));
+        LOG_INFO("文件解析成功: %1, 提取 %2 个函数, 保存 %3 个", m_currentFile, result.functions.size(), savedCount);
     }
     else if (result.functions.isEmpty())
     {
         m_currentProgress.skippedCount++;
         m_currentResult.skippedCount++;
-        Logger::instance().info("文件中未找到函数: " + m_currentFile);
+        LOG_INFO("文件中未找到函数: %1", m_currentFile);
     }
     else
     {
         m_currentResult.failedCount++;
         m_currentProgress.failedCount++;
         m_currentResult.failedFiles.append(m_currentFile);
-        Logger::instance().warning("文件解析失败: " + m_currentFile);
+        LOG_WARNING("文件解析失败: %1", m_currentFile);
     }
 
     emit fileParsed(m_currentFile, result);
@@ -330,7 +316,7 @@ void BatchCodeParser::onFileParseFailed(const QString& error)
     m_currentProgress.failedCount++;
     m_currentResult.failedFiles.append(m_currentFile);
 
-    Logger::instance().error(QString("文件解析失败: %1, 错误: %2").arg(m_currentFile).arg(error));
+    LOG_ERROR("文件解析失败: %1, 错误: %2", m_currentFile, error);
 
     emitProgress();
 
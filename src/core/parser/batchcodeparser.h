@@ -22,6 +22,8 @@
 #include <QString>
 #include <QStringList>
 #include "core/interfaces/idatabaserepository.h"
+#include "core/models/parseresult.h"
+#include "common/utils/progressthrottle.h"
 #include "core/parser/aicodeparser.h"
 
 /**
@@ -49,9 +51,12 @@ struct BatchParseResult
     int successCount;                    ///< 成功数量
     int failedCount;                     ///< 失败数量
     int skippedCount;                    ///< 跳过数量
-    QVector<FunctionData> allFunctions;  ///< 所有提取的函数
+    int savedFunctionCount;              ///< 保存的函数数
+    QVector<FunctionData> allFunctions;  ///< 所有提取的函数（流式结果模式下为空）
     QStringList failedFiles;             ///< 失败的文件列表
     QString errorMessage;                ///< 错误信息
+    qint64 promptTokens;                 ///< 本次运行发送的提示词token数
+    qint64 completionTokens;             ///< 本次运行接收的输出token数
 };
 
 /**
@@ -119,6 +124,12 @@ class BatchCodeParser : public QObject
      */
     void setFileExtensions(const QStringList& extensions);
 
+    /**
+     * @brief 获取要处理的文件扩展名
+     * @return 扩展名列表
+     */
+    QStringList fileExtensions() const;
+
     /**
      * @brief 设置要排除的目录名
      * @param directories 目录名列表（如 {"node_modules", ".git"}）
@@ -143,6 +154,13 @@ class BatchCodeParser : public QObject
      */
     int targetProjectId() const { return m_targetProjectId; }
 
+    /**
+     * @brief 设置是否使用流式结果
+     * @param enabled 是否启用（启用后保存的函数只以摘要通过 functionsSaved 信号交出，
+     *                批量结果只含统计数据，内存占用不随批量大小增长）
+     */
+    void setStreamResults(bool enabled);
+
    signals:
     /**
      * @brief 批量解析进度信号
@@ -157,6 +175,12 @@ class BatchCodeParser : public QObject
      */
     void fileParsed(const QString& filePath, const AIParseResult& result);
 
+    /**
+     * @brief 一个文件的函数保存完成信号
+     * @param functions 本文件保存的函数摘要
+     */
+    void functionsSaved(const QVector<FunctionSummary>& functions);
+
     /**
      * @brief 批量解析完成信号
      * @param result 批量解析结果
@@ -196,27 +220,20 @@ class BatchCodeParser : public QObject
 
    private:
     /**
-     * @brief 递归扫描文件夹
+     * @brief 扫描文件夹（并行遍历，剪除排除目录并遵循 .gitignore）
      * @param folderPath 文件夹路径
      * @param files 输出参数，找到的文件列表
      * @param recursive 是否递归扫描子文件夹
      */
     void scanFolder(const QString& folderPath, QStringList& files, bool recursive = true);
 
-    /**
-     * @brief 检查文件扩展名是否在允许列表中
-     * @param filePath 文件路径
-     * @return 是否允许
-     */
-    bool isFileExtensionAllowed(const QString& filePath) const;
-
     /**
      * @brief 处理下一个文件
      */
     void processNextFile();
 
     /**
-     * @brief 发送进度信号
+     * @brief 请求发送进度信号（按固定帧率合并，只发出最新进度）
      */
     void emitProgress();
 
@@ -229,15 +246,17 @@ class BatchCodeParser : public QObject
     QQueue<QString> m_fileQueue;     ///< 文件队列
     QSet<QString> m_processedFiles;  ///< 已处理的文件集合
 
-    bool m_isParsing;     ///< 是否正在解析
-    bool m_skipExisting;  ///< 是否跳过已存在的函数
-    bool m_cancelled;     ///< 是否已取消
+    bool m_isParsing;      ///< 是否正在解析
+    bool m_skipExisting;   ///< 是否跳过已存在的函数
+    bool m_cancelled;      ///< 是否已取消
+    bool m_streamResults;  ///< 是否使用流式结果
 
     QStringList m_allowedExtensions;   ///< 允许的文件扩展名
     QStringList m_excludeDirectories;  ///< 排除的目录名
 
     BatchParseResult m_currentResult;      ///< 当前批量解析结果
     BatchParseProgress m_currentProgress;  ///< 当前进度
+    ProgressThrottle* m_progressThrottle;  ///< 进度信号节流器
     QString m_currentFile;                 ///< 当前处理的文件
     int m_targetProjectId;                 ///< 目标项目ID
     QString m_projectRootPath;             ///< 项目根路径
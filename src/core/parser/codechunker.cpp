@@ -0,0 +1,183 @@
+/**
+ * @file codechunker.cpp
+ * @brief 代码分片器实现
+ * @author Developer
+ * @date 2026-10-18
+ * @version 1.0
+ */
+
+#include "core/parser/codechunker.h"
+
+QVector<CodeChunk> CodeChunker::split(const QString& code, const QString& language, int maxChunkChars,
+                                      int overlapLines)
+{
+    QVector<CodeChunk> chunks;
+
+    if (code.size() <= maxChunkChars)
+    {
+        CodeChunk chunk;
+        chunk.code = code;
+        chunk.startLine = 1;
+        chunk.endLine = code.count('\n') + 1;
+        chunks.append(chunk);
+        return chunks;
+    }
+
+    QVector<int> lineStarts;
+    QVector<QStringView> lines;
+    int pos = 0;
+    while (pos <= code.size())
+    {
+        int lineEnd = code.indexOf('\n', pos);
+        if (lineEnd < 0)
+        {
+            lineEnd = code.size();
+        }
+        lineStarts.append(pos);
+        lines.append(QStringView(code).mid(pos, lineEnd - pos));
+        pos = lineEnd + 1;
+    }
+    lineStarts.append(code.size());
+
+    QVector<int> depths;
+    QVector<bool> boundaryOk;
+    analyzeLines(lines, language, depths, boundaryOk);
+
+    const int lineCount = lines.size();
+    int chunkStart = 0;
+    int contentStart = 0;
+
+    while (contentStart < lineCount)
+    {
+        int line = chunkStart;
+        int size = 0;
+        while (line < lineCount && size + lines[line].size() + 1 <= maxChunkChars)
+        {
+            size += lines[line].size() + 1;
+            line++;
+        }
+
+        if (line >= lineCount)
+        {
+            line = lineCount;
+        }
+        else
+        {
+            if (line <= contentStart)
+            {
+                line = contentStart + 1;
+            }
+
+            // 在片段后半部分寻找嵌套最浅的边界，同等深度取最靠后的位置
+            int searchFloor = contentStart + (line - contentStart) / 2;
+            int best = -1;
+            for (int b = line; b > searchFloor; --b)
+            {
+                if (boundaryOk[b] && (best < 0 || depths[b] < depths[best]))
+                {
+                    best = b;
+                }
+            }
+            if (best > 0)
+            {
+                line = best;
+            }
+        }
+
+        CodeChunk chunk;
+        chunk.startLine = chunkStart + 1;
+        chunk.endLine = line;
+        chunk.code = code.mid(lineStarts[chunkStart], lineStarts[line] - lineStarts[chunkStart]);
+        chunks.append(chunk);
+
+        contentStart = line;
+        chunkStart = qMax(line - overlapLines, chunkStart + 1);
+    }
+
+    return chunks;
+}
+
+void CodeChunker::analyzeLines(const QVector<QStringView>& lines, const QString& language, QVector<int>& depths,
+                               QVector<bool>& boundaryOk)
+{
+    depths.resize(lines.size() + 1);
+    boundaryOk.resize(lines.size() + 1);
+    depths[lines.size()] = 0;
+    boundaryOk[lines.size()] = true;
+
+    if (language == "python" || language == "ruby")
+    {
+        for (int i = 0; i < lines.size(); ++i)
+        {
+            QStringView line = lines[i];
+            bool blank = line.trimmed().isEmpty();
+            bool topLevel = !blank && !line[0].isSpace();
+            depths[i] = topLevel ? 0 : 1;
+            boundaryOk[i] = topLevel;
+        }
+        return;
+    }
+
+    int depth = 0;
+    bool inBlockComment = false;
+    bool previousEndsStatement = true;
+
+    for (int i = 0; i < lines.size(); ++i)
+    {
+        QStringView line = lines[i];
+        depths[i] = depth;
+        boundaryOk[i] = !inBlockComment && previousEndsStatement;
+
+        int j = 0;
+        while (j < line.size())
+        {
+            QChar c = line[j];
+            if (inBlockComment)
+            {
+                if (c == '*' && j + 1 < line.size() && line[j + 1] == '/')
+                {
+                    inBlockComment = false;
+                    j += 2;
+                    continue;
+                }
+                j++;
+                continue;
+            }
+
+            if (c == '/' && j + 1 < line.size() && line[j + 1] == '/')
+            {
+                break;
+            }
+            if (c == '/' && j + 1 < line.size() && line[j + 1] == '*')
+            {
+                inBlockComment = true;
+                j += 2;
+                continue;
+            }
+            if (c == '"' || c == '\'')
+            {
+                j++;
+                while (j < line.size() && line[j] != c)
+                {
+                    j += (line[j] == '\\') ? 2 : 1;
+                }
+                j++;
+                continue;
+            }
+
+            if (c == '{')
+            {
+                depth++;
+            }
+            else if (c == '}' && depth > 0)
+            {
+                depth--;
+            }
+            j++;
+        }
+
+        QStringView trimmed = line.trimmed();
+        previousEndsStatement = trimmed.isEmpty() || trimmed.endsWith('}') || trimmed.endsWith(';') ||
+                                trimmed.endsWith(QStringLiteral("*/"));
+    }
+}
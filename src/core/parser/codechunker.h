@@ -0,0 +1,65 @@
+/**
+ * @file codechunker.h
+ * @brief 代码分片器，将超大源文件按顶层声明边界切分为带重叠的片段
+ * @author Developer
+ * @date 2026-10-18
+ * @version 1.0
+ *
+ * @details 分片规则：
+ * - 每个片段不超过指定字符数（单行超长时除外）
+ * - 切分点优先选择括号深度（或缩进层级）最浅、且前一行为空行或语句结束的位置
+ * - 相邻片段之间保留若干行重叠，作为上下文并避免边界处的函数丢失
+ */
+
+#ifndef CODECHUNKER_H
+#define CODECHUNKER_H
+
+#include <QString>
+#include <QStringView>
+#include <QVector>
+
+/**
+ * @brief 代码片段
+ */
+struct CodeChunk
+{
+    QString code;   ///< 片段代码
+    int startLine;  ///< 片段在原文件中的起始行号（从1开始）
+    int endLine;    ///< 片段在原文件中的结束行号
+
+    /**
+     * @brief 默认构造函数
+     */
+    CodeChunk() : startLine(0), endLine(0) {}
+};
+
+/**
+ * @brief 代码分片器类
+ */
+class CodeChunker
+{
+   public:
+    /**
+     * @brief 按顶层声明边界切分代码
+     * @param code 源代码
+     * @param language 语言类型
+     * @param maxChunkChars 单个片段最大字符数
+     * @param overlapLines 相邻片段之间的重叠行数
+     * @return 片段列表；代码不超过maxChunkChars时只返回一个片段
+     */
+    static QVector<CodeChunk> split(const QString& code, const QString& language, int maxChunkChars,
+                                    int overlapLines);
+
+   private:
+    /**
+     * @brief 计算每一行行首的嵌套深度
+     * @param lines 代码行
+     * @param language 语言类型
+     * @param depths 输出参数，每行行首的嵌套深度
+     * @param boundaryOk 输出参数，每行是否适合作为片段起点
+     */
+    static void analyzeLines(const QVector<QStringView>& lines, const QString& language, QVector<int>& depths,
+                             QVector<bool>& boundaryOk);
+};
+
+#endif  // CODECHUNKER_H
@@ -0,0 +1,242 @@
+/**
+ * @file directorywalker.cpp
+ * @brief 并行目录遍历器实现
+ * @author Developer
+ * @date 2026-10-18
+ * @version 1.0
+ */
+
+#include "core/parser/directorywalker.h"
+#include <QDir>
+#include <QDirIterator>
+#include <QFileInfo>
+#include <QMutexLocker>
+#include <QThread>
+#include <algorithm>
+#include "common/logger/logger.h"
+
+DirectoryWalker::DirectoryWalker(const WalkerOptions& options)
+    : m_options(options), m_pending(0), m_stopped(0), m_directoriesVisited(0), m_directoriesPruned(0)
+{
+    for (const QString& ext : options.fileExtensions)
+    {
+        m_extensions.insert(ext.toLower());
+    }
+
+    for (const QString& dir : options.excludeDirectories)
+    {
+        QString normalized = QDir::fromNativeSeparators(dir);
+        while (normalized.endsWith('/'))
+        {
+            normalized.chop(1);
+        }
+        if (normalized.isEmpty())
+        {
+            continue;
+        }
+
+        if (normalized.contains('/'))
+        {
+            m_excludePaths.append(normalized);
+        }
+        else
+        {
+            m_excludeNames.insert(normalized);
+        }
+    }
+}
+
+bool DirectoryWalker::walk(const QString& rootPath, const FileCallback& onFile)
+{
+    if (!QFileInfo(rootPath).isDir())
+    {
+        Logger::instance().warning("文件夹不存在: " + rootPath);
+        return false;
+    }
+
+    {
+        QMutexLocker locker(&m_mutex);
+        m_stack.clear();
+        DirTask root;
+        root.path = QDir(rootPath).absolutePath();
+        m_stack.append(root);
+        m_pending = 1;
+    }
+    m_stopped.storeRelaxed(0);
+    m_directoriesVisited.storeRelaxed(0);
+    m_directoriesPruned.storeRelaxed(0);
+
+    int threadCount = m_options.threadCount > 0 ? m_options.threadCount : QThread::idealThreadCount();
+    if (!m_options.recursive)
+    {
+        threadCount = 1;
+    }
+
+    // 调用线程本身也参与遍历
+    QVector<QThread*> threads;
+    for (int i = 1; i < threadCount; ++i)
+    {
+        QThread* thread = QThread::create([this, &onFile]() { workerLoop(onFile); });
+        thread->setObjectName(QString("walker-%1").arg(i));
+        threads.append(thread);
+        thread->start();
+    }
+
+    workerLoop(onFile);
+
+    for (QThread* thread : threads)
+    {
+        thread->wait();
+    }
+    qDeleteAll(threads);
+
+    return m_stopped.loadRelaxed() == 0;
+}
+
+QStringList DirectoryWalker::collect(const QString& rootPath)
+{
+    QMutex filesMutex;
+    QStringList files;
+    walk(rootPath,
+         [&filesMutex, &files](const QString& filePath)
+         {
+             QMutexLocker locker(&filesMutex);
+             files.append(filePath);
+             return true;
+         });
+
+    // 并行遍历的顺序不固定，排序后保证结果可重复
+    std::sort(files.begin(), files.end());
+    return files;
+}
+
+void DirectoryWalker::cancel()
+{
+    stop();
+}
+
+void DirectoryWalker::workerLoop(const FileCallback& onFile)
+{
+    while (true)
+    {
+        DirTask task;
+        {
+            QMutexLocker locker(&m_mutex);
+            while (m_stack.isEmpty() && m_pending > 0 && !m_stopped.loadRelaxed())
+            {
+                m_hasWork.wait(&m_mutex);
+            }
+            if (m_stopped.loadRelaxed() || m_pending == 0)
+            {
+                return;
+            }
+            task = m_stack.takeLast();
+        }
+
+        QVector<DirTask> subdirs;
+        visitDirectory(task, onFile, subdirs);
+
+        QMutexLocker locker(&m_mutex);
+        // 逆序入栈，使子目录按列出的顺序出栈
+        for (auto it = subdirs.crbegin(); it != subdirs.crend(); ++it)
+        {
+            m_stack.append(*it);
+        }
+        m_pending += subdirs.size() - 1;
+        if (m_pending == 0 || !subdirs.isEmpty())
+        {
+            m_hasWork.wakeAll();
+        }
+    }
+}
+
+void DirectoryWalker::visitDirectory(const DirTask& task, const FileCallback& onFile, QVector<DirTask>& subdirs)
+{
+    m_directoriesVisited.fetchAndAddRelaxed(1);
+    if (m_onDirectory)
+    {
+        m_onDirectory(task.path);
+    }
+
+    std::shared_ptr<const IgnoreRules> rules = task.rules;
+    if (m_options.respectGitignore)
+    {
+        rules = IgnoreRules::forDirectory(task.rules, task.path, task.relativePath);
+    }
+
+    QDirIterator it(task.path, QDir::Dirs | QDir::Files | QDir::NoDotAndDotDot | QDir::NoSymLinks);
+    while (it.hasNext())
+    {
+        if (m_stopped.loadRelaxed())
+        {
+            return;
+        }
+
+        QString filePath = it.next();
+        QFileInfo info = it.fileInfo();
+        QString name = info.fileName();
+        QString relativePath = task.relativePath.isEmpty() ? name : task.relativePath + "/" + name;
+
+        if (info.isDir())
+        {
+            if (!m_options.recursive)
+            {
+                continue;
+            }
+            if (isExcluded(name, relativePath) || (rules && rules->isIgnored(relativePath, name, true)))
+            {
+                m_directoriesPruned.fetchAndAddRelaxed(1);
+                continue;
+            }
+
+            DirTask subdir;
+            subdir.path = filePath;
+            subdir.relativePath = relativePath;
+            subdir.rules = rules;
+            subdirs.append(subdir);
+            continue;
+        }
+
+        if (!m_extensions.isEmpty())
+        {
+            int dot = name.lastIndexOf('.');
+            if (dot < 0 || !m_extensions.contains(name.mid(dot + 1).toLower()))
+            {
+                continue;
+            }
+        }
+        if (rules && rules->isIgnored(relativePath, name, false))
+        {
+            continue;
+        }
+
+        if (!onFile(filePath))
+        {
+            stop();
+            return;
+        }
+    }
+}
+
+bool DirectoryWalker::isExcluded(const QString& name, const QString& relativePath) const
+{
+    if (m_excludeNames.contains(name))
+    {
+        return true;
+    }
+    for (const QString& path : m_excludePaths)
+    {
+        if (relativePath == path)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+void DirectoryWalker::stop()
+{
+    QMutexLocker locker(&m_mutex);
+    m_stopped.storeRelaxed(1);
+    m_hasWork.wakeAll();
+}
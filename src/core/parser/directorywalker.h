@@ -0,0 +1,158 @@
+/**
+ * @file directorywalker.h
+ * @brief 并行目录遍历器，在进入目录前剪除排除目录并遵循 .gitignore
+ * @author Developer
+ * @date 2026-10-18
+ * @version 1.0
+ *
+ * @details 与逐个文件计算相对路径、再与排除列表逐一比较的遍历方式相比：
+ * - 排除目录名和扩展名预先放入哈希集合，每个条目只做一次查找
+ * - 被排除或被忽略的目录不会进入，其下的文件不会被列出
+ * - 多个线程共享一个待遍历目录栈，深度优先，找到的文件立即通过回调交出
+ */
+
+#ifndef DIRECTORYWALKER_H
+#define DIRECTORYWALKER_H
+
+#include <QAtomicInt>
+#include <QMutex>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QWaitCondition>
+#include <functional>
+#include <memory>
+#include "core/parser/ignorerules.h"
+
+/**
+ * @brief 目录遍历配置
+ */
+struct WalkerOptions
+{
+    QStringList fileExtensions;      ///< 要列出的文件扩展名（为空时列出所有文件）
+    QStringList excludeDirectories;  ///< 要排除的目录名，含 / 时按相对于根目录的路径匹配
+    bool recursive = true;           ///< 是否递归进入子目录
+    bool respectGitignore = true;    ///< 是否遵循 .gitignore
+    int threadCount = 0;             ///< 遍历线程数（0表示使用CPU核心数）
+};
+
+/**
+ * @brief 并行目录遍历器类
+ */
+class DirectoryWalker
+{
+   public:
+    /**
+     * @brief 文件回调，会在多个遍历线程中并发调用
+     * @param filePath 文件绝对路径
+     * @return 是否继续遍历
+     */
+    using FileCallback = std::function<bool(const QString& filePath)>;
+
+    /**
+     * @brief 目录回调，每进入一个目录（含根目录）调用一次，会在多个遍历线程中并发调用
+     * @param dirPath 目录绝对路径
+     */
+    using DirectoryCallback = std::function<void(const QString& dirPath)>;
+
+    /**
+     * @brief 构造函数
+     * @param options 遍历配置
+     */
+    explicit DirectoryWalker(const WalkerOptions& options);
+
+    DirectoryWalker(const DirectoryWalker&) = delete;
+    DirectoryWalker& operator=(const DirectoryWalker&) = delete;
+
+    /**
+     * @brief 设置目录回调
+     * @param callback 目录回调（为空时不回调）
+     */
+    void setDirectoryCallback(DirectoryCallback callback) { m_onDirectory = std::move(callback); }
+
+    /**
+     * @brief 遍历目录，阻塞直到完成、被取消或回调返回false
+     * @param rootPath 根目录
+     * @param onFile 文件回调
+     * @return 是否完整遍历（被取消或回调要求停止时返回false）
+     */
+    bool walk(const QString& rootPath, const FileCallback& onFile);
+
+    /**
+     * @brief 遍历目录并返回排序后的文件列表
+     * @param rootPath 根目录
+     * @return 文件绝对路径列表
+     */
+    QStringList collect(const QString& rootPath);
+
+    /**
+     * @brief 取消正在进行的遍历（可在任意线程调用）
+     */
+    void cancel();
+
+    /**
+     * @brief 获取上次遍历访问的目录数
+     * @return 目录数
+     */
+    int directoriesVisited() const { return m_directoriesVisited.loadRelaxed(); }
+
+    /**
+     * @brief 获取上次遍历剪除的目录数（排除或被 .gitignore 忽略）
+     * @return 目录数
+     */
+    int directoriesPruned() const { return m_directoriesPruned.loadRelaxed(); }
+
+   private:
+    /**
+     * @brief 待遍历的目录
+     */
+    struct DirTask
+    {
+        QString path;                              ///< 目录绝对路径
+        QString relativePath;                      ///< 相对于根目录的路径（根目录为空）
+        std::shared_ptr<const IgnoreRules> rules;  ///< 上级目录适用的忽略规则
+    };
+
+    /**
+     * @brief 遍历线程主循环
+     * @param onFile 文件回调
+     */
+    void workerLoop(const FileCallback& onFile);
+
+    /**
+     * @brief 列出一个目录，文件交给回调，子目录放入输出列表
+     * @param task 目录
+     * @param onFile 文件回调
+     * @param subdirs 输出参数，需要继续遍历的子目录
+     */
+    void visitDirectory(const DirTask& task, const FileCallback& onFile, QVector<DirTask>& subdirs);
+
+    /**
+     * @brief 检查目录是否被排除
+     * @param name 目录名
+     * @param relativePath 相对于根目录的路径
+     * @return 是否被排除
+     */
+    bool isExcluded(const QString& name, const QString& relativePath) const;
+
+    /**
+     * @brief 停止遍历并唤醒所有等待的线程
+     */
+    void stop();
+
+    WalkerOptions m_options;          ///< 遍历配置
+    DirectoryCallback m_onDirectory;  ///< 目录回调
+    QSet<QString> m_extensions;       ///< 允许的扩展名（小写）
+    QSet<QString> m_excludeNames;     ///< 排除的目录名
+    QStringList m_excludePaths;       ///< 排除的相对路径
+    QMutex m_mutex;                   ///< 保护目录栈的互斥锁
+    QWaitCondition m_hasWork;         ///< 目录栈非空或遍历结束条件
+    QVector<DirTask> m_stack;         ///< 待遍历的目录栈
+    int m_pending;                    ///< 在栈中或正在遍历的目录数
+    QAtomicInt m_stopped;             ///< 是否已停止
+    QAtomicInt m_directoriesVisited;  ///< 访问的目录数
+    QAtomicInt m_directoriesPruned;   ///< 剪除的目录数
+};
+
+#endif  // DIRECTORYWALKER_H
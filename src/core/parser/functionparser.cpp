@@ -12,7 +12,9 @@
 #include <QList>
 #include <QPair>
 #include <QRegularExpressionMatchIterator>
+#include <QStringView>
 #include <QTextStream>
+#include <algorithm>
 #include "common/logger/logger.h"
 
 FunctionParser& FunctionParser::instance()
@@ -21,7 +23,7 @@ FunctionParser& FunctionParser::instance()
     return instance;
 }
 
-FunctionParser::FunctionParser(QObject* parent) : QObject(parent)
+FunctionParser::FunctionParser(QObject* parent) : QObject(parent), m_progressThrottle(new ProgressThrottle(20, this))
 {
     initializeParsers();
 
@@ -143,6 +145,7 @@ ExtractionResult FunctionParser::parseCpp(const QString& code)
     QRegularExpression funcPattern(
         R"((?:^|\n)\s*(?:template\s*<[^>]*>\s*)?(?:static\s+|virtual\s+|inline\s+|explicit\s+|friend\s+)*([\w:<>,]+(?:\s*[*&]+)?)\s+(\w+)\s*\(([^)]*)\)\s*(?:const\s*)?(?:override\s*)?(?:final\s*)?(?:noexcept\s*)?(?:->\s*[\w:<>,*&]+\s*)?\{)");
 
+    QVector<int> lineStarts = buildLineIndex(code);
     QRegularExpressionMatchIterator it = funcPattern.globalMatch(code);
     int matchCount = 0;
 
@@ -158,16 +161,21 @@ ExtractionResult FunctionParser::parseCpp(const QString& code)
         func.signature = func.returnType + " " + func.name + "(" + paramsStr + ")";
         func.parameters = parseParameters(paramsStr);
 
-        int bodyStart = match.capturedEnd();
+        int declStart = declarationStart(code, match.capturedStart());
+        int bodyStart = match.capturedEnd() - 1;
         func.body = extractFunctionBody(code, bodyStart);
-        func.startLine = getLineNumber(code, match.capturedStart()) + 1;
-        func.endLine = func.startLine + func.body.count('\n');
+        func.startLine = getLineNumber(lineStarts, declStart) + 1;
+        func.endLine = func.startLine + QStringView(code).mid(declStart, bodyStart - declStart).count('\n') +
+                       func.body.count('\n');
         func.language = "cpp";
 
         result.functions.append(func);
         matchCount++;
 
-        emit extractionProgress(matchCount, 0, QString("已找到函数: %1").arg(func.name));
+        if (m_progressThrottle->tryAcquire())
+        {
+            emit extractionProgress(matchCount, 0, QString("已找到函数: %1").arg(func.name));
+        }
     }
 
     result.success = !result.functions.isEmpty();
@@ -184,6 +192,7 @@ ExtractionResult FunctionParser::parsePython(const QString& code)
 
     QRegularExpression funcPattern(R"((?:^|\n)\s*def\s+(\w+)\s*\(([^)]*)\)\s*(?:->\s*([\w\[\],\s]+))?\s*:)");
 
+    QVector<int> lineStarts = buildLineIndex(code);
     QRegularExpressionMatchIterator it = funcPattern.globalMatch(code);
     int matchCount = 0;
 
@@ -203,16 +212,21 @@ ExtractionResult FunctionParser::parsePython(const QString& code)
         func.signature = "def " + func.name + "(" + paramsStr + ")";
         func.parameters = parseParameters(paramsStr);
 
+        int declStart = declarationStart(code, match.capturedStart());
         int bodyStart = match.capturedEnd();
-        func.body = extractFunctionBody(code, bodyStart);
-        func.startLine = getLineNumber(code, match.capturedStart()) + 1;
-        func.endLine = func.startLine + func.body.count('\n');
+        func.body = extractIndentedBody(code, declStart, bodyStart);
+        func.startLine = getLineNumber(lineStarts, declStart) + 1;
+        func.endLine = func.startLine + QStringView(code).mid(declStart, bodyStart - declStart).count('\n') +
+                       func.body.count('\n');
         func.language = "python";
 
         result.functions.append(func);
         matchCount++;
 
-        emit extractionProgress(matchCount, 0, QString("已找到函数: %1").arg(func.name));
+        if (m_progressThrottle->tryAcquire())
+        {
+            emit extractionProgress(matchCount, 0, QString("已找到函数: %1").arg(func.name));
+        }
     }
 
     result.success = !result.functions.isEmpty();
@@ -230,6 +244,7 @@ ExtractionResult FunctionParser::parseJava(const QString& code)
     QRegularExpression funcPattern(
         R"((?:^|\n)\s*(?:public\s+|protected\s+|private\s+|static\s+|final\s+|abstract\s+|synchronized\s+|native\s+|strictfp\s+)*([\w<>,.?\[\]]+(?:\s*\[*\]*))\s+(\w+)\s*\(([^)]*)\)\s*(?:throws\s+[\w\s,<>.]+)?\s*\{)");
 
+    QVector<int> lineStarts = buildLineIndex(code);
     QRegularExpressionMatchIterator it = funcPattern.globalMatch(code);
     int matchCount = 0;
 
@@ -245,16 +260,21 @@ ExtractionResult FunctionParser::parseJava(const QString& code)
         func.signature = func.returnType + " " + func.name + "(" + paramsStr + ")";
         func.parameters = parseParameters(paramsStr);
 
-        int bodyStart = match.capturedEnd();
+        int declStart = declarationStart(code, match.capturedStart());
+        int bodyStart = match.capturedEnd() - 1;
         func.body = extractFunctionBody(code, bodyStart);
-        func.startLine = getLineNumber(code, match.capturedStart()) + 1;
-        func.endLine = func.startLine + func.body.count('\n');
+        func.startLine = getLineNumber(lineStarts, declStart) + 1;
+        func.endLine = func.startLine + QStringView(code).mid(declStart, bodyStart - declStart).count('\n') +
+                       func.body.count('\n');
         func.language = "java";
 
         result.functions.append(func);
         matchCount++;
 
-        emit extractionProgress(matchCount, 0, QString("已找到函数: %1").arg(func.name));
+        if (m_progressThrottle->tryAcquire())
+        {
+            emit extractionProgress(matchCount, 0, QString("已找到函数: %1").arg(func.name));
+        }
     }
 
     result.success = !result.functions.isEmpty();
@@ -301,6 +321,7 @@ ExtractionResult FunctionParser::parseJavaScript(const QString& code)
                          return func;
                      }});
 
+    QVector<int> lineStarts = buildLineIndex(code);
     int matchCount = 0;
     for (const auto& patternPair : patterns)
     {
@@ -314,16 +335,21 @@ ExtractionResult FunctionParser::parseJavaScript(const QString& code)
             QString paramsStr = match.captured(2);
             func.parameters = parseParameters(paramsStr);
 
-            int bodyStart = match.capturedEnd();
+            int declStart = declarationStart(code, match.capturedStart());
+            int bodyStart = match.capturedEnd() - 1;
             func.body = extractFunctionBody(code, bodyStart);
-            func.startLine = getLineNumber(code, match.capturedStart()) + 1;
-            func.endLine = func.startLine + func.body.count('\n');
+            func.startLine = getLineNumber(lineStarts, declStart) + 1;
+            func.endLine = func.startLine + QStringView(code).mid(declStart, bodyStart - declStart).count('\n') +
+                           func.body.count('\n');
             func.language = "javascript";
 
             result.functions.append(func);
             matchCount++;
 
-            emit extractionProgress(matchCount, 0, QString("已找到函数: %1").arg(func.name));
+            if (m_progressThrottle->tryAcquire())
+            {
+                emit extractionProgress(matchCount, 0, QString("已找到函数: %1").arg(func.name));
+            }
         }
     }
 
@@ -356,6 +382,30 @@ QString FunctionParser::extractFunctionBody(const QString& code, int startPos) c
     {
         QChar c = code[i];
 
+        if (c == '/' && i + 1 < code.length() && code[i + 1] == '/')
+        {
+            int lineEnd = code.indexOf('\n', i);
+            i = lineEnd < 0 ? code.length() : lineEnd;
+            continue;
+        }
+        if (c == '/' && i + 1 < code.length() && code[i + 1] == '*')
+        {
+            int commentEnd = code.indexOf("*/", i + 2);
+            i = commentEnd < 0 ? code.length() : commentEnd + 2;
+            continue;
+        }
+        if (c == '"' || c == '\'' || c == '`')
+        {
+            // 跳过字符串字面量，避免其中的括号影响配对
+            int j = i + 1;
+            while (j < code.length() && code[j] != c && code[j] != '\n')
+            {
+                j += (code[j] == '\\') ? 2 : 1;
+            }
+            i = j + 1;
+            continue;
+        }
+
         if (c == '{')
         {
             braceBalance++;
@@ -372,7 +422,55 @@ QString FunctionParser::extractFunctionBody(const QString& code, int startPos) c
         i++;
     }
 
-    return code.mid(startPos, i - startPos + 1);
+    return code.mid(startPos, qMin(i, code.length() - 1) - startPos + 1);
+}
+
+QString FunctionParser::extractIndentedBody(const QString& code, int declStart, int bodyStart) const
+{
+    int lineStart = code.lastIndexOf('\n', declStart > 0 ? declStart - 1 : 0) + 1;
+    int declIndent = declStart - lineStart;
+
+    int end = bodyStart;
+    int pos = code.indexOf('\n', bodyStart);
+    while (pos >= 0 && pos < code.length())
+    {
+        int next = pos + 1;
+        int indent = 0;
+        while (next + indent < code.length() && (code[next + indent] == ' ' || code[next + indent] == '\t'))
+        {
+            indent++;
+        }
+
+        int lineEnd = code.indexOf('\n', next);
+        bool blankLine = next + indent >= code.length() || code[next + indent] == '\n' || code[next + indent] == '\r';
+        if (!blankLine && indent <= declIndent)
+        {
+            break;
+        }
+        if (!blankLine)
+        {
+            end = lineEnd < 0 ? code.length() : lineEnd;
+        }
+        pos = lineEnd;
+    }
+
+    if (end == bodyStart)
+    {
+        int lineEnd = code.indexOf('\n', bodyStart);
+        end = lineEnd < 0 ? code.length() : lineEnd;
+    }
+
+    return code.mid(bodyStart, end - bodyStart);
+}
+
+int FunctionParser::declarationStart(const QString& code, int matchStart) const
+{
+    int pos = matchStart;
+    while (pos < code.length() && code[pos].isSpace())
+    {
+        pos++;
+    }
+    return pos;
 }
 
 QVector<ParameterInfo> FunctionParser::parseParameters(const QString& paramsStr) const
@@ -460,9 +558,23 @@ int FunctionParser::countLines(const QString& code) const
     return code.count('\n') + 1;
 }
 
-int FunctionParser::getLineNumber(const QString& code, int pos) const
+QVector<int> FunctionParser::buildLineIndex(const QString& code) const
+{
+    QVector<int> lineStarts;
+    lineStarts.append(0);
+    for (int i = 0; i < code.length(); i++)
+    {
+        if (code[i] == '\n')
+        {
+            lineStarts.append(i + 1);
+        }
+    }
+    return lineStarts;
+}
+
+int FunctionParser::getLineNumber(const QVector<int>& lineStarts, int pos) const
 {
     if (pos <= 0)
         return 0;
-    return code.left(pos).count('\n');
+    return int(std::upper_bound(lineStarts.begin(), lineStarts.end(), pos) - lineStarts.begin()) - 1;
 }
@@ -14,6 +14,7 @@
 #include <QRegularExpression>
 #include <QString>
 #include <functional>
+#include "common/utils/progressthrottle.h"
 #include "core/models/extractedfunction.h"
 
 /**
@@ -67,7 +68,7 @@ class FunctionParser : public QObject
 
    signals:
     /**
-     * @brief 提取进度信号
+     * @brief 提取进度信号（限速为每秒最多20次，不保证每个文件的最终计数都会发出，准确结果以返回值为准）
      * @param current 当前进度
      * @param total 总数
      * @param message 进度消息
@@ -130,11 +131,28 @@ class FunctionParser : public QObject
     /**
      * @brief 提取函数体（平衡括号匹配）
      * @param code 完整代码
-     * @param startPos 函数体起始位置
-     * @return 函数体代码
+     * @param startPos 函数体起始位置（左花括号所在位置）
+     * @return 函数体代码（包含花括号）
      */
     QString extractFunctionBody(const QString& code, int startPos) const;
 
+    /**
+     * @brief 提取缩进式函数体（Python）
+     * @param code 完整代码
+     * @param declStart 函数声明起始位置
+     * @param bodyStart 函数体起始位置（冒号之后）
+     * @return 函数体代码
+     */
+    QString extractIndentedBody(const QString& code, int declStart, int bodyStart) const;
+
+    /**
+     * @brief 获取匹配结果中声明的实际起始位置（跳过前导空白和换行）
+     * @param code 完整代码
+     * @param matchStart 正则匹配起始位置
+     * @return 声明起始位置
+     */
+    int declarationStart(const QString& code, int matchStart) const;
+
     /**
      * @brief 解析参数列表
      * @param paramsStr 参数字符串
@@ -150,15 +168,23 @@ class FunctionParser : public QObject
     int countLines(const QString& code) const;
 
     /**
-     * @brief 获取位置对应的行号
+     * @brief 构建行首位置索引
      * @param code 代码文本
+     * @return 每一行起始字符位置的有序列表
+     */
+    QVector<int> buildLineIndex(const QString& code) const;
+
+    /**
+     * @brief 获取位置对应的行号
+     * @param lineStarts 行首位置索引
      * @param pos 字符位置
-     * @return 行号（从1开始）
+     * @return 行号（从0开始）
      */
-    int getLineNumber(const QString& code, int pos) const;
+    int getLineNumber(const QVector<int>& lineStarts, int pos) const;
 
     QMap<QString, std::function<ExtractionResult(const QString&)>> m_parsers;  ///< 语言解析器映射
     QMap<QString, QStringList> m_languageExtensions;                           ///< 语言扩展名映射
+    ProgressThrottle* m_progressThrottle;                                      ///< 提取进度节流器
 };
 
 #endif  // FUNCTIONPARSER_H
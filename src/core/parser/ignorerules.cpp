@@ -0,0 +1,264 @@
+/**
+ * @file ignorerules.cpp
+ * @brief .gitignore 规则的解析与匹配实现
+ * @author Developer
+ * @date 2026-10-18
+ * @version 1.0
+ */
+
+#include "core/parser/ignorerules.h"
+#include <QFile>
+
+namespace
+{
+const QString kIgnoreFileName = ".gitignore";  ///< 忽略规则文件名
+
+/**
+ * @brief 检查文本中是否含有通配符
+ * @param text 文本
+ * @return 是否含有通配符
+ */
+bool hasWildcard(const QString& text)
+{
+    for (QChar c : text)
+    {
+        if (c == '*' || c == '?' || c == '[' || c == '\\')
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief 将glob转换为正则表达式（不含首尾锚点）
+ * @param glob glob文本
+ * @return 正则表达式文本
+ */
+QString globToRegex(const QString& glob)
+{
+    QString rx;
+    const int n = glob.size();
+    for (int i = 0; i < n; ++i)
+    {
+        QChar c = glob[i];
+        if (c == '*')
+        {
+            if (i + 1 < n && glob[i + 1] == '*')
+            {
+                bool atSegmentStart = (i == 0 || glob[i - 1] == '/');
+                bool slashAfter = (i + 2 < n && glob[i + 2] == '/');
+                if (atSegmentStart && slashAfter)
+                {
+                    // "**/" 匹配零个或多个目录
+                    rx += "(?:.*/)?";
+                    i += 2;
+                }
+                else
+                {
+                    rx += ".*";
+                    i += 1;
+                }
+            }
+            else
+            {
+                rx += "[^/]*";
+            }
+        }
+        else if (c == '?')
+        {
+            rx += "[^/]";
+        }
+        else if (c == '[')
+        {
+            int j = i + 1;
+            if (j < n && (glob[j] == '!' || glob[j] == '^'))
+            {
+                ++j;
+            }
+            if (j < n && glob[j] == ']')
+            {
+                ++j;
+            }
+            while (j < n && glob[j] != ']')
+            {
+                ++j;
+            }
+
+            if (j >= n)
+            {
+                rx += "\\[";
+            }
+            else
+            {
+                QString cls = glob.mid(i + 1, j - i - 1);
+                if (cls.startsWith('!'))
+                {
+                    cls[0] = '^';
+                }
+                rx += '[' + cls + ']';
+                i = j;
+            }
+        }
+        else if (c == '\\' && i + 1 < n)
+        {
+            rx += QRegularExpression::escape(QString(glob[++i]));
+        }
+        else
+        {
+            rx += QRegularExpression::escape(QString(c));
+        }
+    }
+    return rx;
+}
+}  // namespace
+
+IgnoreRules::IgnoreRules(std::shared_ptr<const IgnoreRules> parent, const QString& basePrefix,
+                         const QStringList& lines)
+    : m_parent(std::move(parent)), m_basePrefix(basePrefix)
+{
+    for (const QString& line : lines)
+    {
+        IgnorePattern pattern;
+        if (compile(line, pattern))
+        {
+            m_patterns.append(pattern);
+        }
+    }
+}
+
+std::shared_ptr<const IgnoreRules> IgnoreRules::forDirectory(const std::shared_ptr<const IgnoreRules>& parent,
+                                                            const QString& dirPath, const QString& relativePath)
+{
+    QFile file(dirPath + "/" + kIgnoreFileName);
+    if (!file.exists() || !file.open(QIODevice::ReadOnly | QIODevice::Text))
+    {
+        return parent;
+    }
+
+    QStringList lines = QString::fromUtf8(file.readAll()).split('\n');
+    QString basePrefix = relativePath.isEmpty() ? QString() : relativePath + "/";
+    auto rules = std::make_shared<const IgnoreRules>(parent, basePrefix, lines);
+    if (rules->patternCount() == 0)
+    {
+        return parent;
+    }
+    return rules;
+}
+
+bool IgnoreRules::compile(const QString& line, IgnorePattern& pattern)
+{
+    QString text = line;
+    while (!text.isEmpty() && text.back().isSpace())
+    {
+        text.chop(1);
+    }
+    if (text.isEmpty() || text.startsWith('#'))
+    {
+        return false;
+    }
+
+    pattern = IgnorePattern();
+    if (text.startsWith('!'))
+    {
+        pattern.negated = true;
+        text = text.mid(1);
+    }
+    else if (text.startsWith("\\!") || text.startsWith("\\#"))
+    {
+        text = text.mid(1);
+    }
+
+    if (text.endsWith('/'))
+    {
+        pattern.directoryOnly = true;
+        text.chop(1);
+    }
+    if (text.isEmpty())
+    {
+        return false;
+    }
+
+    // 开头或中间有 / 时相对于规则所在目录锚定；"**/name" 等价于不锚定的 "name"
+    if (text.startsWith("**/") && !text.mid(3).contains('/'))
+    {
+        text = text.mid(3);
+    }
+    else if (text.contains('/'))
+    {
+        pattern.anchored = true;
+        if (text.startsWith('/'))
+        {
+            text = text.mid(1);
+        }
+    }
+
+    if (!hasWildcard(text))
+    {
+        pattern.kind = IgnorePattern::Kind::Name;
+        pattern.text = text;
+    }
+    else if (!pattern.anchored && text.startsWith('*') && !hasWildcard(text.mid(1)))
+    {
+        pattern.kind = IgnorePattern::Kind::Suffix;
+        pattern.text = text.mid(1);
+    }
+    else
+    {
+        pattern.kind = IgnorePattern::Kind::Regex;
+        pattern.regex = QRegularExpression("^" + globToRegex(text) + "$");
+        if (!pattern.regex.isValid())
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool IgnoreRules::isIgnored(const QString& relativePath, const QString& name, bool isDir) const
+{
+    for (const IgnoreRules* node = this; node; node = node->m_parent.get())
+    {
+        bool ignored = false;
+        if (node->matchLocal(relativePath.mid(node->m_basePrefix.size()), name, isDir, ignored))
+        {
+            return ignored;
+        }
+    }
+    return false;
+}
+
+bool IgnoreRules::matchLocal(const QString& localPath, const QString& name, bool isDir, bool& ignored) const
+{
+    // 同一文件中后面的规则优先
+    for (int i = m_patterns.size() - 1; i >= 0; --i)
+    {
+        const IgnorePattern& pattern = m_patterns[i];
+        if (pattern.directoryOnly && !isDir)
+        {
+            continue;
+        }
+
+        const QString& subject = pattern.anchored ? localPath : name;
+        bool hit = false;
+        switch (pattern.kind)
+        {
+            case IgnorePattern::Kind::Name:
+                hit = (subject == pattern.text);
+                break;
+            case IgnorePattern::Kind::Suffix:
+                hit = subject.endsWith(pattern.text);
+                break;
+            case IgnorePattern::Kind::Regex:
+                hit = pattern.regex.match(subject).hasMatch();
+                break;
+        }
+
+        if (hit)
+        {
+            ignored = !pattern.negated;
+            return true;
+        }
+    }
+    return false;
+}
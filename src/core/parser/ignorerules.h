@@ -0,0 +1,113 @@
+/**
+ * @file ignorerules.h
+ * @brief .gitignore 规则的解析与匹配
+ * @author Developer
+ * @date 2026-10-18
+ * @version 1.0
+ *
+ * @details 每个 .gitignore 编译为一个规则节点，子目录的节点指向父目录的节点：
+ * - 匹配时从最近的节点开始，节点内最后一条命中的规则生效，未命中时交给上一级节点
+ * - 以 ! 开头的规则取消忽略，以 / 结尾的规则只匹配目录
+ * - 规则中含 / 时相对于 .gitignore 所在目录锚定，否则匹配任意层级的名称
+ * 简单规则（如 *.o、build）编译为后缀或名称比较，其余编译为正则表达式。
+ * 不支持的语法：转义的行尾空格；工作目录以外的上级 .gitignore 和 .git/info/exclude 不会被读取。
+ */
+
+#ifndef IGNORERULES_H
+#define IGNORERULES_H
+
+#include <QRegularExpression>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <memory>
+
+/**
+ * @brief 编译后的单条忽略规则
+ */
+struct IgnorePattern
+{
+    /**
+     * @brief 匹配方式
+     */
+    enum class Kind
+    {
+        Name,    ///< 名称完全相等
+        Suffix,  ///< 名称以指定后缀结尾（*.ext）
+        Regex    ///< 正则表达式
+    };
+
+    Kind kind;                 ///< 匹配方式
+    QString text;              ///< 名称或后缀（Name、Suffix方式）
+    QRegularExpression regex;  ///< 正则表达式（Regex方式）
+    bool anchored;             ///< 是否相对于规则所在目录锚定（否则只匹配名称）
+    bool negated;              ///< 是否为取消忽略的规则
+    bool directoryOnly;        ///< 是否只匹配目录
+
+    IgnorePattern() : kind(Kind::Name), anchored(false), negated(false), directoryOnly(false) {}
+};
+
+/**
+ * @brief 一个目录的忽略规则节点
+ */
+class IgnoreRules
+{
+   public:
+    /**
+     * @brief 构造函数
+     * @param parent 上级目录的规则节点（可为空）
+     * @param basePrefix 规则所在目录相对于遍历根目录的路径前缀（根目录为空，否则以 / 结尾）
+     * @param lines .gitignore 的内容行
+     */
+    IgnoreRules(std::shared_ptr<const IgnoreRules> parent, const QString& basePrefix, const QStringList& lines);
+
+    /**
+     * @brief 获取目录适用的规则节点，目录中有 .gitignore 时创建新节点，否则沿用上级节点
+     * @param parent 上级目录的规则节点（可为空）
+     * @param dirPath 目录绝对路径
+     * @param relativePath 目录相对于遍历根目录的路径（根目录为空）
+     * @return 规则节点（没有任何规则时为空）
+     */
+    static std::shared_ptr<const IgnoreRules> forDirectory(const std::shared_ptr<const IgnoreRules>& parent,
+                                                           const QString& dirPath, const QString& relativePath);
+
+    /**
+     * @brief 编译单条规则
+     * @param line 规则文本
+     * @param pattern 输出参数，编译后的规则
+     * @return 是否为有效规则（空行和注释返回false）
+     */
+    static bool compile(const QString& line, IgnorePattern& pattern);
+
+    /**
+     * @brief 检查路径是否被忽略
+     * @param relativePath 相对于遍历根目录的路径
+     * @param name 文件或目录名
+     * @param isDir 是否为目录
+     * @return 是否被忽略
+     */
+    bool isIgnored(const QString& relativePath, const QString& name, bool isDir) const;
+
+    /**
+     * @brief 获取本节点的规则数
+     * @return 规则数
+     */
+    int patternCount() const { return m_patterns.size(); }
+
+   private:
+    /**
+     * @brief 在本节点内匹配
+     * @param localPath 相对于规则所在目录的路径
+     * @param name 文件或目录名
+     * @param isDir 是否为目录
+     * @param ignored 输出参数，命中时是否忽略
+     * @return 是否有规则命中
+     */
+    bool matchLocal(const QString& localPath, const QString& name, bool isDir, bool& ignored) const;
+
+    std::shared_ptr<const IgnoreRules> m_parent;  ///< 上级目录的规则节点
+    QString m_basePrefix;                         ///< 规则所在目录的路径前缀
+    QVector<IgnorePattern> m_patterns;            ///< 编译后的规则（按文件中的顺序）
+};
+
+#endif  // IGNORERULES_H
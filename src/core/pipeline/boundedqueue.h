@@ -0,0 +1,162 @@
+/**
+ * @file boundedqueue.h
+ * @brief 有界阻塞队列，用于流水线阶段之间传递数据并提供背压
+ * @author Developer
+ * @date 2026-10-18
+ * @version 1.0
+ *
+ * @details 队列满时生产者阻塞，队列空时消费者阻塞：
+ * - close()：生产者全部结束后调用，消费者取完剩余数据后pop()返回false
+ * - abort()：取消时调用，丢弃剩余数据并唤醒所有等待的线程
+ */
+
+#ifndef BOUNDEDQUEUE_H
+#define BOUNDEDQUEUE_H
+
+#include <QMutex>
+#include <QQueue>
+#include <QWaitCondition>
+
+/**
+ * @brief 有界阻塞队列模板类
+ * @tparam T 元素类型
+ */
+template <typename T>
+class BoundedQueue
+{
+   public:
+    /**
+     * @brief 构造函数
+     * @param capacity 队列容量（至少为1）
+     */
+    explicit BoundedQueue(int capacity) : m_capacity(qMax(1, capacity)), m_closed(false), m_aborted(false), m_peak(0)
+    {
+    }
+
+    BoundedQueue(const BoundedQueue&) = delete;
+    BoundedQueue& operator=(const BoundedQueue&) = delete;
+
+    /**
+     * @brief 放入元素，队列满时阻塞
+     * @param item 元素
+     * @return 是否成功（队列已关闭或已中止时返回false）
+     */
+    bool push(const T& item)
+    {
+        QMutexLocker locker(&m_mutex);
+        while (m_queue.size() >= m_capacity && !m_closed && !m_aborted)
+        {
+            m_notFull.wait(&m_mutex);
+        }
+        if (m_closed || m_aborted)
+        {
+            return false;
+        }
+
+        m_queue.enqueue(item);
+        m_peak = qMax(m_peak, static_cast<int>(m_queue.size()));
+        m_notEmpty.wakeOne();
+        return true;
+    }
+
+    /**
+     * @brief 取出元素，队列空时阻塞
+     * @param item 输出参数，取出的元素
+     * @return 是否取到元素（队列已关闭且为空，或已中止时返回false）
+     */
+    bool pop(T& item)
+    {
+        QMutexLocker locker(&m_mutex);
+        while (m_queue.isEmpty() && !m_closed && !m_aborted)
+        {
+            m_notEmpty.wait(&m_mutex);
+        }
+        if (m_aborted || m_queue.isEmpty())
+        {
+            return false;
+        }
+
+        item = m_queue.dequeue();
+        m_notFull.wakeOne();
+        return true;
+    }
+
+    /**
+     * @brief 不阻塞地取出元素
+     * @param item 输出参数，取出的元素
+     * @return 是否取到元素
+     */
+    bool tryPop(T& item)
+    {
+        QMutexLocker locker(&m_mutex);
+        if (m_aborted || m_queue.isEmpty())
+        {
+            return false;
+        }
+
+        item = m_queue.dequeue();
+        m_notFull.wakeOne();
+        return true;
+    }
+
+    /**
+     * @brief 关闭队列，不再接受新元素，已有元素仍可取出
+     */
+    void close()
+    {
+        QMutexLocker locker(&m_mutex);
+        m_closed = true;
+        m_notEmpty.wakeAll();
+        m_notFull.wakeAll();
+    }
+
+    /**
+     * @brief 中止队列，丢弃剩余元素并唤醒所有等待的线程
+     */
+    void abort()
+    {
+        QMutexLocker locker(&m_mutex);
+        m_aborted = true;
+        m_queue.clear();
+        m_notEmpty.wakeAll();
+        m_notFull.wakeAll();
+    }
+
+    /**
+     * @brief 获取当前元素数
+     * @return 元素数
+     */
+    int size() const
+    {
+        QMutexLocker locker(&m_mutex);
+        return m_queue.size();
+    }
+
+    /**
+     * @brief 获取队列容量
+     * @return 容量
+     */
+    int capacity() const { return m_capacity; }
+
+    /**
+     * @brief 获取运行以来的最大元素数
+     * @return 最大元素数
+     */
+    int peak() const
+    {
+        QMutexLocker locker(&m_mutex);
+        return m_peak;
+    }
+
+   private:
+    mutable QMutex m_mutex;     ///< 互斥锁
+    QWaitCondition m_notEmpty;  ///< 队列非空条件
+    QWaitCondition m_notFull;   ///< 队列未满条件
+    QQueue<T> m_queue;          ///< 元素队列
+    const int m_capacity;       ///< 队列容量
+    bool m_closed;              ///< 是否已关闭
+    bool m_aborted;             ///< 是否已中止
+    int m_peak;                 ///< 最大元素数
+};
+
+#endif  // BOUNDEDQUEUE_H
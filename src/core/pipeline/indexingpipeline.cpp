@@ -0,0 +1,608 @@
+/**
+ * @file indexingpipeline.cpp
+ * @brief 分阶段索引流水线实现
+ * @author Developer
+ * @date 2026-10-18
+ * @version 1.0
+ */
+
+#include "core/pipeline/indexingpipeline.h"
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMutexLocker>
+#include <QThread>
+#include "common/logger/logger.h"
+#include "core/ai/aiservicemanager.h"
+#include "core/parser/functionparser.h"
+
+namespace
+{
+const int kMetricsIntervalMs = 1000;  ///< 指标更新间隔（毫秒）
+const int kWaitSliceMs = 100;         ///< 工作线程等待主线程时检查取消标志的间隔（毫秒）
+
+/**
+ * @brief 将本地提取的参数列表转换为JSON字符串
+ * @param parameters 参数列表
+ * @return JSON字符串
+ */
+QString parametersToJson(const QVector<ParameterInfo>& parameters)
+{
+    QJsonArray array;
+    for (const ParameterInfo& param : parameters)
+    {
+        QJsonObject obj;
+        obj["name"] = param.name;
+        obj["type"] = param.type;
+        if (!param.defaultValue.isEmpty())
+        {
+            obj["default"] = param.defaultValue;
+        }
+        array.append(obj);
+    }
+    return QString::fromUtf8(QJsonDocument(array).toJson(QJsonDocument::Compact));
+}
+}  // namespace
+
+IndexingPipeline::IndexingPipeline(IDatabaseManager* dbManager, QObject* parent)
+    : QObject(parent),
+      m_dbManager(dbManager),
+      m_metricsTimer(new QTimer(this)),
+      m_running(false),
+      m_cancelled(0),
+      m_projectId(-1),
+      m_walker(nullptr),
+      m_requestSeq(0),
+      m_skipped(0),
+      m_stored(0)
+{
+    m_config.fileExtensions = {"cpp", "h", "hpp", "cc", "cxx", "py", "java", "js", "ts"};
+    m_config.excludeDirectories = {".git", "node_modules", "build", "dist", "__pycache__"};
+
+    m_metricsTimer->setInterval(kMetricsIntervalMs);
+    connect(m_metricsTimer, &QTimer::timeout, this, [this]() { emit metricsUpdated(metrics()); });
+
+    connect(&AIServiceManager::instance(), &AIServiceManager::functionAnalysisComplete, this,
+            &IndexingPipeline::onAnalysisComplete);
+}
+
+IndexingPipeline::~IndexingPipeline()
+{
+    m_cancelled.storeRelaxed(1);
+    shutdown();
+}
+
+void IndexingPipeline::setConfig(const PipelineConfig& config)
+{
+    if (m_running)
+    {
+        Logger::instance().warning("索引流水线正在运行，配置未生效");
+        return;
+    }
+    m_config = config;
+}
+
+bool IndexingPipeline::start(const QStringList& rootPaths)
+{
+    if (m_running)
+    {
+        Logger::instance().warning("索引流水线正在运行");
+        return false;
+    }
+    if (!m_dbManager)
+    {
+        Logger::instance().error("索引流水线缺少数据库管理器");
+        return false;
+    }
+    if (rootPaths.isEmpty())
+    {
+        return false;
+    }
+
+    shutdown();
+
+    m_running = true;
+    m_cancelled.storeRelaxed(0);
+    m_skipped.storeRelaxed(0);
+    m_stored.storeRelaxed(0);
+    m_storedFunctions.clear();
+
+    m_projectId = m_config.projectId;
+    if (m_projectId <= 0)
+    {
+        m_projectId = m_dbManager->getOrCreateTemporaryProject().id;
+    }
+
+    // 单例在首次调用的线程中创建，必须先在主线程创建，工作线程中发出的信号才会排队到主线程
+    FunctionParser::instance();
+    AIServiceManager::instance().setMaxConcurrentRequests(m_config.analyzeWorkers);
+    AIServiceManager::instance().beginRun();
+
+    int extractWorkers = m_config.extractWorkers > 0 ? m_config.extractWorkers : QThread::idealThreadCount();
+    int capacity = qMax(1, m_config.queueCapacity);
+
+    for (int i = 0; i < 5; ++i)
+    {
+        m_queues.append(new BoundedQueue<PipelineItem>(i == 0 ? qMax(capacity, rootPaths.size()) : capacity));
+    }
+
+    using namespace std::placeholders;
+    m_stages.append(new PipelineStage("scan", 1, 1, m_queues[0], m_queues[1],
+                                      std::bind(&IndexingPipeline::scanBatch, this, _1, _2)));
+    m_stages.append(new PipelineStage("read", m_config.readWorkers, 1, m_queues[1], m_queues[2],
+                                      std::bind(&IndexingPipeline::readBatch, this, _1, _2)));
+    m_stages.append(new PipelineStage("extract", extractWorkers, 1, m_queues[2], m_queues[3],
+                                      std::bind(&IndexingPipeline::extractBatch, this, _1, _2)));
+    m_stages.append(new PipelineStage("analyze", m_config.analyzeWorkers, 1, m_queues[3], m_queues[4],
+                                      std::bind(&IndexingPipeline::analyzeBatch, this, _1, _2)));
+    m_stages.append(new PipelineStage("persist", 1, m_config.persistBatchSize, m_queues[4], nullptr,
+                                      std::bind(&IndexingPipeline::persistBatch, this, _1, _2)));
+
+    for (const QString& rootPath : rootPaths)
+    {
+        PipelineItem item;
+        item.filePath = rootPath;
+        m_queues[0]->push(item);
+    }
+    m_queues[0]->close();
+
+    Logger::instance().info(QString("索引流水线开始 - 读取: %1, 提取: %2, 分析: %3, 队列容量: %4")
+                                .arg(m_config.readWorkers)
+                                .arg(extractWorkers)
+                                .arg(m_config.analyzeWorkers)
+                                .arg(capacity));
+
+    m_clock.start();
+    for (int i = 0; i < m_stages.size() - 1; ++i)
+    {
+        m_stages[i]->start(nullptr);
+    }
+    m_stages.last()->start(
+        [this]() { QMetaObject::invokeMethod(this, "onStagesFinished", Qt::QueuedConnection); });
+    m_metricsTimer->start();
+
+    return true;
+}
+
+void IndexingPipeline::cancel()
+{
+    if (!m_running)
+    {
+        return;
+    }
+
+    m_cancelled.storeRelaxed(1);
+    for (BoundedQueue<PipelineItem>* queue : m_queues)
+    {
+        queue->abort();
+    }
+
+    {
+        QMutexLocker locker(&m_waitersMutex);
+        for (const auto& waiter : m_waiters)
+        {
+            waiter->done.release();
+        }
+        m_waiters.clear();
+    }
+    {
+        QMutexLocker locker(&m_walkerMutex);
+        if (m_walker)
+        {
+            m_walker->cancel();
+        }
+    }
+    AIServiceManager::instance().cancelAllRequests();
+
+    Logger::instance().info("已取消索引流水线");
+}
+
+QVector<StageMetrics> IndexingPipeline::metrics() const
+{
+    QVector<StageMetrics> result;
+    qint64 elapsed = m_clock.isValid() ? m_clock.elapsed() : 0;
+    for (const PipelineStage* stage : m_stages)
+    {
+        result.append(stage->metrics(elapsed));
+    }
+    return result;
+}
+
+void IndexingPipeline::onAnalysisComplete(const AIAnalysisResponse& response)
+{
+    std::shared_ptr<AnalysisWaiter> waiter;
+    {
+        QMutexLocker locker(&m_waitersMutex);
+        waiter = m_waiters.take(response.requestId);
+    }
+    if (!waiter)
+    {
+        return;
+    }
+
+    waiter->response = response;
+    waiter->done.release();
+}
+
+void IndexingPipeline::onStagesFinished()
+{
+    if (!m_running)
+    {
+        return;
+    }
+
+    m_metricsTimer->stop();
+
+    PipelineSummary summary;
+    summary.elapsedMs = m_clock.elapsed();
+    summary.stages = metrics();
+    shutdown();
+
+    summary.cancelled = m_cancelled.loadRelaxed() != 0;
+    summary.filesScanned = static_cast<int>(summary.stages[0].emitted);
+    summary.functionsExtracted = static_cast<int>(summary.stages[2].emitted);
+    summary.storedCount = m_stored.loadRelaxed();
+    summary.skippedCount = m_skipped.loadRelaxed();
+    for (const StageMetrics& stage : summary.stages)
+    {
+        summary.failedCount += static_cast<int>(stage.failed);
+    }
+    summary.storedFunctions = m_storedFunctions;
+    m_storedFunctions.clear();
+    m_running = false;
+
+    Logger::instance().info(QString("索引流水线结束 - 文件: %1, 函数: %2, 保存: %3, 跳过: %4, 失败: %5, 耗时: %6ms")
+                                .arg(summary.filesScanned)
+                                .arg(summary.functionsExtracted)
+                                .arg(summary.storedCount)
+                                .arg(summary.skippedCount)
+                                .arg(summary.failedCount)
+                                .arg(summary.elapsedMs));
+    logMetrics(summary.stages);
+
+    emit metricsUpdated(summary.stages);
+    emit finished(summary);
+}
+
+int IndexingPipeline::scanBatch(QVector<PipelineItem>& batch, const StageEmitter& emitItem)
+{
+    WalkerOptions options;
+    options.fileExtensions = m_config.fileExtensions;
+    options.excludeDirectories = m_config.excludeDirectories;
+    options.recursive = m_config.recursive;
+    options.respectGitignore = m_config.respectGitignore;
+    options.threadCount = m_config.scanThreads;
+
+    int failed = 0;
+    for (const PipelineItem& root : batch)
+    {
+        QFileInfo rootInfo(root.filePath);
+        if (rootInfo.isFile())
+        {
+            PipelineItem item;
+            item.filePath = rootInfo.absoluteFilePath();
+            if (!emitItem(item))
+            {
+                return failed;
+            }
+            continue;
+        }
+
+        // 遍历器找到一个文件就立即交给读取阶段，下游队列满时遍历线程随之阻塞
+        DirectoryWalker walker(options);
+        {
+            QMutexLocker locker(&m_walkerMutex);
+            m_walker = &walker;
+        }
+        bool exists = rootInfo.isDir();
+        if (exists && !m_cancelled.loadRelaxed())
+        {
+            walker.walk(root.filePath,
+                        [&emitItem](const QString& filePath)
+                        {
+                            PipelineItem item;
+                            item.filePath = filePath;
+                            return emitItem(item);
+                        });
+        }
+        {
+            QMutexLocker locker(&m_walkerMutex);
+            m_walker = nullptr;
+        }
+
+        if (!exists)
+        {
+            Logger::instance().warning("文件夹不存在: " + root.filePath);
+            failed++;
+            continue;
+        }
+        Logger::instance().info(QString("扫描完成: %1, 访问目录: %2, 剪除目录: %3")
+                                    .arg(root.filePath)
+                                    .arg(walker.directoriesVisited())
+                                    .arg(walker.directoriesPruned()));
+    }
+    return failed;
+}
+
+int IndexingPipeline::readBatch(QVector<PipelineItem>& batch, const StageEmitter& emitItem)
+{
+    int failed = 0;
+    for (PipelineItem& item : batch)
+    {
+        item.language = FunctionParser::instance().detectLanguage(item.filePath);
+        if (!FunctionParser::instance().isLanguageSupported(item.language))
+        {
+            // 本地解析器不支持的语言不进入流水线，计入跳过数，避免汇总中少算未索引的文件
+            m_skipped.fetchAndAddRelaxed(1);
+            continue;
+        }
+
+        QFile file(item.filePath);
+        if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+        {
+            Logger::instance().warning("无法读取文件: " + item.filePath);
+            failed++;
+            continue;
+        }
+
+        item.content = QString::fromUtf8(file.readAll());
+        if (!emitItem(item))
+        {
+            return failed;
+        }
+    }
+    return failed;
+}
+
+int IndexingPipeline::extractBatch(QVector<PipelineItem>& batch, const StageEmitter& emitItem)
+{
+    for (const PipelineItem& item : batch)
+    {
+        ExtractionResult result = FunctionParser::instance().extractFromCode(item.content, item.language);
+        for (ExtractedFunction func : result.functions)
+        {
+            func.filePath = item.filePath;
+            func.language = item.language;
+
+            PipelineItem out;
+            out.filePath = item.filePath;
+            out.language = item.language;
+            out.function = func;
+            if (!emitItem(out))
+            {
+                return 0;
+            }
+        }
+    }
+    return 0;
+}
+
+int IndexingPipeline::analyzeBatch(QVector<PipelineItem>& batch, const StageEmitter& emitItem)
+{
+    int failed = 0;
+    for (PipelineItem& item : batch)
+    {
+        const ExtractedFunction& func = item.function;
+
+        if (m_config.skipExisting)
+        {
+            IDatabaseManager* db = m_dbManager;
+            QString key = func.name;
+            auto exists = std::make_shared<bool>(false);
+            if (!runOnOwnerThread([db, key, exists]() { *exists = db->functionExists(key); }))
+            {
+                return failed;
+            }
+            if (*exists)
+            {
+                m_skipped.fetchAndAddRelaxed(1);
+                continue;
+            }
+        }
+
+        FunctionData& data = item.data;
+        data.projectId = m_projectId;
+        data.key = func.name;
+        data.signature = func.signature;
+        data.returnType = func.returnType;
+        data.parameters = parametersToJson(func.parameters);
+        data.filePath = relativePath(func.filePath);
+        data.startLine = func.startLine;
+        data.endLine = func.endLine;
+        data.language = func.language;
+
+        if (m_config.analyzeWithAI)
+        {
+            QString requestId = QString("pipeline-%1").arg(m_requestSeq.fetchAndAddRelaxed(1) + 1);
+            auto waiter = std::make_shared<AnalysisWaiter>();
+            {
+                QMutexLocker locker(&m_waitersMutex);
+                m_waiters.insert(requestId, waiter);
+            }
+
+            QMetaObject::invokeMethod(
+                &AIServiceManager::instance(),
+                [func, requestId]() { AIServiceManager::instance().analyzeFunction(func, requestId); },
+                Qt::QueuedConnection);
+
+            while (!waiter->done.tryAcquire(1, kWaitSliceMs))
+            {
+                if (m_cancelled.loadRelaxed())
+                {
+                    QMutexLocker locker(&m_waitersMutex);
+                    m_waiters.remove(requestId);
+                    return failed;
+                }
+            }
+
+            const AIAnalysisResponse& response = waiter->response;
+            if (!response.success)
+            {
+                if (!m_cancelled.loadRelaxed())
+                {
+                    Logger::instance().warning(QString("函数分析失败: %1 - %2").arg(func.name, response.errorMessage));
+                    failed++;
+                }
+                continue;
+            }
+
+            data.value = response.functionDescription;
+            if (!response.signature.isEmpty())
+            {
+                data.signature = response.signature;
+            }
+            if (!response.returnType.isEmpty())
+            {
+                data.returnType = response.returnType;
+            }
+            if (!response.parameters.isEmpty())
+            {
+                data.parameters = response.parameters;
+            }
+            data.flowchart = response.flowchart;
+            data.sequenceDiagram = response.sequenceDiagram;
+            data.structureDiagram = response.structureDiagram;
+            data.aiModel = response.aiModel;
+            data.analyzeTime = response.analyzeTime;
+        }
+
+        item.function.body.clear();
+        if (!emitItem(item))
+        {
+            return failed;
+        }
+    }
+    return failed;
+}
+
+int IndexingPipeline::persistBatch(QVector<PipelineItem>& batch, const StageEmitter& emitItem)
+{
+    Q_UNUSED(emitItem);
+
+    QVector<FunctionData> functions;
+    functions.reserve(batch.size());
+    for (const PipelineItem& item : batch)
+    {
+        FunctionData data = item.data;
+        data.createTime = QDateTime::currentDateTime();
+        functions.append(data);
+    }
+
+    // addFunctionsBatch在一个事务中写入整批函数，比逐条提交少很多次磁盘同步
+    IDatabaseManager* db = m_dbManager;
+    auto savedCount = std::make_shared<int>(0);
+    bool done = runOnOwnerThread(
+        [this, db, functions, savedCount]()
+        {
+            *savedCount = db->addFunctionsBatch(functions);
+            m_stored.fetchAndAddRelaxed(*savedCount);
+            if (*savedCount == functions.size())
+            {
+                if (!m_config.streamResults)
+                {
+                    m_storedFunctions.append(functions);
+                }
+                emit functionsStored(functions);
+            }
+            else
+            {
+                Logger::instance().warning(QString("批量保存函数部分失败: %1/%2").arg(*savedCount).arg(functions.size()));
+            }
+        });
+
+    return done ? functions.size() - *savedCount : 0;
+}
+
+bool IndexingPipeline::runOnOwnerThread(std::function<void()> fn)
+{
+    auto done = std::make_shared<QSemaphore>(0);
+    QMetaObject::invokeMethod(
+        this,
+        [fn, done]()
+        {
+            fn();
+            done->release();
+        },
+        Qt::QueuedConnection);
+
+    // 不使用BlockingQueuedConnection：取消时主线程可能正在等待工作线程退出，阻塞调用会死锁
+    while (!done->tryAcquire(1, kWaitSliceMs))
+    {
+        if (m_cancelled.loadRelaxed())
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+QString IndexingPipeline::relativePath(const QString& filePath) const
+{
+    QString relative = filePath;
+    if (!m_config.projectRootPath.isEmpty() && filePath.startsWith(m_config.projectRootPath))
+    {
+        relative = filePath.mid(m_config.projectRootPath.length());
+        if (relative.startsWith("/"))
+        {
+            relative = relative.mid(1);
+        }
+    }
+    return relative;
+}
+
+void IndexingPipeline::shutdown()
+{
+    for (BoundedQueue<PipelineItem>* queue : m_queues)
+    {
+        queue->abort();
+    }
+
+    {
+        QMutexLocker locker(&m_waitersMutex);
+        for (const auto& waiter : m_waiters)
+        {
+            waiter->done.release();
+        }
+        m_waiters.clear();
+    }
+
+    qDeleteAll(m_stages);
+    m_stages.clear();
+    qDeleteAll(m_queues);
+    m_queues.clear();
+}
+
+void IndexingPipeline::logMetrics(const QVector<StageMetrics>& stages) const
+{
+    const StageMetrics* bottleneck = nullptr;
+    for (const StageMetrics& stage : stages)
+    {
+        Logger::instance().info(
+            QString("  阶段 %1 - 线程: %2, 处理: %3, 输出: %4, 失败: %5, 利用率: %6%, 等待输入: %7ms, "
+                    "等待下游: %8ms, 队列峰值: %9/%10")
+                .arg(stage.name)
+                .arg(stage.workers)
+                .arg(stage.processed)
+                .arg(stage.emitted)
+                .arg(stage.failed)
+                .arg(stage.utilization * 100.0, 0, 'f', 1)
+                .arg(stage.starvedMs)
+                .arg(stage.blockedMs)
+                .arg(stage.queuePeak)
+                .arg(stage.queueCapacity));
+
+        if (!bottleneck || stage.utilization > bottleneck->utilization)
+        {
+            bottleneck = &stage;
+        }
+    }
+
+    if (bottleneck)
+    {
+        Logger::instance().info(QString("瓶颈阶段: %1（利用率 %2%），可增加该阶段的工作线程数")
+                                    .arg(bottleneck->name)
+                                    .arg(bottleneck->utilization * 100.0, 0, 'f', 1));
+    }
+}
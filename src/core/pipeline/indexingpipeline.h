@@ -0,0 +1,271 @@
+/**
+ * @file indexingpipeline.h
+ * @brief 分阶段的索引流水线：扫描、读取、提取、分析、保存
+ * @author Developer
+ * @date 2026-10-18
+ * @version 1.0
+ *
+ * @details 各阶段有独立的工作线程数，阶段之间用有界队列连接：
+ * - scan：并行遍历目录（剪除排除目录、遵循 .gitignore），找到文件立即输出
+ * - read：读取文件内容（IO密集）
+ * - extract：用FunctionParser提取函数（CPU密集）
+ * - analyze：调用AIServiceManager分析函数（网络等待）
+ * - persist：按批写入数据库
+ * 下游处理不过来时队列被填满，上游自动阻塞，内存占用受队列容量限制。
+ * AIServiceManager和数据库连接都属于主线程，工作线程通过排队调用交给主线程执行并等待结果，
+ * 因此主线程的事件循环必须保持运行。
+ */
+
+#ifndef INDEXINGPIPELINE_H
+#define INDEXINGPIPELINE_H
+
+#include <QAtomicInt>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QMutex>
+#include <QObject>
+#include <QSemaphore>
+#include <QStringList>
+#include <QTimer>
+#include <QVector>
+#include <functional>
+#include <memory>
+#include "core/interfaces/idatabaserepository.h"
+#include "core/models/batchconfig.h"
+#include "core/parser/directorywalker.h"
+#include "core/pipeline/pipelinestage.h"
+
+/**
+ * @brief 索引流水线配置
+ */
+struct PipelineConfig
+{
+    int readWorkers = 2;             ///< 读取阶段工作线程数
+    int extractWorkers = 0;          ///< 提取阶段工作线程数（0表示使用CPU核心数）
+    int analyzeWorkers = 4;          ///< 分析阶段工作线程数，即同时在途的AI请求数
+    int persistBatchSize = 50;       ///< 每次写入数据库的最大函数数
+    int queueCapacity = 256;         ///< 阶段之间队列的容量
+    int scanThreads = 0;             ///< 扫描阶段的目录遍历线程数（0表示使用CPU核心数）
+    bool recursive = true;           ///< 是否递归扫描子文件夹
+    bool respectGitignore = true;    ///< 扫描时是否遵循 .gitignore
+    bool skipExisting = true;        ///< 是否跳过已存在的函数
+    bool analyzeWithAI = true;       ///< 是否调用AI分析（关闭时只保存本地提取的签名信息）
+    bool streamResults = false;      ///< 是否只通过 functionsStored 信号交出保存的函数（结果中不累积）
+    int projectId = -1;              ///< 目标项目ID（不大于0时使用临时项目）
+    QString projectRootPath;         ///< 项目根路径（用于计算相对路径）
+    QStringList fileExtensions;      ///< 要处理的文件扩展名
+    QStringList excludeDirectories;  ///< 要排除的目录名
+};
+
+/**
+ * @brief 索引流水线运行结果
+ */
+struct PipelineSummary
+{
+    bool cancelled;                         ///< 是否被取消
+    int filesScanned;                       ///< 扫描到的文件数
+    int functionsExtracted;                 ///< 提取的函数数
+    int storedCount;                        ///< 保存的函数数
+    int skippedCount;                       ///< 跳过数（已存在的函数和语言不受支持的文件）
+    int failedCount;                        ///< 失败数（读取、分析或保存失败）
+    qint64 elapsedMs;                       ///< 运行时间（毫秒）
+    QVector<FunctionData> storedFunctions;  ///< 已保存的函数（流式结果模式下为空）
+    QVector<StageMetrics> stages;           ///< 各阶段的最终指标
+
+    PipelineSummary()
+        : cancelled(false),
+          filesScanned(0),
+          functionsExtracted(0),
+          storedCount(0),
+          skippedCount(0),
+          failedCount(0),
+          elapsedMs(0)
+    {
+    }
+};
+
+/**
+ * @brief 索引流水线类
+ */
+class IndexingPipeline : public QObject
+{
+    Q_OBJECT
+
+   public:
+    /**
+     * @brief 构造函数
+     * @param dbManager 数据库管理器接口（依赖注入）
+     * @param parent 父对象
+     */
+    explicit IndexingPipeline(IDatabaseManager* dbManager, QObject* parent = nullptr);
+
+    /**
+     * @brief 析构函数，取消并等待所有工作线程退出
+     */
+    ~IndexingPipeline();
+
+    IndexingPipeline(const IndexingPipeline&) = delete;
+    IndexingPipeline& operator=(const IndexingPipeline&) = delete;
+
+    /**
+     * @brief 设置流水线配置（运行中设置无效）
+     * @param config 流水线配置
+     */
+    void setConfig(const PipelineConfig& config);
+
+    /**
+     * @brief 获取流水线配置
+     * @return 流水线配置
+     */
+    PipelineConfig config() const { return m_config; }
+
+    /**
+     * @brief 开始索引，必须在主线程调用
+     * @param rootPaths 要扫描的根目录或文件
+     * @return 是否成功开始
+     */
+    bool start(const QStringList& rootPaths);
+
+    /**
+     * @brief 取消索引，已在途的AI请求结果会被丢弃
+     */
+    void cancel();
+
+    /**
+     * @brief 检查是否正在运行
+     * @return 是否正在运行
+     */
+    bool isRunning() const { return m_running; }
+
+    /**
+     * @brief 获取各阶段当前指标
+     * @return 指标列表（按阶段顺序）
+     */
+    QVector<StageMetrics> metrics() const;
+
+   signals:
+    /**
+     * @brief 指标更新信号（每秒一次）
+     * @param stages 各阶段指标
+     */
+    void metricsUpdated(const QVector<StageMetrics>& stages);
+
+    /**
+     * @brief 一批函数保存完成信号
+     * @param functions 已保存的函数
+     */
+    void functionsStored(const QVector<FunctionData>& functions);
+
+    /**
+     * @brief 索引结束信号（完成或取消）
+     * @param summary 运行结果
+     */
+    void finished(const PipelineSummary& summary);
+
+   private slots:
+    /**
+     * @brief 单个函数分析完成槽函数，唤醒等待该请求的工作线程
+     * @param response 分析响应
+     */
+    void onAnalysisComplete(const AIAnalysisResponse& response);
+
+    /**
+     * @brief 全部阶段结束后的收尾
+     */
+    void onStagesFinished();
+
+   private:
+    /**
+     * @brief 单个AI请求的等待状态
+     */
+    struct AnalysisWaiter
+    {
+        QSemaphore done;              ///< 收到响应时释放
+        AIAnalysisResponse response;  ///< 分析响应
+    };
+
+    /**
+     * @brief 扫描阶段处理函数，输入为根目录，输出为文件路径
+     * @param batch 输入项
+     * @param emitItem 输出函数
+     * @return 失败数
+     */
+    int scanBatch(QVector<PipelineItem>& batch, const StageEmitter& emitItem);
+
+    /**
+     * @brief 读取阶段处理函数，输出带文件内容的数据项
+     * @param batch 输入项
+     * @param emitItem 输出函数
+     * @return 失败数
+     */
+    int readBatch(QVector<PipelineItem>& batch, const StageEmitter& emitItem);
+
+    /**
+     * @brief 提取阶段处理函数，每个函数输出一个数据项
+     * @param batch 输入项
+     * @param emitItem 输出函数
+     * @return 失败数
+     */
+    int extractBatch(QVector<PipelineItem>& batch, const StageEmitter& emitItem);
+
+    /**
+     * @brief 分析阶段处理函数，输出待保存的函数数据
+     * @param batch 输入项
+     * @param emitItem 输出函数
+     * @return 失败数
+     */
+    int analyzeBatch(QVector<PipelineItem>& batch, const StageEmitter& emitItem);
+
+    /**
+     * @brief 保存阶段处理函数，整批写入数据库
+     * @param batch 输入项
+     * @param emitItem 输出函数
+     * @return 失败数
+     */
+    int persistBatch(QVector<PipelineItem>& batch, const StageEmitter& emitItem);
+
+    /**
+     * @brief 在主线程执行函数并等待完成
+     * @param fn 要执行的函数，只能捕获值或共享指针（取消时工作线程不再等待）
+     * @return 是否执行完成（取消时返回false）
+     */
+    bool runOnOwnerThread(std::function<void()> fn);
+
+    /**
+     * @brief 计算相对于项目根路径的文件路径
+     * @param filePath 文件绝对路径
+     * @return 相对路径
+     */
+    QString relativePath(const QString& filePath) const;
+
+    /**
+     * @brief 中止所有队列并等待工作线程退出
+     */
+    void shutdown();
+
+    /**
+     * @brief 输出各阶段指标和瓶颈阶段
+     * @param stages 各阶段指标
+     */
+    void logMetrics(const QVector<StageMetrics>& stages) const;
+
+    IDatabaseManager* m_dbManager;                              ///< 数据库管理器（依赖注入）
+    PipelineConfig m_config;                                    ///< 流水线配置
+    QVector<BoundedQueue<PipelineItem>*> m_queues;              ///< 各阶段的输入队列
+    QVector<PipelineStage*> m_stages;                           ///< 流水线阶段
+    QTimer* m_metricsTimer;                                     ///< 指标更新定时器
+    QElapsedTimer m_clock;                                      ///< 运行计时
+    bool m_running;                                             ///< 是否正在运行
+    QAtomicInt m_cancelled;                                     ///< 是否已取消
+    int m_projectId;                                            ///< 本次运行的目标项目ID
+    QMutex m_walkerMutex;                                       ///< 保护当前目录遍历器的互斥锁
+    DirectoryWalker* m_walker;                                  ///< 扫描阶段当前的目录遍历器（用于取消）
+    QMutex m_waitersMutex;                                      ///< 保护等待表的互斥锁
+    QHash<QString, std::shared_ptr<AnalysisWaiter>> m_waiters;  ///< 在途AI请求（请求ID -> 等待状态）
+    QAtomicInt m_requestSeq;                                    ///< 请求序号
+    QAtomicInt m_skipped;                                       ///< 跳过的函数和文件数
+    QAtomicInt m_stored;                                        ///< 保存的函数数
+    QVector<FunctionData> m_storedFunctions;                    ///< 已保存的函数
+};
+
+#endif  // INDEXINGPIPELINE_H
@@ -0,0 +1,147 @@
+/**
+ * @file pipelinestage.cpp
+ * @brief 索引流水线阶段实现
+ * @author Developer
+ * @date 2026-10-18
+ * @version 1.0
+ */
+
+#include "core/pipeline/pipelinestage.h"
+#include <QElapsedTimer>
+
+PipelineStage::PipelineStage(const QString& name, int workerCount, int batchSize, BoundedQueue<PipelineItem>* input,
+                             BoundedQueue<PipelineItem>* output, StageProcessor processor)
+    : m_name(name),
+      m_workerCount(qMax(1, workerCount)),
+      m_batchSize(qMax(1, batchSize)),
+      m_input(input),
+      m_output(output),
+      m_processor(std::move(processor)),
+      m_activeWorkers(0),
+      m_processed(0),
+      m_emitted(0),
+      m_failed(0),
+      m_busyMs(0),
+      m_starvedMs(0),
+      m_blockedMs(0)
+{
+}
+
+PipelineStage::~PipelineStage()
+{
+    wait();
+    qDeleteAll(m_threads);
+    m_threads.clear();
+}
+
+void PipelineStage::start(std::function<void()> onFinished)
+{
+    m_onFinished = std::move(onFinished);
+    m_activeWorkers.storeRelaxed(m_workerCount);
+
+    for (int i = 0; i < m_workerCount; ++i)
+    {
+        QThread* thread = QThread::create([this]() { workerLoop(); });
+        thread->setObjectName(QString("%1-%2").arg(m_name).arg(i + 1));
+        m_threads.append(thread);
+        thread->start();
+    }
+}
+
+void PipelineStage::wait()
+{
+    for (QThread* thread : m_threads)
+    {
+        thread->wait();
+    }
+}
+
+StageMetrics PipelineStage::metrics(qint64 elapsedMs) const
+{
+    StageMetrics metrics;
+    metrics.name = m_name;
+    metrics.workers = m_workerCount;
+    metrics.processed = m_processed.loadRelaxed();
+    metrics.emitted = m_emitted.loadRelaxed();
+    metrics.failed = m_failed.loadRelaxed();
+    metrics.busyMs = m_busyMs.loadRelaxed();
+    metrics.starvedMs = m_starvedMs.loadRelaxed();
+    metrics.blockedMs = m_blockedMs.loadRelaxed();
+    metrics.queueDepth = m_input->size();
+    metrics.queueCapacity = m_input->capacity();
+    metrics.queuePeak = m_input->peak();
+
+    if (elapsedMs > 0)
+    {
+        metrics.utilization = qMin(1.0, static_cast<double>(metrics.busyMs) / (m_workerCount * elapsedMs));
+    }
+    return metrics;
+}
+
+void PipelineStage::workerLoop()
+{
+    QElapsedTimer timer;
+
+    while (true)
+    {
+        timer.start();
+        PipelineItem first;
+        bool got = m_input->pop(first);
+        m_starvedMs.fetchAndAddRelaxed(timer.elapsed());
+        if (!got)
+        {
+            break;
+        }
+
+        // 只把已在队列中的数据凑成一批，不为凑满批次而等待
+        QVector<PipelineItem> batch;
+        batch.append(first);
+        PipelineItem next;
+        while (batch.size() < m_batchSize && m_input->tryPop(next))
+        {
+            batch.append(next);
+        }
+
+        // 等待下游队列的时间计入blocked，从处理时间中扣除；
+        // 处理函数可能在多个线程中同时输出（如扫描阶段的目录遍历），累加须是原子的
+        QAtomicInteger<qint64> blockedMs(0);
+        StageEmitter emitItem = [this, &blockedMs](const PipelineItem& item)
+        {
+            if (!m_output)
+            {
+                return true;
+            }
+
+            QElapsedTimer pushTimer;
+            pushTimer.start();
+            bool pushed = m_output->push(item);
+            blockedMs.fetchAndAddRelaxed(pushTimer.elapsed());
+            if (pushed)
+            {
+                m_emitted.fetchAndAddRelaxed(1);
+            }
+            return pushed;
+        };
+
+        timer.start();
+        int failed = m_processor(batch, emitItem);
+        qint64 elapsed = timer.elapsed();
+        qint64 batchBlockedMs = blockedMs.loadRelaxed();
+        m_busyMs.fetchAndAddRelaxed(qMax<qint64>(0, elapsed - batchBlockedMs));
+        m_blockedMs.fetchAndAddRelaxed(batchBlockedMs);
+        m_processed.fetchAndAddRelaxed(batch.size());
+        m_failed.fetchAndAddRelaxed(failed);
+    }
+
+    if (m_activeWorkers.fetchAndSubOrdered(1) == 1)
+    {
+        if (m_output)
+        {
+            m_output->close();
+        }
+        if (m_onFinished)
+        {
+            m_onFinished();
+        }
+    }
+}
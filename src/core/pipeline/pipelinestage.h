@@ -0,0 +1,165 @@
+/**
+ * @file pipelinestage.h
+ * @brief 索引流水线的单个阶段，多个工作线程从输入队列取数据、处理后放入输出队列
+ * @author Developer
+ * @date 2026-10-18
+ * @version 1.0
+ *
+ * @details 每个阶段记录三类耗时，用于定位瓶颈：
+ * - busy：处理函数的执行时间
+ * - starved：等待输入队列的时间（上游太慢）
+ * - blocked：等待输出队列的时间（下游太慢，即背压）
+ * 最后一个退出的工作线程关闭输出队列，下游取完剩余数据后随之结束。
+ */
+
+#ifndef PIPELINESTAGE_H
+#define PIPELINESTAGE_H
+
+#include <QAtomicInteger>
+#include <QString>
+#include <QThread>
+#include <QVector>
+#include <functional>
+#include "core/models/extractedfunction.h"
+#include "core/models/functiondata.h"
+#include "core/pipeline/boundedqueue.h"
+
+/**
+ * @brief 在流水线阶段之间传递的数据项
+ */
+struct PipelineItem
+{
+    QString filePath;            ///< 文件绝对路径（扫描阶段的输入为根目录）
+    QString content;             ///< 文件内容（读取阶段填充，提取后清空）
+    QString language;            ///< 语言类型
+    ExtractedFunction function;  ///< 提取的函数
+    FunctionData data;           ///< 待保存的函数数据
+};
+
+/**
+ * @brief 流水线阶段的运行指标
+ */
+struct StageMetrics
+{
+    QString name;        ///< 阶段名称
+    int workers;         ///< 工作线程数
+    qint64 processed;    ///< 已处理的输入项数
+    qint64 emitted;      ///< 已输出的数据项数
+    qint64 failed;       ///< 处理失败的输入项数
+    qint64 busyMs;       ///< 累计处理时间（毫秒，所有工作线程之和）
+    qint64 starvedMs;    ///< 累计等待输入时间（毫秒）
+    qint64 blockedMs;    ///< 累计等待输出队列时间（毫秒）
+    int queueDepth;      ///< 输入队列当前长度
+    int queueCapacity;   ///< 输入队列容量
+    int queuePeak;       ///< 输入队列最大长度
+    double utilization;  ///< 利用率（处理时间 / (工作线程数 × 运行时间)）
+
+    StageMetrics()
+        : workers(0),
+          processed(0),
+          emitted(0),
+          failed(0),
+          busyMs(0),
+          starvedMs(0),
+          blockedMs(0),
+          queueDepth(0),
+          queueCapacity(0),
+          queuePeak(0),
+          utilization(0.0)
+    {
+    }
+};
+
+/**
+ * @brief 阶段输出函数，把数据项放入下游队列，队列满时阻塞
+ *
+ * @details 可在多个线程中并发调用（如扫描阶段在目录遍历的各个线程中直接输出），
+ * 在处理函数返回前有效。
+ * @param item 数据项
+ * @return 是否成功（流水线被中止时返回false，处理函数应尽快返回）
+ */
+using StageEmitter = std::function<bool(const PipelineItem& item)>;
+
+/**
+ * @brief 阶段处理函数
+ * @param batch 本次取出的输入项
+ * @param emitItem 输出函数，产生一项就立即交给下游，不必等整批处理完
+ * @return 处理失败的输入项数
+ */
+using StageProcessor = std::function<int(QVector<PipelineItem>& batch, const StageEmitter& emitItem)>;
+
+/**
+ * @brief 流水线阶段类
+ */
+class PipelineStage
+{
+   public:
+    /**
+     * @brief 构造函数
+     * @param name 阶段名称
+     * @param workerCount 工作线程数（至少为1）
+     * @param batchSize 每次最多取出的输入项数（至少为1）
+     * @param input 输入队列
+     * @param output 输出队列（最后一个阶段为nullptr）
+     * @param processor 处理函数，会在多个工作线程中并发调用
+     */
+    PipelineStage(const QString& name, int workerCount, int batchSize, BoundedQueue<PipelineItem>* input,
+                  BoundedQueue<PipelineItem>* output, StageProcessor processor);
+
+    /**
+     * @brief 析构函数，等待所有工作线程退出
+     */
+    ~PipelineStage();
+
+    PipelineStage(const PipelineStage&) = delete;
+    PipelineStage& operator=(const PipelineStage&) = delete;
+
+    /**
+     * @brief 启动工作线程
+     * @param onFinished 所有工作线程退出后调用（在最后退出的工作线程中执行）
+     */
+    void start(std::function<void()> onFinished);
+
+    /**
+     * @brief 等待所有工作线程退出
+     */
+    void wait();
+
+    /**
+     * @brief 获取阶段名称
+     * @return 阶段名称
+     */
+    QString name() const { return m_name; }
+
+    /**
+     * @brief 获取运行指标
+     * @param elapsedMs 流水线已运行时间（毫秒），用于计算利用率
+     * @return 运行指标
+     */
+    StageMetrics metrics(qint64 elapsedMs) const;
+
+   private:
+    /**
+     * @brief 工作线程主循环
+     */
+    void workerLoop();
+
+    QString m_name;                        ///< 阶段名称
+    int m_workerCount;                     ///< 工作线程数
+    int m_batchSize;                       ///< 每次最多取出的输入项数
+    BoundedQueue<PipelineItem>* m_input;   ///< 输入队列
+    BoundedQueue<PipelineItem>* m_output;  ///< 输出队列
+    StageProcessor m_processor;            ///< 处理函数
+    std::function<void()> m_onFinished;    ///< 全部工作线程退出后的回调
+    QVector<QThread*> m_threads;           ///< 工作线程
+
+    QAtomicInt m_activeWorkers;          ///< 仍在运行的工作线程数
+    QAtomicInteger<qint64> m_processed;  ///< 已处理的输入项数
+    QAtomicInteger<qint64> m_emitted;    ///< 已输出的数据项数
+    QAtomicInteger<qint64> m_failed;     ///< 处理失败的输入项数
+    QAtomicInteger<qint64> m_busyMs;     ///< 累计处理时间（毫秒）
+    QAtomicInteger<qint64> m_starvedMs;  ///< 累计等待输入时间（毫秒）
+    QAtomicInteger<qint64> m_blockedMs;  ///< 累计等待输出队列时间（毫秒）
+};
+
+#endif  // PIPELINESTAGE_H
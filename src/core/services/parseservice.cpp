@@ -9,11 +9,18 @@
 #include "core/services/parseservice.h"
 #include <QDateTime>
 #include "common/logger/logger.h"
+#include "core/parser/directorywalker.h"
+#include "core/parser/functionparser.h"
 
 ParseService::ParseService(IDatabaseManager* dbManager, QObject* parent)
     : IParseService(parent),
       m_dbManager(dbManager),
       m_batchParser(new BatchCodeParser(dbManager, this)),
+      m_pipeline(new IndexingPipeline(dbManager, this)),
+      m_usePipeline(true),
+      m_folderRecursive(false),
+      m_hasPipelineResult(false),
+      m_streamResults(false),
       m_skipExisting(true),
       m_isParsing(false),
       m_isBatchMode(false),
@@ -27,10 +34,16 @@ ParseService::ParseService(IDatabaseManager* dbManager, QObject* parent)
 
     connect(m_batchParser, &BatchCodeParser::batchProgress, this, &ParseService::onBatchProgress);
     connect(m_batchParser, &BatchCodeParser::fileParsed, this, &ParseService::onFileParsed);
+    connect(m_batchParser, &BatchCodeParser::functionsSaved, this, &ParseService::onFunctionsSaved);
     connect(m_batchParser, &BatchCodeParser::batchComplete, this, &ParseService::onBatchComplete);
     connect(m_batchParser, &BatchCodeParser::batchFailed, this, &ParseService::onBatchFailed);
     connect(m_batchParser, &BatchCodeParser::batchCancelled, this, &ParseService::onBatchCancelled);
 
+    m_pipelineConfig = m_pipeline->config();
+    connect(m_pipeline, &IndexingPipeline::metricsUpdated, this, &ParseService::onPipelineMetrics);
+    connect(m_pipeline, &IndexingPipeline::functionsStored, this, &ParseService::onPipelineFunctionsStored);
+    connect(m_pipeline, &IndexingPipeline::finished, this, &ParseService::onPipelineFinished);
+
     Logger::instance().info("解析服务初始化完成");
 }
 
@@ -65,7 +78,43 @@ void ParseService::parseFolder(const QString& folderPath, bool recursive)
 
     Logger::instance().info(QString("开始批量解析文件夹: %1, 递归: %2").arg(folderPath).arg(recursive));
 
+    if (m_usePipeline)
+    {
+        // 本地解析器支持的语言走流水线，其余语言留到流水线结束后逐文件AI解析
+        PipelineConfig config = m_pipelineConfig;
+        QStringList supported;
+        splitExtensions(m_batchParser->fileExtensions(), supported, m_remainingExtensions);
+        config.fileExtensions = supported;
+        config.recursive = recursive;
+        config.skipExisting = m_skipExisting;
+        config.streamResults = m_streamResults;
+        config.projectId = m_targetProjectId;
+        config.projectRootPath = folderPath;
+        if (m_targetProjectId > 0)
+        {
+            ProjectInfo project = m_dbManager->getProjectById(m_targetProjectId);
+            if (project.id > 0)
+            {
+                config.projectRootPath = project.rootPath;
+            }
+        }
+
+        m_folderPath = folderPath;
+        m_folderRecursive = recursive;
+        m_hasPipelineResult = false;
+
+        m_pipeline->setConfig(config);
+        if (!m_pipeline->start({folderPath}))
+        {
+            m_isParsing = false;
+            m_isBatchMode = false;
+            emit parseFailed("索引流水线启动失败");
+        }
+        return;
+    }
+
     m_batchParser->setSkipExisting(m_skipExisting);
+    m_batchParser->setStreamResults(m_streamResults);
     m_batchParser->setTargetProject(m_targetProjectId);
 
     if (m_targetProjectId > 0)
@@ -102,6 +151,11 @@ void ParseService::cancelParsing()
     {
         m_batchParser->cancelParsing();
     }
+
+    if (m_pipeline->isRunning())
+    {
+        m_pipeline->cancel();
+    }
 }
 
 bool ParseService::isParsing() const
@@ -126,6 +180,23 @@ int ParseService::targetProject() const
     return m_targetProjectId;
 }
 
+void ParseService::setUsePipeline(bool enabled)
+{
+    m_usePipeline = enabled;
+    Logger::instance().info(QString("设置使用索引流水线: %1").arg(enabled ? "是" : "否"));
+}
+
+void ParseService::setPipelineConfig(const PipelineConfig& config)
+{
+    m_pipelineConfig = config;
+}
+
+void ParseService::setStreamResults(bool enabled)
+{
+    m_streamResults = enabled;
+    Logger::instance().info(QString("设置流式结果: %1").arg(enabled ? "是" : "否"));
+}
+
 void ParseService::onAIParseComplete(const AIParseResult& result)
 {
     if (m_isBatchMode)
@@ -217,9 +288,26 @@ void ParseService::onFileParsed(const QString& filePath, const AIParseResult& re
     Logger::instance().info(QString("文件解析完成: %1, 提取 %2 个函数").arg(filePath).arg(result.functions.size()));
 }
 
+void ParseService::onFunctionsSaved(const QVector<FunctionSummary>& functions)
+{
+    emit functionsPersisted(functions);
+}
+
 void ParseService::onBatchComplete(const BatchParseResult& result)
 {
     ParseResult parseResult = processBatchResult(result);
+    if (m_hasPipelineResult)
+    {
+        m_hasPipelineResult = false;
+        parseResult.success = parseResult.success && m_pipelineResult.success;
+        parseResult.successCount += m_pipelineResult.successCount;
+        parseResult.failedCount += m_pipelineResult.failedCount;
+        parseResult.skippedCount += m_pipelineResult.skippedCount;
+        parseResult.functionCount += m_pipelineResult.functionCount;
+        parseResult.functions = m_pipelineResult.functions + parseResult.functions;
+        m_pipelineResult = ParseResult();
+    }
+
     m_isParsing = false;
     m_isBatchMode = false;
     emit parseComplete(parseResult);
@@ -227,6 +315,8 @@ void ParseService::onBatchComplete(const BatchParseResult& result)
 
 void ParseService::onBatchFailed(const QString& error)
 {
+    m_hasPipelineResult = false;
+    m_pipelineResult = ParseResult();
     m_isParsing = false;
     m_isBatchMode = false;
     Logger::instance().error("批量解析失败: " + error);
@@ -235,12 +325,136 @@ void ParseService::onBatchFailed(const QString& error)
 
 void ParseService::onBatchCancelled()
 {
+    m_hasPipelineResult = false;
+    m_pipelineResult = ParseResult();
     m_isParsing = false;
     m_isBatchMode = false;
     Logger::instance().info("批量解析已取消");
     emit parseCancelled();
 }
 
+void ParseService::onPipelineMetrics(const QVector<StageMetrics>& stages)
+{
+    if (stages.size() < 5)
+    {
+        return;
+    }
+
+    // 以进入保存阶段的函数数作为进度，总数为已提取的函数数
+    ParseProgress progressInfo;
+    progressInfo.current = static_cast<int>(stages[4].processed);
+    progressInfo.total = static_cast<int>(stages[2].emitted);
+    progressInfo.failedCount = 0;
+    for (const StageMetrics& stage : stages)
+    {
+        progressInfo.failedCount += static_cast<int>(stage.failed);
+    }
+    progressInfo.stage = "索引";
+
+    QStringList parts;
+    for (const StageMetrics& stage : stages)
+    {
+        parts.append(QString("%1 %2%").arg(stage.name).arg(qRound(stage.utilization * 100.0)));
+    }
+    progressInfo.message = "阶段利用率: " + parts.join(", ");
+
+    emit parseProgress(progressInfo);
+}
+
+void ParseService::onPipelineFunctionsStored(const QVector<FunctionData>& functions)
+{
+    QVector<FunctionSummary> summaries;
+    summaries.reserve(functions.size());
+    for (const FunctionData& data : functions)
+    {
+        summaries.append(FunctionSummary(data));
+    }
+    emit functionsPersisted(summaries);
+}
+
+void ParseService::onPipelineFinished(const PipelineSummary& summary)
+{
+    if (summary.cancelled)
+    {
+        m_isParsing = false;
+        m_isBatchMode = false;
+        Logger::instance().info("批量解析已取消");
+        emit parseCancelled();
+        return;
+    }
+
+    ParseResult parseResult;
+    parseResult.success = (summary.failedCount == 0);
+    parseResult.successCount = summary.storedCount;
+    parseResult.failedCount = summary.failedCount;
+    parseResult.skippedCount = summary.skippedCount;
+    parseResult.functionCount = summary.storedCount;
+    parseResult.streamed = m_streamResults;
+    parseResult.functions = summary.storedFunctions;
+
+    m_pipelineResult = parseResult;
+    if (startRemainingFiles())
+    {
+        return;
+    }
+
+    m_pipelineResult = ParseResult();
+    m_isParsing = false;
+    m_isBatchMode = false;
+    emit parseComplete(parseResult);
+}
+
+void ParseService::splitExtensions(const QStringList& extensions, QStringList& supported, QStringList& unsupported)
+{
+    supported.clear();
+    unsupported.clear();
+
+    const FunctionParser& parser = FunctionParser::instance();
+    for (const QString& ext : extensions)
+    {
+        if (parser.isLanguageSupported(parser.detectLanguage("file." + ext)))
+        {
+            supported.append(ext);
+        }
+        else
+        {
+            unsupported.append(ext);
+        }
+    }
+}
+
+bool ParseService::startRemainingFiles()
+{
+    if (m_remainingExtensions.isEmpty())
+    {
+        return false;
+    }
+
+    WalkerOptions options;
+    options.fileExtensions = m_remainingExtensions;
+    options.excludeDirectories = m_pipelineConfig.excludeDirectories;
+    options.recursive = m_folderRecursive;
+    options.respectGitignore = m_pipelineConfig.respectGitignore;
+
+    DirectoryWalker walker(options);
+    QStringList files = walker.collect(m_folderPath);
+    if (files.isEmpty())
+    {
+        return false;
+    }
+
+    Logger::instance().info(QString("索引流水线完成，继续AI解析 %1 个其他语言文件").arg(files.size()));
+
+    m_batchParser->setSkipExisting(m_skipExisting);
+    m_batchParser->setStreamResults(m_streamResults);
+    m_batchParser->setTargetProject(m_targetProjectId);
+    m_batchParser->setProjectRootPath(m_pipeline->config().projectRootPath);
+
+    m_hasPipelineResult = true;
+    m_batchParser->parseFiles(files);
+    return true;
+}
+
 ParseResult ParseService::processSingleFileResult(const AIParseResult& result)
 {
     ParseResult parseResult;
@@ -316,6 +530,7 @@ ParseResult ParseService::processSingleFileResult(const AIParseResult& result)
     parseResult.successCount = successCount;
     parseResult.failedCount = failedCount;
     parseResult.skippedCount = skippedCount;
+    parseResult.functionCount = parseResult.functions.size();
 
     Logger::instance().info(
         QString("解析完成！成功: %1, 失败: %2, 跳过: %3").arg(successCount).arg(failedCount).arg(skippedCount));
@@ -330,6 +545,8 @@ ParseResult ParseService::processBatchResult(const BatchParseResult& result)
     parseResult.successCount = result.successCount;
     parseResult.failedCount = result.failedCount;
     parseResult.skippedCount = result.skippedCount;
+    parseResult.functionCount = result.savedFunctionCount;
+    parseResult.streamed = m_streamResults;
     parseResult.functions = result.allFunctions;
 
     if (!result.success)
@@ -342,7 +559,7 @@ ParseResult ParseService::processBatchResult(const BatchParseResult& result)
                                 .arg(result.successCount)
                                 .arg(result.failedCount)
                                 .arg(result.skippedCount)
-                                .arg(result.allFunctions.size()));
+                                .arg(result.savedFunctionCount));
 
     return parseResult;
 }
@@ -16,6 +16,7 @@
 #include "core/interfaces/iparseservice.h"
 #include "core/parser/aicodeparser.h"
 #include "core/parser/batchcodeparser.h"
+#include "core/pipeline/indexingpipeline.h"
 
 class ParseService : public IParseService
 {
@@ -67,6 +68,27 @@ class ParseService : public IParseService
      */
     int targetProject() const override;
 
+    /**
+     * @brief 设置文件夹解析是否使用分阶段索引流水线
+     * @details 启用时本地解析器支持的语言由流水线在工作线程中提取和分析，
+     *          其余语言的文件在流水线结束后仍逐文件交给AI解析，两部分的统计合并后一起报告
+     * @param enabled 是否启用（默认启用；关闭时所有文件都逐文件交给AI解析）
+     */
+    void setUsePipeline(bool enabled);
+
+    /**
+     * @brief 设置索引流水线配置（项目、跳过已存在等由解析服务填充）
+     * @param config 流水线配置
+     */
+    void setPipelineConfig(const PipelineConfig& config);
+
+    /**
+     * @brief 设置文件夹解析是否使用流式结果
+     * @param enabled 是否启用（启用后保存的函数只以摘要通过 functionsPersisted 信号逐批交出，
+     *                解析完成时的结果只含统计数据）
+     */
+    void setStreamResults(bool enabled);
+
    private slots:
     /**
      * @brief AI代码解析完成槽函数（单文件）
@@ -105,6 +127,12 @@ class ParseService : public IParseService
      */
     void onFileParsed(const QString& filePath, const AIParseResult& result);
 
+    /**
+     * @brief 批量解析保存函数槽函数
+     * @param functions 本文件保存的函数摘要
+     */
+    void onFunctionsSaved(const QVector<FunctionSummary>& functions);
+
     /**
      * @brief 批量解析完成槽函数
      * @param result 批量解析结果
@@ -122,6 +150,24 @@ class ParseService : public IParseService
      */
     void onBatchCancelled();
 
+    /**
+     * @brief 索引流水线指标更新槽函数
+     * @param stages 各阶段指标
+     */
+    void onPipelineMetrics(const QVector<StageMetrics>& stages);
+
+    /**
+     * @brief 索引流水线保存函数槽函数
+     * @param functions 本批保存的函数
+     */
+    void onPipelineFunctionsStored(const QVector<FunctionData>& functions);
+
+    /**
+     * @brief 索引流水线结束槽函数
+     * @param summary 运行结果
+     */
+    void onPipelineFinished(const PipelineSummary& summary);
+
    private:
     /**
      * @brief 处理单文件解析结果
@@ -137,13 +183,36 @@ class ParseService : public IParseService
      */
     ParseResult processBatchResult(const BatchParseResult& result);
 
-    IDatabaseManager* m_dbManager;   ///< 数据库管理器（依赖注入）
-    BatchCodeParser* m_batchParser;  ///< 批量解析器（依赖注入）
-    bool m_skipExisting;             ///< 是否跳过已存在的函数
-    bool m_isParsing;                ///< 是否正在解析
-    bool m_isBatchMode;              ///< 是否处于批量模式
-    QString m_currentFilePath;       ///< 当前解析的文件路径
-    int m_targetProjectId;           ///< 目标项目ID
+    /**
+     * @brief 把文件扩展名按本地解析器是否支持对应语言分为两组
+     * @param extensions 扩展名列表
+     * @param supported 输出参数，本地解析器支持的扩展名
+     * @param unsupported 输出参数，需要AI提取的扩展名
+     */
+    static void splitExtensions(const QStringList& extensions, QStringList& supported, QStringList& unsupported);
+
+    /**
+     * @brief 流水线结束后，逐文件AI解析其余语言的文件
+     * @return 是否启动了AI解析（没有其余语言的文件时返回false）
+     */
+    bool startRemainingFiles();
+
+    IDatabaseManager* m_dbManager;      ///< 数据库管理器（依赖注入）
+    BatchCodeParser* m_batchParser;     ///< 批量解析器（依赖注入）
+    IndexingPipeline* m_pipeline;       ///< 分阶段索引流水线
+    PipelineConfig m_pipelineConfig;    ///< 索引流水线配置
+    bool m_usePipeline;                 ///< 文件夹解析是否使用索引流水线
+    QStringList m_remainingExtensions;  ///< 流水线不处理、需逐文件AI解析的扩展名
+    QString m_folderPath;               ///< 当前解析的文件夹
+    bool m_folderRecursive;             ///< 当前文件夹解析是否递归
+    bool m_hasPipelineResult;           ///< 流水线已结束，正在AI解析其余语言的文件
+    ParseResult m_pipelineResult;       ///< 流水线部分的解析结果（与AI解析部分合并后报告）
+    bool m_streamResults;               ///< 文件夹解析是否使用流式结果
+    bool m_skipExisting;                ///< 是否跳过已存在的函数
+    bool m_isParsing;                   ///< 是否正在解析
+    bool m_isBatchMode;                 ///< 是否处于批量模式
+    QString m_currentFilePath;          ///< 当前解析的文件路径
+    int m_targetProjectId;              ///< 目标项目ID
 };
 
 #endif  // PARSESERVICE_H
@@ -0,0 +1,974 @@
+/**
+ * @file projectwatcher.cpp
+ * @brief 项目目录监视器实现
+ * @author Developer
+ * @date 2026-10-18
+ * @version 1.0
+ */
+
+#include "core/watcher/projectwatcher.h"
+#include <QDir>
+#include <QDirIterator>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QRegularExpression>
+#include <algorithm>
+#include "common/logger/logger.h"
+#include "core/ai/aiservicemanager.h"
+#include "core/ai/requestfingerprint.h"
+#include "core/parser/directorywalker.h"
+#include "core/parser/functionparser.h"
+
+namespace
+{
+const int kPollSliceDirs = 2000;  ///< 每次轮询最多重新列出的目录数，其余留到下一轮事件循环
+
+/**
+ * @brief 获取文件状态
+ * @param info 文件信息
+ * @return 修改时间和大小
+ */
+QPair<qint64, qint64> stampOf(const QFileInfo& info)
+{
+    return qMakePair(info.lastModified().toMSecsSinceEpoch(), info.size());
+}
+
+/**
+ * @brief 计算路径深度
+ * @param path 路径
+ * @return 路径中 / 的个数
+ */
+int depthOf(const QString& path)
+{
+    return path.count('/');
+}
+
+/**
+ * @brief 将本地提取的参数列表转换为JSON字符串
+ * @param parameters 参数列表
+ * @return JSON字符串
+ */
+QString parametersToJson(const QVector<ParameterInfo>& parameters)
+{
+    QJsonArray array;
+    for (const ParameterInfo& param : parameters)
+    {
+        QJsonObject obj;
+        obj["name"] = param.name;
+        obj["type"] = param.type;
+        if (!param.defaultValue.isEmpty())
+        {
+            obj["default"] = param.defaultValue;
+        }
+        array.append(obj);
+    }
+    return QString::fromUtf8(QJsonDocument(array).toJson(QJsonDocument::Compact));
+}
+}  // namespace
+
+ProjectWatcher::ProjectWatcher(IDatabaseManager* dbManager, QObject* parent)
+    : QObject(parent),
+      m_dbManager(dbManager),
+      m_watcher(new QFileSystemWatcher(this)),
+      m_debounceTimer(new QTimer(this)),
+      m_pollTimer(new QTimer(this)),
+      m_requestSeq(0)
+{
+    WatcherConfig config;
+    config.fileExtensions = {"cpp", "h", "hpp", "cc", "cxx", "py", "java", "js", "ts"};
+    config.excludeDirectories = {"node_modules", ".git",        ".svn",  "build",   "dist", "bin",
+                                 "obj",          "__pycache__", ".idea", ".vscode", "venv", "env"};
+    setConfig(config);
+
+    m_debounceTimer->setSingleShot(true);
+    connect(m_debounceTimer, &QTimer::timeout, this, &ProjectWatcher::onDebounceTimeout);
+    connect(m_pollTimer, &QTimer::timeout, this, &ProjectWatcher::onPollTimeout);
+
+    connect(m_watcher, &QFileSystemWatcher::directoryChanged, this, &ProjectWatcher::onDirectoryChanged);
+    connect(m_watcher, &QFileSystemWatcher::fileChanged, this, &ProjectWatcher::onFileChanged);
+
+    connect(&AIServiceManager::instance(), &AIServiceManager::functionAnalysisComplete, this,
+            &ProjectWatcher::onAnalysisComplete);
+}
+
+ProjectWatcher::~ProjectWatcher()
+{
+    unwatchAll();
+}
+
+void ProjectWatcher::setConfig(const WatcherConfig& config)
+{
+    m_config = config;
+
+    m_extensions.clear();
+    for (const QString& ext : config.fileExtensions)
+    {
+        m_extensions.insert(ext.toLower());
+    }
+
+    m_excludeNames.clear();
+    for (const QString& dir : config.excludeDirectories)
+    {
+        m_excludeNames.insert(dir);
+    }
+}
+
+bool ProjectWatcher::watchProject(int projectId)
+{
+    if (m_projects.contains(projectId))
+    {
+        return true;
+    }
+
+    ProjectInfo info = m_dbManager->getProjectById(projectId);
+    if (info.id <= 0 || m_dbManager->isTemporaryProject(projectId))
+    {
+        return false;
+    }
+
+    QFileInfo rootInfo(info.rootPath);
+    if (!rootInfo.isDir())
+    {
+        Logger::instance().warning(QString("项目根目录不存在，无法监视: %1").arg(info.rootPath));
+        return false;
+    }
+
+    WatchedProject project;
+    project.id = projectId;
+    project.rootPath = QDir::cleanPath(rootInfo.absoluteFilePath());
+    snapshot(project);
+    m_projects.insert(projectId, project);
+
+    if (!m_pollTimer->isActive())
+    {
+        m_pollTimer->start(m_config.pollIntervalMs);
+    }
+
+    Logger::instance().info(QString("开始监视项目: %1, 文件: %2, 监视目录: %3, 监视文件: %4, 轮询目录: %5")
+                                .arg(project.rootPath)
+                                .arg(project.files.size())
+                                .arg(project.watchedDirs.size())
+                                .arg(project.watchedFiles.size())
+                                .arg(project.pollDirs.size()));
+    return true;
+}
+
+void ProjectWatcher::unwatchProject(int projectId)
+{
+    auto it = m_projects.find(projectId);
+    if (it == m_projects.end())
+    {
+        return;
+    }
+
+    releaseWatches(it.value());
+    Logger::instance().info("停止监视项目: " + it.value().rootPath);
+    m_projects.erase(it);
+
+    if (m_projects.isEmpty())
+    {
+        m_pollTimer->stop();
+        m_debounceTimer->stop();
+        m_pollQueue.clear();
+    }
+}
+
+int ProjectWatcher::watchAllProjects()
+{
+    int count = 0;
+    for (const ProjectInfo& project : m_dbManager->getAllProjects())
+    {
+        if (watchProject(project.id))
+        {
+            count++;
+        }
+    }
+    return count;
+}
+
+void ProjectWatcher::unwatchAll()
+{
+    const QList<int> ids = m_projects.keys();
+    for (int id : ids)
+    {
+        unwatchProject(id);
+    }
+}
+
+bool ProjectWatcher::isWatching(int projectId) const
+{
+    return m_projects.contains(projectId);
+}
+
+int ProjectWatcher::watchesInUse() const
+{
+    int count = 0;
+    for (const WatchedProject& project : m_projects)
+    {
+        count += project.watchedDirs.size() + project.watchedFiles.size();
+    }
+    return count;
+}
+
+void ProjectWatcher::onDirectoryChanged(const QString& path)
+{
+    if (projectForPath(path))
+    {
+        m_dirtyDirs.insert(path);
+        scheduleProcessing();
+    }
+}
+
+void ProjectWatcher::onFileChanged(const QString& path)
+{
+    if (projectForPath(path))
+    {
+        m_dirtyFiles.insert(path);
+        scheduleProcessing();
+    }
+}
+
+void ProjectWatcher::onDebounceTimeout()
+{
+    const QSet<QString> dirs = m_dirtyDirs;
+    const QSet<QString> files = m_dirtyFiles;
+    m_dirtyDirs.clear();
+    m_dirtyFiles.clear();
+
+    QHash<int, QSet<QString>> changed;
+    QHash<int, QSet<QString>> removed;
+
+    for (const QString& dir : dirs)
+    {
+        WatchedProject* project = projectForPath(dir);
+        if (project)
+        {
+            rescanDirectory(*project, dir, changed[project->id], removed[project->id]);
+        }
+    }
+
+    for (const QString& file : files)
+    {
+        WatchedProject* project = projectForPath(file);
+        if (!project || !project->files.contains(file))
+        {
+            continue;
+        }
+
+        QFileInfo info(file);
+        if (!info.exists())
+        {
+            forgetFile(*project, file);
+            removed[project->id].insert(file);
+            continue;
+        }
+
+        FileStamp& stamp = project->files[file];
+        QPair<qint64, qint64> current = stampOf(info);
+        if (stamp.modified != current.first || stamp.size != current.second)
+        {
+            stamp.modified = current.first;
+            stamp.size = current.second;
+            changed[project->id].insert(file);
+        }
+
+        // 以改名方式保存的文件会丢失监视，需要重新添加
+        if (project->watchedFiles.contains(file) && !m_watcher->files().contains(file))
+        {
+            m_watcher->addPath(file);
+        }
+    }
+
+    applyChanges(changed, removed);
+}
+
+void ProjectWatcher::onPollTimeout()
+{
+    if (!m_pollQueue.isEmpty())
+    {
+        return;
+    }
+
+    for (const WatchedProject& project : m_projects)
+    {
+        for (const QString& dir : project.pollDirs)
+        {
+            m_pollQueue.append(qMakePair(project.id, dir));
+        }
+    }
+    processPollSlice();
+}
+
+void ProjectWatcher::processPollSlice()
+{
+    QHash<int, QSet<QString>> changed;
+    QHash<int, QSet<QString>> removed;
+
+    int count = 0;
+    while (!m_pollQueue.isEmpty() && count < kPollSliceDirs)
+    {
+        QPair<int, QString> entry = m_pollQueue.takeLast();
+        count++;
+
+        auto it = m_projects.find(entry.first);
+        if (it == m_projects.end() || !it.value().pollDirs.contains(entry.second))
+        {
+            continue;
+        }
+        rescanDirectory(it.value(), entry.second, changed[entry.first], removed[entry.first]);
+    }
+
+    applyChanges(changed, removed);
+
+    if (!m_pollQueue.isEmpty())
+    {
+        QTimer::singleShot(0, this, &ProjectWatcher::processPollSlice);
+    }
+}
+
+void ProjectWatcher::onAnalysisComplete(const AIAnalysisResponse& response)
+{
+    auto it = m_pendingAnalysis.find(response.requestId);
+    if (it == m_pendingAnalysis.end())
+    {
+        return;
+    }
+
+    FunctionData data = it.value();
+    m_pendingAnalysis.erase(it);
+
+    if (!response.success)
+    {
+        Logger::instance().warning(QString("函数分析失败: %1 - %2").arg(data.key, response.errorMessage));
+        return;
+    }
+
+    data.value = response.functionDescription;
+    if (!response.signature.isEmpty())
+    {
+        data.signature = response.signature;
+    }
+    if (!response.returnType.isEmpty())
+    {
+        data.returnType = response.returnType;
+    }
+    if (!response.parameters.isEmpty())
+    {
+        data.parameters = response.parameters;
+    }
+    data.flowchart = response.flowchart;
+    data.sequenceDiagram = response.sequenceDiagram;
+    data.structureDiagram = response.structureDiagram;
+    data.aiModel = response.aiModel;
+    data.analyzeTime = response.analyzeTime;
+
+    if (m_dbManager->upsertFunction(data))
+    {
+        emit projectUpdated(data.projectId, {data.filePath}, {});
+    }
+}
+
+void ProjectWatcher::snapshot(WatchedProject& project)
+{
+    WalkerOptions options;
+    options.fileExtensions = m_config.fileExtensions;
+    options.excludeDirectories = m_config.excludeDirectories;
+
+    QMutex mutex;
+    QStringList dirs;
+    QStringList files;
+    DirectoryWalker walker(options);
+    walker.setDirectoryCallback(
+        [&mutex, &dirs](const QString& dirPath)
+        {
+            QMutexLocker locker(&mutex);
+            dirs.append(QDir::cleanPath(dirPath));
+        });
+    walker.walk(project.rootPath,
+                [&mutex, &files](const QString& filePath)
+                {
+                    QMutexLocker locker(&mutex);
+                    files.append(QDir::cleanPath(filePath));
+                    return true;
+                });
+
+    QStringList newDirs;
+    for (const QString& dir : dirs)
+    {
+        registerDirectory(project, dir, newDirs);
+    }
+
+    for (const QString& file : files)
+    {
+        QFileInfo info(file);
+        QPair<qint64, qint64> current = stampOf(info);
+        FileStamp stamp;
+        stamp.modified = current.first;
+        stamp.size = current.second;
+        project.files.insert(file, stamp);
+        project.filesByDir[info.absolutePath()].insert(file);
+    }
+
+    allocateWatches(project, newDirs);
+}
+
+void ProjectWatcher::registerDirectory(WatchedProject& project, const QString& dirPath, QStringList& newDirs)
+{
+    if (project.subdirsByDir.contains(dirPath))
+    {
+        return;
+    }
+
+    project.subdirsByDir.insert(dirPath, QSet<QString>());
+    newDirs.append(dirPath);
+
+    if (dirPath != project.rootPath)
+    {
+        QString parent = QFileInfo(dirPath).path();
+        registerDirectory(project, parent, newDirs);
+        project.subdirsByDir[parent].insert(dirPath);
+    }
+}
+
+void ProjectWatcher::allocateWatches(WatchedProject& project, const QStringList& dirs)
+{
+    // 浅层目录优先获得监视：目录越浅，下面可能出现的新文件越多
+    QStringList sorted = dirs;
+    std::sort(sorted.begin(), sorted.end(),
+              [](const QString& a, const QString& b) { return depthOf(a) < depthOf(b); });
+
+    int budget = qMax(0, m_config.watchBudget - watchesInUse());
+    QStringList candidates = sorted.mid(0, budget);
+    QStringList failed = candidates.isEmpty() ? QStringList() : m_watcher->addPaths(candidates);
+
+    // 系统拒绝监视（如达到 inotify 上限）的目录和超出预算的目录改为轮询
+    QSet<QString> candidateSet(candidates.begin(), candidates.end());
+    QSet<QString> failedSet(failed.begin(), failed.end());
+    for (const QString& dir : sorted)
+    {
+        if (candidateSet.contains(dir) && !failedSet.contains(dir))
+        {
+            project.watchedDirs.insert(dir);
+        }
+        else
+        {
+            project.pollDirs.insert(dir);
+        }
+    }
+
+    if (!m_config.watchFiles || !failed.isEmpty())
+    {
+        // 不监视文件（或系统监视数已用尽）时，原地写入只能靠轮询发现
+        for (const QString& dir : sorted)
+        {
+            project.pollDirs.insert(dir);
+        }
+        return;
+    }
+
+    for (const QString& dir : sorted)
+    {
+        if (!project.watchedDirs.contains(dir))
+        {
+            continue;
+        }
+
+        QStringList files = project.filesByDir.value(dir).values();
+        budget = qMax(0, m_config.watchBudget - watchesInUse());
+        if (files.size() > budget)
+        {
+            project.pollDirs.insert(dir);
+            continue;
+        }
+        if (files.isEmpty())
+        {
+            continue;
+        }
+
+        QStringList fileFailed = m_watcher->addPaths(files);
+        for (const QString& file : files)
+        {
+            if (!fileFailed.contains(file))
+            {
+                project.watchedFiles.insert(file);
+            }
+        }
+        if (!fileFailed.isEmpty())
+        {
+            project.pollDirs.insert(dir);
+        }
+    }
+}
+
+void ProjectWatcher::releaseWatches(WatchedProject& project)
+{
+    QStringList paths = project.watchedDirs.values() + project.watchedFiles.values();
+    if (!paths.isEmpty())
+    {
+        m_watcher->removePaths(paths);
+    }
+    project.watchedDirs.clear();
+    project.watchedFiles.clear();
+}
+
+void ProjectWatcher::rescanDirectory(WatchedProject& project, const QString& dirPath, QSet<QString>& changed,
+                                     QSet<QString>& removed)
+{
+    if (!project.subdirsByDir.contains(dirPath))
+    {
+        return;
+    }
+    if (!QFileInfo(dirPath).isDir())
+    {
+        removeDirectoryTree(project, dirPath, removed);
+        return;
+    }
+
+    std::shared_ptr<const IgnoreRules> rules = rulesFor(project, dirPath);
+    QString dirRelative = relativePath(project, dirPath);
+
+    QSet<QString> seenFiles;
+    QSet<QString> seenDirs;
+
+    QDirIterator it(dirPath, QDir::Dirs | QDir::Files | QDir::NoDotAndDotDot | QDir::NoSymLinks);
+    while (it.hasNext())
+    {
+        QString path = it.next();
+        QFileInfo info = it.fileInfo();
+        QString name = info.fileName();
+        QString relative = dirRelative.isEmpty() ? name : dirRelative + "/" + name;
+
+        if (info.isDir())
+        {
+            if (m_excludeNames.contains(name) || (rules && rules->isIgnored(relative, name, true)))
+            {
+                continue;
+            }
+            seenDirs.insert(path);
+            if (!project.subdirsByDir.contains(path))
+            {
+                addDirectoryTree(project, path, changed);
+            }
+            continue;
+        }
+
+        if (!isSourceFile(name) || (rules && rules->isIgnored(relative, name, false)))
+        {
+            continue;
+        }
+
+        seenFiles.insert(path);
+        QPair<qint64, qint64> current = stampOf(info);
+        auto known = project.files.find(path);
+        if (known == project.files.end())
+        {
+            FileStamp stamp;
+            stamp.modified = current.first;
+            stamp.size = current.second;
+            project.files.insert(path, stamp);
+            project.filesByDir[dirPath].insert(path);
+            changed.insert(path);
+
+            // 新文件在预算允许时加入监视，否则所在目录改为轮询
+            bool watched = false;
+            if (m_config.watchFiles && project.watchedDirs.contains(dirPath) &&
+                watchesInUse() < m_config.watchBudget && m_watcher->addPath(path))
+            {
+                project.watchedFiles.insert(path);
+                watched = true;
+            }
+            if (!watched)
+            {
+                project.pollDirs.insert(dirPath);
+            }
+        }
+        else if (known.value().modified != current.first || known.value().size != current.second)
+        {
+            known.value().modified = current.first;
+            known.value().size = current.second;
+            changed.insert(path);
+        }
+    }
+
+    const QSet<QString> knownFiles = project.filesByDir.value(dirPath);
+    for (const QString& file : knownFiles)
+    {
+        if (!seenFiles.contains(file))
+        {
+            forgetFile(project, file);
+            removed.insert(file);
+        }
+    }
+
+    const QSet<QString> knownDirs = project.subdirsByDir.value(dirPath);
+    for (const QString& dir : knownDirs)
+    {
+        if (!seenDirs.contains(dir))
+        {
+            removeDirectoryTree(project, dir, removed);
+        }
+    }
+}
+
+void ProjectWatcher::addDirectoryTree(WatchedProject& project, const QString& dirPath, QSet<QString>& changed)
+{
+    WalkerOptions options;
+    options.fileExtensions = m_config.fileExtensions;
+    options.excludeDirectories = m_config.excludeDirectories;
+
+    QMutex mutex;
+    QStringList dirs;
+    QStringList files;
+    DirectoryWalker walker(options);
+    walker.setDirectoryCallback(
+        [&mutex, &dirs](const QString& path)
+        {
+            QMutexLocker locker(&mutex);
+            dirs.append(QDir::cleanPath(path));
+        });
+    walker.walk(dirPath,
+                [&mutex, &files](const QString& path)
+                {
+                    QMutexLocker locker(&mutex);
+                    files.append(QDir::cleanPath(path));
+                    return true;
+                });
+
+    QStringList newDirs;
+    for (const QString& dir : dirs)
+    {
+        registerDirectory(project, dir, newDirs);
+    }
+
+    for (const QString& file : files)
+    {
+        QFileInfo info(file);
+        QPair<qint64, qint64> current = stampOf(info);
+        FileStamp stamp;
+        stamp.modified = current.first;
+        stamp.size = current.second;
+        project.files.insert(file, stamp);
+        project.filesByDir[info.absolutePath()].insert(file);
+        changed.insert(file);
+    }
+
+    allocateWatches(project, newDirs);
+}
+
+void ProjectWatcher::removeDirectoryTree(WatchedProject& project, const QString& dirPath, QSet<QString>& removed)
+{
+    const QSet<QString> subdirs = project.subdirsByDir.value(dirPath);
+    for (const QString& subdir : subdirs)
+    {
+        removeDirectoryTree(project, subdir, removed);
+    }
+
+    const QSet<QString> files = project.filesByDir.value(dirPath);
+    for (const QString& file : files)
+    {
+        forgetFile(project, file);
+        removed.insert(file);
+    }
+
+    if (project.watchedDirs.remove(dirPath))
+    {
+        m_watcher->removePath(dirPath);
+    }
+    project.pollDirs.remove(dirPath);
+    project.filesByDir.remove(dirPath);
+    project.subdirsByDir.remove(dirPath);
+
+    QString parent = QFileInfo(dirPath).path();
+    auto parentIt = project.subdirsByDir.find(parent);
+    if (parentIt != project.subdirsByDir.end())
+    {
+        parentIt.value().remove(dirPath);
+    }
+}
+
+void ProjectWatcher::forgetFile(WatchedProject& project, const QString& filePath)
+{
+    project.files.remove(filePath);
+    project.bodyHashes.remove(filePath);
+
+    QString dir = QFileInfo(filePath).absolutePath();
+    auto it = project.filesByDir.find(dir);
+    if (it != project.filesByDir.end())
+    {
+        it.value().remove(filePath);
+    }
+
+    if (project.watchedFiles.remove(filePath))
+    {
+        m_watcher->removePath(filePath);
+    }
+}
+
+void ProjectWatcher::applyChanges(const QHash<int, QSet<QString>>& changed, const QHash<int, QSet<QString>>& removed)
+{
+    QSet<int> projectIds;
+    for (auto it = changed.begin(); it != changed.end(); ++it)
+    {
+        if (!it.value().isEmpty())
+        {
+            projectIds.insert(it.key());
+        }
+    }
+    for (auto it = removed.begin(); it != removed.end(); ++it)
+    {
+        if (!it.value().isEmpty())
+        {
+            projectIds.insert(it.key());
+        }
+    }
+
+    for (int projectId : projectIds)
+    {
+        auto projectIt = m_projects.find(projectId);
+        if (projectIt == m_projects.end())
+        {
+            continue;
+        }
+        WatchedProject& project = projectIt.value();
+
+        QStringList removedFiles;
+        for (const QString& file : removed.value(projectId))
+        {
+            QString relative = relativePath(project, file);
+            if (m_dbManager->deleteFunctionsByFile(projectId, relative))
+            {
+                removedFiles.append(relative);
+            }
+        }
+
+        QStringList changedFiles;
+        for (const QString& file : changed.value(projectId))
+        {
+            if (reindexFile(project, file))
+            {
+                changedFiles.append(relativePath(project, file));
+            }
+        }
+
+        if (changedFiles.isEmpty() && removedFiles.isEmpty())
+        {
+            continue;
+        }
+
+        Logger::instance().info(QString("项目增量更新: %1, 重新提取: %2 个文件, 删除: %3 个文件")
+                                    .arg(project.rootPath)
+                                    .arg(changedFiles.size())
+                                    .arg(removedFiles.size()));
+        emit projectUpdated(projectId, changedFiles, removedFiles);
+    }
+}
+
+bool ProjectWatcher::reindexFile(WatchedProject& project, const QString& filePath)
+{
+    FunctionParser& parser = FunctionParser::instance();
+    QString language = parser.detectLanguage(filePath);
+    if (!parser.isLanguageSupported(language))
+    {
+        return false;
+    }
+
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+    {
+        Logger::instance().warning("无法读取文件: " + filePath);
+        return false;
+    }
+    QString code = QString::fromUtf8(file.readAll());
+
+    QString relative = relativePath(project, filePath);
+    ExtractionResult result = parser.extractFromCode(code, language);
+
+    QHash<QString, FunctionData> existing;
+    for (const FunctionData& data : m_dbManager->getFunctionsByFile(project.id, relative))
+    {
+        existing.insert(data.key, data);
+    }
+
+    // 数据库不保存函数体，用上次提取时记录的指纹判断内容是否变化；
+    // 开始监视后第一次修改的文件没有记录，其中的已有函数无法比较，按已变化处理
+    const QHash<QString, QString> previousHashes = project.bodyHashes.value(filePath);
+    QHash<QString, QString> currentHashes;
+
+    QVector<FunctionData> updates;
+    QVector<ExtractedFunction> toAnalyze;
+    QSet<QString> seen;
+    for (ExtractedFunction func : result.functions)
+    {
+        // 同一文件中的同名函数（重载）在数据库中只占一行
+        if (seen.contains(func.name))
+        {
+            continue;
+        }
+        seen.insert(func.name);
+
+        QString bodyHash = RequestFingerprint::compute(func.signature + "\n" + func.body, language, QString(), 0);
+        currentHashes.insert(func.name, bodyHash);
+
+        bool known = existing.contains(func.name);
+        FunctionData data = existing.value(func.name);
+        bool signatureChanged = known && RequestFingerprint::normalizeCode(data.signature) !=
+                                             RequestFingerprint::normalizeCode(func.signature);
+        bool contentChanged = !known || signatureChanged || previousHashes.value(func.name) != bodyHash ||
+                              (data.endLine - data.startLine) != (func.endLine - func.startLine);
+        bool moved = known && (data.startLine != func.startLine || data.endLine != func.endLine);
+        if (!contentChanged && !moved)
+        {
+            continue;
+        }
+
+        data.projectId = project.id;
+        data.key = func.name;
+        data.filePath = relative;
+        data.startLine = func.startLine;
+        data.endLine = func.endLine;
+        data.language = language;
+        if (!known || signatureChanged)
+        {
+            // 签名未变的已有函数保留AI分析得到的签名和参数，其余使用本地提取的结果
+            data.signature = func.signature;
+            data.returnType = func.returnType;
+            data.parameters = parametersToJson(func.parameters);
+        }
+        if (!known)
+        {
+            data.createTime = QDateTime::currentDateTime();
+        }
+        updates.append(data);
+
+        if (contentChanged && m_config.analyzeChanged)
+        {
+            func.filePath = filePath;
+            func.language = language;
+            toAnalyze.append(func);
+        }
+    }
+
+    // 本地解析器可能漏掉AI识别出的函数，只有文件中已找不到调用形式的名称时才删除
+    QVector<int> staleIds;
+    for (const FunctionData& data : existing)
+    {
+        if (seen.contains(data.key))
+        {
+            continue;
+        }
+        QRegularExpression pattern("\\b" + QRegularExpression::escape(data.key) + "\\s*\\(");
+        if (!code.contains(pattern))
+        {
+            staleIds.append(data.id);
+        }
+    }
+
+    project.bodyHashes.insert(filePath, currentHashes);
+
+    if (!staleIds.isEmpty())
+    {
+        m_dbManager->deleteFunctions(staleIds);
+    }
+    if (!updates.isEmpty())
+    {
+        m_dbManager->addFunctionsBatch(updates);
+    }
+
+    for (const ExtractedFunction& func : toAnalyze)
+    {
+        QString requestId = QString("watch-%1").arg(++m_requestSeq);
+        for (const FunctionData& data : updates)
+        {
+            if (data.key == func.name)
+            {
+                m_pendingAnalysis.insert(requestId, data);
+                break;
+            }
+        }
+        AIServiceManager::instance().analyzeFunction(func, requestId);
+    }
+
+    return true;
+}
+
+ProjectWatcher::WatchedProject* ProjectWatcher::projectForPath(const QString& path)
+{
+    WatchedProject* best = nullptr;
+    for (auto it = m_projects.begin(); it != m_projects.end(); ++it)
+    {
+        const QString& root = it.value().rootPath;
+        if (path == root || path.startsWith(root + "/"))
+        {
+            // 项目嵌套时取最深的根目录
+            if (!best || root.size() > best->rootPath.size())
+            {
+                best = &it.value();
+            }
+        }
+    }
+    return best;
+}
+
+void ProjectWatcher::scheduleProcessing()
+{
+    if (!m_debounceTimer->isActive())
+    {
+        m_firstPending.start();
+        m_debounceTimer->start(m_config.debounceMs);
+        return;
+    }
+
+    // 事件持续到达时不再推迟，保证最长延迟
+    if (m_firstPending.elapsed() + m_config.debounceMs < m_config.maxBatchDelayMs)
+    {
+        m_debounceTimer->start(m_config.debounceMs);
+    }
+}
+
+bool ProjectWatcher::isSourceFile(const QString& fileName) const
+{
+    int dot = fileName.lastIndexOf('.');
+    return dot >= 0 && m_extensions.contains(fileName.mid(dot + 1).toLower());
+}
+
+std::shared_ptr<const IgnoreRules> ProjectWatcher::rulesFor(const WatchedProject& project,
+                                                            const QString& dirPath) const
+{
+    // 从根目录逐级加载 .gitignore，与初次遍历时的规则链一致
+    std::shared_ptr<const IgnoreRules> rules =
+        IgnoreRules::forDirectory(nullptr, project.rootPath, QString());
+
+    QString relative = relativePath(project, dirPath);
+    if (relative.isEmpty())
+    {
+        return rules;
+    }
+
+    QString current = project.rootPath;
+    QString currentRelative;
+    for (const QString& segment : relative.split('/', Qt::SkipEmptyParts))
+    {
+        current += "/" + segment;
+        currentRelative = currentRelative.isEmpty() ? segment : currentRelative + "/" + segment;
+        rules = IgnoreRules::forDirectory(rules, current, currentRelative);
+    }
+    return rules;
+}
+
+QString ProjectWatcher::relativePath(const WatchedProject& project, const QString& filePath)
+{
+    if (filePath == project.rootPath)
+    {
+        return QString();
+    }
+    if (filePath.startsWith(project.rootPath + "/"))
+    {
+        return filePath.mid(project.rootPath.size() + 1);
+    }
+    return filePath;
+}
@@ -0,0 +1,319 @@
+/**
+ * @file projectwatcher.h
+ * @brief 项目目录监视器，源文件变化后增量更新函数库
+ * @author Developer
+ * @date 2026-10-18
+ * @version 1.0
+ *
+ * @details 监视策略：
+ * - 所有项目共享一个系统监视数预算，先按目录深度由浅到深监视目录（新建、删除、重命名），
+ *   剩余预算再监视单个文件（原地写入）
+ * - 超出预算或系统拒绝监视的目录进入轮询列表，定期比较文件的修改时间和大小
+ * - 变化事件先去抖再成批处理，持续有事件时最多延迟 maxBatchDelayMs 处理一次
+ * 处理时只重新提取变化的文件：保留签名未变的函数已有的AI分析结果，删除文件中已不存在的函数，
+ * 被删除的文件的函数一并删除。
+ */
+
+#ifndef PROJECTWATCHER_H
+#define PROJECTWATCHER_H
+
+#include <QElapsedTimer>
+#include <QFileSystemWatcher>
+#include <QHash>
+#include <QObject>
+#include <QSet>
+#include <QStringList>
+#include <QTimer>
+#include <QVector>
+#include <memory>
+#include "core/interfaces/idatabaserepository.h"
+#include "core/models/batchconfig.h"
+#include "core/parser/ignorerules.h"
+
+/**
+ * @brief 项目监视配置
+ */
+struct WatcherConfig
+{
+    int watchBudget = 8192;          ///< 所有项目共享的系统监视数上限
+    bool watchFiles = true;          ///< 预算有剩余时是否监视单个文件
+    int debounceMs = 500;            ///< 去抖间隔（毫秒）
+    int maxBatchDelayMs = 5000;      ///< 持续有事件时的最长处理延迟（毫秒）
+    int pollIntervalMs = 30000;      ///< 轮询未被监视的目录的间隔（毫秒）
+    bool analyzeChanged = false;     ///< 新增、签名或函数体变化的函数是否提交AI分析
+    QStringList fileExtensions;      ///< 要监视的文件扩展名
+    QStringList excludeDirectories;  ///< 要排除的目录名
+};
+
+/**
+ * @brief 项目目录监视器类
+ */
+class ProjectWatcher : public QObject
+{
+    Q_OBJECT
+
+   public:
+    /**
+     * @brief 构造函数
+     * @param dbManager 数据库管理器接口（依赖注入）
+     * @param parent 父对象
+     */
+    explicit ProjectWatcher(IDatabaseManager* dbManager, QObject* parent = nullptr);
+
+    /**
+     * @brief 析构函数
+     */
+    ~ProjectWatcher();
+
+    ProjectWatcher(const ProjectWatcher&) = delete;
+    ProjectWatcher& operator=(const ProjectWatcher&) = delete;
+
+    /**
+     * @brief 设置监视配置（对之后开始监视的项目生效）
+     * @param config 监视配置
+     */
+    void setConfig(const WatcherConfig& config);
+
+    /**
+     * @brief 获取监视配置
+     * @return 监视配置
+     */
+    WatcherConfig config() const { return m_config; }
+
+    /**
+     * @brief 开始监视项目根目录
+     * @param projectId 项目ID
+     * @return 是否成功
+     */
+    bool watchProject(int projectId);
+
+    /**
+     * @brief 停止监视项目
+     * @param projectId 项目ID
+     */
+    void unwatchProject(int projectId);
+
+    /**
+     * @brief 监视所有已注册的项目（跳过临时项目和根目录不存在的项目）
+     * @return 开始监视的项目数
+     */
+    int watchAllProjects();
+
+    /**
+     * @brief 停止监视所有项目
+     */
+    void unwatchAll();
+
+    /**
+     * @brief 检查项目是否正在被监视
+     * @param projectId 项目ID
+     * @return 是否正在被监视
+     */
+    bool isWatching(int projectId) const;
+
+    /**
+     * @brief 获取正在使用的系统监视数
+     * @return 监视数
+     */
+    int watchesInUse() const;
+
+   signals:
+    /**
+     * @brief 项目增量更新完成信号
+     * @param projectId 项目ID
+     * @param changedFiles 重新提取的文件（相对路径）
+     * @param removedFiles 被删除的文件（相对路径）
+     */
+    void projectUpdated(int projectId, const QStringList& changedFiles, const QStringList& removedFiles);
+
+   private slots:
+    /**
+     * @brief 目录变化槽函数
+     * @param path 目录路径
+     */
+    void onDirectoryChanged(const QString& path);
+
+    /**
+     * @brief 文件变化槽函数
+     * @param path 文件路径
+     */
+    void onFileChanged(const QString& path);
+
+    /**
+     * @brief 去抖结束，成批处理变化
+     */
+    void onDebounceTimeout();
+
+    /**
+     * @brief 轮询未被监视的目录
+     */
+    void onPollTimeout();
+
+    /**
+     * @brief 重新列出一部分待轮询的目录，剩余的留到下一轮事件循环
+     */
+    void processPollSlice();
+
+    /**
+     * @brief 函数分析完成槽函数
+     * @param response 分析响应
+     */
+    void onAnalysisComplete(const AIAnalysisResponse& response);
+
+   private:
+    /**
+     * @brief 文件状态
+     */
+    struct FileStamp
+    {
+        qint64 modified;  ///< 修改时间（毫秒）
+        qint64 size;      ///< 文件大小
+
+        FileStamp() : modified(0), size(0) {}
+    };
+
+    /**
+     * @brief 被监视的项目
+     */
+    struct WatchedProject
+    {
+        int id;                                              ///< 项目ID
+        QString rootPath;                                    ///< 根目录（绝对路径）
+        QHash<QString, FileStamp> files;                     ///< 已知的源文件（绝对路径）
+        QHash<QString, QSet<QString>> filesByDir;            ///< 目录 -> 直接包含的源文件
+        QHash<QString, QSet<QString>> subdirsByDir;          ///< 目录 -> 直接包含的子目录
+        QSet<QString> watchedDirs;                           ///< 已被系统监视的目录
+        QSet<QString> watchedFiles;                          ///< 已被系统监视的文件
+        QSet<QString> pollDirs;                              ///< 需要轮询的目录
+        QHash<QString, QHash<QString, QString>> bodyHashes;  ///< 源文件 -> 函数名称 -> 签名和函数体的指纹
+
+        WatchedProject() : id(0) {}
+    };
+
+    /**
+     * @brief 建立项目的初始快照并分配监视
+     * @param project 项目
+     */
+    void snapshot(WatchedProject& project);
+
+    /**
+     * @brief 把目录及其父目录链登记到项目中
+     * @param project 项目
+     * @param dirPath 目录路径
+     * @param newDirs 输出参数，新登记的目录
+     */
+    void registerDirectory(WatchedProject& project, const QString& dirPath, QStringList& newDirs);
+
+    /**
+     * @brief 按剩余预算为项目分配目录和文件监视，其余目录进入轮询列表
+     * @param project 项目
+     * @param dirs 新登记的目录
+     */
+    void allocateWatches(WatchedProject& project, const QStringList& dirs);
+
+    /**
+     * @brief 释放项目的所有监视
+     * @param project 项目
+     */
+    void releaseWatches(WatchedProject& project);
+
+    /**
+     * @brief 重新列出目录，与已知状态比较
+     * @param project 项目
+     * @param dirPath 目录路径
+     * @param changed 输出参数，新增或修改的文件
+     * @param removed 输出参数，被删除的文件
+     */
+    void rescanDirectory(WatchedProject& project, const QString& dirPath, QSet<QString>& changed,
+                         QSet<QString>& removed);
+
+    /**
+     * @brief 遍历新出现的子目录，其中的文件全部视为新增
+     * @param project 项目
+     * @param dirPath 子目录路径
+     * @param changed 输出参数，新增的文件
+     */
+    void addDirectoryTree(WatchedProject& project, const QString& dirPath, QSet<QString>& changed);
+
+    /**
+     * @brief 移除已被删除的目录及其下所有文件
+     * @param project 项目
+     * @param dirPath 目录路径
+     * @param removed 输出参数，被删除的文件
+     */
+    void removeDirectoryTree(WatchedProject& project, const QString& dirPath, QSet<QString>& removed);
+
+    /**
+     * @brief 从项目中移除一个文件的记录和监视
+     * @param project 项目
+     * @param filePath 文件绝对路径
+     */
+    void forgetFile(WatchedProject& project, const QString& filePath);
+
+    /**
+     * @brief 更新数据库中变化和被删除的文件，并发出更新信号
+     * @param changed 各项目新增或修改的文件
+     * @param removed 各项目被删除的文件
+     */
+    void applyChanges(const QHash<int, QSet<QString>>& changed, const QHash<int, QSet<QString>>& removed);
+
+    /**
+     * @brief 重新提取一个文件的函数并更新数据库
+     * @param project 项目
+     * @param filePath 文件绝对路径
+     * @return 是否成功
+     */
+    bool reindexFile(WatchedProject& project, const QString& filePath);
+
+    /**
+     * @brief 查找路径所属的项目
+     * @param path 绝对路径
+     * @return 项目指针（未找到时为nullptr）
+     */
+    WatchedProject* projectForPath(const QString& path);
+
+    /**
+     * @brief 记录一个变化事件并（重新）启动去抖定时器
+     */
+    void scheduleProcessing();
+
+    /**
+     * @brief 检查文件扩展名是否需要监视
+     * @param fileName 文件名
+     * @return 是否需要监视
+     */
+    bool isSourceFile(const QString& fileName) const;
+
+    /**
+     * @brief 加载从项目根目录到指定目录的 .gitignore 规则链
+     * @param project 项目
+     * @param dirPath 目录路径
+     * @return 规则节点（没有任何规则时为空）
+     */
+    std::shared_ptr<const IgnoreRules> rulesFor(const WatchedProject& project, const QString& dirPath) const;
+
+    /**
+     * @brief 计算相对于项目根目录的路径
+     * @param project 项目
+     * @param filePath 绝对路径
+     * @return 相对路径
+     */
+    static QString relativePath(const WatchedProject& project, const QString& filePath);
+
+    IDatabaseManager* m_dbManager;                   ///< 数据库管理器（依赖注入）
+    WatcherConfig m_config;                          ///< 监视配置
+    QFileSystemWatcher* m_watcher;                   ///< 系统文件监视器
+    QTimer* m_debounceTimer;                         ///< 去抖定时器
+    QTimer* m_pollTimer;                             ///< 轮询定时器
+    QElapsedTimer m_firstPending;                    ///< 本批第一个事件的时间
+    QHash<int, WatchedProject> m_projects;           ///< 被监视的项目
+    QSet<QString> m_dirtyDirs;                       ///< 待重新列出的目录
+    QSet<QString> m_dirtyFiles;                      ///< 待检查的文件
+    QSet<QString> m_extensions;                      ///< 需要监视的扩展名（小写）
+    QSet<QString> m_excludeNames;                    ///< 排除的目录名
+    QVector<QPair<int, QString>> m_pollQueue;        ///< 本轮待轮询的目录（项目ID，目录）
+    QHash<QString, FunctionData> m_pendingAnalysis;  ///< 等待AI分析的函数（请求ID -> 函数数据）
+    int m_requestSeq;                                ///< AI请求序号
+};
+
+#endif  // PROJECTWATCHER_H
@@ -0,0 +1,274 @@
+/**
+ * @file main.cpp
+ * @brief 消息总线发布吞吐量基准测试
+ * @author Developer
+ * @date 2026-10-18
+ * @version 1.0
+ *
+ * @details 多个线程同时同步发布同一类型的消息，统计线程数从1倍增到 --threads 时的总吞吐量：
+ * - MessageBus：按消息类型索引的不可变订阅者快照，分发不加锁
+ * - 类型化通道：同一套快照，负载直接按引用传递，不构造 Message 和 QVariant
+ * - 请求-响应：requestAsync 发出请求，处理函数内直接 respond，返回的 future 已完成
+ * - 异步批量：publishAsync 发布到主线程接收者的投递队列，发布结束后主线程一次分发事件处理全部消息；
+ *   合并模式下队列中只保留最新的一条
+ * - 加锁参照：每次发布加锁、在QMap中查找并复制订阅者列表（快照化之前的分发方式）
+ * 示例：
+ * busbench --threads 8 --messages 200000 --subscribers 4
+ */
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QList>
+#include <QMap>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QThread>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <vector>
+#include "common/logger/logger.h"
+#include "common/messagebus/messagebus.h"
+
+namespace
+{
+thread_local quint64 t_handled = 0;  ///< 当前线程处理的消息数
+
+/**
+ * @brief 类型化通道的负载
+ */
+struct ProgressEvent
+{
+    int current;  ///< 当前进度
+    int total;    ///< 总数
+};
+
+/**
+ * @brief 快照化之前的分发方式，作为对照
+ */
+class LockedDispatcher
+{
+   public:
+    void subscribe(MessageType type, const MessageBus::MessageHandler& handler)
+    {
+        QMutexLocker locker(&m_mutex);
+        m_subscribers[type].append(handler);
+    }
+
+    void dispatch(const Message& message)
+    {
+        QMutexLocker locker(&m_mutex);
+        if (!m_subscribers.contains(message.type))
+        {
+            return;
+        }
+        QList<MessageBus::MessageHandler> handlers = m_subscribers[message.type];
+        locker.unlock();
+
+        for (const MessageBus::MessageHandler& handler : handlers)
+        {
+            handler(message);
+        }
+    }
+
+   private:
+    QMutex m_mutex;                                                      ///< 互斥锁
+    QMap<MessageType, QList<MessageBus::MessageHandler>> m_subscribers;  ///< 按消息类型分组的处理函数
+};
+
+/**
+ * @brief 用指定线程数并发发布并返回总吞吐量
+ * @param threadCount 线程数
+ * @param messagesPerThread 每个线程发布的消息数
+ * @param publish 发布一条消息
+ * @param handled 输出参数，所有线程处理的消息总数
+ * @return 吞吐量（条/秒）
+ */
+double measure(int threadCount, int messagesPerThread, const std::function<void(const Message&)>& publish,
+               quint64& handled)
+{
+    Message message(MessageType::ParseProgress, QVariant(42), "busbench");
+    std::atomic<bool> go(false);
+    std::atomic<quint64> total(0);
+
+    std::vector<std::unique_ptr<QThread>> threads;
+    for (int i = 0; i < threadCount; ++i)
+    {
+        threads.emplace_back(QThread::create(
+            [&]()
+            {
+                while (!go.load(std::memory_order_acquire))
+                {
+                    QThread::yieldCurrentThread();
+                }
+                t_handled = 0;
+                for (int n = 0; n < messagesPerThread; ++n)
+                {
+                    publish(message);
+                }
+                total.fetch_add(t_handled, std::memory_order_relaxed);
+            }));
+        threads.back()->start();
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    go.store(true, std::memory_order_release);
+    for (const std::unique_ptr<QThread>& thread : threads)
+    {
+        thread->wait();
+    }
+    qint64 elapsedNs = qMax<qint64>(1, timer.nsecsElapsed());
+
+    handled = total.load();
+    return static_cast<double>(threadCount) * messagesPerThread * 1e9 / elapsedNs;
+}
+
+/**
+ * @brief 多线程异步发布，发布结束后在主线程处理投递事件，返回包含分发在内的总吞吐量
+ * @param threadCount 线程数
+ * @param messagesPerThread 每个线程发布的消息数
+ * @param coalesce 是否合并
+ * @param handled 输出参数，主线程处理的消息总数
+ * @return 吞吐量（条/秒）
+ */
+double measureAsync(int threadCount, int messagesPerThread, bool coalesce, quint64& handled)
+{
+    MessageBus::instance().setCoalescing(MessageType::ParseProgress, coalesce);
+    t_handled = 0;
+
+    QElapsedTimer timer;
+    timer.start();
+    std::vector<std::unique_ptr<QThread>> threads;
+    for (int i = 0; i < threadCount; ++i)
+    {
+        threads.emplace_back(QThread::create(
+            [messagesPerThread]()
+            {
+                for (int n = 0; n < messagesPerThread; ++n)
+                {
+                    MessageBus::instance().publishAsync(MessageType::ParseProgress, QVariant(n), "busbench");
+                }
+            }));
+        threads.back()->start();
+    }
+    for (const std::unique_ptr<QThread>& thread : threads)
+    {
+        thread->wait();
+    }
+    // 主线程在等待期间没有处理事件，所有消息都在同一个投递事件中分发
+    QCoreApplication::sendPostedEvents();
+    qint64 elapsedNs = qMax<qint64>(1, timer.nsecsElapsed());
+
+    MessageBus::instance().setCoalescing(MessageType::ParseProgress, false);
+    handled = t_handled;
+    return static_cast<double>(threadCount) * messagesPerThread * 1e9 / elapsedNs;
+}
+}  // namespace
+
+int main(int argc, char* argv[])
+{
+    QCoreApplication app(argc, argv);
+    app.setApplicationName("busbench");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("消息总线发布吞吐量基准测试");
+    parser.addHelpOption();
+    QCommandLineOption threadsOption("threads", "最大发布线程数", "count", QString::number(QThread::idealThreadCount()));
+    QCommandLineOption messagesOption("messages", "每个线程发布的消息数", "count", "200000");
+    QCommandLineOption subscribersOption("subscribers", "订阅者数量", "count", "4");
+    parser.addOptions({threadsOption, messagesOption, subscribersOption});
+    parser.process(app);
+
+    int maxThreads = qMax(1, parser.value(threadsOption).toInt());
+    int messagesPerThread = qMax(1, parser.value(messagesOption).toInt());
+    int subscriberCount = qMax(1, parser.value(subscribersOption).toInt());
+
+    Logger& logger = Logger::instance();
+    logger.setFileEnabled(false);
+    logger.setMinLevel(Info);
+
+    MessageBus::MessageHandler handler = [](const Message&) { ++t_handled; };
+    QObject receiver;
+    LockedDispatcher locked;
+    for (int i = 0; i < subscriberCount; ++i)
+    {
+        MessageBus::instance().subscribe(MessageType::ParseProgress, &receiver, handler);
+        MessageBus::instance().subscribe<ProgressEvent>(&receiver, [](const ProgressEvent&) { ++t_handled; });
+        locked.subscribe(MessageType::ParseProgress, handler);
+    }
+    MessageBus::instance().registerResponseHandler(MessageType::AIRequestStarted, &receiver,
+                                                   [](const Message& request)
+                                                   { MessageBus::instance().respond(request, request.data); });
+
+    logger.info(QString("消息总线基准测试 - 每线程消息数: %1, 订阅者数: %2").arg(messagesPerThread).arg(subscriberCount));
+    for (int threadCount = 1; threadCount <= maxThreads; threadCount *= 2)
+    {
+        quint64 expected = static_cast<quint64>(threadCount) * messagesPerThread * subscriberCount;
+        quint64 handled = 0;
+
+        double snapshot = measure(threadCount, messagesPerThread,
+                                  [](const Message& message) { MessageBus::instance().publishMessage(message); },
+                                  handled);
+        if (handled != expected)
+        {
+            logger.error(QString("MessageBus 处理数不符 - 期望: %1, 实际: %2").arg(expected).arg(handled));
+            return 1;
+        }
+
+        double typed = measure(threadCount, messagesPerThread,
+                               [](const Message&) { MessageBus::instance().publish(ProgressEvent{1, 100}); }, handled);
+        if (handled != expected)
+        {
+            logger.error(QString("类型化通道处理数不符 - 期望: %1, 实际: %2").arg(expected).arg(handled));
+            return 1;
+        }
+
+        double requests = measure(threadCount, messagesPerThread,
+                                  [](const Message& message)
+                                  {
+                                      QFuture<Message> future = MessageBus::instance().requestAsync(
+                                          MessageType::AIRequestStarted, message.data, message.sender, -1);
+                                      t_handled += future.isFinished() ? 1 : 0;
+                                  },
+                                  handled);
+        if (handled != static_cast<quint64>(threadCount) * messagesPerThread)
+        {
+            logger.error(QString("请求-响应完成数不符 - 期望: %1, 实际: %2")
+                             .arg(static_cast<quint64>(threadCount) * messagesPerThread)
+                             .arg(handled));
+            return 1;
+        }
+
+        double batched = measureAsync(threadCount, messagesPerThread, false, handled);
+        if (handled != expected)
+        {
+            logger.error(QString("异步批量处理数不符 - 期望: %1, 实际: %2").arg(expected).arg(handled));
+            return 1;
+        }
+
+        double coalesced = measureAsync(threadCount, messagesPerThread, true, handled);
+        if (handled != static_cast<quint64>(subscriberCount))
+        {
+            logger.error(QString("异步合并处理数不符 - 期望: %1, 实际: %2").arg(subscriberCount).arg(handled));
+            return 1;
+        }
+
+        double reference = measure(threadCount, messagesPerThread,
+                                   [&locked](const Message& message) { locked.dispatch(message); }, handled);
+
+        logger.info(QString("线程数 %1: MessageBus %2 万条/秒, 类型化通道 %3 万条/秒, 请求-响应 %4 万次/秒, "
+                            "异步批量 %5 万条/秒, 异步合并 %6 万条/秒, 加锁参照 %7 万条/秒")
+                        .arg(threadCount)
+                        .arg(snapshot / 10000.0, 0, 'f', 1)
+                        .arg(typed / 10000.0, 0, 'f', 1)
+                        .arg(requests / 10000.0, 0, 'f', 1)
+                        .arg(batched / 10000.0, 0, 'f', 1)
+                        .arg(coalesced / 10000.0, 0, 'f', 1)
+                        .arg(reference / 10000.0, 0, 'f', 1));
+    }
+
+    MessageBus::instance().unsubscribeAll(&receiver);
+    return 0;
+}
@@ -0,0 +1,340 @@
+/**
+ * @file main.cpp
+ * @brief C接口批量操作吞吐量基准测试
+ * @author Developer
+ * @date 2026-10-18
+ * @version 1.0
+ *
+ * @details 在临时数据库（或 --db 指定的数据库）上对比：
+ * - 单条接口：function_dict_add_function / function_dict_function_exists 逐条调用（抽样 --legacy 条）
+ * - 批量插入、批量更新或插入：fd_insert_functions / fd_upsert_functions，每 --batch 条一个事务
+ * - 多线程批量插入、多线程批量检查存在：--threads 个线程共用一个句柄
+ * - 游标读取：按名称前缀（走索引）和按文本搜索（全表扫描）逐行读取全部结果
+ * 示例：
+ * capibench --keys 1000000 --batch 10000 --threads 8
+ */
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QTemporaryDir>
+#include <QThread>
+#include <QVector>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <vector>
+#include "api/function_dict_c_api.h"
+#include "common/logger/logger.h"
+
+namespace
+{
+/**
+ * @brief 一组待写入的函数，fd_function 中的指针指向本组持有的字符串
+ */
+struct FunctionBatch
+{
+    QVector<QByteArray> keys;          ///< 函数名称
+    QVector<QByteArray> filePaths;     ///< 源文件路径
+    QVector<fd_function> functions;    ///< C接口使用的记录
+    QVector<const char*> keyPointers;  ///< 检查存在时使用的函数名称数组
+};
+
+/**
+ * @brief 生成一组函数
+ * @param prefix 函数名称前缀
+ * @param count 数量
+ * @return 函数组
+ */
+std::unique_ptr<FunctionBatch> makeFunctions(const QByteArray& prefix, int count)
+{
+    static const char* const kValue = "基准测试生成的函数介绍";
+
+    std::unique_ptr<FunctionBatch> batch(new FunctionBatch);
+    batch->keys.resize(count);
+    batch->filePaths.resize(count);
+    batch->functions.resize(count);
+    batch->keyPointers.resize(count);
+    for (int i = 0; i < count; ++i)
+    {
+        batch->keys[i] = prefix + QByteArray::number(i);
+        batch->filePaths[i] = "src/bench_" + QByteArray::number(i / 1000) + ".cpp";
+    }
+    for (int i = 0; i < count; ++i)
+    {
+        fd_function& function = batch->functions[i];
+        function.key = batch->keys[i].constData();
+        function.value = kValue;
+        function.signature = nullptr;
+        function.file_path = batch->filePaths[i].constData();
+        function.language = "cpp";
+        function.project_id = 0;
+        function.start_line = i % 1000;
+        function.end_line = i % 1000 + 10;
+        batch->keyPointers[i] = function.key;
+    }
+    return batch;
+}
+
+/**
+ * @brief 按批写入一段函数
+ * @param handle 句柄
+ * @param batch 函数组
+ * @param begin 起始下标
+ * @param end 结束下标（不含）
+ * @param batchSize 每批条数
+ * @param upsert 是否更新已有函数
+ * @return 写入数量，失败时返回-1
+ */
+qint64 writeRange(fd_handle* handle, const FunctionBatch& batch, int begin, int end, int batchSize, bool upsert)
+{
+    qint64 total = 0;
+    for (int offset = begin; offset < end; offset += batchSize)
+    {
+        int count = qMin(batchSize, end - offset);
+        int written = 0;
+        int result = upsert ? fd_upsert_functions(handle, batch.functions.constData() + offset, count, &written)
+                            : fd_insert_functions(handle, batch.functions.constData() + offset, count, &written);
+        if (result != 0)
+        {
+            return -1;
+        }
+        total += written;
+    }
+    return total;
+}
+
+/**
+ * @brief 按批检查一段函数名称是否存在
+ * @param handle 句柄
+ * @param batch 函数组
+ * @param begin 起始下标
+ * @param end 结束下标（不含）
+ * @param batchSize 每批条数
+ * @return 存在的数量，失败时返回-1
+ */
+qint64 existsRange(fd_handle* handle, const FunctionBatch& batch, int begin, int end, int batchSize)
+{
+    std::vector<int> results(batchSize);
+    qint64 found = 0;
+    for (int offset = begin; offset < end; offset += batchSize)
+    {
+        int count = qMin(batchSize, end - offset);
+        if (fd_functions_exist(handle, batch.keyPointers.constData() + offset, count, results.data()) != 0)
+        {
+            return -1;
+        }
+        for (int i = 0; i < count; ++i)
+        {
+            found += results[i];
+        }
+    }
+    return found;
+}
+
+/**
+ * @brief 读完游标并释放
+ * @param handle 句柄
+ * @param prefix 为true时按名称前缀查询，否则按文本搜索
+ * @param text 前缀或搜索文本
+ * @return 读到的行数，失败时返回-1
+ */
+qint64 scanCursor(fd_handle* handle, bool prefix, const char* text)
+{
+    fd_cursor* cursor = nullptr;
+    int result = prefix ? fd_query_by_prefix(handle, text, &cursor) : fd_query_search(handle, text, &cursor);
+    if (result != 0)
+    {
+        return -1;
+    }
+
+    fd_row row;
+    qint64 rows = 0;
+    while ((result = fd_cursor_next(cursor, &row)) == 1)
+    {
+        ++rows;
+    }
+    fd_cursor_close(cursor);
+    return result == 0 ? rows : -1;
+}
+
+/**
+ * @brief 把一段工作平均分给多个线程并汇总结果
+ * @param threadCount 线程数
+ * @param total 总条数
+ * @param work 处理 [begin, end) 并返回结果，失败时返回-1
+ * @return 结果之和，任一线程失败时返回-1
+ */
+qint64 runThreads(int threadCount, int total, const std::function<qint64(int, int)>& work)
+{
+    std::atomic<qint64> sum(0);
+    std::atomic<bool> failed(false);
+    std::vector<std::unique_ptr<QThread>> threads;
+    int perThread = (total + threadCount - 1) / threadCount;
+    for (int t = 0; t < threadCount; ++t)
+    {
+        int begin = qMin(total, t * perThread);
+        int end = qMin(total, begin + perThread);
+        threads.emplace_back(QThread::create(
+            [&, begin, end]()
+            {
+                qint64 result = work(begin, end);
+                if (result < 0)
+                {
+                    failed.store(true);
+                    return;
+                }
+                sum.fetch_add(result);
+            }));
+        threads.back()->start();
+    }
+    for (const std::unique_ptr<QThread>& thread : threads)
+    {
+        thread->wait();
+    }
+    return failed.load() ? -1 : sum.load();
+}
+
+/**
+ * @brief 计算吞吐量（万条/秒）
+ * @param count 条数
+ * @param elapsedNs 耗时（纳秒）
+ * @return 吞吐量
+ */
+double rate(qint64 count, qint64 elapsedNs)
+{
+    return static_cast<double>(count) * 1e9 / qMax<qint64>(1, elapsedNs) / 10000.0;
+}
+}  // namespace
+
+int main(int argc, char* argv[])
+{
+    QCoreApplication app(argc, argv);
+    app.setApplicationName("capibench");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("C接口批量操作吞吐量基准测试");
+    parser.addHelpOption();
+    QCommandLineOption keysOption("keys", "批量操作的函数数量", "count", "1000000");
+    QCommandLineOption batchOption("batch", "每次批量调用的条数", "count", "10000");
+    QCommandLineOption threadsOption("threads", "多线程测试的线程数", "count", QString::number(QThread::idealThreadCount()));
+    QCommandLineOption legacyOption("legacy", "单条接口的抽样条数", "count", "20000");
+    QCommandLineOption dbOption("db", "数据库文件路径（默认使用临时目录）", "path");
+    parser.addOptions({keysOption, batchOption, threadsOption, legacyOption, dbOption});
+    parser.process(app);
+
+    int keyCount = qMax(1, parser.value(keysOption).toInt());
+    int batchSize = qMax(1, parser.value(batchOption).toInt());
+    int threadCount = qMax(1, parser.value(threadsOption).toInt());
+    int legacyCount = qMax(1, parser.value(legacyOption).toInt());
+
+    Logger& logger = Logger::instance();
+    logger.setFileEnabled(false);
+    logger.setMinLevel(Info);
+
+    QTemporaryDir tempDir;
+    QString dbPath = parser.isSet(dbOption) ? parser.value(dbOption) : tempDir.filePath("capibench.db");
+    QByteArray dbPathUtf8 = dbPath.toUtf8();
+    if (function_dict_init(dbPathUtf8.constData()) != 0)
+    {
+        logger.error(QString("初始化数据库失败: %1").arg(QString::fromUtf8(function_dict_get_last_error())));
+        return 1;
+    }
+
+    fd_handle* handle = nullptr;
+    if (fd_open(dbPathUtf8.constData(), &handle) != 0)
+    {
+        logger.error(QString("打开句柄失败: %1").arg(QString::fromUtf8(fd_last_error(handle))));
+        fd_close(handle);
+        return 1;
+    }
+
+    logger.info(QString("C接口基准测试 - 函数数: %1, 每批: %2, 线程数: %3, 单条抽样: %4")
+                    .arg(keyCount)
+                    .arg(batchSize)
+                    .arg(threadCount)
+                    .arg(legacyCount));
+
+    std::unique_ptr<FunctionBatch> legacy = makeFunctions("legacy_func_", legacyCount);
+    std::unique_ptr<FunctionBatch> single = makeFunctions("bench_func_", keyCount);
+    std::unique_ptr<FunctionBatch> concurrent = makeFunctions("concurrent_func_", keyCount);
+    QElapsedTimer timer;
+
+    timer.start();
+    for (int i = 0; i < legacyCount; ++i)
+    {
+        if (function_dict_add_function(legacy->functions[i].key, legacy->functions[i].value) != 0)
+        {
+            logger.error(QString("单条添加失败: %1").arg(QString::fromUtf8(function_dict_get_last_error())));
+            fd_close(handle);
+            return 1;
+        }
+    }
+    double legacyAdd = rate(legacyCount, timer.nsecsElapsed());
+
+    timer.start();
+    int legacyFound = 0;
+    for (int i = 0; i < legacyCount; ++i)
+    {
+        legacyFound += function_dict_function_exists(legacy->functions[i].key);
+    }
+    double legacyExists = rate(legacyCount, timer.nsecsElapsed());
+
+    timer.start();
+    qint64 inserted = writeRange(handle, *single, 0, keyCount, batchSize, false);
+    double bulkInsert = rate(keyCount, timer.nsecsElapsed());
+
+    timer.start();
+    qint64 upserted = writeRange(handle, *single, 0, keyCount, batchSize, true);
+    double bulkUpsert = rate(keyCount, timer.nsecsElapsed());
+
+    timer.start();
+    qint64 concurrentInserted =
+        runThreads(threadCount, keyCount,
+                   [&](int begin, int end) { return writeRange(handle, *concurrent, begin, end, batchSize, false); });
+    double parallelInsert = rate(keyCount, timer.nsecsElapsed());
+
+    timer.start();
+    qint64 found = runThreads(threadCount, keyCount,
+                              [&](int begin, int end) { return existsRange(handle, *single, begin, end, batchSize); });
+    double parallelExists = rate(keyCount, timer.nsecsElapsed());
+
+    timer.start();
+    qint64 prefixRows = scanCursor(handle, true, "bench_func_");
+    double prefixScan = rate(keyCount, timer.nsecsElapsed());
+
+    timer.start();
+    qint64 searchRows = scanCursor(handle, false, "bench_func_");
+    double searchScan = rate(keyCount, timer.nsecsElapsed());
+
+    bool ok = legacyFound == legacyCount && inserted == keyCount && upserted == keyCount &&
+              concurrentInserted == keyCount && found == keyCount && prefixRows == keyCount && searchRows == keyCount;
+    if (!ok)
+    {
+        logger.error(QString("结果不符 - 单条存在: %1, 插入: %2, 更新或插入: %3, 多线程插入: %4, 多线程存在: %5, "
+                             "前缀游标: %6, 搜索游标: %7（期望单条 %8，其余 %9）; 最后错误: %10")
+                         .arg(legacyFound)
+                         .arg(inserted)
+                         .arg(upserted)
+                         .arg(concurrentInserted)
+                         .arg(found)
+                         .arg(prefixRows)
+                         .arg(searchRows)
+                         .arg(legacyCount)
+                         .arg(keyCount)
+                         .arg(QString::fromUtf8(fd_last_error(handle))));
+        fd_close(handle);
+        return 1;
+    }
+
+    logger.info(QString("单条添加 %1 万条/秒, 单条存在 %2 万条/秒").arg(legacyAdd, 0, 'f', 2).arg(legacyExists, 0, 'f', 2));
+    logger.info(QString("批量插入 %1 万条/秒, 批量更新或插入 %2 万条/秒").arg(bulkInsert, 0, 'f', 1).arg(bulkUpsert, 0, 'f', 1));
+    logger.info(QString("多线程批量插入 %1 万条/秒, 多线程批量存在 %2 万条/秒")
+                    .arg(parallelInsert, 0, 'f', 1)
+                    .arg(parallelExists, 0, 'f', 1));
+    logger.info(QString("前缀游标 %1 万行/秒, 搜索游标 %2 万行/秒").arg(prefixScan, 0, 'f', 1).arg(searchScan, 0, 'f', 1));
+
+    fd_close(handle);
+    function_dict_cleanup();
+    return 0;
+}
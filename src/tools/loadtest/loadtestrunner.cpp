@@ -0,0 +1,380 @@
+/**
+ * @file loadtestrunner.cpp
+ * @brief 端到端压测程序实现
+ * @author Developer
+ * @date 2026-10-18
+ * @version 1.0
+ */
+
+#include "tools/loadtest/loadtestrunner.h"
+#include <algorithm>
+#include <cmath>
+#include "common/logger/logger.h"
+#include "core/ai/aiconfigmanager.h"
+#include "core/ai/aiservicemanager.h"
+#include "core/ai/responserecorder.h"
+#include "core/batch/batchprocessmanager.h"
+#include "core/models/errorhandler.h"
+
+namespace
+{
+const char kConfigPrefix[] = "loadtest-";  ///< 压测AI配置名前缀
+const char kApiKey[] = "loadtest-key";     ///< 压测使用的API密钥（模拟服务不校验）
+}  // namespace
+
+LoadTestRunner::LoadTestRunner(const LoadTestOptions& options, QObject* parent)
+    : QObject(parent),
+      m_options(options),
+      m_deadlineTimer(new QTimer(this)),
+      m_responses(0),
+      m_succeeded(0),
+      m_failed(0),
+      m_promptTokens(0),
+      m_completionTokens(0),
+      m_breaker(nullptr),
+      m_rejectedAtStart(0),
+      m_recoveryMs(-1),
+      m_done(false)
+{
+    m_deadlineTimer->setSingleShot(true);
+    connect(m_deadlineTimer, &QTimer::timeout, this, &LoadTestRunner::onDeadline);
+}
+
+bool LoadTestRunner::start()
+{
+    if (m_options.mode != "batch" && m_options.mode != "service")
+    {
+        Logger::instance().error("未知的压测模式: " + m_options.mode);
+        return false;
+    }
+
+    QStringList configNames = setupConfigs();
+    if (configNames.isEmpty())
+    {
+        Logger::instance().error("没有可用的AI服务地址");
+        return false;
+    }
+
+    if (!m_options.replayFile.isEmpty())
+    {
+        if (!ResponseRecorder::instance().startReplay(m_options.replayFile, m_options.replaySpeed))
+        {
+            return false;
+        }
+    }
+    else if (!m_options.recordFile.isEmpty())
+    {
+        if (!ResponseRecorder::instance().startRecording(m_options.recordFile))
+        {
+            return false;
+        }
+    }
+
+    AIServiceManager& aiService = AIServiceManager::instance();
+    aiService.setRateLimit(m_options.requestsPerMinute);
+    aiService.setTokenRateLimit(m_options.tokensPerMinute);
+    aiService.setMaxConcurrentRequests(m_options.concurrency);
+    aiService.setTimeout(m_options.timeoutMs);
+    aiService.setHedging(m_options.hedgeBudgetPercent > 0, m_options.hedgeBudgetPercent);
+    aiService.setEndpointPool(configNames.size() > 1 ? configNames : QStringList());
+
+    connect(&aiService, &AIServiceManager::functionAnalysisComplete, this, &LoadTestRunner::onAnalysisComplete);
+
+    QVector<ExtractedFunction> functions = generateFunctions();
+
+    Logger::instance().info(QString("压测开始: 模式 %1, 函数 %2 (重复比例 %3), 端点 %4, 并发 %5, RPM %6, TPM %7")
+                                .arg(m_options.mode)
+                                .arg(functions.size())
+                                .arg(m_options.duplicateRatio)
+                                .arg(configNames.size())
+                                .arg(m_options.concurrency)
+                                .arg(m_options.requestsPerMinute)
+                                .arg(m_options.tokensPerMinute));
+
+    m_clock.start();
+    m_deadlineTimer->start(m_options.deadlineSec * 1000);
+
+    if (m_options.mode == "batch")
+    {
+        BatchProcessManager& batch = BatchProcessManager::instance();
+        connect(&batch, &BatchProcessManager::batchCompleted, this, &LoadTestRunner::onBatchCompleted);
+
+        // 与BatchProcessManager取同一个端点熔断器，记录故障期间的状态变化和短路请求数
+        m_breaker = ErrorHandler::instance().circuitBreaker(AIConfigManager::instance().getCurrentConfig().baseUrl);
+        m_rejectedAtStart = m_breaker->rejectedCount();
+        connect(m_breaker, &CircuitBreaker::stateChanged, this, &LoadTestRunner::onBreakerStateChanged,
+                Qt::DirectConnection);
+
+        BatchProcessConfig config = batch.getConfig();
+        config.maxConcurrentRequests = m_options.concurrency;
+        config.requestTimeout = m_options.timeoutMs;
+        config.requestInterval = m_options.requestInterval;
+        config.skipExisting = false;
+        config.enableCheckpoint = false;
+        batch.setConfig(config);
+        batch.startBatchProcessing(functions);
+    }
+    else
+    {
+        aiService.analyzeFunctions(functions);
+    }
+
+    return true;
+}
+
+void LoadTestRunner::onAnalysisComplete(const AIAnalysisResponse& response)
+{
+    if (m_done)
+    {
+        return;
+    }
+
+    m_responses++;
+    m_promptTokens += response.promptTokens;
+    m_completionTokens += response.completionTokens;
+
+    if (response.success)
+    {
+        m_succeeded++;
+        m_latencies.append(response.responseTime);
+
+        qint64 outageEnd = static_cast<qint64>(m_options.outageAfterMs) + m_options.outageDurationMs;
+        if (m_options.outageAfterMs >= 0 && m_recoveryMs < 0 && m_clock.elapsed() >= outageEnd)
+        {
+            m_recoveryMs = m_clock.elapsed() - outageEnd;
+        }
+    }
+    else
+    {
+        m_failed++;
+        m_errors[response.errorMessage]++;
+    }
+
+    // service模式下每个函数只产生一次响应，batch模式以批量完成信号为准
+    if (m_options.mode == "service" && m_responses >= m_options.functionCount)
+    {
+        report(false);
+    }
+}
+
+void LoadTestRunner::onBatchCompleted(int successCount, int failedCount, int skippedCount)
+{
+    Logger::instance().info(
+        QString("批量处理完成: 成功 %1, 失败 %2, 跳过 %3").arg(successCount).arg(failedCount).arg(skippedCount));
+    report(false);
+}
+
+void LoadTestRunner::onDeadline()
+{
+    Logger::instance().warning(QString("压测超过最长运行时间 %1 秒，提前结束").arg(m_options.deadlineSec));
+    if (m_options.mode == "batch")
+    {
+        BatchProcessManager::instance().cancelProcessing();
+    }
+    AIServiceManager::instance().cancelAllRequests();
+    report(true);
+}
+
+void LoadTestRunner::onBreakerStateChanged(CircuitState oldState, CircuitState newState)
+{
+    if (m_done)
+    {
+        return;
+    }
+
+    m_transitions.append({m_clock.elapsed(), oldState, newState});
+}
+
+QStringList LoadTestRunner::setupConfigs() const
+{
+    AIConfigManager& configManager = AIConfigManager::instance();
+
+    for (const QString& name : configManager.getAllConfigNames())
+    {
+        if (name.startsWith(kConfigPrefix))
+        {
+            configManager.deleteConfig(name);
+        }
+    }
+
+    QStringList configNames;
+    for (int i = 0; i < m_options.baseUrls.size(); ++i)
+    {
+        AIConfig config;
+        config.configName = QString("%1%2").arg(kConfigPrefix).arg(i);
+        config.provider = "OpenAI Compatible";
+        config.baseUrl = m_options.baseUrls[i];
+        config.apiKey = kApiKey;
+        config.defaultModel = m_options.model;
+        config.modelList = QStringList{m_options.model};
+        config.requestsPerMinute = m_options.requestsPerMinute;
+        config.tokensPerMinute = m_options.tokensPerMinute;
+        config.maxConcurrent = m_options.concurrency;
+
+        configManager.saveConfig(config.configName, config);
+        configNames.append(config.configName);
+    }
+
+    if (!configNames.isEmpty())
+    {
+        configManager.setCurrentConfig(configNames.first());
+    }
+
+    return configNames;
+}
+
+QVector<ExtractedFunction> LoadTestRunner::generateFunctions() const
+{
+    QVector<ExtractedFunction> functions;
+    functions.reserve(m_options.functionCount);
+
+    double uniqueRatio = 1.0 - qBound(0.0, m_options.duplicateRatio, 1.0);
+    int uniqueCount = qMax(1, static_cast<int>(std::lround(m_options.functionCount * uniqueRatio)));
+
+    for (int i = 0; i < m_options.functionCount; ++i)
+    {
+        // 超出唯一数量的函数是前面函数在其他文件中的副本（签名和函数体相同，只有位置不同）
+        int variant = i % uniqueCount;
+
+        ExtractedFunction func;
+        func.name = QString("load_func_%1").arg(variant);
+        func.returnType = "int";
+        func.signature = QString("int %1(int value, const char* label)").arg(func.name);
+        func.language = "c";
+        func.filePath = QString("loadtest/file_%1.c").arg(i / 50);
+        func.startLine = (i % 50) * (m_options.bodyLines + 3) + 1;
+        func.endLine = func.startLine + m_options.bodyLines + 2;
+
+        QString body = "{\n    int total = value;\n";
+        for (int line = 0; line < m_options.bodyLines; ++line)
+        {
+            body += QString("    total = total * %1 + %2; /* %3 */\n").arg(variant + 3).arg(line).arg(variant);
+        }
+        body += "    return total;\n}";
+        func.body = body;
+
+        ParameterInfo value;
+        value.name = "value";
+        value.type = "int";
+        ParameterInfo label;
+        label.name = "label";
+        label.type = "const char*";
+        func.parameters = {value, label};
+
+        functions.append(func);
+    }
+
+    return functions;
+}
+
+void LoadTestRunner::report(bool timedOut)
+{
+    if (m_done)
+    {
+        return;
+    }
+    m_done = true;
+    m_deadlineTimer->stop();
+    ResponseRecorder::instance().stop();
+
+    qint64 elapsed = qMax<qint64>(1, m_clock.elapsed());
+    std::sort(m_latencies.begin(), m_latencies.end());
+
+    Logger::instance().info("========== 压测报告 ==========");
+    Logger::instance().info(QString("模式: %1, 总耗时: %2 ms").arg(m_options.mode).arg(elapsed));
+    Logger::instance().info(QString("响应: %1 (成功 %2, 失败 %3)").arg(m_responses).arg(m_succeeded).arg(m_failed));
+    Logger::instance().info(QString("吞吐: %1 函数/秒").arg(m_succeeded * 1000.0 / elapsed, 0, 'f', 2));
+    Logger::instance().info(QString("token: 发送 %1 / 接收 %2，%3 token/分钟")
+                                .arg(m_promptTokens)
+                                .arg(m_completionTokens)
+                                .arg((m_promptTokens + m_completionTokens) * 60000.0 / elapsed, 0, 'f', 0));
+
+    if (!m_latencies.isEmpty())
+    {
+        Logger::instance().info(QString("延迟(ms): p50 %1, p90 %2, p95 %3, p99 %4, max %5")
+                                    .arg(percentileOf(m_latencies, 50))
+                                    .arg(percentileOf(m_latencies, 90))
+                                    .arg(percentileOf(m_latencies, 95))
+                                    .arg(percentileOf(m_latencies, 99))
+                                    .arg(m_latencies.last()));
+    }
+
+    for (auto it = m_errors.constBegin(); it != m_errors.constEnd(); ++it)
+    {
+        Logger::instance().warning(QString("错误 x%1: %2").arg(it.value()).arg(it.key()));
+    }
+
+    reportBreaker();
+
+    int exitCode = (timedOut || m_succeeded < m_options.functionCount) ? 1 : 0;
+    emit finished(exitCode);
+}
+
+void LoadTestRunner::reportBreaker()
+{
+    if (m_options.outageAfterMs >= 0)
+    {
+        Logger::instance().info(QString("故障窗口: %1 ms 开始, 持续 %2 ms, %3 ms 结束")
+                                    .arg(m_options.outageAfterMs)
+                                    .arg(m_options.outageDurationMs)
+                                    .arg(m_options.outageAfterMs + m_options.outageDurationMs));
+        if (m_recoveryMs >= 0)
+        {
+            Logger::instance().info(QString("故障结束到首次成功: %1 ms").arg(m_recoveryMs));
+        }
+        else
+        {
+            Logger::instance().warning("故障结束后没有成功的请求");
+        }
+    }
+
+    if (!m_breaker)
+    {
+        return;
+    }
+
+    int opened = 0;
+    int halfOpened = 0;
+    int closed = 0;
+    for (const BreakerTransition& transition : m_transitions)
+    {
+        switch (transition.newState)
+        {
+            case CircuitState::Open:
+                opened++;
+                break;
+            case CircuitState::HalfOpen:
+                halfOpened++;
+                break;
+            case CircuitState::Closed:
+                closed++;
+                break;
+        }
+    }
+
+    Logger::instance().info(QString("熔断器: 打开 %1 次, 半开 %2 次, 关闭 %3 次, 短路请求 %4, 结束时%5")
+                                .arg(opened)
+                                .arg(halfOpened)
+                                .arg(closed)
+                                .arg(m_breaker->rejectedCount() - m_rejectedAtStart)
+                                .arg(CircuitBreaker::stateToString(m_breaker->state())));
+
+    for (const BreakerTransition& transition : m_transitions)
+    {
+        Logger::instance().info(QString("  %1 ms: %2 -> %3")
+                                    .arg(transition.elapsedMs)
+                                    .arg(CircuitBreaker::stateToString(transition.oldState))
+                                    .arg(CircuitBreaker::stateToString(transition.newState)));
+    }
+}
+
+qint64 LoadTestRunner::percentileOf(const QVector<qint64>& sorted, double percentile)
+{
+    if (sorted.isEmpty())
+    {
+        return 0;
+    }
+
+    int rank = static_cast<int>(std::ceil(percentile / 100.0 * sorted.size())) - 1;
+    return sorted[qBound(0, rank, static_cast<int>(sorted.size()) - 1)];
+}
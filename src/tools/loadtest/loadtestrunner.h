@@ -0,0 +1,169 @@
+/**
+ * @file loadtestrunner.h
+ * @brief 端到端压测程序，驱动批量分析流水线并统计吞吐和延迟分位数
+ * @author Developer
+ * @date 2026-10-18
+ * @version 1.0
+ *
+ * @details 压测模式：
+ * - batch：通过BatchProcessManager走完整的批量处理流程（重试、熔断、断点续传关闭）
+ * - service：直接调用AIServiceManager::analyzeFunctions，测量请求队列本身的并发吞吐
+ * 压测使用可执行文件目录下独立的AI配置文件，不会影响主程序的配置。
+ * 录制一次真实服务的响应后，用 --replay 回放可得到不受服务端延迟波动影响的基准，
+ * 回放速度为0时只剩SSE解析、JSON解码等本地CPU开销。
+ */
+
+#ifndef LOADTESTRUNNER_H
+#define LOADTESTRUNNER_H
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QTimer>
+#include <QVector>
+#include "core/models/batchconfig.h"
+#include "core/models/circuitbreaker.h"
+#include "core/models/extractedfunction.h"
+
+/**
+ * @brief 压测配置
+ */
+struct LoadTestOptions
+{
+    QString mode = "batch";        ///< 压测模式（batch 或 service）
+    QStringList baseUrls;          ///< AI服务地址列表，多于一个时启用端点池
+    QString model = "mock-model";  ///< 使用的模型
+    int functionCount = 200;       ///< 合成函数数量
+    double duplicateRatio = 0.0;   ///< 函数体重复的比例（0-1），用于观察请求合并
+    int bodyLines = 30;            ///< 合成函数体行数
+    int concurrency = 4;           ///< 最大并发请求数
+    int requestsPerMinute = 600;   ///< 每分钟请求数上限
+    int tokensPerMinute = 0;       ///< 每分钟token数上限（0表示不限制）
+    int requestInterval = 0;       ///< batch模式的请求间隔（毫秒）
+    int hedgeBudgetPercent = 0;    ///< 对冲预算（百分比，0表示关闭）
+    int timeoutMs = 60000;         ///< 单个请求超时时间（毫秒）
+    int deadlineSec = 600;         ///< 压测最长运行时间（秒）
+    QString recordFile;            ///< AI响应录制文件（为空时不录制）
+    QString replayFile;            ///< AI响应回放文件（为空时访问真实服务）
+    double replaySpeed = 1.0;      ///< 回放速度倍数（0表示不等待）
+    int outageAfterMs = -1;        ///< 模拟服务故障窗口的开始时间（从压测开始计，毫秒，-1表示未设置）
+    int outageDurationMs = 0;      ///< 模拟服务故障窗口的持续时间（毫秒）
+};
+
+/**
+ * @brief 熔断器状态变化记录
+ */
+struct BreakerTransition
+{
+    qint64 elapsedMs;       ///< 发生时间（从压测开始计，毫秒）
+    CircuitState oldState;  ///< 原状态
+    CircuitState newState;  ///< 新状态
+};
+
+/**
+ * @brief 压测执行类
+ */
+class LoadTestRunner : public QObject
+{
+    Q_OBJECT
+
+   public:
+    /**
+     * @brief 构造函数
+     * @param options 压测配置
+     * @param parent 父对象
+     */
+    explicit LoadTestRunner(const LoadTestOptions& options, QObject* parent = nullptr);
+
+    /**
+     * @brief 配置AI服务并开始压测
+     * @return 是否成功开始
+     */
+    bool start();
+
+   signals:
+    /**
+     * @brief 压测结束信号
+     * @param exitCode 退出码（有失败请求或超时时非0）
+     */
+    void finished(int exitCode);
+
+   private slots:
+    /**
+     * @brief 单个函数分析完成槽函数
+     * @param response 分析响应
+     */
+    void onAnalysisComplete(const AIAnalysisResponse& response);
+
+    /**
+     * @brief 批量处理完成槽函数
+     * @param successCount 成功数
+     * @param failedCount 失败数
+     * @param skippedCount 跳过数
+     */
+    void onBatchCompleted(int successCount, int failedCount, int skippedCount);
+
+    /**
+     * @brief 超时槽函数
+     */
+    void onDeadline();
+
+    /**
+     * @brief 熔断器状态变化槽函数（在熔断器持锁时直接调用，只记录不回调熔断器）
+     * @param oldState 原状态
+     * @param newState 新状态
+     */
+    void onBreakerStateChanged(CircuitState oldState, CircuitState newState);
+
+   private:
+    /**
+     * @brief 保存压测使用的AI配置
+     * @return 配置名称列表
+     */
+    QStringList setupConfigs() const;
+
+    /**
+     * @brief 生成合成函数
+     * @return 函数列表
+     */
+    QVector<ExtractedFunction> generateFunctions() const;
+
+    /**
+     * @brief 输出压测报告并结束
+     * @param timedOut 是否因超时结束
+     */
+    void report(bool timedOut);
+
+    /**
+     * @brief 输出熔断器状态变化、短路请求数和故障恢复时间
+     */
+    void reportBreaker();
+
+    /**
+     * @brief 计算分位数
+     * @param sorted 已排序的样本
+     * @param percentile 分位（0-100）
+     * @return 分位数值
+     */
+    static qint64 percentileOf(const QVector<qint64>& sorted, double percentile);
+
+    LoadTestOptions m_options;                 ///< 压测配置
+    QElapsedTimer m_clock;                     ///< 压测计时
+    QTimer* m_deadlineTimer;                   ///< 超时定时器
+    QVector<qint64> m_latencies;               ///< 成功请求的响应时间（毫秒）
+    QHash<QString, int> m_errors;              ///< 各类错误信息的出现次数
+    int m_responses;                           ///< 收到的响应数（含重试前的失败）
+    int m_succeeded;                           ///< 成功响应数
+    int m_failed;                              ///< 失败响应数
+    qint64 m_promptTokens;                     ///< 累计提示词token数
+    qint64 m_completionTokens;                 ///< 累计输出token数
+    CircuitBreaker* m_breaker;                 ///< batch模式使用的熔断器（service模式为空）
+    qint64 m_rejectedAtStart;                  ///< 压测开始时熔断器已拒绝的请求数
+    QVector<BreakerTransition> m_transitions;  ///< 熔断器状态变化记录
+    qint64 m_recoveryMs;                       ///< 故障窗口结束到首次成功的时间（毫秒，-1表示尚未成功）
+    bool m_done;                               ///< 是否已结束
+};
+
+#endif  // LOADTESTRUNNER_H
@@ -0,0 +1,112 @@
+/**
+ * @file main.cpp
+ * @brief 端到端压测程序入口
+ * @author Developer
+ * @date 2026-10-18
+ * @version 1.0
+ *
+ * @details 示例（先启动 mockaiserver）：
+ * loadtest --mode batch --functions 500 --concurrency 8 --base-url http://127.0.0.1:8089/v1
+ * 指定多个 --base-url 时启用端点池，--hedge-budget 大于0时启用对冲请求。
+ * --record 录制本次运行的AI响应，之后用 --replay（配合 --replay-speed）可重复得到相同的响应序列。
+ * --binary-log 把日志写为结构化二进制文件（不输出控制台），用 logdecoder 解码。
+ * 配合 mockaiserver --outage-after/--outage-duration 测试熔断恢复时，两边传入相同的故障窗口并同时启动，
+ * 报告中会列出熔断器状态变化、短路请求数和故障结束到首次成功的时间。
+ */
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include "common/logger/logger.h"
+#include "tools/loadtest/loadtestrunner.h"
+
+int main(int argc, char* argv[])
+{
+    QCoreApplication app(argc, argv);
+    app.setApplicationName("loadtest");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("AI分析流水线端到端压测");
+    parser.addHelpOption();
+
+    LoadTestOptions defaults;
+    QCommandLineOption modeOption("mode", "压测模式（batch 或 service）", "mode", defaults.mode);
+    QCommandLineOption baseUrlOption("base-url", "AI服务地址，可重复指定以启用端点池", "url");
+    QCommandLineOption modelOption("model", "使用的模型", "model", defaults.model);
+    QCommandLineOption functionsOption("functions", "合成函数数量", "count", QString::number(defaults.functionCount));
+    QCommandLineOption duplicateOption("duplicate-ratio", "函数体重复的比例（0-1）", "ratio",
+                                       QString::number(defaults.duplicateRatio));
+    QCommandLineOption bodyLinesOption("body-lines", "合成函数体行数", "lines", QString::number(defaults.bodyLines));
+    QCommandLineOption concurrencyOption("concurrency", "最大并发请求数", "count",
+                                         QString::number(defaults.concurrency));
+    QCommandLineOption rpmOption("rpm", "每分钟请求数上限", "rpm", QString::number(defaults.requestsPerMinute));
+    QCommandLineOption tpmOption("tpm", "每分钟token数上限（0表示不限制）", "tpm",
+                                 QString::number(defaults.tokensPerMinute));
+    QCommandLineOption intervalOption("interval", "batch模式的请求间隔（毫秒）", "ms",
+                                      QString::number(defaults.requestInterval));
+    QCommandLineOption hedgeOption("hedge-budget", "对冲预算（百分比，0表示关闭）", "percent",
+                                   QString::number(defaults.hedgeBudgetPercent));
+    QCommandLineOption timeoutOption("timeout", "单个请求超时时间（毫秒）", "ms", QString::number(defaults.timeoutMs));
+    QCommandLineOption deadlineOption("deadline", "压测最长运行时间（秒）", "sec",
+                                      QString::number(defaults.deadlineSec));
+    QCommandLineOption recordOption("record", "录制AI响应到文件", "file");
+    QCommandLineOption replayOption("replay", "从文件回放AI响应，不访问真实服务", "file");
+    QCommandLineOption replaySpeedOption("replay-speed", "回放速度倍数（0表示不等待）", "speed",
+                                         QString::number(defaults.replaySpeed));
+    QCommandLineOption outageAfterOption("outage-after", "模拟服务故障窗口的开始时间（从压测开始计，毫秒），用于报告恢复时间",
+                                         "ms", QString::number(defaults.outageAfterMs));
+    QCommandLineOption outageDurationOption("outage-duration", "模拟服务故障窗口的持续时间（毫秒）", "ms",
+                                            QString::number(defaults.outageDurationMs));
+    QCommandLineOption binaryLogOption("binary-log", "把日志写入结构化二进制文件，不输出到控制台", "file");
+
+    parser.addOptions({modeOption, baseUrlOption, modelOption, functionsOption, duplicateOption, bodyLinesOption,
+                       concurrencyOption, rpmOption, tpmOption, intervalOption, hedgeOption, timeoutOption,
+                       deadlineOption, recordOption, replayOption, replaySpeedOption, outageAfterOption,
+                       outageDurationOption, binaryLogOption});
+    parser.process(app);
+
+    LoadTestOptions options;
+    options.mode = parser.value(modeOption);
+    options.baseUrls = parser.values(baseUrlOption);
+    if (options.baseUrls.isEmpty())
+    {
+        options.baseUrls.append("http://127.0.0.1:8089/v1");
+    }
+    options.model = parser.value(modelOption);
+    options.functionCount = qMax(1, parser.value(functionsOption).toInt());
+    options.duplicateRatio = parser.value(duplicateOption).toDouble();
+    options.bodyLines = qMax(1, parser.value(bodyLinesOption).toInt());
+    options.concurrency = qMax(1, parser.value(concurrencyOption).toInt());
+    options.requestsPerMinute = parser.value(rpmOption).toInt();
+    options.tokensPerMinute = parser.value(tpmOption).toInt();
+    options.requestInterval = parser.value(intervalOption).toInt();
+    options.hedgeBudgetPercent = parser.value(hedgeOption).toInt();
+    options.timeoutMs = parser.value(timeoutOption).toInt();
+    options.deadlineSec = qMax(1, parser.value(deadlineOption).toInt());
+    options.recordFile = parser.value(recordOption);
+    options.replayFile = parser.value(replayOption);
+    options.replaySpeed = parser.value(replaySpeedOption).toDouble();
+    options.outageAfterMs = parser.value(outageAfterOption).toInt();
+    options.outageDurationMs = parser.value(outageDurationOption).toInt();
+
+    Logger::instance().setFileEnabled(false);
+    // 压测时每个请求都会记录日志，同步写控制台会计入请求耗时
+    Logger::instance().setAsyncEnabled(true);
+    if (parser.isSet(binaryLogOption))
+    {
+        if (!Logger::instance().setBinaryLog(parser.value(binaryLogOption)))
+        {
+            return 1;
+        }
+        Logger::instance().setConsoleEnabled(false);
+    }
+
+    LoadTestRunner runner(options);
+    QObject::connect(&runner, &LoadTestRunner::finished, &app, [](int exitCode) { QCoreApplication::exit(exitCode); });
+
+    if (!runner.start())
+    {
+        return 1;
+    }
+
+    return app.exec();
+}
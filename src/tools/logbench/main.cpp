@@ -0,0 +1,130 @@
+/**
+ * @file main.cpp
+ * @brief 日志开销微基准测试
+ * @author Developer
+ * @date 2026-10-18
+ * @version 1.0
+ *
+ * @details 比较被级别过滤的日志在两种写法下的每次调用耗时：
+ * - 先拼接字符串再调用 Logger::debug（过滤前已经付出格式化和分配的开销）
+ * - 使用 LOG_DEBUG 宏（先检查级别，参数不求值）
+ * 另外给出空循环基线和异步模式下实际写出一条日志的耗时作为参照，
+ * 并比较同步写文本日志文件和结构化二进制日志的每次耗时与文件大小。示例：
+ * logbench --iterations 2000000
+ */
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QTemporaryDir>
+#include <functional>
+#include "common/logger/logger.h"
+
+namespace
+{
+volatile int g_sink = 0;  ///< 防止循环被优化掉
+
+/**
+ * @brief 运行一个用例并返回每次调用的平均耗时
+ * @param iterations 迭代次数
+ * @param body 循环体
+ * @return 平均耗时（纳秒）
+ */
+double measure(int iterations, const std::function<void(int)>& body)
+{
+    QElapsedTimer timer;
+    timer.start();
+    for (int i = 0; i < iterations; ++i)
+    {
+        body(i);
+    }
+    return static_cast<double>(timer.nsecsElapsed()) / iterations;
+}
+}  // namespace
+
+int main(int argc, char* argv[])
+{
+    QCoreApplication app(argc, argv);
+    app.setApplicationName("logbench");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("日志开销微基准测试");
+    parser.addHelpOption();
+    QCommandLineOption iterationsOption("iterations", "每个用例的迭代次数", "count", "1000000");
+    parser.addOption(iterationsOption);
+    parser.process(app);
+
+    int iterations = qMax(1, parser.value(iterationsOption).toInt());
+    QString sender = "FunctionalityWidget";
+
+    Logger& logger = Logger::instance();
+    logger.setFileEnabled(false);
+    logger.setConsoleEnabled(false);
+    logger.setMinLevel(Info);
+
+    double baseline = measure(iterations, [](int i) { g_sink = i; });
+
+    double eagerDisabled = measure(iterations,
+                                   [&logger, &sender](int i)
+                                   {
+                                       g_sink = i;
+                                       logger.debug(QString("发布消息(同步) - 类型: %1, 发送者: %2").arg(i).arg(sender));
+                                   });
+
+    double lazyDisabled = measure(iterations,
+                                  [&sender](int i)
+                                  {
+                                      g_sink = i;
+                                      LOG_DEBUG("发布消息(同步) - 类型: %1, 发送者: %2", i, sender);
+                                  });
+
+    // 实际写出的日志走异步后台线程，控制台和文件均关闭，只计格式化和入队
+    logger.setAsyncEnabled(true);
+    double lazyEnabledAsync = measure(iterations,
+                                      [&sender](int i)
+                                      {
+                                          g_sink = i;
+                                          LOG_INFO("发布消息(同步) - 类型: %1, 发送者: %2", i, sender);
+                                      });
+    logger.setAsyncEnabled(false);
+
+    // 同步写出，耗时包含格式化和文件写入
+    QTemporaryDir tempDir;
+    QString textPath = tempDir.filePath("logbench.log");
+    QString binaryPath = tempDir.filePath("logbench.bin");
+    logger.init(textPath);
+    double textFile = measure(iterations,
+                              [&sender](int i)
+                              {
+                                  g_sink = i;
+                                  LOG_INFO("发布消息(同步) - 类型: %1, 发送者: %2", i, sender);
+                              });
+    logger.setFileEnabled(false);
+
+    BinaryLogOptions binaryOptions;
+    binaryOptions.maxFileBytes = 0;
+    logger.setBinaryLog(binaryPath, binaryOptions);
+    double binaryFile = measure(iterations,
+                                [&sender](int i)
+                                {
+                                    g_sink = i;
+                                    LOG_INFO("发布消息(同步) - 类型: %1, 发送者: %2", i, sender);
+                                });
+    logger.closeBinaryLog();
+
+    logger.setConsoleEnabled(true);
+    logger.info(QString("日志基准测试 - 迭代次数: %1, 编译期下限: %2").arg(iterations).arg(CODEATLAS_LOG_FLOOR));
+    logger.info(QString("空循环基线: %1 ns/次").arg(baseline, 0, 'f', 2));
+    logger.info(QString("被过滤的日志（先拼接再调用）: %1 ns/次").arg(eagerDisabled, 0, 'f', 2));
+    logger.info(QString("被过滤的日志（LOG_DEBUG 宏）: %1 ns/次").arg(lazyDisabled, 0, 'f', 2));
+    logger.info(QString("写出的日志（LOG_INFO 宏，异步）: %1 ns/次").arg(lazyEnabledAsync, 0, 'f', 2));
+    logger.info(QString("文本日志文件（同步）: %1 ns/次, 文件大小: %2 字节")
+                    .arg(textFile, 0, 'f', 2)
+                    .arg(QFileInfo(textPath).size()));
+    logger.info(QString("二进制日志文件（同步）: %1 ns/次, 文件大小: %2 字节")
+                    .arg(binaryFile, 0, 'f', 2)
+                    .arg(QFileInfo(binaryPath).size()));
+
+    return 0;
+}
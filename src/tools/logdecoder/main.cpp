@@ -0,0 +1,138 @@
+/**
+ * @file main.cpp
+ * @brief 结构化二进制日志离线解码工具
+ * @author Developer
+ * @date 2026-10-18
+ * @version 1.0
+ *
+ * @details 把 Logger::setBinaryLog 写出的文件解码为文本或JSON行，输出到标准输出。
+ * 按给出的顺序解码多个文件，轮转出的 .z 文件自动解压。示例：
+ * logdecoder codeatlas.bin.2.z codeatlas.bin.1.z codeatlas.bin
+ * logdecoder --format json codeatlas.bin
+ */
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTextStream>
+#include <iostream>
+#include "common/logger/binarylog.h"
+
+namespace
+{
+/**
+ * @brief 把日志参数转换为JSON值
+ * @param arg 日志参数
+ * @return JSON值
+ */
+QJsonValue argToJson(const LogArg& arg)
+{
+    switch (arg.type)
+    {
+        case LogArg::Type::Integer:
+            return QJsonValue(arg.integer);
+        case LogArg::Type::Real:
+            return QJsonValue(arg.real);
+        case LogArg::Type::Text:
+            return QJsonValue(arg.text);
+    }
+    return QJsonValue();
+}
+
+/**
+ * @brief 把一条日志格式化为与文本日志相同的行（附带线程）
+ * @param entry 日志
+ * @return 文本行
+ */
+QString entryToText(const BinaryLogEntry& entry)
+{
+    QString timestamp = QDateTime::fromMSecsSinceEpoch(entry.epochMs).toString("yyyy-MM-dd HH:mm:ss.zzz");
+    QString thread = entry.threadName.isEmpty() ? QString::number(entry.threadId)
+                                                : QString("%1:%2").arg(entry.threadId).arg(entry.threadName);
+    return QString("[%1] [%2] [%3] %4").arg(timestamp, QString(logLevelName(entry.level)), thread, entry.text());
+}
+
+/**
+ * @brief 把一条日志格式化为单行JSON
+ * @param entry 日志
+ * @return JSON行
+ */
+QString entryToJson(const BinaryLogEntry& entry)
+{
+    QJsonObject object;
+    object["time"] = QDateTime::fromMSecsSinceEpoch(entry.epochMs).toString(Qt::ISODateWithMs);
+    object["monotonicNs"] = entry.monotonicNs;
+    object["level"] = logLevelName(entry.level);
+    object["threadId"] = static_cast<qint64>(entry.threadId);
+    object["threadName"] = entry.threadName;
+    object["message"] = entry.text();
+    if (!entry.format.isEmpty())
+    {
+        QJsonArray args;
+        for (const LogArg& arg : entry.args)
+        {
+            args.append(argToJson(arg));
+        }
+        object["format"] = entry.format;
+        object["args"] = args;
+    }
+    return QString::fromUtf8(QJsonDocument(object).toJson(QJsonDocument::Compact));
+}
+}  // namespace
+
+int main(int argc, char* argv[])
+{
+    QCoreApplication app(argc, argv);
+    app.setApplicationName("logdecoder");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("结构化二进制日志离线解码");
+    parser.addHelpOption();
+    QCommandLineOption formatOption("format", "输出格式（text 或 json）", "format", "text");
+    parser.addOption(formatOption);
+    parser.addPositionalArgument("files", "二进制日志文件（按给出的顺序解码）", "files...");
+    parser.process(app);
+
+    QString format = parser.value(formatOption);
+    if (format != "text" && format != "json")
+    {
+        std::cerr << "不支持的输出格式: " << format.toStdString() << std::endl;
+        return 1;
+    }
+    QStringList files = parser.positionalArguments();
+    if (files.isEmpty())
+    {
+        parser.showHelp(1);
+    }
+
+    QTextStream out(stdout);
+    bool json = (format == "json");
+    int exitCode = 0;
+    for (const QString& path : files)
+    {
+        BinaryLogReader reader;
+        if (!reader.open(path))
+        {
+            std::cerr << "无法读取 " << path.toStdString() << ": " << reader.lastError().toStdString() << std::endl;
+            exitCode = 1;
+            continue;
+        }
+
+        BinaryLogEntry entry;
+        while (reader.readNext(entry))
+        {
+            out << (json ? entryToJson(entry) : entryToText(entry)) << "\n";
+        }
+        if (!reader.lastError().isEmpty())
+        {
+            std::cerr << path.toStdString() << ": " << reader.lastError().toStdString() << std::endl;
+            exitCode = 1;
+        }
+    }
+    out.flush();
+
+    return exitCode;
+}
@@ -0,0 +1,83 @@
+/**
+ * @file main.cpp
+ * @brief 本地模拟AI服务入口
+ * @author Developer
+ * @date 2026-10-18
+ * @version 1.0
+ *
+ * @details 示例：
+ * mockaiserver --port 8089 --latency 800 --sigma 0.6 --tail-rate 0.02 --rate-429 0.05
+ * 在AI配置中将基础URL设为 http://127.0.0.1:8089/v1，模型设为 mock-model 即可使用。
+ */
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QTimer>
+#include "common/logger/logger.h"
+#include "tools/mockaiserver/mockaiserver.h"
+
+int main(int argc, char* argv[])
+{
+    QCoreApplication app(argc, argv);
+    app.setApplicationName("mockaiserver");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("本地模拟的OpenAI兼容AI服务");
+    parser.addHelpOption();
+
+    MockServerOptions defaults;
+    QCommandLineOption portOption("port", "监听端口", "port", QString::number(defaults.port));
+    QCommandLineOption latencyOption("latency", "首字节延迟中位数（毫秒）", "ms",
+                                     QString::number(defaults.latencyMedianMs));
+    QCommandLineOption sigmaOption("sigma", "延迟对数正态分布的sigma", "sigma", QString::number(defaults.latencySigma));
+    QCommandLineOption tailRateOption("tail-rate", "长尾请求比例（0-1）", "rate", QString::number(defaults.tailRate));
+    QCommandLineOption tailLatencyOption("tail-latency", "长尾请求延迟（毫秒）", "ms",
+                                         QString::number(defaults.tailLatencyMs));
+    QCommandLineOption tokenRateOption("tokens-per-second", "流式输出速度（0表示一次性输出）", "tps",
+                                       QString::number(defaults.tokensPerSecond));
+    QCommandLineOption rate429Option("rate-429", "返回429的比例（0-1）", "rate", QString::number(defaults.rate429));
+    QCommandLineOption retryAfterOption("retry-after", "429响应的Retry-After秒数", "sec",
+                                        QString::number(defaults.retryAfterSec));
+    QCommandLineOption rate5xxOption("rate-5xx", "返回503的比例（0-1）", "rate", QString::number(defaults.rate5xx));
+    QCommandLineOption outageAfterOption("outage-after", "启动多久后进入故障窗口（毫秒）", "ms", "-1");
+    QCommandLineOption outageDurationOption("outage-duration", "故障窗口持续时间（毫秒）", "ms", "0");
+    QCommandLineOption responseFileOption("response-file", "固定响应内容文件", "file");
+    QCommandLineOption statsIntervalOption("stats-interval", "统计输出间隔（秒，0表示不输出）", "sec", "10");
+
+    parser.addOptions({portOption, latencyOption, sigmaOption, tailRateOption, tailLatencyOption, tokenRateOption,
+                       rate429Option, retryAfterOption, rate5xxOption, outageAfterOption, outageDurationOption,
+                       responseFileOption, statsIntervalOption});
+    parser.process(app);
+
+    MockServerOptions options;
+    options.port = static_cast<quint16>(parser.value(portOption).toUInt());
+    options.latencyMedianMs = parser.value(latencyOption).toInt();
+    options.latencySigma = parser.value(sigmaOption).toDouble();
+    options.tailRate = parser.value(tailRateOption).toDouble();
+    options.tailLatencyMs = parser.value(tailLatencyOption).toInt();
+    options.tokensPerSecond = parser.value(tokenRateOption).toInt();
+    options.rate429 = parser.value(rate429Option).toDouble();
+    options.retryAfterSec = parser.value(retryAfterOption).toInt();
+    options.rate5xx = parser.value(rate5xxOption).toDouble();
+    options.outageAfterMs = parser.value(outageAfterOption).toInt();
+    options.outageDurationMs = parser.value(outageDurationOption).toInt();
+    options.cannedResponseFile = parser.value(responseFileOption);
+
+    Logger::instance().setFileEnabled(false);
+
+    MockAIServer server(options);
+    if (!server.start())
+    {
+        return 1;
+    }
+
+    int statsInterval = parser.value(statsIntervalOption).toInt();
+    QTimer statsTimer;
+    if (statsInterval > 0)
+    {
+        QObject::connect(&statsTimer, &QTimer::timeout, [&server]() { Logger::instance().info(server.statsLine()); });
+        statsTimer.start(statsInterval * 1000);
+    }
+
+    return app.exec();
+}
@@ -0,0 +1,502 @@
+/**
+ * @file mockaiserver.cpp
+ * @brief 本地模拟AI服务实现
+ * @author Developer
+ * @date 2026-10-18
+ * @version 1.0
+ */
+
+#include "tools/mockaiserver/mockaiserver.h"
+#include <QDateTime>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QRegularExpression>
+#include <QTimer>
+#include <cmath>
+#include <memory>
+#include "common/logger/logger.h"
+
+namespace
+{
+const int kMaxHeaderBytes = 64 * 1024;   ///< 请求头最大字节数
+const int kCharsPerToken = 4;            ///< 估算token时每个token对应的字符数
+const int kTokensPerChunk = 8;           ///< 流式输出时每个SSE事件包含的token数
+const char kMockModel[] = "mock-model";  ///< 模拟服务返回的模型名
+}  // namespace
+
+MockAIServer::MockAIServer(const MockServerOptions& options, QObject* parent)
+    : QObject(parent), m_options(options), m_server(new QTcpServer(this)), m_random(std::random_device{}()), m_nextId(0)
+{
+    connect(m_server, &QTcpServer::newConnection, this, &MockAIServer::onNewConnection);
+}
+
+bool MockAIServer::start()
+{
+    if (!m_options.cannedResponseFile.isEmpty())
+    {
+        QFile file(m_options.cannedResponseFile);
+        if (!file.open(QIODevice::ReadOnly))
+        {
+            Logger::instance().error("无法打开固定响应文件: " + m_options.cannedResponseFile);
+            return false;
+        }
+        m_cannedResponse = QString::fromUtf8(file.readAll());
+    }
+
+    if (!m_server->listen(QHostAddress::LocalHost, m_options.port))
+    {
+        Logger::instance().error(QString("模拟AI服务监听端口 %1 失败: %2")
+                                     .arg(m_options.port)
+                                     .arg(m_server->errorString()));
+        return false;
+    }
+
+    m_uptime.start();
+    Logger::instance().info(QString("模拟AI服务已启动: http://127.0.0.1:%1/v1 (延迟中位数 %2ms, sigma %3, "
+                                    "长尾 %4/%5ms, %6 token/s, 429 %7, 5xx %8)")
+                                .arg(m_server->serverPort())
+                                .arg(m_options.latencyMedianMs)
+                                .arg(m_options.latencySigma)
+                                .arg(m_options.tailRate)
+                                .arg(m_options.tailLatencyMs)
+                                .arg(m_options.tokensPerSecond)
+                                .arg(m_options.rate429)
+                                .arg(m_options.rate5xx));
+    return true;
+}
+
+MockServerStats MockAIServer::stats() const
+{
+    return m_stats;
+}
+
+QString MockAIServer::statsLine() const
+{
+    return QString("请求 %1, 成功 %2, 429 %3, 503 %4, 故障窗口 %5, 客户端断开 %6, token: 输入 %7 / 输出 %8")
+        .arg(m_stats.requests)
+        .arg(m_stats.succeeded)
+        .arg(m_stats.rateLimited)
+        .arg(m_stats.serverErrors)
+        .arg(m_stats.outageErrors)
+        .arg(m_stats.disconnected)
+        .arg(m_stats.promptTokens)
+        .arg(m_stats.completionTokens);
+}
+
+void MockAIServer::onNewConnection()
+{
+    while (QTcpSocket* socket = m_server->nextPendingConnection())
+    {
+        m_buffers.insert(socket, QByteArray());
+        connect(socket, &QTcpSocket::readyRead, this, [this, socket]() { onSocketReadyRead(socket); });
+        connect(socket, &QTcpSocket::disconnected, this,
+                [this, socket]()
+                {
+                    if (!socket->property("responded").toBool() && socket->property("handled").toBool())
+                    {
+                        m_stats.disconnected++;
+                    }
+                    m_buffers.remove(socket);
+                    socket->deleteLater();
+                });
+    }
+}
+
+void MockAIServer::onSocketReadyRead(QTcpSocket* socket)
+{
+    if (!m_buffers.contains(socket) || socket->property("handled").toBool())
+    {
+        socket->readAll();
+        return;
+    }
+
+    QByteArray& buffer = m_buffers[socket];
+    buffer.append(socket->readAll());
+
+    int headerEnd = buffer.indexOf("\r\n\r\n");
+    if (headerEnd < 0)
+    {
+        if (buffer.size() > kMaxHeaderBytes)
+        {
+            sendResponse(socket, "431 Request Header Fields Too Large", QByteArray());
+        }
+        return;
+    }
+
+    QList<QByteArray> headerLines = buffer.left(headerEnd).split('\n');
+    QList<QByteArray> requestLine = headerLines.value(0).trimmed().split(' ');
+    if (requestLine.size() < 2)
+    {
+        sendResponse(socket, "400 Bad Request", QByteArray());
+        return;
+    }
+
+    int contentLength = 0;
+    for (int i = 1; i < headerLines.size(); ++i)
+    {
+        QByteArray line = headerLines[i].trimmed();
+        int colon = line.indexOf(':');
+        if (colon > 0 && line.left(colon).trimmed().toLower() == "content-length")
+        {
+            contentLength = line.mid(colon + 1).trimmed().toInt();
+        }
+    }
+
+    int bodyStart = headerEnd + 4;
+    if (buffer.size() - bodyStart < contentLength)
+    {
+        return;
+    }
+
+    QByteArray body = buffer.mid(bodyStart, contentLength);
+    buffer.clear();
+    socket->setProperty("handled", true);
+
+    handleRequest(socket, requestLine[0], requestLine[1], body);
+}
+
+void MockAIServer::handleRequest(QTcpSocket* socket, const QByteArray& method, const QByteArray& path,
+                                 const QByteArray& body)
+{
+    if (method == "GET" && path.endsWith("/models"))
+    {
+        QJsonObject model;
+        model["id"] = QString::fromLatin1(kMockModel);
+        model["object"] = "model";
+        model["owned_by"] = "mock";
+
+        QJsonObject root;
+        root["object"] = "list";
+        root["data"] = QJsonArray{model};
+        sendResponse(socket, "200 OK", QJsonDocument(root).toJson(QJsonDocument::Compact));
+        return;
+    }
+
+    if (method != "POST" || !path.endsWith("/chat/completions"))
+    {
+        sendResponse(socket, "404 Not Found", QByteArray());
+        return;
+    }
+
+    QJsonParseError parseError;
+    QJsonDocument doc = QJsonDocument::fromJson(body, &parseError);
+    if (parseError.error != QJsonParseError::NoError || !doc.isObject())
+    {
+        sendResponse(socket, "400 Bad Request", R"({"error":{"message":"invalid json","type":"invalid_request"}})");
+        return;
+    }
+
+    m_stats.requests++;
+    handleChatCompletion(QPointer<QTcpSocket>(socket), doc.object());
+}
+
+void MockAIServer::handleChatCompletion(QPointer<QTcpSocket> socket, const QJsonObject& request)
+{
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+
+    // 故障窗口：模拟端点整体不可用，用于观察熔断器和故障转移
+    qint64 uptime = m_uptime.elapsed();
+    if (m_options.outageAfterMs >= 0 && uptime >= m_options.outageAfterMs &&
+        uptime < m_options.outageAfterMs + m_options.outageDurationMs)
+    {
+        m_stats.outageErrors++;
+        sendResponse(socket, "503 Service Unavailable",
+                     R"({"error":{"message":"mock outage","type":"server_error"}})");
+        return;
+    }
+
+    if (unit(m_random) < m_options.rate429)
+    {
+        m_stats.rateLimited++;
+        sendResponse(socket, "429 Too Many Requests",
+                     R"({"error":{"message":"rate limit exceeded","type":"rate_limit_error"}})",
+                     QByteArray("Retry-After: ") + QByteArray::number(m_options.retryAfterSec) + "\r\n");
+        return;
+    }
+
+    bool serverError = unit(m_random) < m_options.rate5xx;
+    int latency = sampleLatency();
+
+    QString prompt;
+    const QJsonArray messages = request["messages"].toArray();
+    for (const QJsonValue& message : messages)
+    {
+        prompt += message.toObject()["content"].toString();
+    }
+
+    bool stream = request["stream"].toBool();
+    bool includeUsage = request["stream_options"].toObject()["include_usage"].toBool();
+    int promptTokens = estimateTokens(prompt);
+
+    QTimer::singleShot(latency, this,
+                       [this, socket, serverError, prompt, stream, includeUsage, promptTokens]()
+                       {
+                           if (!socket || socket->state() != QAbstractSocket::ConnectedState)
+                           {
+                               return;
+                           }
+
+                           if (serverError)
+                           {
+                               m_stats.serverErrors++;
+                               sendResponse(socket, "503 Service Unavailable",
+                                            R"({"error":{"message":"mock failure","type":"server_error"}})");
+                               return;
+                           }
+
+                           QString content = m_cannedResponse.isEmpty() ? buildCannedContent(prompt)
+                                                                        : m_cannedResponse;
+                           if (stream)
+                           {
+                               streamContent(socket, content, promptTokens, includeUsage);
+                               return;
+                           }
+
+                           int completionTokens = estimateTokens(content);
+                           m_stats.succeeded++;
+                           m_stats.promptTokens += promptTokens;
+                           m_stats.completionTokens += completionTokens;
+
+                           QJsonObject message;
+                           message["role"] = "assistant";
+                           message["content"] = content;
+
+                           QJsonObject choice;
+                           choice["index"] = 0;
+                           choice["message"] = message;
+                           choice["finish_reason"] = "stop";
+
+                           QJsonObject usage;
+                           usage["prompt_tokens"] = promptTokens;
+                           usage["completion_tokens"] = completionTokens;
+                           usage["total_tokens"] = promptTokens + completionTokens;
+
+                           QJsonObject root;
+                           root["id"] = QString("chatcmpl-mock-%1").arg(++m_nextId);
+                           root["object"] = "chat.completion";
+                           root["created"] = QDateTime::currentSecsSinceEpoch();
+                           root["model"] = QString::fromLatin1(kMockModel);
+                           root["choices"] = QJsonArray{choice};
+                           root["usage"] = usage;
+
+                           sendResponse(socket, "200 OK", QJsonDocument(root).toJson(QJsonDocument::Compact));
+                       });
+}
+
+void MockAIServer::streamContent(QPointer<QTcpSocket> socket, const QString& content, int promptTokens,
+                                 bool includeUsage)
+{
+    QString id = QString("chatcmpl-mock-%1").arg(++m_nextId);
+    qint64 created = QDateTime::currentSecsSinceEpoch();
+
+    auto makeEvent = [id, created](const QJsonObject& delta, const QJsonValue& finishReason)
+    {
+        QJsonObject choice;
+        choice["index"] = 0;
+        choice["delta"] = delta;
+        choice["finish_reason"] = finishReason;
+
+        QJsonObject root;
+        root["id"] = id;
+        root["object"] = "chat.completion.chunk";
+        root["created"] = created;
+        root["model"] = QString::fromLatin1(kMockModel);
+        root["choices"] = QJsonArray{choice};
+        return QByteArray("data: ") + QJsonDocument(root).toJson(QJsonDocument::Compact) + "\n\n";
+    };
+
+    socket->setProperty("responded", true);
+    socket->write("HTTP/1.1 200 OK\r\n"
+                  "Content-Type: text/event-stream\r\n"
+                  "Cache-Control: no-cache\r\n"
+                  "Connection: close\r\n\r\n");
+
+    QJsonObject roleDelta;
+    roleDelta["role"] = "assistant";
+    socket->write(makeEvent(roleDelta, QJsonValue::Null));
+
+    // 按token速度切分输出，每个事件包含固定数量的token
+    QStringList chunks;
+    int chunkChars = kTokensPerChunk * kCharsPerToken;
+    for (int pos = 0; pos < content.size(); pos += chunkChars)
+    {
+        chunks.append(content.mid(pos, chunkChars));
+    }
+
+    int completionTokens = estimateTokens(content);
+    int interval = (m_options.tokensPerSecond > 0) ? (kTokensPerChunk * 1000 / m_options.tokensPerSecond) : 0;
+
+    auto finish = [this, socket, makeEvent, id, created, promptTokens, completionTokens, includeUsage]()
+    {
+        if (!socket || socket->state() != QAbstractSocket::ConnectedState)
+        {
+            return;
+        }
+
+        socket->write(makeEvent(QJsonObject(), "stop"));
+
+        if (includeUsage)
+        {
+            QJsonObject usage;
+            usage["prompt_tokens"] = promptTokens;
+            usage["completion_tokens"] = completionTokens;
+            usage["total_tokens"] = promptTokens + completionTokens;
+
+            QJsonObject root;
+            root["id"] = id;
+            root["object"] = "chat.completion.chunk";
+            root["created"] = created;
+            root["model"] = QString::fromLatin1(kMockModel);
+            root["choices"] = QJsonArray();
+            root["usage"] = usage;
+            socket->write(QByteArray("data: ") + QJsonDocument(root).toJson(QJsonDocument::Compact) + "\n\n");
+        }
+
+        socket->write("data: [DONE]\n\n");
+        socket->disconnectFromHost();
+
+        m_stats.succeeded++;
+        m_stats.promptTokens += promptTokens;
+        m_stats.completionTokens += completionTokens;
+    };
+
+    if (interval <= 0)
+    {
+        for (const QString& chunk : chunks)
+        {
+            QJsonObject delta;
+            delta["content"] = chunk;
+            socket->write(makeEvent(delta, QJsonValue::Null));
+        }
+        finish();
+        return;
+    }
+
+    // 定时器挂在连接上，客户端中途断开时随连接一起销毁
+    QTimer* timer = new QTimer(socket);
+    timer->setInterval(interval);
+    auto next = std::make_shared<int>(0);
+    connect(timer, &QTimer::timeout, timer,
+            [socket, timer, next, chunks, makeEvent, finish]()
+            {
+                if (*next >= chunks.size())
+                {
+                    timer->stop();
+                    timer->deleteLater();
+                    finish();
+                    return;
+                }
+
+                QJsonObject delta;
+                delta["content"] = chunks[*next];
+                socket->write(makeEvent(delta, QJsonValue::Null));
+                ++*next;
+            });
+    timer->start();
+}
+
+void MockAIServer::sendResponse(QTcpSocket* socket, const QByteArray& status, const QByteArray& body,
+                                const QByteArray& extraHeaders)
+{
+    socket->setProperty("responded", true);
+
+    QByteArray response = "HTTP/1.1 " + status + "\r\n";
+    response += "Content-Type: application/json\r\n";
+    response += "Content-Length: " + QByteArray::number(body.size()) + "\r\n";
+    response += extraHeaders;
+    response += "Connection: close\r\n\r\n";
+    response += body;
+
+    socket->write(response);
+    socket->disconnectFromHost();
+}
+
+QString MockAIServer::buildCannedContent(const QString& prompt) const
+{
+    const QString flowchart = "flowchart TD\n    A[开始] --> B[处理] --> C[结束]";
+    const QString sequence = "sequenceDiagram\n    participant Caller\n    participant Func\n    Caller->>Func: 调用";
+    const QString structure = "graph TD\n    Module --> Func";
+
+    // 混合模式描述请求：按 "### id: N" 逐个返回
+    static const QRegularExpression idPattern("### id: (\\d+)");
+    QRegularExpressionMatchIterator it = idPattern.globalMatch(prompt);
+    if (it.hasNext())
+    {
+        QJsonArray array;
+        while (it.hasNext())
+        {
+            QRegularExpressionMatch match = it.next();
+            QJsonObject item;
+            item["id"] = match.captured(1).toInt();
+            item["parameters"] = QJsonArray();
+            item["description"] = "## 功能概述\n模拟服务生成的函数说明。";
+            item["flowchart"] = flowchart;
+            item["sequence_diagram"] = sequence;
+            item["structure_diagram"] = structure;
+            array.append(item);
+        }
+        return "```json\n" + QString::fromUtf8(QJsonDocument(array).toJson(QJsonDocument::Indented)) + "```";
+    }
+
+    // 单函数分析请求
+    if (prompt.contains("\"function_name\""))
+    {
+        static const QRegularExpression namePattern("函数名称: ([^\\n]*)");
+        static const QRegularExpression signaturePattern("函数签名: ([^\\n]*)");
+
+        QJsonObject object;
+        object["function_name"] = namePattern.match(prompt).captured(1).trimmed();
+        object["function_description"] = "1. 功能概述\n模拟服务生成的函数说明。";
+        object["signature"] = signaturePattern.match(prompt).captured(1).trimmed();
+        object["return_type"] = "void";
+        object["parameters"] = QJsonArray();
+        object["flowchart"] = flowchart;
+        object["sequence_diagram"] = sequence;
+        object["structure_diagram"] = structure;
+        return "```json\n" + QString::fromUtf8(QJsonDocument(object).toJson(QJsonDocument::Indented)) + "```";
+    }
+
+    // AI提取模式：返回一个覆盖整段代码的函数
+    int codeStart = prompt.indexOf("```");
+    int codeEnd = prompt.indexOf("```", codeStart + 3);
+    int lineCount = (codeStart >= 0 && codeEnd > codeStart) ? prompt.mid(codeStart, codeEnd - codeStart).count('\n')
+                                                             : 1;
+
+    QJsonObject function;
+    function["name"] = "mock_function";
+    function["signature"] = "void mock_function()";
+    function["return_type"] = "void";
+    function["parameters"] = QJsonArray();
+    function["start_line"] = 1;
+    function["end_line"] = qMax(1, lineCount - 1);
+    function["description"] = "## 功能概述\n模拟服务生成的函数说明。";
+    function["flowchart"] = flowchart;
+    function["sequence_diagram"] = sequence;
+    function["structure_diagram"] = structure;
+    return "```json\n" + QString::fromUtf8(QJsonDocument(QJsonArray{function}).toJson(QJsonDocument::Indented)) +
+           "```";
+}
+
+int MockAIServer::sampleLatency()
+{
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    if (m_options.tailRate > 0.0 && unit(m_random) < m_options.tailRate)
+    {
+        return m_options.tailLatencyMs;
+    }
+
+    if (m_options.latencyMedianMs <= 0)
+    {
+        return 0;
+    }
+
+    std::lognormal_distribution<double> distribution(std::log(static_cast<double>(m_options.latencyMedianMs)),
+                                                     m_options.latencySigma);
+    return static_cast<int>(distribution(m_random));
+}
+
+int MockAIServer::estimateTokens(const QString& text)
+{
+    return qMax(1, static_cast<int>(text.size() / kCharsPerToken));
+}
@@ -0,0 +1,173 @@
+/**
+ * @file mockaiserver.h
+ * @brief 本地模拟的OpenAI兼容AI服务，用于压测和故障注入
+ * @author Developer
+ * @date 2026-10-18
+ * @version 1.0
+ *
+ * @details 支持的接口：
+ * - POST .../chat/completions：普通JSON响应和SSE流式响应（含stream_options.include_usage）
+ * - GET  .../models：返回固定的模型列表
+ * 响应内容根据提示词类型生成（函数分析、混合模式描述、AI提取函数），也可通过文件指定固定内容。
+ */
+
+#ifndef MOCKAISERVER_H
+#define MOCKAISERVER_H
+
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QJsonObject>
+#include <QObject>
+#include <QPointer>
+#include <QString>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <random>
+
+/**
+ * @brief 模拟服务配置
+ */
+struct MockServerOptions
+{
+    quint16 port = 8089;         ///< 监听端口
+    int latencyMedianMs = 800;   ///< 首字节延迟中位数（毫秒，对数正态分布）
+    double latencySigma = 0.5;   ///< 对数正态分布的sigma
+    double tailRate = 0.0;       ///< 长尾请求比例（0-1）
+    int tailLatencyMs = 30000;   ///< 长尾请求的延迟（毫秒）
+    int tokensPerSecond = 200;   ///< 流式输出速度（0表示一次性输出）
+    double rate429 = 0.0;        ///< 返回429的比例（0-1）
+    int retryAfterSec = 2;       ///< 429响应的Retry-After秒数
+    double rate5xx = 0.0;        ///< 返回503的比例（0-1）
+    int outageAfterMs = -1;      ///< 启动多久后进入故障窗口（毫秒，-1表示不启用）
+    int outageDurationMs = 0;    ///< 故障窗口持续时间（毫秒），期间所有请求返回503
+    QString cannedResponseFile;  ///< 固定响应内容文件（为空时按提示词生成）
+};
+
+/**
+ * @brief 模拟服务统计
+ */
+struct MockServerStats
+{
+    int requests = 0;             ///< 收到的请求数
+    int succeeded = 0;            ///< 正常响应数
+    int rateLimited = 0;          ///< 返回429的次数
+    int serverErrors = 0;         ///< 随机返回503的次数
+    int outageErrors = 0;         ///< 故障窗口内返回503的次数
+    int disconnected = 0;         ///< 客户端在响应前断开的次数（超时或被中止）
+    qint64 promptTokens = 0;      ///< 累计提示词token数
+    qint64 completionTokens = 0;  ///< 累计输出token数
+};
+
+/**
+ * @brief 模拟AI服务类
+ */
+class MockAIServer : public QObject
+{
+    Q_OBJECT
+
+   public:
+    /**
+     * @brief 构造函数
+     * @param options 服务配置
+     * @param parent 父对象
+     */
+    explicit MockAIServer(const MockServerOptions& options, QObject* parent = nullptr);
+
+    /**
+     * @brief 开始监听
+     * @return 是否成功
+     */
+    bool start();
+
+    /**
+     * @brief 获取统计信息
+     * @return 统计信息
+     */
+    MockServerStats stats() const;
+
+    /**
+     * @brief 将统计信息格式化为一行文本
+     * @return 统计文本
+     */
+    QString statsLine() const;
+
+   private slots:
+    /**
+     * @brief 新连接槽函数
+     */
+    void onNewConnection();
+
+   private:
+    /**
+     * @brief 读取连接上的数据，收到完整请求后处理
+     * @param socket 连接
+     */
+    void onSocketReadyRead(QTcpSocket* socket);
+
+    /**
+     * @brief 处理一个完整的HTTP请求
+     * @param socket 连接
+     * @param method 请求方法
+     * @param path 请求路径
+     * @param body 请求体
+     */
+    void handleRequest(QTcpSocket* socket, const QByteArray& method, const QByteArray& path, const QByteArray& body);
+
+    /**
+     * @brief 处理chat/completions请求
+     * @param socket 连接
+     * @param request 请求JSON
+     */
+    void handleChatCompletion(QPointer<QTcpSocket> socket, const QJsonObject& request);
+
+    /**
+     * @brief 以SSE流式方式发送响应内容
+     * @param socket 连接
+     * @param content 响应内容
+     * @param promptTokens 提示词token数
+     * @param includeUsage 是否在结尾发送usage事件
+     */
+    void streamContent(QPointer<QTcpSocket> socket, const QString& content, int promptTokens, bool includeUsage);
+
+    /**
+     * @brief 发送完整的HTTP响应并关闭连接
+     * @param socket 连接
+     * @param status 状态行（如"200 OK"）
+     * @param body 响应体
+     * @param extraHeaders 额外的响应头
+     */
+    void sendResponse(QTcpSocket* socket, const QByteArray& status, const QByteArray& body,
+                      const QByteArray& extraHeaders = QByteArray());
+
+    /**
+     * @brief 根据提示词生成模拟的AI回答
+     * @param prompt 提示词
+     * @return 回答内容
+     */
+    QString buildCannedContent(const QString& prompt) const;
+
+    /**
+     * @brief 抽样一次首字节延迟
+     * @return 延迟（毫秒）
+     */
+    int sampleLatency();
+
+    /**
+     * @brief 估算文本的token数（约每4个字符1个token）
+     * @param text 文本
+     * @return token数
+     */
+    static int estimateTokens(const QString& text);
+
+    MockServerOptions m_options;               ///< 服务配置
+    QTcpServer* m_server;                      ///< TCP服务
+    QHash<QTcpSocket*, QByteArray> m_buffers;  ///< 各连接尚未处理的数据
+    QElapsedTimer m_uptime;                    ///< 启动以来的时间
+    std::mt19937 m_random;                     ///< 随机数生成器
+    QString m_cannedResponse;                  ///< 固定响应内容
+    MockServerStats m_stats;                   ///< 统计信息
+    int m_nextId;                              ///< 响应ID计数
+};
+
+#endif  // MOCKAISERVER_H
@@ -0,0 +1,209 @@
+/**
+ * @file main.cpp
+ * @brief 函数字典快照查找基准测试
+ * @author Developer
+ * @date 2026-10-18
+ * @version 1.0
+ *
+ * @details 在临时数据库中批量写入 --keys 个函数，导出为快照后对比按函数名称查找介绍的耗时：
+ * - 快照：fd_snapshot_lookup，随机顺序查找 --lookups 次（命中），再查找同样次数的不存在名称
+ * - SQLite：fd_query_by_key 打开游标并读取一行，随机顺序查找 --sqlite-lookups 次
+ * 两条路径的查找结果逐一比对。示例：
+ * snapbench --keys 1000000 --lookups 5000000
+ */
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QRandomGenerator>
+#include <QTemporaryDir>
+#include <QVector>
+#include <cstring>
+#include "api/function_dict_c_api.h"
+#include "common/logger/logger.h"
+
+namespace
+{
+const int kWriteBatch = 10000;  ///< 写入数据库时每批的条数
+
+/**
+ * @brief 通过SQLite路径查找函数介绍
+ * @param handle 句柄
+ * @param key 函数名称
+ * @param value 输出参数，函数介绍
+ * @return 是否找到
+ */
+bool sqliteLookup(fd_handle* handle, const char* key, QByteArray& value)
+{
+    fd_cursor* cursor = nullptr;
+    if (fd_query_by_key(handle, key, &cursor) != 0)
+    {
+        return false;
+    }
+    fd_row row;
+    bool found = fd_cursor_next(cursor, &row) == 1;
+    if (found)
+    {
+        value = row.value ? QByteArray(row.value) : QByteArray();
+    }
+    fd_cursor_close(cursor);
+    return found;
+}
+}  // namespace
+
+int main(int argc, char* argv[])
+{
+    QCoreApplication app(argc, argv);
+    app.setApplicationName("snapbench");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("函数字典快照查找基准测试");
+    parser.addHelpOption();
+    QCommandLineOption keysOption("keys", "函数数量", "count", "1000000");
+    QCommandLineOption lookupsOption("lookups", "快照查找次数", "count", "5000000");
+    QCommandLineOption sqliteOption("sqlite-lookups", "SQLite路径查找次数", "count", "20000");
+    parser.addOptions({keysOption, lookupsOption, sqliteOption});
+    parser.process(app);
+
+    int keyCount = qMax(1, parser.value(keysOption).toInt());
+    int lookupCount = qMax(1, parser.value(lookupsOption).toInt());
+    int sqliteCount = qMax(1, parser.value(sqliteOption).toInt());
+
+    Logger& logger = Logger::instance();
+    logger.setFileEnabled(false);
+    logger.setMinLevel(Info);
+
+    QTemporaryDir tempDir;
+    QByteArray dbPath = tempDir.filePath("snapbench.db").toUtf8();
+    QByteArray snapshotPath = tempDir.filePath("snapbench.snap").toUtf8();
+    if (function_dict_init(dbPath.constData()) != 0)
+    {
+        logger.error(QString("初始化数据库失败: %1").arg(QString::fromUtf8(function_dict_get_last_error())));
+        return 1;
+    }
+    fd_handle* handle = nullptr;
+    if (fd_open(dbPath.constData(), &handle) != 0)
+    {
+        logger.error(QString("打开句柄失败: %1").arg(QString::fromUtf8(fd_last_error(handle))));
+        fd_close(handle);
+        return 1;
+    }
+
+    QVector<QByteArray> keys(keyCount);
+    QVector<QByteArray> values(keyCount);
+    QVector<QByteArray> missing(keyCount);
+    for (int i = 0; i < keyCount; ++i)
+    {
+        keys[i] = "snap_func_" + QByteArray::number(i);
+        values[i] = "函数 " + QByteArray::number(i) + " 的介绍：基准测试生成";
+        missing[i] = "missing_func_" + QByteArray::number(i);
+    }
+
+    QVector<fd_function> functions(kWriteBatch);
+    for (int offset = 0; offset < keyCount; offset += kWriteBatch)
+    {
+        int count = qMin(kWriteBatch, keyCount - offset);
+        for (int i = 0; i < count; ++i)
+        {
+            fd_function& function = functions[i];
+            std::memset(&function, 0, sizeof(function));
+            function.key = keys[offset + i].constData();
+            function.value = values[offset + i].constData();
+        }
+        if (fd_insert_functions(handle, functions.constData(), count, nullptr) != 0)
+        {
+            logger.error(QString("写入数据库失败: %1").arg(QString::fromUtf8(fd_last_error(handle))));
+            fd_close(handle);
+            return 1;
+        }
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    int exported = 0;
+    if (fd_export_snapshot(handle, snapshotPath.constData(), &exported) != 0 || exported != keyCount)
+    {
+        logger.error(QString("导出快照失败（%1 个函数）: %2").arg(exported).arg(QString::fromUtf8(fd_last_error(handle))));
+        fd_close(handle);
+        return 1;
+    }
+    qint64 exportMs = timer.elapsed();
+
+    fd_snapshot* snapshot = nullptr;
+    if (fd_snapshot_open(snapshotPath.constData(), &snapshot) != 0)
+    {
+        logger.error(QString("打开快照失败: %1").arg(QString::fromUtf8(fd_snapshot_last_error(snapshot))));
+        fd_snapshot_close(snapshot);
+        fd_close(handle);
+        return 1;
+    }
+
+    QRandomGenerator random(42);
+    QVector<int> order(qMax(lookupCount, sqliteCount));
+    for (int& index : order)
+    {
+        index = static_cast<int>(random.bounded(keyCount));
+    }
+
+    const char* value = nullptr;
+    size_t valueLength = 0;
+    int hits = 0;
+    timer.start();
+    for (int i = 0; i < lookupCount; ++i)
+    {
+        hits += fd_snapshot_lookup(snapshot, keys[order[i]].constData(), &value, &valueLength);
+    }
+    qint64 hitNs = timer.nsecsElapsed();
+
+    int misses = 0;
+    timer.start();
+    for (int i = 0; i < lookupCount; ++i)
+    {
+        misses += 1 - fd_snapshot_lookup(snapshot, missing[order[i]].constData(), &value, &valueLength);
+    }
+    qint64 missNs = timer.nsecsElapsed();
+
+    QByteArray sqliteValue;
+    int sqliteHits = 0;
+    timer.start();
+    for (int i = 0; i < sqliteCount; ++i)
+    {
+        sqliteHits += sqliteLookup(handle, keys[order[i]].constData(), sqliteValue) ? 1 : 0;
+    }
+    qint64 sqliteNs = timer.nsecsElapsed();
+
+    int mismatches = 0;
+    for (int i = 0; i < sqliteCount; ++i)
+    {
+        const QByteArray& key = keys[order[i]];
+        bool found = fd_snapshot_lookup(snapshot, key.constData(), &value, &valueLength) == 1;
+        if (!found || !sqliteLookup(handle, key.constData(), sqliteValue) ||
+            sqliteValue != QByteArray(value, static_cast<int>(valueLength)))
+        {
+            ++mismatches;
+        }
+    }
+
+    fd_snapshot_close(snapshot);
+    fd_close(handle);
+    function_dict_cleanup();
+
+    if (hits != lookupCount || misses != lookupCount || sqliteHits != sqliteCount || mismatches != 0)
+    {
+        logger.error(QString("结果不符 - 快照命中: %1/%2, 快照未命中: %3/%2, SQLite命中: %4/%5, 不一致: %6")
+                         .arg(hits)
+                         .arg(lookupCount)
+                         .arg(misses)
+                         .arg(sqliteHits)
+                         .arg(sqliteCount)
+                         .arg(mismatches));
+        return 1;
+    }
+
+    logger.info(QString("函数数 %1, 导出快照 %2 毫秒").arg(keyCount).arg(exportMs));
+    logger.info(QString("快照查找（命中）%1 纳秒/次, 快照查找（不存在）%2 纳秒/次, SQLite查找 %3 纳秒/次")
+                    .arg(static_cast<double>(hitNs) / lookupCount, 0, 'f', 1)
+                    .arg(static_cast<double>(missNs) / lookupCount, 0, 'f', 1)
+                    .arg(static_cast<double>(sqliteNs) / sqliteCount, 0, 'f', 1));
+    return 0;
+}
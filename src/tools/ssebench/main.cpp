@@ -0,0 +1,569 @@
+/**
+ * @file main.cpp
+ * @brief SSE流式响应解析基准测试
+ * @author Developer
+ * @date 2026-10-18
+ * @version 1.0
+ *
+ * @details 回放一段录制的SSE流，按录制时的数据块边界逐块送入两种解析方式，比较每次回放的耗时和堆分配次数：
+ * - 旧方式：每个数据块转为QString后追加到缓冲区，整体按'\n'切分，每个事件构建QJsonDocument
+ * - SseStreamFramer：字节缓冲区加读游标切分，delta.content走快速提取，无法识别的事件回退到QJsonDocument
+ * 录制文件为ResponseRecorder的JSON Lines格式（--capture，取其中数据量最大的一条响应）；
+ * 未指定时生成约 --tokens 个token的流（每个事件一个token，每个数据块包含若干完整事件），
+ * 可用 --save 保存为录制文件供以后回放。两种方式解析出的文本逐字比对。示例：
+ * ssebench --tokens 16384 --iterations 50 --save stream16k.jsonl
+ * ssebench --capture stream16k.jsonl
+ */
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QRandomGenerator>
+#include <QStringList>
+#include <QVector>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include "common/logger/logger.h"
+#include "core/ai/responserecorder.h"
+#include "core/ai/ssestreamframer.h"
+
+namespace
+{
+std::atomic<qint64> g_allocations(0);  ///< 进程内的堆分配次数
+
+/**
+ * @brief 记录一次堆分配
+ */
+void countAllocation()
+{
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+}
+}  // namespace
+
+#if defined(__GLIBC__)
+// glibc下替换malloc系列函数，Qt容器的缓冲区（直接调用malloc/realloc）和operator new都能被统计
+extern "C" {
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t count, size_t size);
+void* __libc_realloc(void* ptr, size_t size);
+
+void* malloc(size_t size)
+{
+    countAllocation();
+    return __libc_malloc(size);
+}
+
+void* calloc(size_t count, size_t size)
+{
+    countAllocation();
+    return __libc_calloc(count, size);
+}
+
+void* realloc(void* ptr, size_t size)
+{
+    countAllocation();
+    return __libc_realloc(ptr, size);
+}
+}
+#else
+// 其他平台只能替换operator new，Qt容器直接调用malloc分配的缓冲区不计入
+void* operator new(std::size_t size)
+{
+    countAllocation();
+    if (void* ptr = std::malloc(size ? size : 1))
+    {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+#endif
+
+namespace
+{
+const int kMinEventsPerChunk = 1;  ///< 生成的流中每个数据块最少包含的事件数
+const int kMaxEventsPerChunk = 6;  ///< 生成的流中每个数据块最多包含的事件数
+
+/**
+ * @brief 旧的解析方式（AICodeParser 改用 SseStreamFramer 之前的实现）
+ */
+struct LegacyParser
+{
+    QString buffer;      ///< 未处理完的行
+    QString content;     ///< 累积的内容
+    int tokens = 0;      ///< 收到的内容事件数
+    int jsonParses = 0;  ///< 构建QJsonDocument的事件数
+
+    /**
+     * @brief 处理一个数据块
+     * @param data 数据块
+     */
+    void feed(const QByteArray& data)
+    {
+        buffer += QString::fromUtf8(data);
+
+        QStringList lines = buffer.split('\n');
+        buffer = lines.takeLast();
+
+        for (const QString& line : lines)
+        {
+            if (line.trimmed().isEmpty())
+            {
+                continue;
+            }
+            parseLine(line);
+        }
+    }
+
+    /**
+     * @brief 结束输入，处理末尾不完整的行
+     */
+    void finish()
+    {
+        if (!buffer.trimmed().isEmpty())
+        {
+            parseLine(buffer);
+            buffer.clear();
+        }
+    }
+
+    /**
+     * @brief 解析一行
+     * @param line 行文本
+     */
+    void parseLine(const QString& line)
+    {
+        if (!line.startsWith("data: "))
+        {
+            return;
+        }
+
+        QString data = line.mid(6).trimmed();
+        if (data == "[DONE]")
+        {
+            return;
+        }
+
+        jsonParses++;
+        QJsonParseError parseError;
+        QJsonDocument jsonDoc = QJsonDocument::fromJson(data.toUtf8(), &parseError);
+        if (parseError.error != QJsonParseError::NoError || !jsonDoc.isObject())
+        {
+            return;
+        }
+
+        QJsonArray choicesArray = jsonDoc.object()["choices"].toArray();
+        if (choicesArray.isEmpty())
+        {
+            return;
+        }
+        QJsonObject deltaObj = choicesArray[0].toObject()["delta"].toObject();
+        if (deltaObj.contains("content"))
+        {
+            content += deltaObj["content"].toString();
+            tokens++;
+        }
+    }
+};
+
+/**
+ * @brief 新的解析方式（与 AICodeParser::parseSSEPayload 相同）
+ */
+struct FramerParser
+{
+    SseStreamFramer framer;  ///< 分帧器
+    QByteArray content;      ///< 累积的内容（UTF-8）
+    int tokens = 0;          ///< 收到的内容事件数
+    int jsonParses = 0;      ///< 回退到QJsonDocument的事件数
+
+    /**
+     * @brief 处理一个数据块
+     * @param data 数据块
+     */
+    void feed(const QByteArray& data)
+    {
+        framer.append(data);
+        drain();
+    }
+
+    /**
+     * @brief 结束输入，处理末尾不完整的行
+     */
+    void finish()
+    {
+        framer.finish();
+        drain();
+        framer.clear();
+    }
+
+    /**
+     * @brief 处理缓冲区中所有完整的事件
+     */
+    void drain()
+    {
+        QByteArrayView payload;
+        while (framer.nextDataPayload(payload))
+        {
+            parsePayload(payload);
+        }
+    }
+
+    /**
+     * @brief 解析一个data负载
+     * @param payload data负载
+     */
+    void parsePayload(QByteArrayView payload)
+    {
+        if (SseStreamFramer::isDoneMarker(payload))
+        {
+            return;
+        }
+
+        SseDeltaResult deltaResult = SseStreamFramer::containsUsage(payload)
+                                         ? SseDeltaResult::Fallback
+                                         : SseStreamFramer::extractDeltaContent(payload, content);
+        if (deltaResult == SseDeltaResult::Fallback)
+        {
+            jsonParses++;
+            QJsonParseError parseError;
+            QJsonDocument jsonDoc = QJsonDocument::fromJson(payload.toByteArray(), &parseError);
+            if (parseError.error != QJsonParseError::NoError || !jsonDoc.isObject())
+            {
+                return;
+            }
+
+            QJsonArray choicesArray = jsonDoc.object()["choices"].toArray();
+            if (choicesArray.isEmpty())
+            {
+                return;
+            }
+            QJsonObject deltaObj = choicesArray[0].toObject()["delta"].toObject();
+            if (!deltaObj.contains("content") || deltaObj["content"].isNull())
+            {
+                return;
+            }
+            content += deltaObj["content"].toString().toUtf8();
+            deltaResult = SseDeltaResult::Content;
+        }
+
+        if (deltaResult == SseDeltaResult::Content)
+        {
+            tokens++;
+        }
+    }
+};
+
+/**
+ * @brief 单种解析方式的测量结果
+ */
+struct ReplayResult
+{
+    QString content;          ///< 解析出的文本
+    int tokens = 0;           ///< 内容事件数
+    int jsonParses = 0;       ///< 构建QJsonDocument的事件数
+    double microseconds = 0;  ///< 每次回放的平均耗时（微秒）
+    double allocations = 0;   ///< 每次回放的平均堆分配次数
+};
+
+/**
+ * @brief 把解析出的内容转为QString
+ */
+QString toText(const QString& content)
+{
+    return content;
+}
+
+QString toText(const QByteArray& content)
+{
+    return QString::fromUtf8(content);
+}
+
+/**
+ * @brief 用一种解析方式回放数据块
+ * @param chunks 数据块
+ * @param iterations 回放次数（另有一次不计时的预热）
+ * @return 测量结果
+ */
+template <typename Parser>
+ReplayResult replay(const QVector<QByteArray>& chunks, int iterations)
+{
+    ReplayResult result;
+    {
+        Parser parser;
+        for (const QByteArray& chunk : chunks)
+        {
+            parser.feed(chunk);
+        }
+        parser.finish();
+        result.content = toText(parser.content);
+        result.tokens = parser.tokens;
+        result.jsonParses = parser.jsonParses;
+    }
+
+    qint64 allocationsBefore = g_allocations.load(std::memory_order_relaxed);
+    QElapsedTimer timer;
+    timer.start();
+    for (int i = 0; i < iterations; ++i)
+    {
+        Parser parser;
+        for (const QByteArray& chunk : chunks)
+        {
+            parser.feed(chunk);
+        }
+        parser.finish();
+    }
+    qint64 elapsedNs = timer.nsecsElapsed();
+    qint64 allocations = g_allocations.load(std::memory_order_relaxed) - allocationsBefore;
+
+    result.microseconds = static_cast<double>(elapsedNs) / iterations / 1000.0;
+    result.allocations = static_cast<double>(allocations) / iterations;
+    return result;
+}
+
+/**
+ * @brief 从录制文件中取数据量最大的一条响应
+ * @param path 录制文件路径
+ * @param response 输出参数，响应记录
+ * @return 是否成功
+ */
+bool loadCapture(const QString& path, RecordedResponse& response)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        return false;
+    }
+
+    qint64 bestBytes = 0;
+    while (!file.atEnd())
+    {
+        QByteArray line = file.readLine().trimmed();
+        QJsonDocument doc = QJsonDocument::fromJson(line);
+        if (!doc.isObject())
+        {
+            continue;
+        }
+
+        RecordedResponse candidate;
+        candidate.fromJson(doc.object());
+        qint64 bytes = 0;
+        for (const RecordedChunk& chunk : candidate.chunks)
+        {
+            bytes += chunk.data.size();
+        }
+        if (bytes > bestBytes)
+        {
+            bestBytes = bytes;
+            response = candidate;
+        }
+    }
+    return bestBytes > 0;
+}
+
+/**
+ * @brief 生成一段流式响应
+ * @param tokenCount 内容事件数
+ * @return 响应记录
+ */
+RecordedResponse generateStream(int tokenCount)
+{
+    // 混合中英文、Markdown和需要转义的字符，接近函数分析结果的实际内容
+    static const char* const kTokens[] = {
+        "该", "函数", "用于", "解析", " SSE", " 数据", "流", "，", "并", "返回", " `QString`", "。",
+        "\n", "## ", "参数", "\n- ", "`payload`", "：", " the", " buffer", " cursor", "\"", "\\", "\t",
+        "缓冲区", "读", "游标", " → ", "{", "}", " O(n)", " 🚀"};
+    const int tokenKinds = static_cast<int>(sizeof(kTokens) / sizeof(kTokens[0]));
+
+    auto makeEvent = [](const QJsonObject& delta, const QJsonValue& finishReason)
+    {
+        QJsonObject choice;
+        choice["index"] = 0;
+        choice["delta"] = delta;
+        choice["finish_reason"] = finishReason;
+
+        QJsonObject root;
+        root["id"] = "chatcmpl-ssebench";
+        root["object"] = "chat.completion.chunk";
+        root["created"] = 1760745600;
+        root["model"] = "ssebench";
+        root["choices"] = QJsonArray{choice};
+        return QByteArray("data: ") + QJsonDocument(root).toJson(QJsonDocument::Compact) + "\n\n";
+    };
+
+    QRandomGenerator random(16384);
+    QVector<QByteArray> events;
+    events.reserve(tokenCount + 4);
+
+    QJsonObject roleDelta;
+    roleDelta["role"] = "assistant";
+    events.append(makeEvent(roleDelta, QJsonValue::Null));
+    for (int i = 0; i < tokenCount; ++i)
+    {
+        QJsonObject delta;
+        delta["content"] = QString::fromUtf8(kTokens[random.bounded(tokenKinds)]);
+        events.append(makeEvent(delta, QJsonValue::Null));
+    }
+    events.append(makeEvent(QJsonObject(), QString("stop")));
+
+    QJsonObject usage;
+    usage["prompt_tokens"] = 1200;
+    usage["completion_tokens"] = tokenCount;
+    usage["total_tokens"] = 1200 + tokenCount;
+    QJsonObject usageRoot;
+    usageRoot["id"] = "chatcmpl-ssebench";
+    usageRoot["object"] = "chat.completion.chunk";
+    usageRoot["choices"] = QJsonArray();
+    usageRoot["usage"] = usage;
+    events.append(QByteArray("data: ") + QJsonDocument(usageRoot).toJson(QJsonDocument::Compact) + "\n\n");
+    events.append("data: [DONE]\n\n");
+
+    RecordedResponse response;
+    response.key = "ssebench";
+    response.httpStatus = 200;
+    response.reasonPhrase = "OK";
+    response.headers.append(qMakePair(QByteArray("Content-Type"), QByteArray("text/event-stream")));
+    for (int i = 0; i < events.size();)
+    {
+        int count = qMin(static_cast<int>(random.bounded(kMinEventsPerChunk, kMaxEventsPerChunk + 1)),
+                         static_cast<int>(events.size()) - i);
+        RecordedChunk chunk;
+        chunk.offsetMs = response.chunks.size() * 10;
+        for (int j = 0; j < count; ++j)
+        {
+            chunk.data += events[i + j];
+        }
+        response.chunks.append(chunk);
+        i += count;
+    }
+    response.finishedAtMs = response.chunks.size() * 10;
+    return response;
+}
+}  // namespace
+
+int main(int argc, char* argv[])
+{
+    QCoreApplication app(argc, argv);
+    app.setApplicationName("ssebench");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("SSE流式响应解析基准测试");
+    parser.addHelpOption();
+    QCommandLineOption captureOption("capture", "录制文件（ResponseRecorder格式），未指定时生成流", "path");
+    QCommandLineOption tokensOption("tokens", "生成的流包含的token数", "count", "16384");
+    QCommandLineOption iterationsOption("iterations", "每种解析方式的回放次数", "count", "20");
+    QCommandLineOption saveOption("save", "把生成的流保存为录制文件", "path");
+    parser.addOptions({captureOption, tokensOption, iterationsOption, saveOption});
+    parser.process(app);
+
+    int tokenCount = qMax(1, parser.value(tokensOption).toInt());
+    int iterations = qMax(1, parser.value(iterationsOption).toInt());
+
+    Logger& logger = Logger::instance();
+    logger.setFileEnabled(false);
+    logger.setMinLevel(Info);
+
+    RecordedResponse response;
+    if (parser.isSet(captureOption))
+    {
+        if (!loadCapture(parser.value(captureOption), response))
+        {
+            logger.error("无法从录制文件中读取响应: " + parser.value(captureOption));
+            return 1;
+        }
+    }
+    else
+    {
+        response = generateStream(tokenCount);
+        if (parser.isSet(saveOption))
+        {
+            QFile file(parser.value(saveOption));
+            if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+            {
+                logger.error("无法写入录制文件: " + file.errorString());
+                return 1;
+            }
+            file.write(QJsonDocument(response.toJson()).toJson(QJsonDocument::Compact));
+            file.write("\n");
+        }
+    }
+
+    QVector<QByteArray> chunks;
+    qint64 totalBytes = 0;
+    for (const RecordedChunk& chunk : response.chunks)
+    {
+        chunks.append(chunk.data);
+        totalBytes += chunk.data.size();
+    }
+
+    ReplayResult legacy = replay<LegacyParser>(chunks, iterations);
+    ReplayResult framer = replay<FramerParser>(chunks, iterations);
+
+    if (legacy.content != framer.content || legacy.tokens != framer.tokens)
+    {
+        // 旧方式逐块转码，多字节字符被数据块截断时结果会出错
+        logger.error(QString("两种方式解析结果不一致 - 旧方式: %1 个token / %2 个字符, "
+                             "SseStreamFramer: %3 个token / %4 个字符")
+                         .arg(legacy.tokens)
+                         .arg(legacy.content.size())
+                         .arg(framer.tokens)
+                         .arg(framer.content.size()));
+        return 1;
+    }
+
+#if defined(__GLIBC__)
+    const char* allocationScope = "malloc/calloc/realloc";
+#else
+    const char* allocationScope = "operator new（不含Qt容器缓冲区）";
+#endif
+    logger.info(QString("数据块 %1 个, %2 字节, 内容token %3 个, 回放 %4 次, 分配统计: %5")
+                    .arg(chunks.size())
+                    .arg(totalBytes)
+                    .arg(framer.tokens)
+                    .arg(iterations)
+                    .arg(allocationScope));
+    logger.info(QString("旧方式（QString切分 + QJsonDocument）: %1 微秒/次, %2 次分配/次, %3 次分配/token, "
+                        "JSON解析 %4 个事件")
+                    .arg(legacy.microseconds, 0, 'f', 1)
+                    .arg(legacy.allocations, 0, 'f', 0)
+                    .arg(legacy.allocations / qMax(1, legacy.tokens), 0, 'f', 2)
+                    .arg(legacy.jsonParses));
+    logger.info(QString("SseStreamFramer（快速路径）: %1 微秒/次, %2 次分配/次, %3 次分配/token, "
+                        "回退JSON解析 %4 个事件")
+                    .arg(framer.microseconds, 0, 'f', 1)
+                    .arg(framer.allocations, 0, 'f', 0)
+                    .arg(framer.allocations / qMax(1, framer.tokens), 0, 'f', 2)
+                    .arg(framer.jsonParses));
+    logger.info(QString("耗时降为 %1%, 分配次数降为 %2%")
+                    .arg(100.0 * framer.microseconds / qMax(0.001, legacy.microseconds), 0, 'f', 1)
+                    .arg(100.0 * framer.allocations / qMax(1.0, legacy.allocations), 0, 'f', 1));
+    return 0;
+}
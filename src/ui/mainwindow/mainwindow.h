@@ -47,6 +47,9 @@ class MainWindow : public QMainWindow
     explicit MainWindow(IDatabaseManager* dbManager, IParseService* parseService, QWidget* parent = nullptr);
     ~MainWindow();
 
+   public slots:
+    void onDataChanged();  // 数据在界面之外变化（批量处理完成、项目增量更新）后刷新函数树
+
    private slots:
     void onTreeItemClicked(const QModelIndex& index);
     void onTreeItemDoubleClicked(const QModelIndex& index);
@@ -60,7 +63,6 @@ class MainWindow : public QMainWindow
     void onAboutClicked();
     void onThemeChanged(QAction* action);
     void onThemeChangedSignal(ThemeType theme);
-    void onDataChanged();
     void onFunctionMoved(int functionId, int targetProjectId);
 
    private:
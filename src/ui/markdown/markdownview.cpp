@@ -40,7 +40,7 @@ void MarkdownView::loadTemplate()
 {
     QString resourcePath = ":/markdown/resources/template.html";
 
-    Logger::instance().debug("尝试加载 Markdown 模板，路径: " + resourcePath);
+    LOG_DEBUG("尝试加载 Markdown 模板，路径: %1", resourcePath);
 
     QFile templateFile(resourcePath);
 
@@ -102,7 +102,7 @@ void MarkdownView::setMarkdown(const QString& content)
         page()->runJavaScript(js);
     }
 
-    Logger::instance().debug("设置 Markdown 内容，长度: " + QString::number(content.length()));
+    LOG_DEBUG("设置 Markdown 内容，长度: %1", content.length());
 }
 
 void MarkdownView::setHtmlContent(const QString& html)
@@ -156,7 +156,7 @@ void MarkdownView::onLoadFinished(bool success)
     }
 
     emit loadFinished(success);
-    Logger::instance().debug("页面加载完成: " + QString(success ? "成功" : "失败"));
+    LOG_DEBUG("页面加载完成: %1", success ? "成功" : "失败");
 }
 
 QString MarkdownView::generateHtml(const QString& markdown)